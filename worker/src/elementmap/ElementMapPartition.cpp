@@ -6,6 +6,8 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include <BRepBndLib.hxx>
@@ -19,6 +21,8 @@
 #include <TopTools_ListOfShape.hxx>
 
 #include "elementmap/Scoring.h"
+#include "util/Stats.h"
+#include "util/Trace.h"
 
 namespace onecad::elementmap {
 
@@ -222,39 +226,137 @@ km::ElementDescriptor ElementMapPartition::descriptor_from_json(const nlohmann::
     return d;
 }
 
+// --- storage ---------------------------------------------------------------
+
+namespace {
+
+std::size_t kind_slot(km::ElementKind kind) { return static_cast<std::size_t>(kind); }
+
+}  // namespace
+
+PartitionEntry& ElementMapPartition::own(Entries::iterator it) {
+    if (it->second.use_count() == 1) return *it->second;
+    // Shared with another partition copy: clone, then re-key this partition's map
+    // node and index at the clone's own strings (the views must not outlive the
+    // original, which the other copy may drop at any time).
+    auto clone = std::make_shared<PartitionEntry>(*it->second);
+    index_erase(*it->second);
+    auto node = entries_.extract(it);
+    node.key() = clone->element_id;
+    node.mapped() = clone;
+    entries_.insert(std::move(node));
+    index_insert(*clone);
+    return *clone;
+}
+
+void ElementMapPartition::index_insert(const PartitionEntry& e) {
+    BodyBucket& bucket = by_body_[e.body_id];
+    bucket.all.insert_or_assign(e.element_id, &e);
+    bucket.by_kind[kind_slot(e.kind)].insert_or_assign(e.element_id, &e);
+}
+
+void ElementMapPartition::index_erase(const PartitionEntry& e) {
+    auto it = by_body_.find(e.body_id);
+    if (it == by_body_.end()) return;
+    it->second.all.erase(e.element_id);
+    it->second.by_kind[kind_slot(e.kind)].erase(e.element_id);
+    if (it->second.all.empty()) by_body_.erase(it);
+}
+
+void ElementMapPartition::erase_entry(Entries::iterator it) {
+    index_erase(*it->second);  // before the node (and the viewed strings) go
+    entries_.erase(it);
+}
+
+std::vector<std::string> ElementMapPartition::ids_of_body(const std::string& body_id) const {
+    std::vector<std::string> ids;
+    auto it = by_body_.find(body_id);
+    if (it == by_body_.end()) return ids;
+    ids.reserve(it->second.all.size());
+    for (const auto& [id, e] : it->second.all) ids.emplace_back(id);
+    return ids;
+}
+
 // --- queries ---------------------------------------------------------------
 
 const PartitionEntry* ElementMapPartition::find(const std::string& element_id) const {
-    auto it = entries_.find(element_id);
-    return it != entries_.end() ? &it->second : nullptr;
+    auto it = entries_.find(std::string_view(element_id));
+    return it != entries_.end() ? it->second.get() : nullptr;
 }
 
 bool ElementMapPartition::contains(const std::string& element_id) const {
-    return entries_.count(element_id) != 0;
+    return entries_.count(std::string_view(element_id)) != 0;
+}
+
+std::vector<const PartitionEntry*> ElementMapPartition::entries() const {
+    std::vector<const PartitionEntry*> out;
+    out.reserve(entries_.size());
+    for (const auto& [id, e] : entries_) out.push_back(e.get());
+    return out;
 }
 
 std::vector<const PartitionEntry*> ElementMapPartition::entries_for_body(
     const std::string& body_id) const {
     std::vector<const PartitionEntry*> out;
-    for (const auto& [id, e] : entries_) {
-        if (e.body_id == body_id) out.push_back(&e);
-    }
+    auto it = by_body_.find(body_id);
+    if (it == by_body_.end()) return out;
+    out.reserve(it->second.all.size());
+    for (const auto& [id, e] : it->second.all) out.push_back(e);
+    return out;
+}
+
+std::vector<const PartitionEntry*> ElementMapPartition::entries_for_body(
+    const std::string& body_id, km::ElementKind kind) const {
+    std::vector<const PartitionEntry*> out;
+    auto it = by_body_.find(body_id);
+    if (it == by_body_.end()) return out;
+    const IdIndex& bucket = it->second.by_kind[kind_slot(kind)];
+    out.reserve(bucket.size());
+    for (const auto& [id, e] : bucket) out.push_back(e);
     return out;
 }
 
+const PartitionEntry* ElementMapPartition::find_by_topokey(const std::string& body_id,
+                                                           const std::string& topo_key) const {
+    auto it = by_body_.find(body_id);
+    if (it == by_body_.end()) return nullptr;
+    // A well-formed key names its kind, so only that sub-bucket can hold it; an
+    // empty or malformed key (an unbound entry) falls back to the whole body.
+    char prefix = 0;
+    int index = 0;
+    const IdIndex& bucket = parse_topokey(topo_key, prefix, index)
+                                ? it->second.by_kind[kind_slot(kind_of_prefix(prefix))]
+                                : it->second.all;
+    for (const auto& [id, e] : bucket) {
+        if (e->topo_key == topo_key) return e;
+    }
+    return nullptr;
+}
+
 // --- minting ---------------------------------------------------------------
 
 DeltaEntry ElementMapPartition::mint(const std::string& body_id, const std::string& element_id,
                                      km::ElementKind kind, const TopoDS_Shape& sub_shape,
                                      const TopoDS_Shape& body_shape, nlohmann::json anchor) {
-    PartitionEntry& e = entries_[element_id];
-    e.element_id = element_id;
+    auto it = entries_.find(std::string_view(element_id));
+    PartitionEntry* target = nullptr;
+    if (it == entries_.end()) {
+        auto fresh = std::make_shared<PartitionEntry>();
+        fresh->element_id = element_id;
+        target = fresh.get();
+        entries_.emplace(std::string_view(target->element_id), std::move(fresh));
+    } else {
+        target = &own(it);
+        index_erase(*target);  // body and kind may change below
+    }
+    PartitionEntry& e = *target;
     e.body_id = body_id;
     e.kind = kind;
     e.shape = sub_shape;
     e.topo_key = topokey_for_shape(body_shape, sub_shape, kind);
     e.descriptor = describe(sub_shape);
     if (!anchor.is_null()) e.anchor = std::move(anchor);
+    index_insert(e);
     return DeltaEntry{element_id, e.topo_key, kind_name(kind), body_id};
 }
 
@@ -326,13 +428,12 @@ void ElementMapPartition::apply_history(const std::string& body_id,
                                         const TopoDS_Shape& new_body_shape,
                                         BRepBuilderAPI_MakeShape& hist, ElementMapDelta& delta,
                                         std::vector<nlohmann::json>* needs_repair_out) {
+    const trace::Span span("history", body_id);
+    const stats::PhaseTimer phase(stats::Phase::History);
     const double body_diag = body_diag_of(new_body_shape);
 
     // Collect the entries of this body up front (we mutate the map below).
-    std::vector<std::string> ids;
-    for (const auto& [id, e] : entries_) {
-        if (e.body_id == body_id) ids.push_back(id);
-    }
+    const std::vector<std::string> ids = ids_of_body(body_id);
 
     auto emit_no_candidates = [&](const std::string& id) {
         if (needs_repair_out) {
@@ -349,13 +450,14 @@ void ElementMapPartition::apply_history(const std::string& body_id,
     };
 
     for (const std::string& id : ids) {
-        PartitionEntry& e = entries_[id];
+        const auto it = entries_.find(std::string_view(id));
+        const PartitionEntry& e = *it->second;  // read-only until the rebind below
         const TopoDS_Shape old = e.shape;
 
         // Deleted by the operation → the element no longer exists (definitive).
         if (!old.IsNull() && hist.IsDeleted(old)) {
             delta.removed.push_back(id);
-            entries_.erase(id);
+            erase_entry(it);
             continue;
         }
 
@@ -434,7 +536,7 @@ void ElementMapPartition::apply_history(const std::string& body_id,
                         {"anchor", e.anchor.is_null() ? nlohmann::json::object() : e.anchor},
                         {"uiLabel", "ambiguous split of element on " + body_id}});
                 }
-                entries_.erase(id);  // cannot confidently rebind
+                erase_entry(it);  // cannot confidently rebind
                 continue;
             }
         }
@@ -443,16 +545,18 @@ void ElementMapPartition::apply_history(const std::string& body_id,
         if (new_key.empty()) {
             // No identifiable successor in the new body → NeedsRepair "no-candidates".
             emit_no_candidates(id);
-            entries_.erase(id);
+            erase_entry(it);
             continue;
         }
 
         const bool changed = (new_key != e.topo_key) || !image.IsSame(e.shape);
-        e.shape = image;
-        e.topo_key = new_key;
-        e.descriptor = describe(image);
+        // Body and kind are unchanged, so the index stays valid across the write.
+        PartitionEntry& w = own(it);
+        w.shape = image;
+        w.topo_key = new_key;
+        w.descriptor = describe(image);
         if (changed) {
-            delta.relabeled.push_back(DeltaEntry{id, new_key, kind_name(e.kind), body_id});
+            delta.relabeled.push_back(DeltaEntry{id, new_key, kind_name(w.kind), body_id});
         }
     }
 }
@@ -491,8 +595,10 @@ void move_direction(nlohmann::json& holder, const char* key, const gp_Trsf& trsf
 
 void ElementMapPartition::apply_placement(const std::string& body_id, const gp_Trsf& trsf) {
     if (trsf.Form() == gp_Identity) return;  // a no-op placement moves no evidence
-    for (auto& [id, e] : entries_) {
-        if (e.body_id != body_id || !e.anchor.is_object()) continue;
+    for (const std::string& id : ids_of_body(body_id)) {
+        const auto it = entries_.find(std::string_view(id));
+        if (!it->second->anchor.is_object()) continue;
+        PartitionEntry& e = own(it);
         move_point(e.anchor, "worldPoint", trsf);
         if (e.anchor.contains("localFrame") && e.anchor["localFrame"].is_object()) {
             nlohmann::json& lf = e.anchor["localFrame"];
@@ -507,14 +613,17 @@ void ElementMapPartition::apply_placement(const std::string& body_id, const gp_T
 }
 
 void ElementMapPartition::remove_body(const std::string& body_id, ElementMapDelta& delta) {
-    for (auto it = entries_.begin(); it != entries_.end();) {
-        if (it->second.body_id == body_id) {
-            delta.removed.push_back(it->first);
-            it = entries_.erase(it);
-        } else {
-            ++it;
-        }
+    for (const std::string& id : ids_of_body(body_id)) {
+        delta.removed.push_back(id);
+        erase_entry(entries_.find(std::string_view(id)));
     }
 }
 
+bool ElementMapPartition::erase(const std::string& element_id) {
+    auto it = entries_.find(std::string_view(element_id));
+    if (it == entries_.end()) return false;
+    erase_entry(it);
+    return true;
+}
+
 }  // namespace onecad::elementmap
@@ -24,15 +24,30 @@
 //     `elementMapDelta` {added, removed, relabeled} whose added/relabeled entries
 //     carry a REQUIRED `bodyId` (SCHEMA §7.2, amended 2026-07-17).
 //
+// ── Storage ──────────────────────────────────────────────────────────────────
+// The partition is cloned on every fence (`Session::fence_and_clone`), every
+// `partition_copy` and every checkpoint, and documents promote tens of thousands
+// of ids. Entries are therefore held COPY-ON-WRITE (`std::shared_ptr`): a clone
+// copies pointers, and a write clones only the entry it touches. Each entry OWNS
+// its id strings; the map keys and the per-body index are `std::string_view`s
+// into them, so a clone copies no element-id string and no anchor json at all.
+// The per-body index (with one sub-bucket per kind) keeps `entries_for_body`,
+// `find_by_topokey`, `apply_history`, `apply_placement` and `remove_body`
+// proportional to the body's entries rather than to the whole partition.
+//
 // DEFERRED to W-WP6 (documented placeholders here): descriptor/anchor SCORING and
 // the confidence-gated resolution ladder. When history alone cannot rebind a
 // referenced element, this WP emits a NeedsRepair item with reason "no-candidates"
 // (the ladder's terminal state) rather than scoring candidates — see PlanExecutor.
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include <BRepBuilderAPI_MakeShape.hxx>
@@ -100,7 +115,17 @@ public:
     const PartitionEntry* find(const std::string& element_id) const;
     bool contains(const std::string& element_id) const;
     std::size_t size() const { return entries_.size(); }
+    // Every entry, in elementId order (checkpoint serialization).
+    std::vector<const PartitionEntry*> entries() const;
+    // Entries of `body_id` in elementId order (the order a full scan yielded).
     std::vector<const PartitionEntry*> entries_for_body(const std::string& body_id) const;
+    // Entries of `body_id` of one `kind`, in elementId order.
+    std::vector<const PartitionEntry*> entries_for_body(const std::string& body_id,
+                                                        km::ElementKind kind) const;
+    // The first entry (elementId order) of `body_id` bound at `topo_key`; the
+    // kind is read from the key's prefix. nullptr when none.
+    const PartitionEntry* find_by_topokey(const std::string& body_id,
+                                          const std::string& topo_key) const;
 
     // --- minting (ID-on-demand) ---
     // Mint (or refresh) an entry for `element_id` bound to `sub_shape` within
@@ -157,6 +182,9 @@ public:
     // Drop every entry of a body that was consumed/deleted (e.g. a boolean tool);
     // appends each removed elementId to `delta.removed`.
     void remove_body(const std::string& body_id, ElementMapDelta& delta);
+    // Drop one entry (replaying a recorded step, session/OpResultCache.h). Returns
+    // whether it was present.
+    bool erase(const std::string& element_id);
 
     // --- evidence helpers (stateless; SCHEMA §7.5/§10) ---
     // The TopoKey of `element_id` **as tracked on `body_id`**; "" when the entry is
@@ -195,7 +223,27 @@ public:
     static km::ElementKind kind_from_name(const std::string& s);
 
 private:
-    std::map<std::string, PartitionEntry> entries_;  // elementId → entry (sorted)
+    // elementId (viewing the entry's own `element_id`) → shared entry, sorted.
+    using Entries = std::map<std::string_view, std::shared_ptr<PartitionEntry>>;
+    using IdIndex = std::map<std::string_view, const PartitionEntry*>;
+    static constexpr std::size_t kKindBuckets = 5;  // km::ElementKind, Body..Unknown
+
+    struct BodyBucket {
+        IdIndex all;
+        std::array<IdIndex, kKindBuckets> by_kind;
+    };
+
+    // Copy-on-write access: clones the entry first if another partition copy
+    // still shares it, re-pointing this partition's keys at the clone.
+    PartitionEntry& own(Entries::iterator it);
+    void index_insert(const PartitionEntry& e);
+    void index_erase(const PartitionEntry& e);
+    void erase_entry(Entries::iterator it);
+    // The body's elementIds, snapshotted (callers mutate the partition).
+    std::vector<std::string> ids_of_body(const std::string& body_id) const;
+
+    Entries entries_;
+    std::unordered_map<std::string, BodyBucket> by_body_;
 };
 
 }  // namespace onecad::elementmap
@@ -35,16 +35,26 @@ constexpr const char* kHeader = "\nOpen CASCADE Topology V4, (c) Open Cascade\n"
 // fd-level dup2 would swallow the concurrent solver lane's frames — see
 // OcctStaticGuard.h) is to REJECT bytes OCCT would complain about before handing
 // them over. Returns "" when the header is the one we write.
+std::string banner_error(const std::string& head) {
+    if (head != kHeader) {
+        return "brep bytes do not carry the BinTools v" + std::to_string(kBrepFormatVersion) +
+               " header (not a brep blob written by this worker)";
+    }
+    return "";
+}
+
 std::string header_error(const std::string& path) {
     std::ifstream in(path, std::ios::binary);
     if (!in) return "brep file is not readable: " + path;
     std::string head(std::char_traits<char>::length(kHeader), '\0');
     in.read(head.data(), static_cast<std::streamsize>(head.size()));
-    if (in.gcount() != static_cast<std::streamsize>(head.size()) || head != kHeader) {
-        return "brep bytes do not carry the BinTools v" + std::to_string(kBrepFormatVersion) +
-               " header (not a brep blob written by this worker)";
-    }
-    return "";
+    head.resize(static_cast<std::size_t>(in.gcount()));
+    return banner_error(head);
+}
+
+std::string failure_text(const char* what, const Standard_Failure& f) {
+    return std::string(what) +
+           (f.GetMessageString() != nullptr ? f.GetMessageString() : "OCCT failure");
 }
 
 }  // namespace
@@ -120,4 +130,35 @@ BrepReadResult read_brep_solids(const std::string& path) {
     return out;
 }
 
+std::string write_brep_shape(const TopoDS_Shape& shape, std::vector<std::uint8_t>& bytes_out) {
+    try {
+        std::ostringstream os(std::ios::out | std::ios::binary);
+        BinTools::Write(shape, os, /*withTriangles=*/Standard_True,
+                        /*withNormals=*/Standard_False, kWriteVersion);
+        const std::string blob = os.str();
+        bytes_out.assign(blob.begin(), blob.end());
+    } catch (const Standard_Failure& f) {
+        return failure_text("BrepCodec write raised: ", f);
+    } catch (const std::exception& e) {
+        return std::string("BrepCodec write raised: ") + e.what();
+    }
+    return "";
+}
+
+std::string read_brep_shape(const std::uint8_t* data, std::size_t len, TopoDS_Shape& shape_out) {
+    const std::string bytes(reinterpret_cast<const char*>(data), len);
+    const std::size_t head_len = std::char_traits<char>::length(kHeader);
+    const std::string banner = banner_error(bytes.substr(0, head_len));
+    if (!banner.empty()) return banner;
+    try {
+        std::istringstream in(bytes, std::ios::in | std::ios::binary);
+        BinTools::Read(shape_out, in);
+    } catch (const Standard_Failure& f) {
+        return failure_text("brep read raised: ", f);
+    } catch (const std::exception& e) {
+        return std::string("brep read raised: ") + e.what();
+    }
+    return shape_out.IsNull() ? "brep bytes decoded to a null shape" : "";
+}
+
 }  // namespace onecad::io
@@ -1,5 +1,6 @@
 // BrepCodec.h — the BinTools brep byte form shared by the §7.8 `InspectStep`
-// conversion lane and the §7.3 `ImportStep` `sourceCodec:"brep"` replay lane.
+// conversion lane, the §7.3 `ImportStep` `sourceCodec:"brep"` replay lane and the
+// §7.7 checkpoint artifacts.
 //
 // One header owns the FORMAT PIN so the producer and the consumer cannot drift:
 // `InspectStep` reports `kBrepFormatVersion` as the `brepFormat` a document should
@@ -49,4 +50,14 @@ struct BrepReadResult {
 // worker's frame channel (see the rationale in the .cpp).
 BrepReadResult read_brep_solids(const std::string& path);
 
+// One body shape in BinTools `kBrepFormatVersion` form, for a §7.7 checkpoint
+// artifact. Unlike `write_brep_compound` the triangulation is KEPT: a checkpoint
+// restores the head exactly as it was saved, and the shape's bbox (hence its
+// geometry signature) reads a present triangulation. Returns "" on success.
+std::string write_brep_shape(const TopoDS_Shape& shape, std::vector<std::uint8_t>& bytes_out);
+
+// Inverse of `write_brep_shape` over in-memory bytes, with the same banner check
+// as `read_brep_solids`. Returns "" on success (a non-null `shape_out`).
+std::string read_brep_shape(const std::uint8_t* data, std::size_t len, TopoDS_Shape& shape_out);
+
 }  // namespace onecad::io
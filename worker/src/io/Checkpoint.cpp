@@ -2,17 +2,19 @@
 #include "io/Checkpoint.h"
 
 #include <cstdint>
-#include <sstream>
 #include <string>
 #include <vector>
 
-#include <BinTools.hxx>
-#include <Standard_Failure.hxx>
+#include <Standard_Version.hxx>
 #include <TopoDS_Shape.hxx>
 
+#include "elementmap/ElementMapPartition.h"
+#include "elementmap/Scoring.h"
+#include "io/BrepCodec.h"
 #include "session/BodyStore.h"
 #include "session/Signatures.h"
 #include "util/Hashing.h"
+#include "util/Log.h"
 
 namespace onecad::io {
 
@@ -30,24 +32,120 @@ std::string get_str(const json& o, const char* key, const std::string& dflt = ""
     return dflt;
 }
 
-// Serialize a shape to BinTools bytes ("" codec failure ⇒ empty vector).
-std::vector<std::uint8_t> bintools_write(const TopoDS_Shape& shape) {
-    std::ostringstream oss(std::ios::binary);
-    try {
-        BinTools::Write(shape, oss);
-    } catch (const Standard_Failure&) {
-        return {};
-    }
-    const std::string s = oss.str();
-    return std::vector<std::uint8_t>(s.begin(), s.end());
-}
-
 json signatures_json(const session::BodyStore& bodies) {
     return json{{"geometry", session::geometry_signature(bodies)},
                 {"bodyLifecycle", session::body_lifecycle_signature({})},
                 {"referencedBinding", session::referenced_binding_signature({})}};
 }
 
+// The versions a persisted checkpoint is only valid under (§7.7 "an envelope whose
+// versions/fingerprint are incompatible is discarded + replayed"): the BinTools
+// codec, the OCCT build that wrote the topology, the kernel policy that built it and
+// the resolver whose evidence the partition carries.
+json compat_json() {
+    return json{{"brepFormat", kBrepFormatVersion},
+                {"occtVersion", OCC_VERSION_COMPLETE},
+                {"kernelPolicyVersion", ONECAD_KERNEL_POLICY_VERSION},
+                {"resolverVersion", elementmap::kResolverVersion}};
+}
+
+// The partition as persisted: identity + binding + anchor per entry. The shape and
+// descriptor are NOT stored — the restore rebinds each entry at its TopoKey in the
+// restored body and re-mints it, which recomputes both from the same sub-shape.
+json partition_json(const elementmap::ElementMapPartition& part) {
+    json entries = json::array();
+    for (const elementmap::PartitionEntry* e : part.entries()) {
+        entries.push_back(json{{"elementId", e->element_id},
+                               {"bodyId", e->body_id},
+                               {"kind", elementmap::ElementMapPartition::kind_name(e->kind)},
+                               {"topoKey", e->topo_key},
+                               {"anchor", e->anchor}});
+    }
+    return json{{"format", "elementmap-json"}, {"entries", std::move(entries)}};
+}
+
+// The request-tail slice a `bin` name addresses; nullptr when absent or out of range.
+const std::uint8_t* section_bytes(const Envelope& req, const std::vector<std::uint8_t>& bin,
+                                  const std::string& name, std::size_t& len) {
+    for (const protocol::BinSection& s : req.bin) {
+        if (s.name != name) continue;
+        if (s.off > bin.size() || s.len > bin.size() - s.off) return nullptr;
+        len = static_cast<std::size_t>(s.len);
+        return bin.data() + s.off;
+    }
+    return nullptr;
+}
+
+// A checkpoint rebuilt from the SaveCheckpoint result + bytes Rust persisted and
+// shipped back. Any mismatch refuses the whole checkpoint with a reason ("" on
+// success): a partial head is never installed, the caller replays instead.
+std::string decode_checkpoint(const Envelope& req, const std::vector<std::uint8_t>& bin,
+                              session::CheckpointState& st) {
+    const json& args = req.args;
+    if (!args.contains("compat") || args["compat"] != compat_json())
+        return "incompatible versions (brep/occt/kernel policy/resolver)";
+    st.history_prefix_hash = get_str(args, "historyPrefixHash");
+    if (st.history_prefix_hash.empty()) return "missing historyPrefixHash";
+    if (!args.contains("artifacts") || !args["artifacts"].is_array()) return "missing artifacts";
+
+    for (const json& a : args["artifacts"]) {
+        const std::string bid = get_str(a, "bodyId");
+        std::size_t len = 0;
+        const std::uint8_t* data = section_bytes(req, bin, get_str(a, "bin"), len);
+        if (bid.empty() || data == nullptr) return "artifact bytes missing for body " + bid;
+        if (get_str(a, "codec") != "brep-bintools" ||
+            hashing::sha256_hex(data, len) != get_str(a, "contentHash"))
+            return "artifact bytes do not match their contentHash for body " + bid;
+        TopoDS_Shape shape;
+        const std::string err = read_brep_shape(data, len, shape);
+        if (!err.empty()) return err + " (body " + bid + ")";
+        session::BodyRecord& rec = st.bodies.create(bid, get_str(a, "provenance"), shape);
+        rec.visible = a.value("visible", true);
+        if (get_str(a, "health") == session::body_health_name(session::BodyHealth::Quarantined))
+            st.bodies.quarantine(bid, get_str(a, "healthReason"));
+        if (a.contains("faceColors") && a["faceColors"].is_array())
+            rec.face_colors = a["faceColors"].get<std::vector<std::uint32_t>>();
+    }
+
+    const json& pmeta = args.value("elementMapPartition", json::object());
+    std::size_t plen = 0;
+    const std::uint8_t* pdata = section_bytes(req, bin, get_str(pmeta, "bin"), plen);
+    if (pdata == nullptr || hashing::sha256_hex(pdata, plen) != get_str(pmeta, "sha256"))
+        return "partition bytes missing or do not match their sha256";
+    const json pj = json::parse(pdata, pdata + plen, nullptr, /*allow_exceptions=*/false);
+    if (!pj.is_object() || !pj.contains("entries") || !pj["entries"].is_array())
+        return "partition bytes are not elementmap-json";
+    for (const json& e : pj["entries"]) {
+        const std::string id = get_str(e, "elementId");
+        const std::string bid = get_str(e, "bodyId");
+        const std::string key = get_str(e, "topoKey");
+        const session::BodyRecord* rec = st.bodies.get(bid);
+        if (rec == nullptr) return "partition entry " + id + " names an absent body";
+        const TopoDS_Shape sub = elementmap::ElementMapPartition::shape_for_topokey(rec->geom, key);
+        if (sub.IsNull()) return "partition entry " + id + " does not rebind at " + key;
+        const elementmap::DeltaEntry bound = st.partition.mint(
+            bid, id, elementmap::ElementMapPartition::kind_from_name(get_str(e, "kind")), sub,
+            rec->geom, e.value("anchor", json()));
+        if (bound.topo_key != key) return "partition entry " + id + " rebinds off its topoKey";
+    }
+    return "";
+}
+
+json restore_result(const session::RestoreOutcome& out, const std::string& expected_hash,
+                    const char* source) {
+    json drift_detail = json();  // null unless drift
+    if (out.drift_detected) {
+        drift_detail = json{{"signature", "geometry"},
+                            {"expected", expected_hash},
+                            {"actual", out.stored_hash}};
+    }
+    return json{{"restored", out.restored},
+                {"snapshotId", out.snapshot_id},
+                {"driftDetected", out.drift_detected},
+                {"driftDetail", drift_detail},
+                {"source", source}};
+}
+
 }  // namespace
 
 Envelope handle_save_checkpoint(session::Session& session, const Envelope& req) {
@@ -57,22 +155,28 @@ Envelope handle_save_checkpoint(session::Session& session, const Envelope& req)
     Envelope resp = Envelope::ok_response(req.id, json::object());
     json artifacts = json::array();
     for (const auto& [bid, rec] : st.bodies.all()) {
-        const std::vector<std::uint8_t> blob = bintools_write(rec.geom);
+        std::vector<std::uint8_t> blob;
+        write_brep_shape(rec.geom, blob);  // a codec failure ships an empty blob
         const std::uint64_t off = resp.out_bin.size();
         resp.out_bin.insert(resp.out_bin.end(), blob.begin(), blob.end());
         const std::string section = "ckpt:body:" + bid;
         resp.bin.push_back(protocol::BinSection{section, off, blob.size()});
-        artifacts.push_back(json{{"bodyId", bid},
-                                 {"bin", section},
-                                 {"codec", "brep-bintools"},
-                                 {"size", blob.size()},
-                                 {"contentHash", hashing::sha256_hex(blob.data(), blob.size())}});
+        json artifact{{"bodyId", bid},
+                      {"bin", section},
+                      {"codec", "brep-bintools"},
+                      {"size", blob.size()},
+                      {"contentHash", hashing::sha256_hex(blob.data(), blob.size())},
+                      {"provenance", rec.provenance},
+                      {"visible", rec.visible},
+                      {"health", session::body_health_name(rec.health)}};
+        if (!rec.health_reason.empty()) artifact["healthReason"] = rec.health_reason;
+        if (!rec.face_colors.empty()) artifact["faceColors"] = rec.face_colors;
+        artifacts.push_back(std::move(artifact));
     }
 
-    // ElementMap partition blob (V1 placeholder JSON — the in-session restore uses the
-    // RETAINED partition copy, not this serialized form; it is emitted only for
-    // Rust-side container durability). Documented divergence.
-    const std::string part_json = json{{"format", "elementmap-json"}, {"entries", json::array()}}.dump();
+    // ElementMap partition blob: every entry's identity + binding + anchor, enough for
+    // a restarted worker to rebuild the partition against the restored bodies.
+    const std::string part_json = partition_json(st.partition).dump();
     const std::vector<std::uint8_t> part_bytes(part_json.begin(), part_json.end());
     const std::uint64_t part_off = resp.out_bin.size();
     resp.out_bin.insert(resp.out_bin.end(), part_bytes.begin(), part_bytes.end());
@@ -83,6 +187,7 @@ Envelope handle_save_checkpoint(session::Session& session, const Envelope& req)
         {"stepIndex", step},
         {"historyPrefixHash", st.history_prefix_hash},
         {"signatures", signatures_json(st.bodies)},
+        {"compat", compat_json()},
         {"artifacts", std::move(artifacts)},
         {"elementMapPartition",
          json{{"bin", "ckpt:partition"},
@@ -93,7 +198,8 @@ Envelope handle_save_checkpoint(session::Session& session, const Envelope& req)
     return resp;
 }
 
-Envelope handle_restore_checkpoint(session::Session& session, const Envelope& req) {
+Envelope handle_restore_checkpoint(session::Session& session, const Envelope& req,
+                                   const std::vector<std::uint8_t>& bin) {
     const json& args = req.args;
     const std::uint64_t step = get_u64(args, "stepIndex");
     const std::string expected_hash = get_str(args, "expectedHistoryPrefixHash");
@@ -109,18 +215,35 @@ Envelope handle_restore_checkpoint(session::Session& session, const Envelope& re
                                         json{{"headEpoch", head.worker_epoch}, {"reqEpoch", worker_epoch}}});
     }
 
-    const session::RestoreOutcome out = session.restore_checkpoint(step, expected_hash);
-    json drift_detail = json();  // null unless drift
-    if (out.drift_detected) {
-        drift_detail = json{{"signature", "geometry"},
-                            {"expected", expected_hash},
-                            {"actual", out.stored_hash}};
+    const session::RestoreOutcome retained = session.restore_checkpoint(step, expected_hash);
+    if (retained.restored || retained.drift_detected || req.bin.empty()) {
+        const char* source = retained.restored ? "session" : "none";
+        return Envelope::ok_response(req.id, restore_result(retained, expected_hash, source));
+    }
+
+    // Not retained (a restarted worker): rebuild the step from the persisted bytes.
+    session::CheckpointState st;
+    const std::string refused = decode_checkpoint(req, bin, st);
+    if (!refused.empty()) {
+        WLOG_WARN("RestoreCheckpoint step=%llu: persisted checkpoint refused (%s); replay",
+                  static_cast<unsigned long long>(step), refused.c_str());
+        return Envelope::ok_response(
+            req.id, restore_result(session::RestoreOutcome{}, expected_hash, "none"));
+    }
+    // Equivalence with the replay that produced it: the rebuilt bodies must fold to
+    // the geometry signature SaveCheckpoint reported, else the bytes drifted.
+    const std::string saved_sig = get_str(args.value("signatures", json::object()), "geometry");
+    const std::string rebuilt_sig = session::geometry_signature(st.bodies);
+    if (rebuilt_sig != saved_sig) {
+        json result = restore_result(session::RestoreOutcome{}, expected_hash, "persisted");
+        result["driftDetected"] = true;
+        result["driftDetail"] =
+            json{{"signature", "geometry"}, {"expected", saved_sig}, {"actual", rebuilt_sig}};
+        return Envelope::ok_response(req.id, std::move(result));
     }
-    return Envelope::ok_response(
-        req.id, json{{"restored", out.restored},
-                     {"snapshotId", out.snapshot_id},
-                     {"driftDetected", out.drift_detected},
-                     {"driftDetail", drift_detail}});
+    const session::RestoreOutcome out =
+        session.restore_checkpoint_state(step, std::move(st), expected_hash);
+    return Envelope::ok_response(req.id, restore_result(out, expected_hash, "persisted"));
 }
 
 }  // namespace onecad::io
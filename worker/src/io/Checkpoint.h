@@ -1,18 +1,25 @@
 // Checkpoint.h — the SaveCheckpoint / RestoreCheckpoint verbs (SCHEMA §7.7).
 //
 // A checkpoint is an atomic artifact set for a step: per-body BREP blobs (BinTools) +
-// the ElementMap partition + the 3 signatures + the historyPrefixHash. SaveCheckpoint
-// serializes the current session head into the resp binary tail (inline — the artifacts
-// are small in V1; the §7.7 streamId/bulk shape is a documented divergence) AND retains
-// the head in-session (Session::save_checkpoint) so RestoreCheckpoint can roll the head
-// back WITHOUT the geometry crossing the wire again (the OCW1 request path carries no
-// binary). RestoreCheckpoint installs the retained step state as the head, fenced on
-// workerEpoch; an ABSENT checkpoint (e.g. after a worker restart) reports
-// `restored:false` so Rust replays from 0 (Invariant 7 — the cache degrades to replay,
-// never a wrong result). Rust persists the SaveCheckpoint bytes into the .onecad
-// container for durability.
+// the ElementMap partition + the 3 signatures + the historyPrefixHash + the versions it
+// is valid under (`compat`). SaveCheckpoint serializes the current session head into
+// the resp binary tail (inline — the artifacts are small in V1; the §7.7 streamId/bulk
+// shape is a documented divergence) AND retains the head in-session
+// (Session::save_checkpoint) so RestoreCheckpoint can roll the head back WITHOUT the
+// geometry crossing the wire again. RestoreCheckpoint, fenced on workerEpoch:
+//   1. installs the RETAINED step state when this worker still holds it;
+//   2. otherwise (a restarted worker) rebuilds it from the persisted bytes Rust ships
+//      back — the SaveCheckpoint result as args, its blobs in the request tail under
+//      the same section names — refusing on any version, contentHash or partition
+//      rebind mismatch, and reporting drift unless the rebuilt bodies fold to the
+//      saved geometry signature (the proof the bytes equal the replay they came from);
+//   3. otherwise reports `restored:false` so Rust replays from 0 (Invariant 7 — the
+//      cache degrades to replay, never a wrong result).
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include "protocol/Envelope.h"
 #include "session/Session.h"
 
@@ -20,6 +27,7 @@ namespace onecad::io {
 
 protocol::Envelope handle_save_checkpoint(session::Session& session, const protocol::Envelope& req);
 protocol::Envelope handle_restore_checkpoint(session::Session& session,
-                                             const protocol::Envelope& req);
+                                             const protocol::Envelope& req,
+                                             const std::vector<std::uint8_t>& bin = {});
 
 }  // namespace onecad::io
@@ -182,6 +182,9 @@ Envelope handle_export_step(session::Session& session, const Envelope& req) {
         for (const std::string& bid : which) {
             const session::BodyRecord* rec = bodies.get(bid);
             if (rec == nullptr || rec->geom.IsNull()) continue;
+            // A located body over a shared prototype (ops/Instancing.h) becomes a
+            // REFERENCE label to one prototype label, so the STEP file carries the
+            // prototype's geometry once plus one placement per instance.
             const TDF_Label label = shapes->AddShape(rec->geom, Standard_False);
             if (label.IsNull()) {
                 return Envelope::error_response(
@@ -25,6 +25,8 @@
 #include <TopoDS_Iterator.hxx>
 
 #include "session/ShapeMetrics.h"
+#include "util/Stats.h"
+#include "util/Trace.h"
 
 namespace onecad::kernel::validation {
 
@@ -267,6 +269,11 @@ PublicationDecision evaluate_publication_policy(const ShapeEvidence &evidence,
 }
 
 ShapeEvidence collect_shape_evidence(const TopoDS_Shape &shape, PublicationTier tier) {
+  static stats::Histogram &tier_a = stats::histogram("audit.tierA");
+  static stats::Histogram &tier_b = stats::histogram("audit.tierB");
+  const stats::ScopedTimer timer(tier == PublicationTier::TierB ? tier_b : tier_a);
+  const trace::Span span(tier == PublicationTier::TierB ? "audit.tierB" : "audit.tierA");
+  const stats::PhaseTimer phase(stats::Phase::Audit);
   const auto started = std::chrono::steady_clock::now();
   ShapeEvidence out;
   out.null_shape = shape.IsNull();
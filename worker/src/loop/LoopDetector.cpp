@@ -584,7 +584,99 @@ bool isPointInPolygonOrOnEdge(const sk::Vec2d& point,
     return false;
 }
 
-bool loopContainsLoop(const Loop& outer, const Loop& inner, double tolerance) {
+// Closed intervals, each tagged with an index, as an interval tree laid out
+// over them sorted by low end: each range's middle entry holds the highest
+// high end in the range. `stab(x)` visits every interval covering x in
+// O(log n + k), in no particular order.
+class IntervalIndex {
+public:
+    void add(double low, double high, size_t id) { intervals_.push_back({low, high, id}); }
+
+    void build() {
+        std::sort(intervals_.begin(), intervals_.end(),
+                  [](const Interval& a, const Interval& b) { return a.low < b.low; });
+        maxHigh_.resize(intervals_.size());
+        build(0, intervals_.size());
+    }
+
+    template <typename Visit>
+    void stab(double x, Visit&& visit) const {
+        stab(0, intervals_.size(), x, visit);
+    }
+
+private:
+    struct Interval {
+        double low;
+        double high;
+        size_t id;
+    };
+
+    double build(size_t lo, size_t hi) {
+        if (lo >= hi) {
+            return -std::numeric_limits<double>::infinity();
+        }
+        const size_t mid = lo + (hi - lo) / 2;
+        maxHigh_[mid] = std::max({intervals_[mid].high, build(lo, mid), build(mid + 1, hi)});
+        return maxHigh_[mid];
+    }
+
+    template <typename Visit>
+    void stab(size_t lo, size_t hi, double x, Visit& visit) const {
+        if (lo >= hi) {
+            return;
+        }
+        const size_t mid = lo + (hi - lo) / 2;
+        if (maxHigh_[mid] < x) {
+            return;
+        }
+        stab(lo, mid, x, visit);
+        if (intervals_[mid].low > x) {
+            return;
+        }
+        if (intervals_[mid].high >= x) {
+            visit(intervals_[mid].id);
+        }
+        stab(mid + 1, hi, x, visit);
+    }
+
+    std::vector<Interval> intervals_;
+    std::vector<double> maxHigh_;
+};
+
+// A polygon's edges by y extent; edge i runs from vertex i - 1 to vertex i.
+IntervalIndex indexEdgesByY(const std::vector<sk::Vec2d>& polygon) {
+    IntervalIndex edges;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        edges.add(std::min(polygon[i].y, polygon[j].y), std::max(polygon[i].y, polygon[j].y), i);
+    }
+    edges.build();
+    return edges;
+}
+
+// isPointInPolygon, casting the ray across only the edges spanning the
+// point's y (`edgesByY`, from indexEdgesByY): no other edge can toggle it.
+bool isPointInPolygonIndexed(const sk::Vec2d& point, const std::vector<sk::Vec2d>& polygon,
+                             const IntervalIndex& edgesByY) {
+    if (polygon.size() < 3) {
+        return false;
+    }
+    bool inside = false;
+    edgesByY.stab(point.y, [&](size_t i) {
+        const auto& pi = polygon[i];
+        const auto& pj = polygon[i == 0 ? polygon.size() - 1 : i - 1];
+        bool intersect = ((pi.y > point.y) != (pj.y > point.y)) &&
+                         (point.x < (pj.x - pi.x) * (point.y - pi.y) / (pj.y - pi.y) + pi.x);
+        if (intersect) {
+            inside = !inside;
+        }
+    });
+    return inside;
+}
+
+// Every vertex of `inner` inside `outer` or on its boundary, `outerEdgesByY`
+// being `outer`'s edges from indexEdgesByY.
+bool loopContainsLoop(const Loop& outer, const IntervalIndex& outerEdgesByY, const Loop& inner,
+                      double tolerance) {
     if (outer.polygon.size() < 3 || inner.polygon.size() < 3) {
         return false;
     }
@@ -595,13 +687,48 @@ bool loopContainsLoop(const Loop& outer, const Loop& inner, double tolerance) {
         return false;
     }
     for (const auto& p : inner.polygon) {
-        if (!isPointInPolygonOrOnEdge(p, outer.polygon, tolerance)) {
+        if (!isPointInPolygonIndexed(p, outer.polygon, outerEdgesByY) &&
+            !isPointInPolygonOrOnEdge(p, outer.polygon, tolerance)) {
             return false;
         }
     }
     return true;
 }
 
+// polygonsIntersect(outer, inner), testing only the outer edges whose box
+// meets the inner polygon's: an edge clear of that box crosses none of its
+// edges, so a small cut-out pays for the few outline edges beside it.
+bool boundaryCrossesLoop(const std::vector<sk::Vec2d>& outer,
+                         const std::vector<sk::Vec2d>& inner) {
+    if (outer.empty() || inner.empty()) {
+        return false;
+    }
+    sk::Vec2d innerMin = inner.front();
+    sk::Vec2d innerMax = inner.front();
+    for (const auto& p : inner) {
+        innerMin.x = std::min(innerMin.x, p.x);
+        innerMin.y = std::min(innerMin.y, p.y);
+        innerMax.x = std::max(innerMax.x, p.x);
+        innerMax.y = std::max(innerMax.y, p.y);
+    }
+    const size_t n1 = outer.size();
+    const size_t n2 = inner.size();
+    for (size_t i = 0; i < n1; ++i) {
+        const sk::Vec2d& a = outer[i];
+        const sk::Vec2d& b = outer[(i + 1) % n1];
+        if (std::max(a.x, b.x) < innerMin.x || std::min(a.x, b.x) > innerMax.x ||
+            std::max(a.y, b.y) < innerMin.y || std::min(a.y, b.y) > innerMax.y) {
+            continue;
+        }
+        for (size_t j = 0; j < n2; ++j) {
+            if (segmentsIntersect(a, b, inner[j], inner[(j + 1) % n2])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void reverseLoop(Loop& loop) {
     std::reverse(loop.wire.edges.begin(), loop.wire.edges.end());
     std::reverse(loop.wire.forward.begin(), loop.wire.forward.end());
@@ -1892,33 +2019,62 @@ std::vector<Face> LoopDetector::buildFaceHierarchy(std::vector<Loop> loops) cons
         return loops[a].area() > loops[b].area();
     });
 
+    std::vector<size_t> rank(loops.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        rank[order[i]] = i;
+    }
+
     std::vector<int> parent(loops.size(), -1);
     std::vector<int> depth(loops.size(), 0);
 
+    // A loop's parent is the smallest-area loop that contains it, and any
+    // container's box holds the loop's box, so only the loops whose x extent
+    // covers the loop's left edge are candidates. They are tried smallest
+    // first (ties in area-sort order, as a full scan would keep them), and the
+    // first that passes the exact tests is the parent. A candidate's edges are
+    // indexed by y the first time it is tried.
+    const double tolerance = config_.coincidenceTolerance;
+    IntervalIndex byExtent;
+    for (size_t i = 0; i < loops.size(); ++i) {
+        if (loops[i].polygon.size() >= 3) {
+            byExtent.add(loops[i].boundsMin.x - tolerance, loops[i].boundsMax.x + tolerance, i);
+        }
+    }
+    byExtent.build();
+    std::vector<std::optional<IntervalIndex>> edgesByY(loops.size());
+    std::vector<size_t> candidates;
     for (size_t i = 0; i < loops.size(); ++i) {
         size_t loopIdx = order[i];
-        double bestArea = std::numeric_limits<double>::infinity();
-        int bestParent = -1;
-
-        for (size_t j = 0; j < loops.size(); ++j) {
-            size_t candidateIdx = order[j];
-            if (candidateIdx == loopIdx) {
-                continue;
+        const Loop& loop = loops[loopIdx];
+        candidates.clear();
+        if (loop.polygon.size() >= 3) {
+            byExtent.stab(loop.boundsMin.x, [&](size_t candidateIdx) {
+                if (candidateIdx != loopIdx && loops[candidateIdx].area() > loop.area()) {
+                    candidates.push_back(candidateIdx);
+                }
+            });
+        }
+        std::sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) {
+            if (loops[a].area() != loops[b].area()) {
+                return loops[a].area() < loops[b].area();
             }
-            if (loops[candidateIdx].area() <= loops[loopIdx].area()) {
-                continue;
+            return rank[a] < rank[b];
+        });
+
+        int bestParent = -1;
+        for (size_t candidateIdx : candidates) {
+            const Loop& candidate = loops[candidateIdx];
+            if (!edgesByY[candidateIdx]) {
+                edgesByY[candidateIdx] = indexEdgesByY(candidate.polygon);
             }
-            if (!loopContainsLoop(loops[candidateIdx], loops[loopIdx], config_.coincidenceTolerance)) {
+            if (!loopContainsLoop(candidate, *edgesByY[candidateIdx], loop, tolerance)) {
                 continue;
             }
-            if (polygonsIntersect(loops[candidateIdx].polygon, loops[loopIdx].polygon)) {
+            if (boundaryCrossesLoop(candidate.polygon, loop.polygon)) {
                 continue;
             }
-            double area = loops[candidateIdx].area();
-            if (area < bestArea) {
-                bestArea = area;
-                bestParent = static_cast<int>(candidateIdx);
-            }
+            bestParent = static_cast<int>(candidateIdx);
+            break;
         }
 
         parent[loopIdx] = bestParent;
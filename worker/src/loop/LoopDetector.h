@@ -365,7 +365,8 @@ private:
     /**
      * @brief Build face hierarchy from loops
      *
-     * Uses point-in-polygon to determine nesting.
+     * Uses point-in-polygon to determine nesting, run only against the loops
+     * whose bounding box can hold the nested one (an x-extent interval tree).
      * Note: loops are copied and may be reordered for hierarchy building.
      */
     std::vector<Face> buildFaceHierarchy(std::vector<Loop> loops) const;
@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <map>
+#include <optional>
 #include <utility>
 
 namespace onecad::core::loop {
@@ -99,6 +101,204 @@ std::pair<std::uint32_t, std::uint32_t> edge_key(std::uint32_t a, std::uint32_t
     return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
 }
 
+sk::Vec2d loop_vertex(const MergedLoop& out, std::size_t li) {
+    return out.verts[out.loop[li % out.loop.size()]];
+}
+
+// Whether the bridge from loop position `li` to hole vertex `q` stays inside
+// the material: it crosses no edge, touches no vertex, and its midpoint is
+// inside the merged loop and outside every not-yet-merged hole (`pending`
+// from `first_pending`, the hole being bridged included).
+bool bridge_is_valid(const MergedLoop& out, std::size_t li, const sk::Vec2d& q,
+                     const std::vector<std::vector<sk::Vec2d>>& pending,
+                     std::size_t first_pending) {
+    const sk::Vec2d p = loop_vertex(out, li);
+    const double d2 = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+    if (d2 < kCoincEps) return false;  // degenerate bridge
+
+    for (std::size_t e = 0; e < out.loop.size(); ++e) {
+        if (segments_cross(p, q, loop_vertex(out, e), loop_vertex(out, e + 1))) return false;
+    }
+    for (std::size_t k = first_pending; k < pending.size(); ++k) {
+        const std::vector<sk::Vec2d>& other = pending[k];
+        for (std::size_t e = 0; e < other.size(); ++e) {
+            if (segments_cross(p, q, other[e], other[(e + 1) % other.size()])) return false;
+        }
+    }
+    // No third vertex may sit ON the bridge (a touch breaks clipping).
+    for (std::size_t e = 0; e < out.loop.size(); ++e) {
+        if (point_on_segment_interior(loop_vertex(out, e), p, q)) return false;
+    }
+    for (std::size_t k = first_pending; k < pending.size(); ++k) {
+        for (const auto& v : pending[k]) {
+            if (point_on_segment_interior(v, p, q)) return false;
+        }
+    }
+
+    const sk::Vec2d mid{0.5 * (p.x + q.x), 0.5 * (p.y + q.y)};
+    if (!point_in_index_loop(mid, out.verts, out.loop)) return false;
+    for (std::size_t k = first_pending; k < pending.size(); ++k) {
+        if (point_in_poly(mid, pending[k])) return false;
+    }
+    return true;
+}
+
+struct Bridge {
+    std::size_t li = 0;  // loop position
+    std::size_t hj = 0;  // hole vertex
+};
+
+// Whether loop position `li` opens toward `q`: `q` lies in the interior sector
+// between its incoming and outgoing edges.
+bool locally_inside(const MergedLoop& out, std::size_t li, const sk::Vec2d& q) {
+    const std::size_t n = out.loop.size();
+    const sk::Vec2d prev = loop_vertex(out, li + n - 1);
+    const sk::Vec2d at = loop_vertex(out, li);
+    const sk::Vec2d next = loop_vertex(out, li + 1);
+    if (cross2(prev, at, next) > 0.0) {
+        return cross2(at, q, next) <= 0.0 && cross2(at, prev, q) <= 0.0;
+    }
+    return cross2(at, q, prev) > 0.0 || cross2(at, next, q) > 0.0;
+}
+
+// Whether the sector at loop position `b` lies within the sector at `a` (two
+// positions on one vertex: a merged bridge end).
+bool sector_contains_sector(const MergedLoop& out, std::size_t a, std::size_t b) {
+    const std::size_t n = out.loop.size();
+    return cross2(loop_vertex(out, a + n - 1), loop_vertex(out, a), loop_vertex(out, b + n - 1)) >
+               0.0 &&
+           cross2(loop_vertex(out, b + 1), loop_vertex(out, a), loop_vertex(out, a + 1)) > 0.0;
+}
+
+// The loop vertex the hole's leftmost vertex `h` sees along the ray toward
+// -x (Eberly, "Triangulation by Ear Clipping", as earcut does it): the nearest
+// loop edge the ray hits, connected at its left end, unless loop vertices lie
+// in the triangle that end spans with the hit and `h` — then the one at the
+// smallest angle to the ray. O(loop) per hole, against the exhaustive pair
+// search's O(loop * hole * edges).
+std::optional<std::size_t> ray_bridge(const MergedLoop& out, const sk::Vec2d& h) {
+    const std::size_t n = out.loop.size();
+    double qx = -std::numeric_limits<double>::infinity();
+    std::optional<std::size_t> m;
+    for (std::size_t i = 0; i < n; ++i) {
+        const sk::Vec2d p = loop_vertex(out, i);
+        const sk::Vec2d next = loop_vertex(out, i + 1);
+        if (h.y <= p.y && h.y >= next.y && next.y != p.y) {
+            const double x = p.x + (h.y - p.y) * (next.x - p.x) / (next.y - p.y);
+            if (x <= h.x && x > qx) {
+                qx = x;
+                m = p.x < next.x ? i : (i + 1) % n;
+                if (x == h.x) return m;  // the ray starts on the edge
+            }
+        }
+    }
+    if (!m) return std::nullopt;
+
+    const sk::Vec2d mv = loop_vertex(out, *m);
+    const sk::Vec2d hit{qx, h.y};
+    double tan_min = std::numeric_limits<double>::infinity();
+    std::size_t best = *m;
+    for (std::size_t step = 0; step < n; ++step) {
+        const std::size_t i = (*m + step) % n;
+        const sk::Vec2d p = loop_vertex(out, i);
+        if (h.x >= p.x && p.x >= mv.x && h.x != p.x &&
+            point_in_triangle(p.x, p.y, h.y < mv.y ? h : hit, mv, h.y < mv.y ? hit : h)) {
+            const double tan = std::abs(h.y - p.y) / (h.x - p.x);
+            const sk::Vec2d bv = loop_vertex(out, best);
+            if (locally_inside(out, i, h) &&
+                (tan < tan_min ||
+                 (tan == tan_min &&
+                  (p.x > bv.x || (p.x == bv.x && sector_contains_sector(out, best, i)))))) {
+                best = i;
+                tan_min = tan;
+            }
+        }
+    }
+    return best;
+}
+
+// The shortest valid bridge over every (loop vertex, hole vertex) pair: the
+// fallback for a hole whose ray bridge is not valid (touching or overlapping
+// input the ray construction does not guard against).
+std::optional<Bridge> shortest_bridge(const MergedLoop& out,
+                                      const std::vector<std::vector<sk::Vec2d>>& pending,
+                                      std::size_t hi) {
+    const std::vector<sk::Vec2d>& hole = pending[hi];
+    std::optional<Bridge> best;
+    double best_d2 = 0.0;
+    for (std::size_t li = 0; li < out.loop.size(); ++li) {
+        const sk::Vec2d p = loop_vertex(out, li);
+        for (std::size_t hj = 0; hj < hole.size(); ++hj) {
+            const sk::Vec2d& q = hole[hj];
+            const double d2 = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+            if (best && d2 >= best_d2) continue;
+            if (!bridge_is_valid(out, li, q, pending, hi)) continue;
+            best = Bridge{li, hj};
+            best_d2 = d2;
+        }
+    }
+    return best;
+}
+
+// Loop positions bucketed on a uniform grid over their bounding box, about
+// one per cell, so an ear's containment test reads only the positions near
+// its triangle instead of the whole remaining loop.
+class PositionGrid {
+public:
+    PositionGrid(const std::vector<sk::Vec2d>& verts, const std::vector<std::uint32_t>& loop) {
+        min_ = verts[loop.front()];
+        sk::Vec2d max = min_;
+        for (std::uint32_t i : loop) {
+            min_.x = std::min(min_.x, verts[i].x);
+            min_.y = std::min(min_.y, verts[i].y);
+            max.x = std::max(max.x, verts[i].x);
+            max.y = std::max(max.y, verts[i].y);
+        }
+        const double side = std::ceil(std::sqrt(static_cast<double>(loop.size())));
+        const double extent = std::max(max.x - min_.x, max.y - min_.y);
+        cell_ = extent > 0.0 && std::isfinite(extent) ? extent / side : 1.0;
+        columns_ = static_cast<std::size_t>(side) + 1;
+        cells_.resize(columns_ * columns_);
+        for (std::size_t k = 0; k < loop.size(); ++k) {
+            const sk::Vec2d& v = verts[loop[k]];
+            cells_[row(v.y) * columns_ + column(v.x)].push_back(k);
+        }
+    }
+
+    // True once `visit` does for a position in a cell the box [lo, hi] touches
+    // (every position inside the box is visited, some beyond it too).
+    template <typename Visit>
+    bool any_in_box(const sk::Vec2d& lo, const sk::Vec2d& hi, Visit&& visit) const {
+        const std::size_t c0 = column(lo.x);
+        const std::size_t c1 = column(hi.x);
+        const std::size_t r1 = row(hi.y);
+        for (std::size_t r = row(lo.y); r <= r1; ++r) {
+            for (std::size_t c = c0; c <= c1; ++c) {
+                for (std::size_t k : cells_[r * columns_ + c]) {
+                    if (visit(k)) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    std::size_t column(double x) const { return bucket(x - min_.x); }
+    std::size_t row(double y) const { return bucket(y - min_.y); }
+    // Clamped, so a non-finite coordinate lands in an edge cell.
+    std::size_t bucket(double offset) const {
+        const double b = std::floor(offset / cell_);
+        if (!(b > 0.0)) return 0;
+        return b < static_cast<double>(columns_ - 1) ? static_cast<std::size_t>(b)
+                                                      : columns_ - 1;
+    }
+
+    sk::Vec2d min_;
+    double cell_ = 1.0;
+    std::size_t columns_ = 1;
+    std::vector<std::vector<std::size_t>> cells_;
+};
+
 }  // namespace
 
 double polygon_signed_area(const std::vector<sk::Vec2d>& poly) {
@@ -127,78 +327,50 @@ MergedLoop merge_holes(const std::vector<sk::Vec2d>& outer_in,
     }
 
     // Normalize holes to CW (opposite the outer loop) and drop degenerates.
-    std::vector<std::vector<sk::Vec2d>> pending;
-    pending.reserve(holes_in.size());
+    // Bridged leftmost-first, each from its leftmost vertex: every hole still
+    // pending then lies at or right of the bridge being cast.
+    struct PendingHole {
+        std::vector<sk::Vec2d> verts;
+        std::size_t leftmost = 0;
+    };
+    std::vector<PendingHole> sorted;
+    sorted.reserve(holes_in.size());
     for (const auto& h_in : holes_in) {
         std::vector<sk::Vec2d> h = h_in;
         drop_closing_point(h);
         if (h.size() < 3) continue;
         if (polygon_signed_area(h) > 0.0) std::reverse(h.begin(), h.end());
-        pending.push_back(std::move(h));
+        std::size_t leftmost = 0;
+        for (std::size_t i = 1; i < h.size(); ++i) {
+            if (h[i].x < h[leftmost].x || (h[i].x == h[leftmost].x && h[i].y < h[leftmost].y)) {
+                leftmost = i;
+            }
+        }
+        sorted.push_back({std::move(h), leftmost});
     }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const PendingHole& a, const PendingHole& b) {
+        const sk::Vec2d& pa = a.verts[a.leftmost];
+        const sk::Vec2d& pb = b.verts[b.leftmost];
+        return pa.x < pb.x || (pa.x == pb.x && pa.y < pb.y);
+    });
+    std::vector<std::vector<sk::Vec2d>> pending;
+    pending.reserve(sorted.size());
+    for (PendingHole& h : sorted) pending.push_back(std::move(h.verts));
 
     for (std::size_t hi = 0; hi < pending.size(); ++hi) {
         const std::vector<sk::Vec2d>& hole = pending[hi];
-
-        // Shortest bridge (loop position li → hole vertex hj) that stays inside
-        // the material: crosses no edge, touches no vertex, and whose midpoint is
-        // inside the merged loop and outside every not-yet-merged hole.
-        std::size_t best_li = 0;
-        std::size_t best_hj = 0;
-        double best_d2 = 0.0;
-        bool found = false;
-
-        for (std::size_t li = 0; li < out.loop.size(); ++li) {
-            const sk::Vec2d& p = out.verts[out.loop[li]];
-            for (std::size_t hj = 0; hj < hole.size(); ++hj) {
-                const sk::Vec2d& q = hole[hj];
-                const double d2 = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
-                if (found && d2 >= best_d2) continue;
-                if (d2 < kCoincEps) continue;  // degenerate bridge
-
-                bool valid = true;
-                for (std::size_t e = 0; e < out.loop.size() && valid; ++e) {
-                    const sk::Vec2d& a = out.verts[out.loop[e]];
-                    const sk::Vec2d& b = out.verts[out.loop[(e + 1) % out.loop.size()]];
-                    if (segments_cross(p, q, a, b)) valid = false;
-                }
-                for (std::size_t k = hi; k < pending.size() && valid; ++k) {
-                    const std::vector<sk::Vec2d>& other = pending[k];
-                    for (std::size_t e = 0; e < other.size() && valid; ++e) {
-                        if (segments_cross(p, q, other[e], other[(e + 1) % other.size()])) {
-                            valid = false;
-                        }
-                    }
-                }
-                // No third vertex may sit ON the bridge (a touch breaks clipping).
-                for (std::size_t e = 0; e < out.loop.size() && valid; ++e) {
-                    if (point_on_segment_interior(out.verts[out.loop[e]], p, q)) valid = false;
-                }
-                for (std::size_t k = hi; k < pending.size() && valid; ++k) {
-                    for (const auto& v : pending[k]) {
-                        if (point_on_segment_interior(v, p, q)) {
-                            valid = false;
-                            break;
-                        }
-                    }
-                }
-                if (!valid) continue;
-
-                const sk::Vec2d mid{0.5 * (p.x + q.x), 0.5 * (p.y + q.y)};
-                if (!point_in_index_loop(mid, out.verts, out.loop)) continue;
-                bool in_hole = false;
-                for (std::size_t k = hi; k < pending.size() && !in_hole; ++k) {
-                    if (point_in_poly(mid, pending[k])) in_hole = true;
-                }
-                if (in_hole) continue;
-
-                best_li = li;
-                best_hj = hj;
-                best_d2 = d2;
-                found = true;
-            }
+        const std::size_t leftmost = sorted[hi].leftmost;
+
+        std::optional<Bridge> bridge;
+        const std::optional<std::size_t> li = ray_bridge(out, hole[leftmost]);
+        if (li && bridge_is_valid(out, *li, hole[leftmost], pending, hi)) {
+            bridge = Bridge{*li, leftmost};
+        } else {
+            bridge = shortest_bridge(out, pending, hi);
         }
-        if (!found) continue;  // hole stays filled; reported via holes_merged
+        if (!bridge) continue;  // hole stays filled; reported via holes_merged
+        const std::size_t best_li = bridge->li;
+        const std::size_t best_hj = bridge->hj;
 
         // Append the hole's vertices, then splice after `best_li`:
         //   … L[li], H[hj], H[hj+1], …, H[hj-1], H[hj], L[li], …
@@ -225,40 +397,60 @@ std::vector<std::uint32_t> ear_clip_indices(const std::vector<sk::Vec2d>& verts,
     std::vector<std::uint32_t> tris;
     if (v.size() < 3) return tris;
 
-    std::size_t guard = 0;
-    const std::size_t guard_max = v.size() * v.size() + 8;
-    while (v.size() > 2 && guard++ < guard_max) {
-        bool clipped = false;
-        const std::size_t m = v.size();
-        for (std::size_t i = 0; i < m; ++i) {
-            const std::uint32_t ia = v[(i + m - 1) % m];
-            const std::uint32_t ib = v[i];
-            const std::uint32_t ic = v[(i + 1) % m];
-            if (ia == ib || ib == ic || ia == ic) continue;  // bridge-collapsed ear
+    // The loop as a ring of positions, so clipping an ear unlinks it in O(1)
+    // and the search goes on from the ear's neighbour instead of restarting.
+    const std::size_t n = v.size();
+    std::vector<std::size_t> prev(n);
+    std::vector<std::size_t> next(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        prev[i] = (i + n - 1) % n;
+        next[i] = (i + 1) % n;
+    }
+    std::vector<bool> clipped(n, false);
+    const PositionGrid grid(verts, v);
+    tris.reserve(3 * (n - 2));
+
+    std::size_t remaining = n;
+    std::size_t i = 0;
+    std::size_t misses = 0;  // positions tried since the last clip
+    while (remaining > 2 && misses < remaining) {
+        const std::uint32_t ia = v[prev[i]];
+        const std::uint32_t ib = v[i];
+        const std::uint32_t ic = v[next[i]];
+        bool ear = ia != ib && ib != ic && ia != ic;  // else a bridge-collapsed ear
+        if (ear) {
             const sk::Vec2d& a = verts[ia];
             const sk::Vec2d& b = verts[ib];
             const sk::Vec2d& c = verts[ic];
             const double cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
-            if (cross <= 0.0) continue;  // reflex or degenerate (CCW convex ear needs >0)
-            bool contains = false;
-            for (std::size_t k = 0; k < m; ++k) {
-                const std::uint32_t iv = v[k];
-                if (iv == ia || iv == ib || iv == ic) continue;
-                if (point_in_triangle(verts[iv].x, verts[iv].y, a, b, c)) {
-                    contains = true;
-                    break;
-                }
+            // Reflex or degenerate: a CCW convex ear needs cross > 0.
+            ear = cross > 0.0;
+            if (ear) {
+                const sk::Vec2d lo{std::min({a.x, b.x, c.x}), std::min({a.y, b.y, c.y})};
+                const sk::Vec2d hi{std::max({a.x, b.x, c.x}), std::max({a.y, b.y, c.y})};
+                ear = !grid.any_in_box(lo, hi, [&](std::size_t k) {
+                    const std::uint32_t iv = v[k];
+                    if (clipped[k] || iv == ia || iv == ib || iv == ic) return false;
+                    return point_in_triangle(verts[iv].x, verts[iv].y, a, b, c);
+                });
             }
-            if (contains) continue;
-            tris.push_back(ia);
-            tris.push_back(ib);
-            tris.push_back(ic);
-            v.erase(v.begin() + static_cast<long>(i));
-            clipped = true;
-            break;
         }
-        if (!clipped) break;  // no ear found (degenerate) — stop
+        if (!ear) {
+            ++misses;
+            i = next[i];
+            continue;
+        }
+        tris.push_back(ia);
+        tris.push_back(ib);
+        tris.push_back(ic);
+        clipped[i] = true;
+        next[prev[i]] = next[i];
+        prev[next[i]] = prev[i];
+        i = next[i];
+        --remaining;
+        misses = 0;
     }
+    // No ear anywhere on the remaining loop (degenerate): stop, partial.
     return tris;
 }
 
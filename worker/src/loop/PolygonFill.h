@@ -35,7 +35,8 @@ namespace sk = onecad::core::sketch;
 
 /// A region's outer loop and its holes merged into ONE weakly-simple CCW loop.
 struct MergedLoop {
-    /// Outer-loop vertices, followed by the vertices of each MERGED hole.
+    /// Outer-loop vertices, followed by the vertices of each MERGED hole, in
+    /// the order the holes were bridged.
     std::vector<sk::Vec2d> verts;
     /// CCW traversal as indices into `verts`. Bridge indices appear twice.
     std::vector<std::uint32_t> loop;
@@ -44,9 +45,11 @@ struct MergedLoop {
     std::size_t holes_merged = 0;
 };
 
-/// Merge `holes` into `outer`, shortest valid bridge first. `outer` is
-/// normalized to CCW and each hole to CW; a closing point coincident with the
-/// first is dropped. A hole with no valid bridge is SKIPPED rather than
+/// Merge `holes` into `outer`, leftmost hole first. Each hole bridges from its
+/// leftmost vertex to the loop vertex seen along a ray cast left from it, and
+/// only when that bridge fails validation to the shortest valid one. `outer`
+/// is normalized to CCW and each hole to CW; a closing point coincident with
+/// the first is dropped. A hole with no valid bridge is SKIPPED rather than
 /// corrupting the whole region's triangulation.
 MergedLoop merge_holes(const std::vector<sk::Vec2d>& outer,
                        const std::vector<std::vector<sk::Vec2d>>& holes);
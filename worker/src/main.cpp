@@ -4,57 +4,94 @@
 //   * assert little-endian host (compile-time + runtime)
 //   * route OCCT diagnostics to stderr (proves TKernel linkage; guards stdout)
 //   * emit the UNSOLICITED hello frame (SCHEMA §6) as the first output frame
-//   * register the lifecycle + solver-lane verbs
+//   * register the lifecycle + solver-lane verbs, routed per document: one worker
+//     hosts several sessions, addressed by `args.sessionId` (SessionRegistry.h)
 //   * run the reader/kernel/solver dispatch loop over stdin/stdout, OR
 //   * with --selftest, exercise hello + a solver op in-process and exit 0.
+//   * with --op-cache-dir DIR [--op-cache-max-mb N] [--op-cache-verify], reuse
+//     ExecutePlan step results stored on disk by earlier runs
+//     (session/OpResultCache.h).
+//   * with --zygote SOCKET, initialize and warm the kernel once, then fork a
+//     ready worker per spawn request on that socket (protocol/Zygote.h).
+//   * with ONECAD_WORKER_TRACE=FILE, record spans from startup and write them as
+//     Chrome trace JSON at exit (util/Trace.h; `%p` in FILE becomes the pid).
 //
 // stdout carries protocol frames ONLY. All diagnostics go to stderr via WLOG_*.
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <memory>
 #include <string>
 #include <unistd.h>
+#include <vector>
 
+#include <BRepAlgoAPI_Fuse.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
 #include <Message.hxx>
 #include <Message_Messenger.hxx>
 #include <Message_PrinterOStream.hxx>
+#include <STEPControl_Controller.hxx>
 #include <Standard_Version.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
 
+#include "io/BrepCodec.h"
 #include "io/Checkpoint.h"
 #include "io/ExportGeometry.h"
 #include "io/ExportStep.h"
 #include "io/InspectStep.h"
 #include "io/MeshExport.h"
+#include "ops/GeneratorCache.h"
+#include "ops/ProfileCache.h"
 #include "protocol/Dispatcher.h"
 #include "protocol/Envelope.h"
 #include "protocol/Limits.h"
 #include "protocol/SolverLane.h"
+#include "protocol/Zygote.h"
 #include "session/ClassifyElement.h"
 #include "session/ElementIdentity.h"
 #include "session/FaceProjection.h"
 #include "session/MassProperties.h"
+#include "session/OpResultCache.h"
 #include "session/BodyTopology.h"
 #include "session/PrepareOffsetFace.h"
 #include "session/PrepareEdgeOp.h"
 #include "session/PlanExecutor.h"
 #include "session/PreviewOp.h"
 #include "session/Session.h"
+#include "session/SessionRegistry.h"
 #include "tess/MeshHandle.h"
 #include "tess/Tessellate.h"
 #include "util/Hashing.h"
 #include "util/LittleEndian.h"
 #include "util/Log.h"
+#include "util/Stats.h"
+#include "util/Trace.h"
 
 namespace {
 
 using onecad::protocol::Dispatcher;
 using onecad::protocol::Envelope;
 using onecad::protocol::HandlerContext;
+using onecad::protocol::Priority;
+using onecad::protocol::Scope;
 using onecad::protocol::SolverLane;
 using onecad::session::Session;
+using onecad::session::SessionRegistry;
+using onecad::session::SessionSlot;
+using onecad::session::session_handle;
 using onecad::session::WorkerHead;
 
+using Bin = std::vector<std::uint8_t>;
+// A kernel-lane handler bound to the session its request addresses.
+using SessionHandler =
+    std::function<Envelope(Session&, const Envelope&, const Bin&, HandlerContext&)>;
+
 constexpr int kProtocolVersion = 1;
 constexpr const char* kWorkerVersion = "0.1.0";
 constexpr int kQuantizationVersion = 1;
@@ -114,11 +151,16 @@ nlohmann::json make_hello_result() {
                                 "op.circularPattern", "op.mirrorBody", "op.transformBody",
                                 "op.offsetFace", "op.importStep", "op.placeComponent",
                                 "op.detachComponent", "solver.planegcs", "tessellate.mesh1",
-                                "io.step", "io.step.import", "io.geometry.export",
-                                "query.classifyElement", "query.bodyTopology"})},
+                                "tessellate.instances", "io.step", "io.step.import",
+                                "io.geometry.export", "checkpoint.persistedRestore",
+                                "query.classifyElement", "query.bodyTopology",
+                                "session.multiDocument", "worker.zygote", "worker.stats",
+                                "worker.trace", "worker.priority", "solver.budget",
+                                "solver.upsertBatch"})},
         {"limits",
          {{"chunkSize", onecad::protocol::kChunkSize},
-          {"initialBulkCredit", onecad::protocol::kInitialBulkCredit}}},
+          {"initialBulkCredit", onecad::protocol::kInitialBulkCredit},
+          {"maxSessions", SessionRegistry::kMaxSessions}}},
     };
 }
 
@@ -136,6 +178,7 @@ Envelope handle_open_session(Session& session, const Envelope& req) {
     const std::uint64_t document_revision = args.value("documentRevision", std::uint64_t{0});
     const std::uint64_t worker_epoch = args.value("workerEpoch", std::uint64_t{0});
     const std::string mode = args.value("mode", std::string{"determinism"});
+    if (args.value("trace", false)) onecad::trace::enable();  // process-wide, until exit
     session.open(document_id, document_revision, worker_epoch, mode);
     nlohmann::json result = {
         {"sessionOpen", true},
@@ -174,6 +217,7 @@ Envelope handle_tessellate(Session& session, const Envelope& req) {
     const nlohmann::json& args = req.args;
     const std::string lod = args.value("lod", std::string("coarse"));
     const bool include_edges = args.value("includeEdges", true);
+    const bool instances = args.value("instances", false);
     const onecad::session::BodyStore bodies = session.bodies_copy();
     const onecad::elementmap::ElementMapPartition part = session.partition_copy();
     const std::uint64_t snapshot_id = session.current_snapshot_id();
@@ -187,14 +231,48 @@ Envelope handle_tessellate(Session& session, const Envelope& req) {
         which = bodies.ids();  // "all" (or missing) → every body
     }
 
+    // `instances: true` — a body that is another emitted body's shared prototype
+    // under a different location (ops/Instancing.h) ships as that body's mesh + a
+    // transform instead of a second blob. Only when neither carries minted ids or
+    // authored face colours: those are per-body, and a MESH1 blob bakes them in.
+    const auto per_body_labels = [&](const onecad::session::BodyRecord& rec) {
+        if (!rec.face_colors.empty()) return true;
+        for (const onecad::elementmap::PartitionEntry* e : part.entries_for_body(rec.id)) {
+            if (!e->topo_key.empty()) return true;
+        }
+        return false;
+    };
+    std::vector<const onecad::session::BodyRecord*> emitted;
+
     nlohmann::json meshes = nlohmann::json::array();
     Envelope resp = Envelope::ok_response(req.id, nlohmann::json::object());
     for (const std::string& bid : which) {
         const onecad::session::BodyRecord* rec = bodies.get(bid);
         if (!rec) continue;
+        const bool shareable = instances && !per_body_labels(*rec);
+        if (shareable) {
+            gp_Trsf trsf;
+            const auto proto = std::find_if(
+                emitted.begin(), emitted.end(), [&](const onecad::session::BodyRecord* p) {
+                    return onecad::tess::instance_of(rec->geom, p->geom, trsf);
+                });
+            if (proto != emitted.end()) {
+                nlohmann::json rows = nlohmann::json::array();
+                for (int r = 1; r <= 3; ++r) {
+                    for (int c = 1; c <= 4; ++c) rows.push_back(trsf.Value(r, c));
+                }
+                meshes.push_back(nlohmann::json{{"bodyId", bid},
+                                                {"format", "MESH1"},
+                                                {"lod", lod},
+                                                {"instanceOf", (*proto)->id},
+                                                {"transform", std::move(rows)},
+                                                {"snapshotId", snapshot_id}});
+                continue;
+            }
+        }
         onecad::tess::BodyMesh bm =
             onecad::tess::tessellate_body(rec->geom, bid, lod, include_edges, &part,
-                                          &rec->face_colors);
+                                          &rec->face_colors, shareable);
         if (!bm.ok) continue;
         const std::uint64_t off = resp.out_bin.size();
         resp.out_bin.insert(resp.out_bin.end(), bm.blob.begin(), bm.blob.end());
@@ -205,6 +283,7 @@ Envelope handle_tessellate(Session& session, const Envelope& req) {
         meshes.push_back(onecad::tess::mesh_handle_json(
             bid, section, lod, bm.blob.size(), bm.triangle_count,
             onecad::hashing::sha256_hex(bm.blob.data(), bm.blob.size()), snapshot_id));
+        if (shareable) emitted.push_back(rec);
     }
     resp.result = nlohmann::json{{"meshes", std::move(meshes)}};
     return resp;
@@ -236,132 +315,250 @@ Envelope handle_debug_busy(const Envelope& req, const std::vector<std::uint8_t>&
     return Envelope::ok_response(req.id, std::move(result));
 }
 
-void register_verbs(Dispatcher& dispatcher, SolverLane& solver_lane, Session& session) {
+// GetWorkerStats (SCHEMA §7.1): the Dispatcher's per-verb/per-lane counters, the
+// process-wide subsystem timings (util/Stats.h), the cache counters and peak RSS.
+// Reads atomics and short-held cache mutexes only — never a session — so it is
+// routed to the solver lane and answers while a long kernel job runs.
+Envelope handle_get_worker_stats(const Dispatcher& dispatcher, const SessionRegistry& registry,
+                                 const Envelope& req) {
+    nlohmann::json result = dispatcher.stats_json();
+    result["process"] = {{"peakRssBytes", onecad::stats::peak_rss_bytes()},
+                         {"sessions", registry.size()}};
+    result["subsystems"] = onecad::stats::snapshot();
+    const onecad::session::OpResultCache& op_cache = onecad::session::op_result_cache();
+    const onecad::ops::ProfileFaceCache& profiles = onecad::ops::profile_face_cache();
+    const onecad::ops::GeneratorCache& generators = onecad::ops::generator_cache();
+    result["caches"] = {
+        {"opResult",
+         {{"entries", op_cache.size()}, {"bytes", op_cache.bytes()}, {"hits", op_cache.hits()},
+          {"misses", op_cache.misses()}, {"mismatches", op_cache.mismatches()}}},
+        {"profileFace",
+         {{"entries", profiles.size()}, {"hits", profiles.hits()}, {"misses", profiles.misses()}}},
+        {"generator",
+         {{"entries", generators.size()}, {"hits", generators.hits()},
+          {"misses", generators.misses()}}},
+    };
+    return Envelope::ok_response(req.id, std::move(result));
+}
+
+// ONECAD_WORKER_TRACE with `%p` expanded to the pid, so the children of one zygote
+// write distinct files. "" when unset.
+std::string env_trace_path() {
+    const char* env = std::getenv("ONECAD_WORKER_TRACE");
+    std::string path = env != nullptr ? env : "";
+    const std::size_t at = path.find("%p");
+    if (at != std::string::npos) path.replace(at, 2, std::to_string(::getpid()));
+    return path;
+}
+
+// DumpTrace (SCHEMA §7.1): write the recorded spans to `args.path` (default: the
+// ONECAD_WORKER_TRACE file). Solver lane, like GetWorkerStats: a trace is most
+// wanted while the kernel lane is stuck.
+Envelope handle_dump_trace(const Envelope& req) {
+    std::string path = req.args.is_object() ? req.args.value("path", std::string{}) : "";
+    if (path.empty()) path = env_trace_path();
+    if (path.empty()) {
+        return Envelope::error_response(
+            req.id, onecad::protocol::ErrorInfo{"OP_FAILED",
+                                                "no trace path (args.path or ONECAD_WORKER_TRACE)",
+                                                /*retriable=*/false});
+    }
+    std::string error;
+    const long events = onecad::trace::write_chrome_trace(path, error);
+    if (events < 0) {
+        return Envelope::error_response(
+            req.id, onecad::protocol::ErrorInfo{"OP_FAILED", error, /*retriable=*/false});
+    }
+    return Envelope::ok_response(req.id, nlohmann::json{{"path", path},
+                                                        {"events", events},
+                                                        {"enabled", onecad::trace::enabled()}});
+}
+
+// Terminal resp for a request whose `sessionId` names no open document.
+Envelope unknown_session(const Envelope& req) {
+    return Envelope::error_response(
+        req.id, onecad::protocol::ErrorInfo{"PROTOCOL_ERROR",
+                                            "unknown sessionId: " + session_handle(req),
+                                            /*retriable=*/false});
+}
+
+// Register a kernel-lane verb that runs against the session its request names.
+// The handler holds the slot for the whole request (SessionRegistry.h lifetime).
+// `priority` is its kernel scheduling class (SCHEMA §5.5); anything but Regen
+// promises the verb never mutates session state. `scope` widens (read-only) or
+// narrows (Regen) what the verb touches to the prepared scratch job.
+void register_session_verb(Dispatcher& dispatcher, SessionRegistry& registry, std::string verb,
+                           SessionHandler handler, Priority priority = Priority::Regen,
+                           Scope scope = Scope::Head) {
     dispatcher.register_verb(
-        "OpenSession",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
-            return handle_open_session(session, r);
-        });
+        std::move(verb),
+        [&registry, handler = std::move(handler)](const Envelope& r, const Bin& bin,
+                                                  HandlerContext& ctx) {
+            const std::shared_ptr<SessionSlot> slot = registry.find(session_handle(r));
+            if (!slot) return unknown_session(r);
+            return handler(slot->session, r, bin, ctx);
+        },
+        priority, scope);
+}
+
+void register_verbs(Dispatcher& dispatcher, SessionRegistry& registry) {
+    // OpenSession is the one verb that CREATES its slot; the rest only find one.
     dispatcher.register_verb(
-        "CloseSession",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
-            return handle_close_session(session, r);
+        "OpenSession", [&registry](const Envelope& r, const Bin&, HandlerContext&) {
+            const std::shared_ptr<SessionSlot> slot = registry.open(session_handle(r));
+            if (!slot) {
+                return Envelope::error_response(
+                    r.id, onecad::protocol::ErrorInfo{
+                              "OP_FAILED",
+                              "worker hosts the maximum of " +
+                                  std::to_string(SessionRegistry::kMaxSessions) + " sessions",
+                              /*retriable=*/false});
+            }
+            return handle_open_session(slot->session, r);
         });
+    // Closing a named session drops its slot (its geometry is freed once no
+    // request holds it); the default session is only closed. The resp of a
+    // dropped session carries the all-zero head.
     dispatcher.register_verb(
-        "ResetSession",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        "CloseSession", [&registry](const Envelope& r, const Bin&, HandlerContext&) {
+            const std::string handle = session_handle(r);
+            const std::shared_ptr<SessionSlot> slot = registry.find(handle);
+            if (!slot) return unknown_session(r);
+            Envelope resp = handle_close_session(slot->session, r);
+            registry.erase(handle);
+            return resp;
+        });
+    register_session_verb(
+        dispatcher, registry, "ResetSession",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return handle_reset_session(session, r);
         });
-    dispatcher.register_verb(
-        "GetWorkerHead",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "GetWorkerHead",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return handle_get_worker_head(session, r);
-        });
+        },
+        Priority::Interactive, Scope::Scratch);  // reports hasScratch
     // --- W-WP4: transactional regen (kernel lane, single-writer) ---
-    dispatcher.register_verb(
-        "ExecutePlan",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext& ctx) {
+    // ExecutePlan builds into the scratch job only (the head moves on Accept), so
+    // hovers and previews queued behind a long plan do not wait for it.
+    register_session_verb(
+        dispatcher, registry, "ExecutePlan",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext& ctx) {
             return onecad::session::handle_execute_plan(session, r, ctx);
-        });
-    dispatcher.register_verb(
-        "AcceptPrepared",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        },
+        Priority::Regen, Scope::Scratch);
+    register_session_verb(
+        dispatcher, registry, "AcceptPrepared",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_accept_prepared(session, r);
         });
-    dispatcher.register_verb(
-        "DiscardPrepared",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "DiscardPrepared",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_discard_prepared(session, r);
         });
     // --- W-WP5: geometry + element identity (SCHEMA §7.5/§7.6) ---
     // MODEL-OPS W3: drag-time preview. Kernel lane (OCCT single-writer), no
     // fencing, no scratch — see session/PreviewOp.h.
-    dispatcher.register_verb(
-        "PreviewOp",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext& ctx) {
+    register_session_verb(
+        dispatcher, registry, "PreviewOp",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext& ctx) {
             return onecad::session::handle_preview_op(session, r, ctx.cancel);
-        });
-    dispatcher.register_verb(
-        "Tessellate",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        },
+        Priority::Preview);
+    register_session_verb(
+        dispatcher, registry, "Tessellate",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return handle_tessellate(session, r);
-        });
-    dispatcher.register_verb(
-        "AcquireElementIds",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        },
+        Priority::Preview);
+    register_session_verb(
+        dispatcher, registry, "AcquireElementIds",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_acquire_element_ids(session, r);
         });
-    dispatcher.register_verb(
-        "BindElementIds",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "BindElementIds",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_bind_element_ids(session, r);
         });
-    dispatcher.register_verb(
-        "QueryElement",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "QueryElement",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_query_element(session, r);
-        });
+        },
+        Priority::Interactive);
     // --- COMPONENT-LIBRARY P0.1: interactive surface classification for the
     //     placement/mate-snap solver (SCHEMA §7.5). Read-only, current head,
     //     no snapshotId — a continuously re-issued LIVE hover query, unlike
     //     QueryElement's pick-time snapshot addressing (Invariant 4). ---
-    dispatcher.register_verb(
-        "ClassifyElement",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "ClassifyElement",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_classify_element(session, r);
-        });
+        },
+        Priority::Interactive);
     // --- WP-C1: exact mass properties (SCHEMA §7.5). Read-only, addressed by
     //     bodyId against a head copy — no fence, no scratch, no minting. ---
-    dispatcher.register_verb(
-        "QueryMassProperties",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "QueryMassProperties",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_query_mass_properties(session, r);
-        });
-    dispatcher.register_verb(
-        "QueryBodyTopology",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        },
+        Priority::Interactive);
+    register_session_verb(
+        dispatcher, registry, "QueryBodyTopology",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_query_body_topology(session, r);
-        });
-    dispatcher.register_verb(
-        "ResolveRefs",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        },
+        Priority::Interactive);
+    register_session_verb(
+        dispatcher, registry, "ResolveRefs",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_resolve_refs(session, r);
-        });
+        },
+        Priority::Interactive);
     // --- SKETCH-ON-FACE W1: face-boundary projection (SCHEMA §7.6). Read-only;
     //     addressed like QueryElement (head copy, `present:false` for stale). ---
-    dispatcher.register_verb(
-        "ProjectFaceBoundary",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "ProjectFaceBoundary",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_project_face_boundary(session, r);
-        });
+        },
+        Priority::Interactive);
     // --- OFFSET-FACE W1: the read-only `op.offsetFace` authoring handshake
     //     (SCHEMA §7.6). Head COPY, no minting — but SNAPSHOT-FENCED, because its
     //     answer is frozen into a document record (stale ⇒ STALE_PREVIEW). ---
-    dispatcher.register_verb(
-        "PrepareOffsetFace",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "PrepareOffsetFace",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_prepare_offset_face(session, r);
-        });
-    dispatcher.register_verb(
-        "PrepareEdgeOp",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        },
+        Priority::Interactive);
+    register_session_verb(
+        dispatcher, registry, "PrepareEdgeOp",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::session::handle_prepare_edge_op(session, r);
-        });
+        },
+        Priority::Interactive);
     // --- W-WP6: STEP export (SCHEMA §7.8, D2) ---
-    dispatcher.register_verb(
-        "ExportStep",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "ExportStep",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::io::handle_export_step(session, r);
-        });
+        },
+        Priority::Bulk);
     // --- Component Library WP-3.2: geometry export in the §7.3 REPLAY codecs
     //     (SCHEMA §7.8). The inverse of InspectStep's conversion lane — this one
     //     bakes a body already in the session, which is what an `embedded` /
     //     `document` component source is made of. ---
-    dispatcher.register_verb(
-        "ExportGeometry",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "ExportGeometry",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::io::handle_export_geometry(session, r);
-        });
+        },
+        Priority::Bulk);
     // --- STEP-IMPORT WP-A W1: read-only STEP probe + brep conversion lane
     //     (SCHEMA §7.8). No session argument by design: no head, no scratch, no
     //     fence, no publish — the import itself is the §7.3 `ImportStep` op. ---
@@ -369,41 +566,60 @@ void register_verbs(Dispatcher& dispatcher, SolverLane& solver_lane, Session& se
         "InspectStep",
         [](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext& ctx) {
             return onecad::io::handle_inspect_step(r, ctx.cancel);
-        });
+        },
+        Priority::Bulk);
     // --- M5a: mesh export (STL / OBJ, SCHEMA §7.8) ---
-    dispatcher.register_verb(
-        "ExportStl",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+    register_session_verb(
+        dispatcher, registry, "ExportStl",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::io::handle_export_stl(session, r);
-        });
-    dispatcher.register_verb(
-        "ExportObj",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        },
+        Priority::Bulk);
+    register_session_verb(
+        dispatcher, registry, "ExportObj",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::io::handle_export_obj(session, r);
-        });
-    // --- M5a: checkpoints (SCHEMA §7.7) ---
-    dispatcher.register_verb(
-        "SaveCheckpoint",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        },
+        Priority::Bulk);
+    // --- M5a: checkpoints (SCHEMA §7.7). SaveCheckpoint records into the
+    //     session's checkpoint table, so both are ordered as mutations. ---
+    register_session_verb(
+        dispatcher, registry, "SaveCheckpoint",
+        [](Session& session, const Envelope& r, const Bin&, HandlerContext&) {
             return onecad::io::handle_save_checkpoint(session, r);
         });
-    dispatcher.register_verb(
-        "RestoreCheckpoint",
-        [&session](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
-            return onecad::io::handle_restore_checkpoint(session, r);
+    register_session_verb(
+        dispatcher, registry, "RestoreCheckpoint",
+        [](Session& session, const Envelope& r, const Bin& bin, HandlerContext&) {
+            return onecad::io::handle_restore_checkpoint(session, r, bin);
         });
     dispatcher.register_verb("Shutdown", handle_shutdown);
     dispatcher.register_verb("Debug.Busy", handle_debug_busy);
-    solver_lane.register_verbs(dispatcher);  // Sketch* verbs -> solver lane
+    dispatcher.register_solver_verb(
+        "GetWorkerStats", [&dispatcher, &registry](const Envelope& r, const Bin&, HandlerContext&) {
+            return handle_get_worker_stats(dispatcher, registry, r);
+        });
+    dispatcher.register_solver_verb(
+        "DumpTrace", [](const Envelope& r, const Bin&, HandlerContext&) {
+            return handle_dump_trace(r);
+        });
+    // Sketch* verbs -> solver lane, each on the lane of its request's session.
+    for (const std::string& verb : SolverLane::verbs()) {
+        dispatcher.register_solver_verb(
+            verb, [&registry](const Envelope& r, const Bin&, HandlerContext& ctx) {
+                const std::shared_ptr<SessionSlot> slot = registry.find(session_handle(r));
+                if (!slot) return unknown_session(r);
+                return slot->solver.handle(r, &ctx.cancel);
+            });
+    }
 }
 
 // Validate the hello payload + run a SketchUpsert through the solver lane
 // in-process; return exit code (0 == OK).
 int run_selftest() {
     Dispatcher dispatcher;
-    Session session;
-    SolverLane solver_lane(session.sketches());
-    register_verbs(dispatcher, solver_lane, session);
+    SessionRegistry registry;
+    register_verbs(dispatcher, registry);
 
     // The hello is unsolicited (SCHEMA §6), not a verb — validate its payload.
     const nlohmann::json hello = make_hello_result();
@@ -442,6 +658,61 @@ int run_selftest() {
     return 0;
 }
 
+// Everything a cold start pays before its hello besides loading the binary: STEP
+// controller registration and the first use of the modeling, meshing and BRep
+// codec toolkits (their lazily built tables and the allocator pools they fill).
+// Run ONCE by a zygote so every forked worker starts warm. Sequential OCCT only:
+// the zygote must hold no thread when it forks (protocol/Zygote.h).
+void warm_up_kernel() {
+    const auto started = std::chrono::steady_clock::now();
+    STEPControl_Controller::Init();
+    const TopoDS_Shape a = BRepPrimAPI_MakeBox(10.0, 10.0, 10.0).Shape();
+    const TopoDS_Shape b = BRepPrimAPI_MakeBox(gp_Pnt(5.0, 5.0, 5.0), 10.0, 10.0, 10.0).Shape();
+    BRepAlgoAPI_Fuse fuse(a, b);
+    if (fuse.IsDone()) {
+        BRepMesh_IncrementalMesh mesh(fuse.Shape(), 0.1, Standard_False, 0.5,
+                                      /*isInParallel=*/Standard_False);
+        std::vector<std::uint8_t> bytes;
+        TopoDS_Shape back;
+        if (onecad::io::write_brep_shape(fuse.Shape(), bytes).empty()) {
+            onecad::io::read_brep_shape(bytes.data(), bytes.size(), back);
+        }
+    }
+    WLOG_INFO("zygote: kernel warm-up took %lld ms",
+              static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::steady_clock::now() - started)
+                                         .count()));
+}
+
+// Normal operation on stdin/stdout: emit the unsolicited hello, then dispatch.
+// A zygote child runs exactly this on the descriptors it was handed.
+int run_worker() {
+    WLOG_INFO("onecad-worker %s starting (protocol v%d, occt %s)", kWorkerVersion,
+              kProtocolVersion, OCC_VERSION_COMPLETE);
+    const std::string trace_path = env_trace_path();
+    if (!trace_path.empty()) onecad::trace::enable();
+    Dispatcher dispatcher;
+    SessionRegistry registry;  // the default session + any OpenSession{sessionId}
+    register_verbs(dispatcher, registry);
+    // Every worker frame is stamped from the head of its request's session (SCHEMA §3).
+    dispatcher.set_stamp_source(
+        [&registry](const std::string& session_id) { return registry.head_stamp(session_id); });
+
+    const Envelope hello = Envelope::hello(make_hello_result());
+    const int code = dispatcher.run(STDIN_FILENO, STDOUT_FILENO, &hello);
+    if (!trace_path.empty()) {
+        std::string error;
+        const long events = onecad::trace::write_chrome_trace(trace_path, error);
+        if (events < 0) {
+            WLOG_WARN("trace: %s", error.c_str());
+        } else {
+            WLOG_INFO("trace: wrote %ld spans to %s", events, trace_path.c_str());
+        }
+    }
+    WLOG_INFO("onecad-worker exiting with code %d", code);
+    return code;
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -461,9 +732,21 @@ int main(int argc, char** argv) {
 
     // 3. Argument handling.
     bool selftest = false;
+    std::string zygote_socket;
+    std::string op_cache_dir;
+    std::uint64_t op_cache_max_bytes = onecad::session::OpResultCache::kDefaultMaxBytes;
+    bool op_cache_verify = false;
     for (int i = 1; i < argc; ++i) {
         if (std::strcmp(argv[i], "--selftest") == 0) {
             selftest = true;
+        } else if (std::strcmp(argv[i], "--zygote") == 0 && i + 1 < argc) {
+            zygote_socket = argv[++i];
+        } else if (std::strcmp(argv[i], "--op-cache-dir") == 0 && i + 1 < argc) {
+            op_cache_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--op-cache-max-mb") == 0 && i + 1 < argc) {
+            op_cache_max_bytes = std::strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        } else if (std::strcmp(argv[i], "--op-cache-verify") == 0) {
+            op_cache_verify = true;
         } else {
             WLOG_WARN("ignoring unknown argument: %s", argv[i]);
         }
@@ -472,19 +755,17 @@ int main(int argc, char** argv) {
     if (selftest) {
         return run_selftest();
     }
+    if (!op_cache_dir.empty()) {
+        onecad::session::op_result_cache().configure(op_cache_dir, op_cache_max_bytes,
+                                                      op_cache_verify);
+    }
 
-    // 4. Normal operation: emit the unsolicited hello, then dispatch stdin/stdout.
-    WLOG_INFO("onecad-worker %s starting (protocol v%d, occt %s)", kWorkerVersion,
-              kProtocolVersion, OCC_VERSION_COMPLETE);
-    Dispatcher dispatcher;
-    Session session;
-    SolverLane solver_lane(session.sketches());
-    register_verbs(dispatcher, solver_lane, session);
-    // Every worker frame is stamped from the session head (SCHEMA §3).
-    dispatcher.set_stamp_source([&session] { return session.head_stamp(); });
+    // 4. Zygote mode: warm up once, then fork a ready worker per spawn request.
+    if (!zygote_socket.empty()) {
+        warm_up_kernel();
+        return onecad::protocol::run_zygote(zygote_socket, run_worker);
+    }
 
-    const Envelope hello = Envelope::hello(make_hello_result());
-    const int code = dispatcher.run(STDIN_FILENO, STDOUT_FILENO, &hello);
-    WLOG_INFO("onecad-worker exiting with code %d", code);
-    return code;
+    // 5. Normal operation: emit the unsolicited hello, then dispatch stdin/stdout.
+    return run_worker();
 }
@@ -30,6 +30,8 @@
 #include "kernel/validation/ShapeAudit.h"
 #include "ops/ComponentGenerators.h"
 #include "ops/ComponentMateSolver.h"
+#include "ops/GeneratorCache.h"
+#include "ops/Instancing.h"
 #include "ops/OpCommon.h"
 #include "session/ClassifyElement.h"
 
@@ -421,6 +423,68 @@ std::optional<OpOutcome> read_source_blob(const json& source, const std::string&
     return std::nullopt;
 }
 
+// The `generator` source arm: reads the free params and runs `build_component`.
+// `nullopt` with `solid_out` set on success, else the failure to return.
+std::optional<OpOutcome> build_generator_source(const json& source,
+                                                const std::string& generator_id,
+                                                const std::string& op_label,
+                                                TopoDS_Shape& solid_out) {
+    // Free params live under `source.params` — the wire lowering has no
+    // PlaceComponent special-case beyond `inputs[]`, so `ComponentSourceRef::
+    // Generator.params` reaches here verbatim. Defaults reproduce P0/P1's
+    // old hardcoded M6×20 exactly; `thread_detail` defaults to `cosmetic` for
+    // the same byte-identical reason (WP-2.5).
+    //
+    // WP-F2: every STRING param is carried through verbatim rather than
+    // named one by one here, so a family keyed by something other than a
+    // thread (a bearing's `code`) needs no change to this layer.
+    // `thread`/`thread_detail` are read back OUT of that map, which is
+    // what keeps them from drifting from it.
+    std::map<std::string, std::string> text_params;
+    double length_mm = kDefaultLengthMm;
+    bool length_given = false;
+    if (source.contains("params") && source["params"].is_object()) {
+        const json& gp = source["params"];
+        for (auto it = gp.begin(); it != gp.end(); ++it) {
+            if (it.value().is_string()) text_params[it.key()] = it.value().get<std::string>();
+        }
+        if (gp.contains("length")) {
+            const json& l = gp["length"];
+            if (l.is_number()) {
+                length_mm = l.get<double>();
+                length_given = true;
+            } else if (l.is_object() && l.contains("value") && l["value"].is_number()) {
+                length_mm = l["value"].get<double>();
+                length_given = true;
+            }
+        }
+    }
+    const auto text_or = [&text_params](const char* key, const char* fallback) {
+        const auto it = text_params.find(key);
+        return it == text_params.end() ? std::string(fallback) : it->second;
+    };
+    const std::string thread = text_or("thread", kDefaultThread);
+    const std::string thread_detail_str = text_or("thread_detail", kDefaultThreadDetail);
+    if (!std::isfinite(length_mm) || length_mm <= 0.0) {
+        return OpOutcome::fail("OP_FAILED",
+                               op_label + ": source.params.length must be finite and positive");
+    }
+    ThreadDetail thread_detail;
+    if (!parse_thread_detail(thread_detail_str, thread_detail)) {
+        return OpOutcome::fail("OP_FAILED", op_label + ": unknown thread_detail '" +
+                                                thread_detail_str +
+                                                "' — known values: cosmetic, simplified, modeled");
+    }
+
+    const GeneratorRequest req{op_label,      thread,        length_mm,
+                               length_given,  thread_detail, std::move(text_params)};
+    std::string err;
+    if (!build_component(generator_id, req, solid_out, err)) {
+        return OpOutcome::fail("OP_FAILED", err);
+    }
+    return std::nullopt;
+}
+
 // Shared pipeline behind BOTH `PlaceComponent` and `DetachComponent`
 // (identical geometry construction — the two differ only in what the
 // RECORD's params carry: PlaceComponent keeps a library identity + optional
@@ -451,6 +515,8 @@ OpOutcome resolve_source_and_publish(OpContext& ctx, const json& params, const s
     }
     TopoDS_Shape solid;
     std::string err;
+    const bool instancing = instancing_enabled(ctx.occt_options);
+    bool source_validated = false;
 
     if (kind != "generator") {
         if (std::optional<OpOutcome> failure =
@@ -466,57 +532,32 @@ OpOutcome resolve_source_and_publish(OpContext& ctx, const json& params, const s
 
         if (ctx.cancel != nullptr && ctx.cancel->cancelled()) return OpOutcome::cancelled();
 
-        // Free params live under `source.params` — the wire lowering has no
-        // PlaceComponent special-case beyond `inputs[]`, so `ComponentSourceRef::
-        // Generator.params` reaches here verbatim. Defaults reproduce P0/P1's
-        // old hardcoded M6×20 exactly; `thread_detail` defaults to `cosmetic` for
-        // the same byte-identical reason (WP-2.5).
-        //
-        // WP-F2: every STRING param is carried through verbatim rather than
-        // named one by one here, so a family keyed by something other than a
-        // thread (a bearing's `code`) needs no change to this layer.
-        // `thread`/`thread_detail` are read back OUT of that map, which is
-        // what keeps them from drifting from it.
-        std::map<std::string, std::string> text_params;
-        double length_mm = kDefaultLengthMm;
-        bool length_given = false;
-        if (source.contains("params") && source["params"].is_object()) {
-            const json& gp = source["params"];
-            for (auto it = gp.begin(); it != gp.end(); ++it) {
-                if (it.value().is_string()) text_params[it.key()] = it.value().get<std::string>();
-            }
-            if (gp.contains("length")) {
-                const json& l = gp["length"];
-                if (l.is_number()) {
-                    length_mm = l.get<double>();
-                    length_given = true;
-                } else if (l.is_object() && l.contains("value") && l["value"].is_number()) {
-                    length_mm = l["value"].get<double>();
-                    length_given = true;
-                }
+        // Generator output is a pure function of (generatorId, source.params,
+        // kernel policy): a hit skips the build AND the input preflight it passed
+        // when it was cached (GeneratorCache.h). The shape handed out is shared —
+        // the placement below deep-copies it; under `occtOptions.instancing` it
+        // re-locates the entry's instance prototype instead (Instancing.h).
+        const std::string cache_key = generator_cache_key(
+            "component:" + generator_id,
+            source.contains("params") ? source["params"] : json::object());
+        if (std::optional<GeneratedSolid> cached = generator_cache().find(cache_key)) {
+            solid = cached->shape;
+            source_validated = true;
+        } else {
+            if (std::optional<OpOutcome> failure =
+                    build_generator_source(source, generator_id, op_label, solid)) {
+                return *failure;
             }
+            if (auto invalid = validate_modeling_input(solid, op_label, "source")) return *invalid;
+            source_validated = true;
+            generator_cache().insert(cache_key, GeneratedSolid{solid});
         }
-        const auto text_or = [&text_params](const char* key, const char* fallback) {
-            const auto it = text_params.find(key);
-            return it == text_params.end() ? std::string(fallback) : it->second;
-        };
-        const std::string thread = text_or("thread", kDefaultThread);
-        const std::string thread_detail_str = text_or("thread_detail", kDefaultThreadDetail);
-        if (!std::isfinite(length_mm) || length_mm <= 0.0) {
-            return OpOutcome::fail("OP_FAILED",
-                                   op_label + ": source.params.length must be finite and positive");
-        }
-        ThreadDetail thread_detail;
-        if (!parse_thread_detail(thread_detail_str, thread_detail)) {
-            return OpOutcome::fail("OP_FAILED", op_label + ": unknown thread_detail '" +
-                                                    thread_detail_str +
-                                                    "' — known values: cosmetic, simplified, modeled");
-        }
-
-        const GeneratorRequest req{op_label,      thread,        length_mm,
-                                   length_given,  thread_detail, std::move(text_params)};
-        if (!build_component(generator_id, req, solid, err)) {
-            return OpOutcome::fail("OP_FAILED", err);
+        // Instanced placements share the entry's own prototype, never the cached
+        // solid deep copies are taken from (GeneratorCache.h).
+        if (instancing) {
+            const std::optional<TopoDS_Shape> shared =
+                generator_cache().instance_prototype(cache_key);
+            if (shared) solid = *shared;
         }
     }
 
@@ -527,7 +568,9 @@ OpOutcome resolve_source_and_publish(OpContext& ctx, const json& params, const s
     // name instead of surfacing as an OCCT exception from `BRepBuilderAPI_Transform`.
     // A generator's own output goes through it too: cheap, and a generator whose
     // table drifted is exactly as broken as a bad blob.
-    if (auto invalid = validate_modeling_input(solid, op_label, "source")) return *invalid;
+    if (!source_validated) {
+        if (auto invalid = validate_modeling_input(solid, op_label, "source")) return *invalid;
+    }
 
     gp_Trsf trsf;
     if (!read_placement(params, op_label, trsf, err)) {
@@ -548,15 +591,21 @@ OpOutcome resolve_source_and_publish(OpContext& ctx, const json& params, const s
         }
     }
 
-    try {
-        BRepBuilderAPI_Transform xf(solid, trsf, /*Copy=*/Standard_True);
-        if (!xf.IsDone() || xf.Shape().IsNull()) {
-            return OpOutcome::fail("OP_FAILED", op_label + ": placement transform failed");
+    if (instancing && is_rigid(trsf)) {
+        // The placement is a location on the shared prototype: no geometry copied.
+        solid = place_instance(solid, trsf);
+    } else {
+        try {
+            BRepBuilderAPI_Transform xf(solid, trsf, /*Copy=*/Standard_True);
+            if (!xf.IsDone() || xf.Shape().IsNull()) {
+                return OpOutcome::fail("OP_FAILED", op_label + ": placement transform failed");
+            }
+            solid = xf.Shape();
+        } catch (const Standard_Failure& f) {
+            return OpOutcome::fail("OP_FAILED",
+                                   op_label + ": placement transform raised: " +
+                                       (f.GetMessageString() ? f.GetMessageString() : "OCCT"));
         }
-        solid = xf.Shape();
-    } catch (const Standard_Failure& f) {
-        return OpOutcome::fail("OP_FAILED", op_label + ": placement transform raised: " +
-                                                (f.GetMessageString() ? f.GetMessageString() : "OCCT"));
     }
 
     if (ctx.cancel != nullptr && ctx.cancel->cancelled()) return OpOutcome::cancelled();
@@ -26,6 +26,7 @@
 #include <Standard_Failure.hxx>
 #include <TopAbs_Orientation.hxx>
 #include <TopExp_Explorer.hxx>
+#include <TopTools_ListOfShape.hxx>
 #include <TopoDS.hxx>
 #include <TopoDS_Face.hxx>
 #include <TopoDS_Shape.hxx>
@@ -38,6 +39,7 @@
 #include "elementmap/Ladder.h"
 #include "kernel/validation/GeometryPrecision.h"
 #include "modeling/BooleanMode.h"
+#include "ops/Instancing.h"
 #include "ops/OpCommon.h"
 
 namespace onecad::ops {
@@ -117,12 +119,17 @@ bool valid_optional_scalar(const json& params, const char* key) {
            std::isfinite(value["value"].get<double>());
 }
 
-const json* find_sketch(const OpContext& ctx, const json& params) {
+// The plan's Sketch op `params` names (else the last one), and the id it
+// resolved to in `resolved_id` (the profile cache's key).
+const json* find_sketch(const OpContext& ctx, const json& params, std::string& resolved_id) {
     std::string sid = read_str(params, "sketchId");
     if (sid.empty() && ctx.last_sketch_id) sid = *ctx.last_sketch_id;
     if (!ctx.sketches) return nullptr;
     for (const auto& [id, p] : *ctx.sketches) {
-        if (id == sid) return &p;
+        if (id == sid) {
+            resolved_id = id;
+            return &p;
+        }
     }
     return nullptr;
 }
@@ -257,7 +264,7 @@ constexpr double kToNextSeatThreshold = 2.0 * kToNextContactEpsilon;
 // sit exactly at the sketch plane and were dropped by its epsilon filter, leaving the
 // exit vertices as the smallest survivor.
 ToNextResult to_next_distance(const TopoDS_Face& profile, const gp_Dir& dir,
-                              const TopoDS_Shape& body) {
+                              const TopoDS_Shape& body, const json& occt_options) {
     GProp_GProps props;
     BRepGProp::SurfaceProperties(profile, props);
     const gp_Pnt origin = props.CentreOfMass();
@@ -278,8 +285,14 @@ ToNextResult to_next_distance(const TopoDS_Face& profile, const gp_Dir& dir,
         BRepPrimAPI_MakePrism sweep(lifted.Shape(), gp_Vec(dir) * sweep_distance,
                                     Standard_True);
         if (sweep.Shape().IsNull()) return {ToNextStatus::Unprovable, -1.0};
-        BRepAlgoAPI_Common common(sweep.Shape(), body);
+        BRepAlgoAPI_Common common;
+        TopTools_ListOfShape args, tools;
+        args.Append(sweep.Shape());
+        tools.Append(body);
+        common.SetArguments(args);
+        common.SetTools(tools);
         common.SetRunParallel(Standard_False);
+        protect_shared_arguments(common, occt_options);  // `body` is a document body
         common.Build();
         if (!common.IsDone() || common.HasErrors() || common.Shape().IsNull())
             return {ToNextStatus::Unprovable, -1.0};
@@ -653,7 +666,8 @@ OpOutcome execute_extrude(OpContext& ctx, const json& op, const std::string& op_
     }
 
     // --- profile face ---
-    const json* sketch_params = find_sketch(ctx, params);
+    std::string sketch_id;
+    const json* sketch_params = find_sketch(ctx, params, sketch_id);
     if (!sketch_params) {
         return OpOutcome::fail("REF_UNRESOLVED", "Extrude: profile sketch not found in plan");
     }
@@ -666,7 +680,7 @@ OpOutcome execute_extrude(OpContext& ctx, const json& op, const std::string& op_
     }
     std::string perr;
     std::optional<TopoDS_Face> profile =
-        build_profile_face(*sketch_params, read_str(params, "regionId"),
+        build_profile_face(sketch_id, *sketch_params, read_str(params, "regionId"),
                            region_identity_version, perr);
     if (!profile) return OpOutcome::fail("OP_FAILED", perr);
 
@@ -721,7 +735,8 @@ OpOutcome execute_extrude(OpContext& ctx, const json& op, const std::string& op_
         }
         if (m == "ToNext") {
             if (!ref_shape) { err = "ToNext requires an existing target body"; return std::nullopt; }
-            const ToNextResult next = to_next_distance(*profile, ref_dir, *ref_shape);
+            const ToNextResult next =
+                to_next_distance(*profile, ref_dir, *ref_shape, ctx.occt_options);
             if (next.status == ToNextStatus::Unprovable) {
                 // UNKNOWN is refused by name, so it is never confused with the honest
                 // "there is nothing ahead" negative below.
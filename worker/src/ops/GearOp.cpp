@@ -7,6 +7,7 @@
 #include <vector>
 
 #include <BRep_Tool.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepClass_FaceClassifier.hxx>
 #include <GeomAPI_ProjectPointOnSurf.hxx>
 #include <Geom_Surface.hxx>
@@ -22,6 +23,7 @@
 #include "elementmap/ElementMapPartition.h"
 #include "elementmap/Ladder.h"
 #include "kernel/validation/ShapeAudit.h"
+#include "ops/GeneratorCache.h"
 #include "ops/OpCommon.h"
 #include "ops/gear/GearTool.h"
 
@@ -132,6 +134,30 @@ std::string read_involute_spec(const json& params, gear::GearBuildSpec& spec) {
     return {};
 }
 
+/// The parsed spec as canonical JSON — the generator-cache key material. Built
+/// from the spec rather than the raw block so the `{value, expr}` and bare-number
+/// scalar forms of the same gear share one entry.
+json canonical_gear_params(const gear::GearBuildSpec& spec) {
+    const kernel::gear::InvoluteToothParams& p = spec.involute;
+    return json{{"teeth", p.numTeeth},
+                {"module", p.module},
+                {"pressureAngle", p.pressureAngle},
+                {"clearance", p.clearance},
+                {"shift", p.shift},
+                {"helixAngle", p.helixAngle},
+                {"undercut", p.undercut},
+                {"backlash", p.backlash},
+                {"head", p.head},
+                {"propertiesFromTool", p.propertiesFromTool},
+                {"sampleCount", spec.sampleCount},
+                {"height", spec.height},
+                {"axleHole", spec.axleHole},
+                {"axleHoleDiameter", spec.axleHoleDiameter},
+                {"offsetHole", spec.offsetHole},
+                {"offsetHoleDiameter", spec.offsetHoleDiameter},
+                {"offsetHoleOffset", spec.offsetHoleOffset}};
+}
+
 /// The gear's placement face ref, when the payload carries one.
 std::optional<em::LadderRef> placement_face_ref(const json& op, const json& params,
                                                 const std::string& op_id) {
@@ -372,23 +398,49 @@ OpOutcome execute_gear(OpContext& ctx, const json& op, const std::string& op_id)
 
     if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
 
-    // --- build -------------------------------------------------------------
-    const gear::GearBuildResult built = gear::build_gear_solid(spec, frame);
-    if (!built.ok) {
-        return OpOutcome::fail("OP_FAILED", built.error.empty() ? "Gear body could not be built"
-                                                                : built.error);
+    // --- build (or reuse) the local solid ----------------------------------
+    // The unplaced gear is a pure function of the parsed recipe, so replays and
+    // previews of the same gear reuse one audited build (GeneratorCache.h). The
+    // cached solid is never published itself: every regen places a deep copy.
+    const kernel::validation::PublicationTier tier =
+        result_validation_tier(ctx, kernel::validation::PublicationTier::TierB);
+    const std::string cache_key =
+        generator_cache_key("gear:" + recipe, canonical_gear_params(spec));
+    TopoDS_Shape local;
+    bool audited = false;
+    if (std::optional<GeneratedSolid> cached = generator_cache().find(cache_key)) {
+        local = cached->shape;
+        audited = audit_covers(cached->audited, tier);
+    } else {
+        gear::GearBuildResult built = gear::build_gear_local(spec);
+        if (!built.ok) {
+            return OpOutcome::fail("OP_FAILED", built.error.empty() ? "Gear body could not be built"
+                                                                    : built.error);
+        }
+        local = built.shape;
     }
 
     if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
 
+    TopoDS_Shape shape;
+    try {
+        BRepBuilderAPI_Copy copy(local);
+        shape = gear::place_on_frame(copy.Shape(), frame);
+    } catch (const Standard_Failure& f) {
+        return OpOutcome::fail("OP_FAILED", std::string("Gear body could not be placed: ") +
+                                                (f.what() ? f.what() : "OCCT"));
+    }
+
     // --- publication: the FULL audit (SCHEMA §7.3) -------------------------
-    const kernel::validation::PublicationDecision decision = publication_decision(
-        built.shape,
-        kernel::validation::single_solid_policy(
-            "Gear", result_validation_tier(
-                        ctx, kernel::validation::PublicationTier::TierB)));
-    if (!decision.publishable()) {
-        return OpOutcome::fail(decision.code, decision.message);
+    // Skipped on a hit audited at this tier or above: a rigid placement cannot
+    // change the verdict. A pass is (re)cached with the tier it passed at.
+    if (!audited) {
+        const kernel::validation::PublicationDecision decision = publication_decision(
+            shape, kernel::validation::single_solid_policy("Gear", tier));
+        if (!decision.publishable()) {
+            return OpOutcome::fail(decision.code, decision.message);
+        }
+        generator_cache().insert(cache_key, GeneratedSolid{local, tier});
     }
 
     // --- mint (D1) ---------------------------------------------------------
@@ -397,7 +449,7 @@ OpOutcome execute_gear(OpContext& ctx, const json& op, const std::string& op_id)
     // nothing to rebind. Tooth faces are deliberately NOT minted into the
     // element map; see GearOp.h on referenceability.
     const std::string bid = "body_" + op_id;
-    ctx.bodies.create(bid, op_id, built.shape);
+    ctx.bodies.create(bid, op_id, shape);
     out.body_events.push_back({"created", bid, {}});
     out.body_ids.push_back(bid);
     return out;
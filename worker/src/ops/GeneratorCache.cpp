@@ -0,0 +1,103 @@
+// GeneratorCache.cpp — see GeneratorCache.h.
+#include "ops/GeneratorCache.h"
+
+#include <BRepBuilderAPI_Copy.hxx>
+#include <Standard_Failure.hxx>
+
+#include "util/Hashing.h"
+
+namespace onecad::ops {
+
+std::optional<GeneratedSolid> GeneratorCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++hits_;
+    return it->second->solid;
+}
+
+void GeneratorCache::insert(const std::string& key, const GeneratedSolid& solid) {
+    if (capacity_ == 0 || solid.shape.IsNull()) return;
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        // A re-audit upgrade keeps the shape, and with it the instances' prototype.
+        if (!it->second->solid.shape.IsSame(solid.shape)) {
+            it->second->instance_prototype.Nullify();
+        }
+        it->second->solid = solid;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    lru_.push_front(Entry{key, solid, TopoDS_Shape()});
+    index_.emplace(key, lru_.begin());
+    while (lru_.size() > capacity_) {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+std::optional<TopoDS_Shape> GeneratorCache::instance_prototype(const std::string& key) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = index_.find(key);
+    if (it == index_.end()) return std::nullopt;
+    Entry& entry = *it->second;
+    if (entry.instance_prototype.IsNull()) {
+        // Topology only: the geometry (and so every bit a placement evaluates)
+        // stays the cached solid's.
+        try {
+            BRepBuilderAPI_Copy copy(entry.solid.shape, /*copyGeom=*/Standard_False);
+            if (!copy.IsDone() || copy.Shape().IsNull()) return std::nullopt;
+            entry.instance_prototype = copy.Shape();
+        } catch (const Standard_Failure&) {
+            return std::nullopt;
+        }
+    }
+    return entry.instance_prototype;
+}
+
+void GeneratorCache::clear() {
+    std::lock_guard<std::mutex> lk(mu_);
+    lru_.clear();
+    index_.clear();
+}
+
+std::size_t GeneratorCache::size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return lru_.size();
+}
+
+std::uint64_t GeneratorCache::hits() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return hits_;
+}
+
+std::uint64_t GeneratorCache::misses() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return misses_;
+}
+
+std::string generator_cache_key(const std::string& family, const nlohmann::json& canonical_params) {
+    // nlohmann's default object is key-sorted, so the dump is canonical.
+    const std::string params =
+        canonical_params.is_null() ? std::string("{}") : canonical_params.dump();
+    return family + "|k" + std::to_string(ONECAD_KERNEL_POLICY_VERSION) + "|" +
+           hashing::sha256_hex(params);
+}
+
+bool audit_covers(kernel::validation::PublicationTier audited,
+                  kernel::validation::PublicationTier required) {
+    return audited == kernel::validation::PublicationTier::TierB ||
+           required == kernel::validation::PublicationTier::TierA;
+}
+
+GeneratorCache& generator_cache() {
+    static GeneratorCache cache;
+    return cache;
+}
+
+}  // namespace onecad::ops
@@ -0,0 +1,99 @@
+// GeneratorCache.h — process-wide cache of generated solids, keyed by what the
+// generator is a pure function of.
+//
+// `PlaceComponent`/`DetachComponent` generator sources (ComponentGenerators.h,
+// including the modeled-thread `MakePipeShell` sweep) and `Gear`
+// (ops/gear/GearTool.h, one B-spline flank interpolation per tooth) rebuild the
+// SAME solid on every replay and every preview. Both build in a LOCAL frame and
+// apply the placement afterwards, so the local solid depends only on:
+//
+//   (family, canonical params, kernel policy version)
+//
+// `family` is the generatorId (`"component:iso4762"`) or the gear recipe
+// (`"gear:involuteExternal"`); the params are the key-sorted JSON dump of the
+// parsed inputs, hashed with SHA-256 (util/Hashing.h) so a key never aliases;
+// the policy version is `ONECAD_KERNEL_POLICY_VERSION` (CMakeLists.txt), which
+// is bumped whenever the kernel's modeling policy changes what a build returns.
+//
+// An entry is stored only after it passed its audit, and remembers the tier it
+// passed at: a hit at the same or a lower tier skips both the build and the
+// audit (a rigid placement cannot change a self-interference verdict). A TierA
+// entry consulted for an authoritative TierB publish is re-audited once and
+// upgraded.
+//
+// ── Sharing discipline ───────────────────────────────────────────────────────
+// `find` hands out the cached shape ITSELF. A consumer that publishes it must
+// deep-copy it (`BRepBuilderAPI_Transform(..., Copy=True)`, `BRepBuilderAPI_Copy`).
+// Copies keep the geometry bits, so a hit publishes exactly what a cold build
+// would have. Placements shared on purpose under a location
+// (`occtOptions.instancing`, Instancing.h) take `instance_prototype` instead: a
+// topological copy made once per entry. Whatever instanced documents do to it —
+// BRepMesh stores its triangulation on the shared TFaces — never reaches the
+// shape `find` hands to the deep-copy path.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <TopoDS_Shape.hxx>
+
+#include "kernel/validation/ShapeAudit.h"
+#include "nlohmann/json.hpp"
+
+namespace onecad::ops {
+
+struct GeneratedSolid {
+    TopoDS_Shape shape;  // local frame, never placed
+    kernel::validation::PublicationTier audited = kernel::validation::PublicationTier::TierA;
+};
+
+// Bounded LRU of audited generator output.
+class GeneratorCache {
+public:
+    static constexpr std::size_t kDefaultCapacity = 64;
+
+    explicit GeneratorCache(std::size_t capacity = kDefaultCapacity) : capacity_(capacity) {}
+
+    std::optional<GeneratedSolid> find(const std::string& key);
+    // Replaces an existing entry (e.g. a TierA entry upgraded to TierB).
+    void insert(const std::string& key, const GeneratedSolid& solid);
+    // The prototype instanced placements of `key` share; nullopt on a miss. Not
+    // counted as a hit or a miss (it follows the `find`/`insert` it belongs to).
+    std::optional<TopoDS_Shape> instance_prototype(const std::string& key);
+    void clear();
+
+    std::size_t size() const;
+    std::uint64_t hits() const;
+    std::uint64_t misses() const;
+
+private:
+    struct Entry {
+        std::string key;
+        GeneratedSolid solid;
+        TopoDS_Shape instance_prototype;  // made on first request
+    };
+
+    mutable std::mutex mu_;
+    std::size_t capacity_;
+    std::list<Entry> lru_;  // front == most recently used
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+};
+
+// `<family>|k<policy>|<sha256(canonical_params.dump())>`.
+std::string generator_cache_key(const std::string& family, const nlohmann::json& canonical_params);
+
+// True iff a cached entry audited at `audited` satisfies a publish at `required`.
+bool audit_covers(kernel::validation::PublicationTier audited,
+                  kernel::validation::PublicationTier required);
+
+// The process-wide instance `PlaceComponent`, `DetachComponent` and `Gear` consult.
+GeneratorCache& generator_cache();
+
+}  // namespace onecad::ops
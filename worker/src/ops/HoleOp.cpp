@@ -8,9 +8,11 @@
 #include <vector>
 
 #include <BRepAdaptor_Surface.hxx>
+#include <BRepBndLib.hxx>
 #include <BRepClass_FaceClassifier.hxx>
 #include <BRepCheck_Analyzer.hxx>
 #include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
 #include <GeomAPI_ProjectPointOnSurf.hxx>
 #include <Geom_Surface.hxx>
 #include <Standard_Failure.hxx>
@@ -42,6 +44,9 @@ constexpr double kPointPlaneFence = 1e-3;
 // Face-boundary classification tolerance (BooleanOperation.cpp:116 precedent).
 constexpr double kClassifyTol = 1e-7;
 constexpr int kResultPolicyVersion2 = 2;
+// `points[]` seat cap — one op, one Cut; past this a perforation belongs in a
+// pattern, and the general fuse's tool set stays bounded.
+constexpr std::size_t kMaxSeats = 4096;
 
 enum class HoleResultPolicy { Legacy, V2 };
 
@@ -189,6 +194,60 @@ std::string read_dims(const json& params, const std::string& hole_type, HoleDims
     return "";
 }
 
+// A frozen world point `[x, y, z]`; "" on success, else the named reason.
+// `what` is the param path the message names ("point" / "points[3]").
+std::string read_point(const json& v, const std::string& what, gp_Pnt& out) {
+    if (!v.is_array() || v.size() != 3) return "Hole " + what + " must be a [x, y, z] world point";
+    for (const json& c : v) {
+        if (!c.is_number()) return "Hole " + what + " must be numeric";
+    }
+    out.SetCoord(v[0].get<double>(), v[1].get<double>(), v[2].get<double>());
+    return "";
+}
+
+// Re-project one frozen seat onto the resolved face and fence it (SCHEMA §7.3).
+// "" with `origin` set on success, else the named reason.
+std::string seat_on_face(const TopoDS_Face& face, const gp_Pnt& frozen, gp_Pnt& origin) {
+    try {
+        const Handle(Geom_Surface) surf = BRep_Tool::Surface(face);
+        GeomAPI_ProjectPointOnSurf proj(frozen, surf);
+        if (!proj.IsDone() || proj.NbPoints() < 1) {
+            return "Hole point could not be projected onto the face";
+        }
+        if (proj.LowerDistance() > kPointPlaneFence) {
+            return "Hole point is off the resolved face plane (fence 1e-3 mm)";
+        }
+        origin = proj.NearestPoint();
+        Standard_Real u = 0.0, v = 0.0;
+        proj.LowerDistanceParameters(u, v);
+        // Re-projecting onto the PLANE is not enough: the point must land inside
+        // the face's boundary, else the drill would start beside the material.
+        BRepClass_FaceClassifier classifier(face, gp_Pnt2d(u, v), kClassifyTol);
+        if (classifier.State() == TopAbs_OUT) {
+            return "Hole point lies outside the resolved face boundary";
+        }
+    } catch (const Standard_Failure& f) {
+        return std::string("Hole point could not be resolved on the face: ") +
+               (f.GetMessageString() ? f.GetMessageString() : "OCCT");
+    }
+    return "";
+}
+
+// §9-shaped NeedsRepair for ONE seat of a `points[]` Hole whose frozen point no
+// longer lands on the resolved face. The face itself resolved, so the repair is
+// about the point: the anchor carries it and there are no candidates to offer.
+json seat_repair(const std::string& op_id, std::size_t k, const std::string& element_id,
+                 const gp_Pnt& frozen, const std::string& reason) {
+    return json{{"refId", op_id + ".seat" + std::to_string(k)},
+                {"elementId", element_id},
+                {"ladderFailed", "descriptor"},
+                {"reason", "no-candidates"},
+                {"scoringVersion", em::kResolverVersion},
+                {"candidates", json::array()},
+                {"anchor", {{"worldPoint", {frozen.X(), frozen.Y(), frozen.Z()}}}},
+                {"uiLabel", "Hole seat " + std::to_string(k) + ": " + reason}};
+}
+
 }  // namespace
 
 OpOutcome execute_hole(OpContext& ctx, const json& op, const std::string& op_id) {
@@ -239,6 +298,7 @@ OpOutcome execute_hole(OpContext& ctx, const json& op, const std::string& op_id)
     }
     OpOutcome out;
     json nr;
+    const std::string face_element_id = ref->element_id;
     const TopoDS_Face face = resolve_host_face(ctx, target_shape, target_id, std::move(*ref), nr);
     if (face.IsNull()) {
         // Host face no longer resolves ⇒ NeedsRepair STATE (never a wrong bind).
@@ -252,65 +312,94 @@ OpOutcome execute_hole(OpContext& ctx, const json& op, const std::string& op_id)
         return OpOutcome::fail("OP_FAILED", "Hole face is not planar (a hole needs a planar seat)");
     }
 
-    // --- re-project the frozen point onto the face, then fence it ---
-    if (!params.contains("point") || !params["point"].is_array() || params["point"].size() != 3) {
-        return OpOutcome::fail("OP_FAILED", "Hole point must be a [x, y, z] world point");
-    }
-    for (const json& c : params["point"]) {
-        if (!c.is_number()) return OpOutcome::fail("OP_FAILED", "Hole point must be numeric");
+    // SCHEMA §7.3: axis = the face's INWARD normal at `point`.
+    const gp_Dir axis = outward.Reversed();
+
+    // --- seats: ONE frozen `point`, or a `points[]` perforation ---
+    const bool has_point = params.contains("point") && !params["point"].is_null();
+    const bool multi_seat = params.contains("points") && !params["points"].is_null();
+    if (has_point && multi_seat) {
+        return OpOutcome::fail("OP_FAILED", "Hole takes either point or points, not both");
     }
-    const gp_Pnt frozen(params["point"][0].get<double>(), params["point"][1].get<double>(),
-                        params["point"][2].get<double>());
 
-    gp_Pnt origin;
-    try {
-        const Handle(Geom_Surface) surf = BRep_Tool::Surface(face);
-        GeomAPI_ProjectPointOnSurf proj(frozen, surf);
-        if (!proj.IsDone() || proj.NbPoints() < 1) {
-            return OpOutcome::fail("OP_FAILED", "Hole point could not be projected onto the face");
+    std::vector<TopoDS_Shape> tools;
+    if (!multi_seat) {
+        // --- re-project the frozen point onto the face, then fence it ---
+        gp_Pnt frozen;
+        if (std::string reason = read_point(has_point ? params["point"] : json(), "point", frozen);
+            !reason.empty()) {
+            return OpOutcome::fail("OP_FAILED", reason);
         }
-        if (proj.LowerDistance() > kPointPlaneFence) {
-            return OpOutcome::fail("OP_FAILED",
-                                   "Hole point is off the resolved face plane (fence 1e-3 mm)");
+        gp_Pnt origin;
+        if (std::string reason = seat_on_face(face, frozen, origin); !reason.empty()) {
+            return OpOutcome::fail("OP_FAILED", reason);
         }
-        origin = proj.NearestPoint();
-        Standard_Real u = 0.0, v = 0.0;
-        proj.LowerDistanceParameters(u, v);
-        // Re-projecting onto the PLANE is not enough: the point must land inside
-        // the face's boundary, else the drill would start beside the material.
-        BRepClass_FaceClassifier classifier(face, gp_Pnt2d(u, v), kClassifyTol);
-        if (classifier.State() == TopAbs_OUT) {
-            return OpOutcome::fail("OP_FAILED",
-                                   "Hole point lies outside the resolved face boundary");
-        }
-    } catch (const Standard_Failure& f) {
-        return OpOutcome::fail("OP_FAILED",
-                               std::string("Hole point could not be resolved on the face: ") +
-                                   (f.GetMessageString() ? f.GetMessageString() : "OCCT"));
-    }
 
-    // SCHEMA §7.3: axis = the face's INWARD normal at `point`.
-    const gp_Dir axis = outward.Reversed();
+        // THROUGH-ALL: bound the drill by the host's own extent (clamped = through).
+        // A blind depth that already overshoots the extent is FINE (SCHEMA §7.3) —
+        // it simply becomes a through hole; nothing here clamps it back.
+        if (dims.depth <= 0.0) {
+            dims.depth = through_all_length(origin, axis, target_shape);
+        }
 
-    // THROUGH-ALL: bound the drill by the host's own extent (clamped = through).
-    // A blind depth that already overshoots the extent is FINE (SCHEMA §7.3) —
-    // it simply becomes a through hole; nothing here clamps it back.
-    if (dims.depth <= 0.0) {
-        dims.depth = through_all_length(origin, axis, target_shape);
-    }
+        if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
 
-    if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
+        // --- tool solid (drill + the conditional cb cylinder / cs cone), fused ---
+        std::string tool_err;
+        const TopoDS_Shape tool = build_hole_tool(origin, axis, dims, tool_err);
+        if (tool.IsNull()) {
+            return OpOutcome::fail("OP_FAILED",
+                                   tool_err.empty() ? "Hole tool solid is null" : tool_err);
+        }
+        tools.push_back(tool);
+    } else {
+        // Every seat is fenced exactly like a single `point`, but a seat that
+        // fails is a per-seat NeedsRepair item rather than an op failure: one
+        // stale seat on a 200-hole flange must not block the other 199. The
+        // surviving seats' UNFUSED pieces form one tool set for one Cut.
+        const json& pts = params["points"];
+        if (!pts.is_array() || pts.empty()) {
+            return OpOutcome::fail("OP_FAILED", "Hole points must be a non-empty array");
+        }
+        if (pts.size() > kMaxSeats) {
+            return OpOutcome::fail("OP_FAILED", "Hole points exceeds " +
+                                                    std::to_string(kMaxSeats) + " seats");
+        }
+        std::vector<gp_Pnt> frozen(pts.size());
+        for (std::size_t k = 0; k < pts.size(); ++k) {
+            const std::string what = "points[" + std::to_string(k) + "]";
+            if (std::string reason = read_point(pts[k], what, frozen[k]); !reason.empty()) {
+                return OpOutcome::fail("OP_FAILED", reason);
+            }
+        }
 
-    // --- tool solid (drill + the conditional cb cylinder / cs cone), fused ---
-    std::string tool_err;
-    const TopoDS_Shape tool = build_hole_tool(origin, axis, dims, tool_err);
-    if (tool.IsNull()) {
-        return OpOutcome::fail("OP_FAILED", tool_err.empty() ? "Hole tool solid is null" : tool_err);
+        Bnd_Box host_box;
+        BRepBndLib::Add(target_shape, host_box);
+        for (std::size_t k = 0; k < frozen.size(); ++k) {
+            if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
+            gp_Pnt origin;
+            if (std::string reason = seat_on_face(face, frozen[k], origin); !reason.empty()) {
+                out.needs_repair.push_back(
+                    seat_repair(op_id, k, face_element_id, frozen[k], reason));
+                continue;
+            }
+            HoleDims seat = dims;
+            if (seat.depth <= 0.0) seat.depth = through_all_length(origin, axis, host_box);
+            std::string tool_err;
+            std::vector<TopoDS_Shape> pieces = build_hole_tool_pieces(origin, axis, seat, tool_err);
+            if (pieces.empty()) {
+                return OpOutcome::fail("OP_FAILED",
+                                       tool_err.empty() ? "Hole tool solid is null" : tool_err);
+            }
+            for (TopoDS_Shape& p : pieces) tools.push_back(std::move(p));
+        }
+        // No seat survived ⇒ NeedsRepair STATE only, exactly like an unresolved face.
+        if (tools.empty()) return out;
     }
 
     // --- ONE cut against the host, builder kept alive for history ---
     std::shared_ptr<BRepBuilderAPI_MakeShape> builder;
-    BooleanResult br = checked_boolean(target_shape, tool, app::BooleanMode::Cut, ctx.parallel,
+    BooleanResult br = checked_boolean(target_shape, tools, app::BooleanMode::Cut, ctx.parallel,
                                        ctx.occt_options, ctx.cancel, builder);
     if (br.error_code == "CANCELLED") return OpOutcome::cancelled();
     if (!br.error_code.empty()) {
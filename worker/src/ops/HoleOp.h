@@ -21,9 +21,15 @@
 //      point safe: a face that slid within its own plane keeps the hole put, while
 //      a face that moved out from under the point fails loudly instead of drilling
 //      through empty space.
+//      `params.points` (a non-empty `[[x,y,z], …]`, exclusive with `point`) drills
+//      every seat in ONE op. Each seat gets the same fence + boundary test, but a
+//      failing seat becomes a per-seat NeedsRepair item (`<opId>.seat<k>`) and is
+//      skipped; the rest still drill. No surviving seat ⇒ NeedsRepair only.
 //   5. axis = the face's INWARD normal (−outward). Never stored — a stored axis
 //      and a re-resolved face can disagree.
 //   6. tool solid (`HoleTool.h`) → ONE `checked_boolean` Cut against the host.
+//      Multi-seat passes every seat's UNFUSED pieces as one tool set, so N seats
+//      still cost one general-fuse run, one audit and one history fold.
 //   7. publish MODIFIED host (id preserved, OCCT history folded into its
 //      partition) — SCHEMA §7.3: "lineage = modified on targetBodyId, nothing
 //      minted". A Hole never creates, never splits, never renames a body.
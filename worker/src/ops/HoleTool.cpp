@@ -50,27 +50,27 @@ double through_all_length(const gp_Pnt& origin, const gp_Dir& axis, const TopoDS
     // Mirrors ExtrudeOp::through_all_distance: bound the drill by the host's own
     // extent rather than a magic length, so the boolean never works with a
     // kilometre-long tool on a millimetre part.
-    if (!target.IsNull()) {
-        Bnd_Box box;
-        BRepBndLib::Add(target, box);
-        if (!box.IsVoid()) {
-            Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
-            box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
-            double max_proj = 0.0;
-            for (int corner = 0; corner < 8; ++corner) {
-                const gp_Pnt p((corner & 1) ? xmax : xmin, (corner & 2) ? ymax : ymin,
-                               (corner & 4) ? zmax : zmin);
-                max_proj = std::max(max_proj, gp_Vec(origin, p).Dot(gp_Vec(axis)));
-            }
-            const double diag = gp_Pnt(xmin, ymin, zmin).Distance(gp_Pnt(xmax, ymax, zmax));
-            return std::max(max_proj, kMinValue) + 0.01 * diag + 1.0;
-        }
+    Bnd_Box box;
+    if (!target.IsNull()) BRepBndLib::Add(target, box);
+    return through_all_length(origin, axis, box);
+}
+
+double through_all_length(const gp_Pnt& origin, const gp_Dir& axis, const Bnd_Box& host_box) {
+    if (host_box.IsVoid()) return kThroughAllFallback;
+    Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+    host_box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    double max_proj = 0.0;
+    for (int corner = 0; corner < 8; ++corner) {
+        const gp_Pnt p((corner & 1) ? xmax : xmin, (corner & 2) ? ymax : ymin,
+                       (corner & 4) ? zmax : zmin);
+        max_proj = std::max(max_proj, gp_Vec(origin, p).Dot(gp_Vec(axis)));
     }
-    return kThroughAllFallback;
+    const double diag = gp_Pnt(xmin, ymin, zmin).Distance(gp_Pnt(xmax, ymax, zmax));
+    return std::max(max_proj, kMinValue) + 0.01 * diag + 1.0;
 }
 
-TopoDS_Shape build_hole_tool(const gp_Pnt& origin, const gp_Dir& axis, const HoleDims& dims,
-                             std::string& err) {
+std::vector<TopoDS_Shape> build_hole_tool_pieces(const gp_Pnt& origin, const gp_Dir& axis,
+                                                 const HoleDims& dims, std::string& err) {
     const double drill_r = dims.diameter * 0.5;
     if (drill_r < kMinValue || dims.depth < kMinValue) {
         err = "Hole tool has a degenerate drill (diameter/depth below 1e-3)";
@@ -97,7 +97,23 @@ TopoDS_Shape build_hole_tool(const gp_Pnt& origin, const gp_Dir& axis, const Hol
                                                   cs_depth + kFaceOvershoot)
                                  .Shape());
         }
+        return pieces;
+    } catch (const Standard_Failure& f) {
+        err = std::string("Hole tool solid could not be built: ") +
+              (f.GetMessageString() ? f.GetMessageString() : "OCCT");
+        return {};
+    } catch (...) {
+        err = "Hole tool solid could not be built";
+        return {};
+    }
+}
 
+TopoDS_Shape build_hole_tool(const gp_Pnt& origin, const gp_Dir& axis, const HoleDims& dims,
+                             std::string& err) {
+    const std::vector<TopoDS_Shape> pieces = build_hole_tool_pieces(origin, axis, dims, err);
+    if (pieces.empty()) return {};
+
+    try {
         TopoDS_Shape tool = pieces.front();
         for (std::size_t i = 1; i < pieces.size(); ++i) {
             BRepAlgoAPI_Fuse fuse(tool, pieces[i]);
@@ -35,10 +35,18 @@
 // the farthest projection of the host's bbox corners along the axis, plus a margin,
 // mirroring `ExtrudeOp`'s `through_all_distance`. Bounded — never `1e6` — so the
 // boolean stays numerically sane.
+//
+// MULTI-SEAT. A `points[]` Hole drills every seat with ONE Cut, so it asks for the
+// UNFUSED pieces (`build_hole_tool_pieces`) and hands all of them to the general
+// fuse as one tool set — pre-fusing N tools pairwise would cost N booleans before
+// the cut even starts. The host bbox is measured once and shared by every seat's
+// through-all length.
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include <Bnd_Box.hxx>
 #include <TopoDS_Shape.hxx>
 #include <gp_Dir.hxx>
 #include <gp_Pnt.hxx>
@@ -73,6 +81,13 @@ double countersink_depth(const HoleDims& d);
 // `ExtrudeOp::through_all_distance` margin). Falls back to a finite constant when
 // the bbox is void. Always > 0.
 double through_all_length(const gp_Pnt& origin, const gp_Dir& axis, const TopoDS_Shape& target);
+// Same, against a host bbox the caller already measured (multi-seat: once per op).
+double through_all_length(const gp_Pnt& origin, const gp_Dir& axis, const Bnd_Box& host_box);
+
+// The tool's pieces — drill cylinder, then the conditional cb cylinder / cs cone —
+// UNFUSED. Empty with `err` filled on failure (same reasons as `build_hole_tool`).
+std::vector<TopoDS_Shape> build_hole_tool_pieces(const gp_Pnt& origin, const gp_Dir& axis,
+                                                 const HoleDims& dims, std::string& err);
 
 // Build the fused cutting solid. Returns a null shape and fills `err` with a named,
 // human-facing reason on failure (OCCT throw, degenerate radius, fuse failure).
@@ -0,0 +1,37 @@
+// Instancing.cpp — see Instancing.h.
+#include "ops/Instancing.h"
+
+#include <cmath>
+
+#include <BRepAlgoAPI_BuilderAlgo.hxx>
+#include <TopLoc_Location.hxx>
+
+namespace onecad::ops {
+
+namespace {
+
+// A rigid motion's scale factor is exactly 1 up to the rounding of the rotation
+// that produced it; anything further off is a genuine scale.
+constexpr double kScaleTol = 1e-12;
+
+}  // namespace
+
+bool instancing_enabled(const nlohmann::json& occt_options) {
+    return occt_options.is_object() && occt_options.contains("instancing") &&
+           occt_options["instancing"].is_boolean() && occt_options["instancing"].get<bool>();
+}
+
+bool is_rigid(const gp_Trsf& trsf) {
+    return std::abs(trsf.ScaleFactor() - 1.0) <= kScaleTol && !trsf.IsNegative();
+}
+
+TopoDS_Shape place_instance(const TopoDS_Shape& shape, const gp_Trsf& trsf) {
+    if (shape.IsNull() || !is_rigid(trsf)) return {};
+    return shape.Moved(TopLoc_Location(trsf));
+}
+
+void protect_shared_arguments(BRepAlgoAPI_BuilderAlgo& algo, const nlohmann::json& occt_options) {
+    if (instancing_enabled(occt_options)) algo.SetNonDestructive(Standard_True);
+}
+
+}  // namespace onecad::ops
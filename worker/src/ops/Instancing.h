@@ -0,0 +1,70 @@
+// Instancing.h — shared-prototype placement for placed components and unfused
+// copies (`determinism.occtOptions.instancing`, SCHEMA §7.3).
+//
+// Without it every placement is a deep copy: `PlaceComponent` bakes the placement
+// into fresh geometry with `BRepBuilderAPI_Transform(..., Copy=True)` (the
+// generator run itself is cached, GeneratorCache.h); `TransformBody {copy:true}`
+// and the unfused pattern paths do the same per instance. 500 identical M6 screws
+// are 500 geometry copies and — because every copy owns its own TFaces — 500
+// BRepMesh runs.
+//
+// With it, a placement is the SAME TShape under a `TopLoc_Location`:
+//
+//   * `PlaceComponent` takes its ONE prototype per (generatorId, source.params)
+//     from `generator_cache()` (GeneratorCache.h); every placement is
+//     `prototype.Moved(loc)` instead of a deep copy of it.
+//   * `TransformBody {copy:true}` and unfused Linear/Circular patterns re-locate
+//     the source instead of copying it.
+//   * `Tessellate {instances:true}` meshes the un-located prototype with a
+//     deflection derived from the prototype's own bbox (Tessellate.h), so BRepMesh
+//     stores ONE triangulation on the shared TFaces and every further instance
+//     finds it already meshed, and ships an instance as a transform of an earlier
+//     body's mesh instead of a second MESH1 blob.
+//   * STEP export needs nothing: XCAF's `AddShape` already turns a located shape
+//     into a reference to one prototype label.
+//
+// ── Why opt-in ───────────────────────────────────────────────────────────────
+// The placed geometry is the same body either way, but it is not the same BITS:
+// a baked transform recomputes the surfaces, a location composes at evaluation
+// time, so volume/bbox differ in the last ulps and a geometry signature computed
+// over a copied placement would drift. `occtOptions` is history-hashed (SCHEMA
+// §6), so a record opts in once and replays identically forever.
+//
+// ── Sharing discipline ───────────────────────────────────────────────────────
+// Only RIGID placements are expressed as locations (`is_rigid`): a scaled or
+// mirrored `gp_Trsf` is not a valid BRep location and keeps the copy path. A
+// generator prototype is the cache entry's OWN topological copy
+// (`GeneratorCache::instance_prototype`), so instanced documents never touch the
+// solid the deep-copy path copies. Every modeling op builds a new shape, but a
+// boolean also raises tolerances on its ARGUMENTS' edges and vertices in place;
+// under instancing those may be shared by every placement of the prototype, so
+// the booleans that can take a document body run non-destructively
+// (`protect_shared_arguments`) and copy what they would grow.
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+#include <gp_Trsf.hxx>
+
+#include "nlohmann/json.hpp"
+
+class BRepAlgoAPI_BuilderAlgo;
+
+namespace onecad::ops {
+
+// `determinism.occtOptions.instancing` — absent/non-boolean ⇒ false.
+bool instancing_enabled(const nlohmann::json& occt_options);
+
+// True iff `trsf` is a proper rigid motion (rotation + translation, unit scale,
+// determinant +1) — i.e. representable as a `TopLoc_Location`.
+bool is_rigid(const gp_Trsf& trsf);
+
+// `shape` re-located by `trsf` (composed on top of any location it already has).
+// Shares every TShape with `shape`. Null when `trsf` is not rigid.
+TopoDS_Shape place_instance(const TopoDS_Shape& shape, const gp_Trsf& trsf);
+
+// Leave `algo`'s arguments untouched (`SetNonDestructive`) when `occt_options`
+// opts into instancing. Call before `Build`; without the option a no-op, so a
+// document that does not opt in builds exactly as before.
+void protect_shared_arguments(BRepAlgoAPI_BuilderAlgo& algo, const nlohmann::json& occt_options);
+
+}  // namespace onecad::ops
@@ -7,12 +7,14 @@
 #include <BRepAlgoAPI_Fuse.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
 #include <Standard_Failure.hxx>
+#include <TopTools_ListOfShape.hxx>
 #include <TopoDS_Shape.hxx>
 #include <gp_Ax2.hxx>
 #include <gp_Dir.hxx>
 #include <gp_Pnt.hxx>
 #include <gp_Trsf.hxx>
 
+#include "ops/Instancing.h"
 #include "ops/OpCommon.h"
 
 namespace onecad::ops {
@@ -78,7 +80,13 @@ OpOutcome execute_mirror_body(OpContext& ctx, const json& op, const std::string&
         result = mirror.Shape();
 
         if (fuse_with_original) {
-            BRepAlgoAPI_Fuse fuse(source, result);
+            BRepAlgoAPI_Fuse fuse;
+            TopTools_ListOfShape args, tools;
+            args.Append(source);
+            tools.Append(result);
+            fuse.SetArguments(args);
+            fuse.SetTools(tools);
+            protect_shared_arguments(fuse, ctx.occt_options);
             fuse.Build();
             if (!fuse.IsDone() || fuse.Shape().IsNull()) {
                 return OpOutcome::fail("OP_FAILED", "MirrorBody fuse failed");
@@ -30,7 +30,11 @@
 #include "elementmap/Ladder.h"
 #include "kernel/validation/ShapeAudit.h"
 #include "ops/CancelProgress.h"
+#include "ops/Instancing.h"
+#include "ops/ProfileCache.h"
 #include "sketch/WireSketch.h"
+#include "util/Stats.h"
+#include "util/Trace.h"
 
 namespace onecad::ops {
 
@@ -311,10 +315,11 @@ std::vector<json> operation_ref_ownership_repairs(const json& op, const std::str
     return out;
 }
 
-std::optional<TopoDS_Face> build_profile_face(const json& sketch_params,
-                                              const std::string& region_id,
-                                              std::optional<int> region_identity_version,
-                                              std::string& err) {
+namespace {
+
+std::optional<TopoDS_Face> build_profile_face_uncached(
+    const json& sketch_params, const std::string& region_id,
+    std::optional<int> region_identity_version, std::string& err) {
     // Sketch params → live Sketch (plane + entities + constraints). Mirrors
     // RegenerationEngine.cpp:1639-1667 buildFaceFromSketchRegion, but the sketch
     // is supplied inline in the plan (deterministic replay) rather than looked up
@@ -435,6 +440,34 @@ std::optional<TopoDS_Face> build_profile_face(const json& sketch_params,
     return fr.face;
 }
 
+}  // namespace
+
+std::optional<TopoDS_Face> build_profile_face(const std::string& sketch_id,
+                                              const json& sketch_params,
+                                              const std::string& region_id,
+                                              std::optional<int> region_identity_version,
+                                              std::string& err) {
+    // The profile is a pure function of (params, region selection); see
+    // ProfileCache.h for the key and why a hit hands out a topological copy.
+    // Failures are never cached, so their diagnostics are always re-derived.
+    const ProfileCacheKey key =
+        ProfileCacheKey::of(sketch_id, sketch_params, region_id, region_identity_version);
+    ProfileFaceCache& cache = profile_face_cache();
+    if (std::optional<TopoDS_Face> hit = cache.find(key)) return hit;
+    std::optional<TopoDS_Face> built =
+        build_profile_face_uncached(sketch_params, region_id, region_identity_version, err);
+    if (built) cache.insert(key, *built);
+    return built;
+}
+
+std::optional<TopoDS_Face> build_profile_face(const json& sketch_params,
+                                              const std::string& region_id,
+                                              std::optional<int> region_identity_version,
+                                              std::string& err) {
+    return build_profile_face(read_str(sketch_params, "sketchId"), sketch_params, region_id,
+                              region_identity_version, err);
+}
+
 std::optional<TopoDS_Face> build_profile_face(const json& sketch_params,
                                               const std::string& region_id, std::string& err) {
     return build_profile_face(sketch_params, region_id, std::nullopt, err);
@@ -470,8 +503,21 @@ BooleanResult checked_boolean(const TopoDS_Shape& target, const TopoDS_Shape& to
                               app::BooleanMode mode, bool parallel, const json& occt_options,
                               const onecad::CancelToken* cancel,
                               std::shared_ptr<BRepBuilderAPI_MakeShape>& builder_out) {
+    return checked_boolean(target, std::vector<TopoDS_Shape>{tool}, mode, parallel, occt_options,
+                           cancel, builder_out);
+}
+
+BooleanResult checked_boolean(const TopoDS_Shape& target, const std::vector<TopoDS_Shape>& tool_set,
+                              app::BooleanMode mode, bool parallel, const json& occt_options,
+                              const onecad::CancelToken* cancel,
+                              std::shared_ptr<BRepBuilderAPI_MakeShape>& builder_out) {
+    static stats::Histogram& timing = stats::histogram("boolean");
+    const stats::ScopedTimer timer(timing);
+    const trace::Span span("boolean");
     BooleanResult out;
-    if (target.IsNull() || tool.IsNull()) {
+    bool null_tool = tool_set.empty();
+    for (const TopoDS_Shape& t : tool_set) null_tool = null_tool || t.IsNull();
+    if (target.IsNull() || null_tool) {
         out.error_code = "OP_FAILED";
         out.error_message = "boolean input is null";
         return out;
@@ -490,13 +536,14 @@ BooleanResult checked_boolean(const TopoDS_Shape& target, const TopoDS_Shape& to
     auto algo = std::make_shared<BRepAlgoAPI_BooleanOperation>();
     TopTools_ListOfShape args, tools;
     args.Append(target);
-    tools.Append(tool);
+    for (const TopoDS_Shape& t : tool_set) tools.Append(t);
     algo->SetArguments(args);
     algo->SetTools(tools);
     algo->SetOperation(bop);
     // Determinism: single-threaded in determinism mode (Invariant 5). §7.3
     // occtOptions apply to both modes.
     algo->SetRunParallel(parallel ? Standard_True : Standard_False);
+    protect_shared_arguments(*algo, occt_options);
     if (occt_options.is_object()) {
         if (occt_options.contains("fuzzyValue") && occt_options["fuzzyValue"].is_number()) {
             const double fuzz = occt_options["fuzzyValue"].get<double>();
@@ -92,6 +92,15 @@ std::optional<TopoDS_Face> build_profile_face(const nlohmann::json& sketch_param
                                               std::optional<int> region_identity_version,
                                               std::string& err);
 
+// As above, for the plan's Sketch op `sketch_id` resolved to (`OpContext::sketches`
+// key). The profile cache files the face under that id, the one the solver lane
+// invalidates on a new revision; the overload above uses `params.sketchId`.
+std::optional<TopoDS_Face> build_profile_face(const std::string& sketch_id,
+                                              const nlohmann::json& sketch_params,
+                                              const std::string& region_id,
+                                              std::optional<int> region_identity_version,
+                                              std::string& err);
+
 // Compatibility overload for direct V1 callers and fixtures.
 std::optional<TopoDS_Face> build_profile_face(const nlohmann::json& sketch_params,
                                               const std::string& region_id, std::string& err);
@@ -119,6 +128,14 @@ BooleanResult checked_boolean(const TopoDS_Shape& target, const TopoDS_Shape& to
                               const nlohmann::json& occt_options, const onecad::CancelToken* cancel,
                               std::shared_ptr<BRepBuilderAPI_MakeShape>& builder_out);
 
+// Same, with a multi-argument TOOL SET: one general-fuse run of target ⊕ {tools}
+// (tools may overlap each other). One build, one audit, one history — a
+// multi-seat Hole cuts every seat this way instead of N sequential booleans.
+BooleanResult checked_boolean(const TopoDS_Shape& target, const std::vector<TopoDS_Shape>& tools,
+                              app::BooleanMode mode, bool parallel,
+                              const nlohmann::json& occt_options, const onecad::CancelToken* cancel,
+                              std::shared_ptr<BRepBuilderAPI_MakeShape>& builder_out);
+
 // One solid of an N-body result, paired with the quantized geometric key its
 // ordinal was assigned by (VF-B6 identity-tripwire evidence).
 struct RankedSolid {
@@ -8,6 +8,7 @@
 #include <BRepAlgoAPI_Fuse.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
 #include <Standard_Failure.hxx>
+#include <TopTools_ListOfShape.hxx>
 #include <TopoDS_Compound.hxx>
 #include <TopoDS_Shape.hxx>
 #include <gp_Ax1.hxx>
@@ -16,6 +17,7 @@
 #include <gp_Trsf.hxx>
 #include <gp_Vec.hxx>
 
+#include "ops/Instancing.h"
 #include "ops/OpCommon.h"
 
 namespace onecad::ops {
@@ -97,22 +99,31 @@ OpOutcome build_pattern(OpContext& ctx, const json& op, const std::string& op_id
     if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
     OpOutcome out;
 
+    // Instance i as a deep copy — or, for an instance that stays its own shape
+    // under `occtOptions.instancing`, the source re-located (Instancing.h).
+    const bool instancing = instancing_enabled(ctx.occt_options) && !fuse_result;
+    const auto instance_at = [&](int i) -> TopoDS_Shape {
+        if (instancing) return place_instance(source, xform(i));
+        BRepBuilderAPI_Transform xf(source, xform(i), Standard_True);
+        return xf.IsDone() ? xf.Shape() : TopoDS_Shape();
+    };
+
     if (result_policy == PatternResultPolicy::V2 && !fuse_result) {
         for (int i = 1; i < count; ++i) {
             if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
-            BRepBuilderAPI_Transform xf(source, xform(i), Standard_True);
-            if (!xf.IsDone() || xf.Shape().IsNull()) {
+            const TopoDS_Shape instance = instance_at(i);
+            if (instance.IsNull()) {
                 return OpOutcome::fail("OP_FAILED", std::string(op_name) +
                                                         " transform failed at instance " +
                                                         std::to_string(i));
             }
             const kernel::validation::PublicationDecision decision = publication_decision(
-                xf.Shape(), kernel::validation::single_solid_policy(
+                instance, kernel::validation::single_solid_policy(
                                 std::string(op_name) + " v2 child",
                                 kernel::validation::PublicationTier::TierA));
             if (!decision.publishable()) return OpOutcome::fail(decision.code, decision.message);
             const std::string bid = "body_" + op_id + ":" + std::to_string(i - 1);
-            ctx.bodies.create(bid, op_id, xf.Shape());
+            ctx.bodies.create(bid, op_id, instance);
             out.body_events.push_back({"created", bid});
             out.body_ids.push_back(bid);
         }
@@ -130,14 +141,20 @@ OpOutcome build_pattern(OpContext& ctx, const json& op, const std::string& op_id
         }
         for (int i = 1; i < count; ++i) {
             if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
-            BRepBuilderAPI_Transform xf(source, xform(i), Standard_True);
-            if (!xf.IsDone() || xf.Shape().IsNull()) {
+            const TopoDS_Shape instance = instance_at(i);
+            if (instance.IsNull()) {
                 return OpOutcome::fail("OP_FAILED", std::string(op_name) +
                                                         " transform failed at instance " +
                                                         std::to_string(i));
             }
             if (fuse_result) {
-                BRepAlgoAPI_Fuse fuse(result, xf.Shape());
+                BRepAlgoAPI_Fuse fuse;
+                TopTools_ListOfShape args, tools;
+                args.Append(result);
+                tools.Append(instance);
+                fuse.SetArguments(args);
+                fuse.SetTools(tools);
+                protect_shared_arguments(fuse, ctx.occt_options);
                 fuse.Build();
                 if (!fuse.IsDone() || fuse.Shape().IsNull()) {
                     return OpOutcome::fail("OP_FAILED", std::string(op_name) +
@@ -150,7 +167,7 @@ OpOutcome build_pattern(OpContext& ctx, const json& op, const std::string& op_id
                                                 &out.needs_repair);
                 }
             } else {
-                cbuilder.Add(compound, xf.Shape());
+                cbuilder.Add(compound, instance);
             }
         }
         if (!fuse_result) result = compound;
@@ -22,6 +22,10 @@
 // patterns modify source in place. Other present numeric versions refuse
 // `UNSUPPORTED_PATTERN_RESULT_POLICY_VERSION`; records remain lossless in Rust.
 // Pattern faces remain ID-on-demand.
+//
+// Under `determinism.occtOptions.instancing` the UNFUSED instances are the source
+// re-located (shared TShape + `TopLoc_Location`, `Instancing.h`) rather than deep
+// copies; fused patterns still need real geometry for the fuse.
 #pragma once
 
 #include <string>
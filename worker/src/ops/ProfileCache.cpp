@@ -0,0 +1,131 @@
+// ProfileCache.cpp — see ProfileCache.h.
+#include "ops/ProfileCache.h"
+
+#include <BRepBuilderAPI_Copy.hxx>
+#include <Standard_Failure.hxx>
+#include <TopoDS.hxx>
+
+#include "util/Hashing.h"
+
+namespace onecad::ops {
+
+ProfileCacheKey ProfileCacheKey::of(const std::string& sketch_id,
+                                    const nlohmann::json& sketch_params,
+                                    const std::string& region_id,
+                                    std::optional<int> region_identity_version) {
+    ProfileCacheKey key;
+    key.sketch_id = sketch_id;
+    key.wire_hash = hashing::fnv1a(sketch_params.dump());
+    key.region_id = region_id;
+    key.region_identity_version = region_identity_version.value_or(0);
+    return key;
+}
+
+ProfileCacheKey ProfileCacheKey::of(const nlohmann::json& sketch_params,
+                                    const std::string& region_id,
+                                    std::optional<int> region_identity_version) {
+    std::string sketch_id;
+    if (sketch_params.is_object() && sketch_params.contains("sketchId") &&
+        sketch_params["sketchId"].is_string()) {
+        sketch_id = sketch_params["sketchId"].get<std::string>();
+    }
+    return of(sketch_id, sketch_params, region_id, region_identity_version);
+}
+
+std::string ProfileCacheKey::flat() const {
+    // '\x1f' (unit separator) cannot occur in a wire id, so the fields never alias.
+    return sketch_id + '\x1f' + hashing::hex16(wire_hash) + '\x1f' + region_id + '\x1f' +
+           std::to_string(region_identity_version);
+}
+
+std::optional<TopoDS_Face> ProfileFaceCache::find(const ProfileCacheKey& key) {
+    TopoDS_Face cached;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto it = index_.find(key.flat());
+        if (it == index_.end()) {
+            ++misses_;
+            return std::nullopt;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second);
+        ++hits_;
+        cached = it->second->face;
+    }
+    // Copy outside the lock: the handle keeps the cached TShape alive even if a
+    // concurrent invalidation drops the entry meanwhile.
+    try {
+        BRepBuilderAPI_Copy copy(cached, /*copyGeom=*/Standard_False);
+        if (!copy.IsDone()) return std::nullopt;
+        return TopoDS::Face(copy.Shape());
+    } catch (const Standard_Failure&) {
+        return std::nullopt;  // degrade to a rebuild, never to a wrong face
+    }
+}
+
+void ProfileFaceCache::insert(const ProfileCacheKey& key, const TopoDS_Face& built) {
+    if (capacity_ == 0 || built.IsNull()) return;
+    // The builder's caller goes on to use `built` itself, so the cache keeps its
+    // own topology for the same reason `find` hands out one.
+    TopoDS_Face face;
+    try {
+        BRepBuilderAPI_Copy copy(built, /*copyGeom=*/Standard_False);
+        if (!copy.IsDone()) return;
+        face = TopoDS::Face(copy.Shape());
+    } catch (const Standard_Failure&) {
+        return;
+    }
+    std::string flat = key.flat();
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = index_.find(flat);
+    if (it != index_.end()) {
+        it->second->face = face;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    lru_.push_front(Entry{flat, key.sketch_id, face});
+    index_.emplace(std::move(flat), lru_.begin());
+    while (lru_.size() > capacity_) {
+        index_.erase(lru_.back().flat_key);
+        lru_.pop_back();
+    }
+}
+
+void ProfileFaceCache::invalidate_sketch(const std::string& sketch_id) {
+    std::lock_guard<std::mutex> lk(mu_);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->sketch_id == sketch_id) {
+            index_.erase(it->flat_key);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ProfileFaceCache::clear() {
+    std::lock_guard<std::mutex> lk(mu_);
+    lru_.clear();
+    index_.clear();
+}
+
+std::size_t ProfileFaceCache::size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return lru_.size();
+}
+
+std::uint64_t ProfileFaceCache::hits() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return hits_;
+}
+
+std::uint64_t ProfileFaceCache::misses() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return misses_;
+}
+
+ProfileFaceCache& profile_face_cache() {
+    static ProfileFaceCache cache;
+    return cache;
+}
+
+}  // namespace onecad::ops
@@ -0,0 +1,105 @@
+// ProfileCache.h — bounded, process-wide cache of built sketch profile faces.
+//
+// Every Extrude / Revolve execution and every PreviewOp tick resolves its profile
+// through `build_profile_face` (OpCommon.h): `wire::translate` → full PlaneGCS
+// solve → `LoopDetector::detect` → `buildRegionTable` → `FaceBuilder`. During a
+// depth drag none of those inputs change between ticks, so the whole pipeline is
+// re-run for a face that is bit-for-bit the one it built last time.
+//
+// ── Key ──────────────────────────────────────────────────────────────────────
+// (sketchId, wire hash, regionId, regionIdentityVersion). The sketchId is the one
+// the plan RESOLVED the Sketch op to — PlanExecutor's "sk_"+opId when its params
+// carry none — since that is the id the solver lane invalidates. The wire hash is FNV-1a
+// over the canonical dump of the sketch params (`nlohmann::json` objects are
+// key-sorted, so the dump is canonical) and covers the plane, every entity and
+// every constraint — i.e. everything the profile is a function of. A hit is
+// therefore correct by construction, whatever produced the params (a plan's
+// `Sketch` op, or PreviewOp seeding from the `SketchStore`).
+//
+// ── Invalidation ─────────────────────────────────────────────────────────────
+// Content keying makes a stale hit impossible; explicit invalidation is about
+// memory. The solver lane drops a sketch's entries when it commits a new
+// revision (SketchUpsert / EndGesture), so superseded revisions never linger until
+// LRU eviction. The cache is bounded by entry count (least-recently-used evicted).
+//
+// ── Sharing discipline ───────────────────────────────────────────────────────
+// The cache stores, and a hit returns, TOPOLOGICAL copies of the built face
+// (`BRepBuilderAPI_Copy` with geometry shared). Boolean builders may raise
+// tolerances on their arguments' sub-shapes in place; handing the cached TShape
+// itself to two ops would let one op's tolerance growth leak into the next op's
+// input. Copying a single face's
+// topology is negligible next to the detection pipeline it replaces.
+//
+// Thread-safety: self-locked. The kernel lane reads/inserts, the solver lane
+// invalidates.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <TopoDS_Face.hxx>
+
+#include "nlohmann/json.hpp"
+
+namespace onecad::ops {
+
+struct ProfileCacheKey {
+    std::string sketch_id;           // the plan's resolved sketch id
+    std::uint64_t wire_hash = 0;     // FNV-1a of the canonical sketch-params dump
+    std::string region_id;
+    int region_identity_version = 0;  // 0 == absent (legacy detector)
+
+    // Key for the sketch `sketch_id` resolved to, its `sketch_params`, and the
+    // op's region selection.
+    static ProfileCacheKey of(const std::string& sketch_id, const nlohmann::json& sketch_params,
+                              const std::string& region_id,
+                              std::optional<int> region_identity_version);
+    // As above, keyed on `params.sketchId` ("" when the params carry none).
+    static ProfileCacheKey of(const nlohmann::json& sketch_params, const std::string& region_id,
+                              std::optional<int> region_identity_version);
+
+    std::string flat() const;
+};
+
+class ProfileFaceCache {
+public:
+    static constexpr std::size_t kDefaultCapacity = 64;
+
+    explicit ProfileFaceCache(std::size_t capacity = kDefaultCapacity) : capacity_(capacity) {}
+
+    // A fresh-topology copy of the cached face, or nullopt on a miss.
+    std::optional<TopoDS_Face> find(const ProfileCacheKey& key);
+    void insert(const ProfileCacheKey& key, const TopoDS_Face& built);
+
+    // Drop every entry built from `sketch_id` (a new committed revision).
+    void invalidate_sketch(const std::string& sketch_id);
+    void clear();
+
+    std::size_t size() const;
+    std::uint64_t hits() const;
+    std::uint64_t misses() const;
+
+private:
+    struct Entry {
+        std::string flat_key;
+        std::string sketch_id;
+        TopoDS_Face face;
+    };
+
+    mutable std::mutex mu_;
+    std::size_t capacity_;
+    std::list<Entry> lru_;  // front == most recently used
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+};
+
+// The process-wide instance `build_profile_face` consults.
+ProfileFaceCache& profile_face_cache();
+
+}  // namespace onecad::ops
@@ -47,13 +47,17 @@ std::optional<app::BooleanMode> boolean_mode_of(const std::string& s) {
     return std::nullopt;
 }
 
+// `resolved_id` (optional) receives the plan id the sketch was found under.
 const json* find_sketch(const OpContext& ctx, const std::string& sid_in,
-                        const std::string& fallback_last) {
+                        const std::string& fallback_last, std::string* resolved_id = nullptr) {
     std::string sid = sid_in;
     if (sid.empty()) sid = fallback_last;
     if (!ctx.sketches) return nullptr;
     for (const auto& [id, p] : *ctx.sketches) {
-        if (id == sid) return &p;
+        if (id == sid) {
+            if (resolved_id) *resolved_id = id;
+            return &p;
+        }
     }
     return nullptr;
 }
@@ -257,8 +261,10 @@ OpOutcome execute_revolve(OpContext& ctx, const json& op, const std::string& op_
     const double angle_rad = angle_deg * M_PI / 180.0;  // no 360 special-case (parity)
 
     // --- profile face ---
+    std::string sketch_id;
     const json* sketch_params = find_sketch(ctx, read_str(params, "sketchId"),
-                                            ctx.last_sketch_id ? *ctx.last_sketch_id : "");
+                                            ctx.last_sketch_id ? *ctx.last_sketch_id : "",
+                                            &sketch_id);
     if (!sketch_params) {
         return OpOutcome::fail("REF_UNRESOLVED", "Revolve: profile sketch not found in plan");
     }
@@ -271,7 +277,7 @@ OpOutcome execute_revolve(OpContext& ctx, const json& op, const std::string& op_
     }
     std::string perr;
     std::optional<TopoDS_Face> profile =
-        build_profile_face(*sketch_params, read_str(params, "regionId"),
+        build_profile_face(sketch_id, *sketch_params, read_str(params, "regionId"),
                            region_identity_version, perr);
     if (!profile) return OpOutcome::fail("OP_FAILED", perr);
 
@@ -14,6 +14,7 @@
 #include <gp_Trsf.hxx>
 #include <gp_Vec.hxx>
 
+#include "ops/Instancing.h"
 #include "ops/OpCommon.h"
 
 namespace onecad::ops {
@@ -178,6 +179,7 @@ OpOutcome execute_transform_body(OpContext& ctx, const json& op, const std::stri
 
     OpOutcome out;
     const std::size_t n = placement.targets.size();
+    const bool deep_copy = placement.copy && !instancing_enabled(ctx.occt_options);
     for (std::size_t k = 0; k < n; ++k) {
         if (ctx.cancel && ctx.cancel->cancelled()) return OpOutcome::cancelled();
         const std::string& target_id = placement.targets[k];
@@ -187,9 +189,10 @@ OpOutcome execute_transform_body(OpContext& ctx, const json& op, const std::stri
             // `copy: false` keeps the geometry shared and only re-locates it (an
             // isometry with determinant 1), which is both cheap and what makes
             // `Modified()` return exactly ONE image per sub-shape — the level-1
-            // rebind with zero descriptor scoring. `copy: true` must deep-copy: the
-            // source stays in the document alongside its copy.
-            builder.Perform(sources[k], placement.copy ? Standard_True : Standard_False);
+            // rebind with zero descriptor scoring. `copy: true` deep-copies: the
+            // source stays in the document alongside its copy — unless instancing
+            // lets the copy share the source's TShape under its own location.
+            builder.Perform(sources[k], deep_copy ? Standard_True : Standard_False);
             if (!builder.IsDone() || builder.Shape().IsNull()) {
                 return OpOutcome::fail("OP_FAILED",
                                        "TransformBody failed on body " + target_id);
@@ -17,6 +17,8 @@
 //   * `copy: true` — the sources are preserved (no body event) and the copies mint
 //     under the §2 N-body rule: one target ⇒ `body_<opId>`, N > 1 ⇒
 //     `body_<opId>:<k>` with `k` the target's index in `params.targets`.
+//     Under `determinism.occtOptions.instancing` a copy shares the source's TShape
+//     under a new location instead of deep-copying it (`Instancing.h`).
 #pragma once
 
 #include <string>
@@ -11,11 +11,18 @@
 #include <BRepCheck_Analyzer.hxx>
 #include <BRepPrimAPI_MakeCylinder.hxx>
 #include <BRepPrimAPI_MakePrism.hxx>
+#include <BRepTools_WireExplorer.hxx>
+#include <BRep_Tool.hxx>
 #include <Standard_Failure.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopExp.hxx>
 #include <TopoDS.hxx>
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Face.hxx>
+#include <TopoDS_Vertex.hxx>
 #include <TopoDS_Wire.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Ax3.hxx>
 #include <gp_Pln.hxx>
 #include <gp_Trsf.hxx>
 #include <gp_Vec.hxx>
@@ -39,16 +46,13 @@ std::string occt_reason(const Standard_Failure& f) {
   return (what && *what) ? what : "OCCT";
 }
 
-/// A profile point rotated into tooth `k`'s position, lifted to 3D at z = 0.
-/// The local frame is the gear's own: axis +Z, centre at the origin.
-gp_Pnt local_point(const kg::Point2d& p, double angle) {
-  const kg::Point2d r = kg::rotate(p, angle);
-  return gp_Pnt(r.x, r.y, 0.0);
-}
+/// A tooth-0 profile point lifted to 3D at z = 0. The local frame is the
+/// gear's own: axis +Z, centre at the origin.
+gp_Pnt local_point(const kg::Point2d& p) { return gp_Pnt(p.x, p.y, 0.0); }
 
 }  // namespace
 
-GearBuildResult build_gear_solid(const GearBuildSpec& spec, const gp_Ax2& frame) {
+GearBuildResult build_gear_local(const GearBuildSpec& spec) {
   GearBuildResult out;
 
   if (spec.sampleCount < 2) {
@@ -113,54 +117,87 @@ GearBuildResult build_gear_solid(const GearBuildSpec& spec, const gp_Ax2& frame)
     }
   }
 
-  // --- 2. Edges for all z teeth, built analytically -----------------------
+  // --- 2. One tooth's edges, then z located copies ---------------------------
   try {
-    BRepBuilderAPI_MakeWire wire;
-
-    for (int k = 0; k < z; ++k) {
-      const double angle = static_cast<double>(k) * phipart;
-      // The wrap-around join must reuse angle 0 EXACTLY (see GearTool.h):
-      // z·(2π/z) does not round-trip to 0 in binary floating point.
-      const double nextAngle = (k + 1 == z) ? 0.0 : static_cast<double>(k + 1) * phipart;
-
-      for (const auto& seg : tooth.segments) {
-        if (seg.size() == 2) {
-          const gp_Pnt a = local_point(seg.front(), angle);
-          const gp_Pnt b = local_point(seg.back(), angle);
-          if (a.Distance(b) <= kMinValue * 1e-3) continue;  // degenerate, skip rather than raise
-          BRepBuilderAPI_MakeEdge mk(a, b);
-          if (!mk.IsDone()) {
-            out.error = "gear profile straight segment could not be built";
-            return out;
-          }
-          wire.Add(mk.Edge());
-        } else {
-          std::vector<gp_Pnt> pts;
-          pts.reserve(seg.size());
-          for (const auto& p : seg) pts.push_back(local_point(p, angle));
-          const geom::BSplineEdgeResult e = geom::interpolated_edge(pts);
-          if (!e.ok) {
-            out.error = "gear flank could not be interpolated: " + e.error +
-                        " (try a lower sampleCount)";
-            return out;
-          }
-          wire.Add(e.edge);
-        }
-      }
-
-      // Root land: the chord from this tooth's last point to the next tooth's
-      // first. Matches the reference's 2-point run (GearTool.h).
-      const gp_Pnt landStart = local_point(toothLast, angle);
-      const gp_Pnt landEnd = local_point(toothFirst, nextAngle);
-      if (landStart.Distance(landEnd) > kMinValue * 1e-3) {
-        BRepBuilderAPI_MakeEdge mk(landStart, landEnd);
+    // The unit tooth, in tooth 0's position, as ONE connected wire so that its
+    // edges share their vertices (MakeWire merges coincident ends once, here).
+    BRepBuilderAPI_MakeWire unit;
+    for (const auto& seg : tooth.segments) {
+      if (seg.size() == 2) {
+        const gp_Pnt a = local_point(seg.front());
+        const gp_Pnt b = local_point(seg.back());
+        if (a.Distance(b) <= kMinValue * 1e-3) continue;  // degenerate, skip rather than raise
+        BRepBuilderAPI_MakeEdge mk(a, b);
         if (!mk.IsDone()) {
-          out.error = "gear root land segment could not be built";
+          out.error = "gear profile straight segment could not be built";
           return out;
         }
-        wire.Add(mk.Edge());
+        unit.Add(mk.Edge());
+      } else {
+        std::vector<gp_Pnt> pts;
+        pts.reserve(seg.size());
+        for (const auto& p : seg) pts.push_back(local_point(p));
+        const geom::BSplineEdgeResult e = geom::interpolated_edge(pts);
+        if (!e.ok) {
+          out.error = "gear flank could not be interpolated: " + e.error +
+                      " (try a lower sampleCount)";
+          return out;
+        }
+        unit.Add(e.edge);
       }
     }
+    if (!unit.IsDone()) {
+      out.error = "gear tooth wire could not be assembled (the tooth segments do not join)";
+      return out;
+    }
+    std::vector<TopoDS_Edge> unitEdges;
+    for (BRepTools_WireExplorer it(unit.Wire()); it.More(); it.Next()) {
+      unitEdges.push_back(it.Current());
+    }
+    if (unitEdges.empty()) {
+      out.error = "gear tooth wire is empty";
+      return out;
+    }
+    const TopoDS_Vertex first = TopExp::FirstVertex(unitEdges.front(), Standard_True);
+    const TopoDS_Vertex last = TopExp::LastVertex(unitEdges.back(), Standard_True);
+
+    // Tooth k is the unit under `pitch^k`. Every location is a power of the
+    // SAME datum, so `pitch^k · pitch == pitch^(k+1)` as a TopLoc_Location and
+    // the root land below ends on exactly the vertex tooth k+1 starts on.
+    gp_Trsf pitchTrsf;
+    pitchTrsf.SetRotation(gp_Ax1(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1)), phipart);
+    const TopLoc_Location pitch(pitchTrsf);
+
+    // Root land: the chord from tooth 0's last point to tooth 1's first.
+    // Matches the reference's 2-point run (GearTool.h).
+    auto make_land = [&](const TopoDS_Vertex& from, const TopoDS_Vertex& to, TopoDS_Edge& land) {
+      if (BRep_Tool::Pnt(from).Distance(BRep_Tool::Pnt(to)) <= kMinValue * 1e-3) return true;
+      BRepBuilderAPI_MakeEdge mk(from, to);
+      if (!mk.IsDone()) {
+        out.error = "gear root land segment could not be built";
+        return false;
+      }
+      land = mk.Edge();
+      return true;
+    };
+    TopoDS_Edge unitLand;
+    if (!make_land(last, TopoDS::Vertex(first.Moved(pitch)), unitLand)) return out;
+
+    BRepBuilderAPI_MakeWire wire;
+    for (int k = 0; k < z; ++k) {
+      const TopLoc_Location loc = pitch.Powered(k);
+      for (const TopoDS_Edge& e : unitEdges) wire.Add(TopoDS::Edge(e.Moved(loc)));
+
+      if (k + 1 < z) {
+        if (!unitLand.IsNull()) wire.Add(TopoDS::Edge(unitLand.Moved(loc)));
+        continue;
+      }
+      // The wrap-around land must end on tooth 0's own, UNLOCATED first vertex
+      // (see GearTool.h): pitch^z is not the identity in binary floating point.
+      TopoDS_Edge closing;
+      if (!make_land(TopoDS::Vertex(last.Moved(loc)), first, closing)) return out;
+      if (!closing.IsNull()) wire.Add(closing);
+    }
 
     if (!wire.IsDone()) {
       out.error = "gear profile wire could not be assembled (the tooth segments do not join)";
@@ -246,16 +283,11 @@ GearBuildResult build_gear_solid(const GearBuildSpec& spec, const gp_Ax2& frame)
     }
     if (!BRepCheck_Analyzer(solid).IsValid()) {
       // The op layer audits again under the publication policy; refusing here
-      // keeps an invalid shape from ever reaching the transform below.
+      // keeps an invalid shape from ever reaching the placement.
       out.error = "gear body failed a validity check before placement";
       return out;
     }
 
-    // --- 5. Place the local build onto the caller's frame ------------------
-    gp_Trsf place;
-    place.SetTransformation(gp_Ax3(frame), gp_Ax3(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1)));
-    solid.Move(TopLoc_Location(place));
-
     out.ok = true;
     out.shape = solid;
     return out;
@@ -268,4 +300,16 @@ GearBuildResult build_gear_solid(const GearBuildSpec& spec, const gp_Ax2& frame)
   }
 }
 
+TopoDS_Shape place_on_frame(const TopoDS_Shape& local, const gp_Ax2& frame) {
+  gp_Trsf place;
+  place.SetTransformation(gp_Ax3(frame), gp_Ax3(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1)));
+  return local.Moved(TopLoc_Location(place));
+}
+
+GearBuildResult build_gear_solid(const GearBuildSpec& spec, const gp_Ax2& frame) {
+  GearBuildResult out = build_gear_local(spec);
+  if (out.ok) out.shape = place_on_frame(out.shape, frame);
+  return out;
+}
+
 }  // namespace onecad::ops::gear
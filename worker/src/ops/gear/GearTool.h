@@ -8,20 +8,23 @@
 // PIPELINE (involute external spur, the G1 recipe):
 //
 //   kernel/gear sampler  ->  one tooth as ordered 2D point runs
-//   replicate            ->  z teeth, each rotated by k·(2π/z)
 //   edges                ->  2-point run = line, >2-point run = interpolated
-//                            B-spline (kernel/geometry/BSpline.h)
+//                            B-spline (kernel/geometry/BSpline.h), ONCE
+//   replicate            ->  z teeth, tooth k = the unit under pitch^k
 //   wire -> face -> prism along the axis -> optional bore cuts
 //
-// EXACT REPLICATION. Each tooth's points are re-evaluated analytically at its
-// own rotation angle rather than copying a transformed shape. That is
-// stronger than the `TopLoc_Location` approach the plan asks for and much
-// stronger than the reference's `transformGeometry` (which re-parameterises
-// every copy and invites tolerance creep). The join between tooth k and k+1
-// is bit-identical by construction because both sides evaluate the SAME
-// expression — and the wrap-around join uses angle 0 rather than z·(2π/z),
-// since `cos(2π)` is not exactly 1 in binary floating point and the wire
-// would otherwise fail to close.
+// REPLICATION BY LOCATION. Tooth 0's edges are interpolated once and the other
+// z−1 teeth are the SAME edges under `TopLoc_Location` powers of one pitch
+// rotation, so a 120-tooth gear runs one tooth's worth of interpolations and
+// shares every flank curve. Earlier versions re-evaluated every tooth's sample
+// points analytically at its own angle and re-interpolated; the located copies
+// agree with that to rounding of the rotation, well inside the profile
+// tolerance. Joins are exact by TOPOLOGY rather than by arithmetic: every
+// location is a power of the same datum, so tooth k's root land ends on the
+// very vertex tooth k+1 starts on. The wrap-around land is built to tooth 0's
+// own unlocated first vertex rather than to the unit under pitch^z, since
+// z·(2π/z) is not exactly 2π in binary floating point and the wire would
+// otherwise fail to close.
 //
 // THE ROOT LAND IS A CHORD, NOT AN ARC — matching the reference, which emits
 // a 2-point run there and therefore a straight `LineSegment`. A true root
@@ -89,4 +92,12 @@ struct GearBuildResult {
 /// null shape as though it were a result.
 GearBuildResult build_gear_solid(const GearBuildSpec& spec, const gp_Ax2& frame);
 
+/// The same solid in the gear's LOCAL frame (axis +Z, centre at the origin),
+/// before placement. A pure function of `spec`, which is what lets the op layer
+/// cache it (GeneratorCache.h) and place a cached copy per regen.
+GearBuildResult build_gear_local(const GearBuildSpec& spec);
+
+/// Place a local build onto `frame` — the final step of `build_gear_solid`.
+TopoDS_Shape place_on_frame(const TopoDS_Shape& local, const gp_Ax2& frame);
+
 }  // namespace onecad::ops::gear
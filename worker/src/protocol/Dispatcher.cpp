@@ -9,6 +9,7 @@
 
 #include "protocol/Frame.h"
 #include "util/Log.h"
+#include "util/Trace.h"
 
 namespace onecad::protocol {
 
@@ -21,18 +22,68 @@ std::uint64_t read_u64(const nlohmann::json& p, const char* key) {
     return 0;
 }
 
+std::int64_t steady_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
 }  // namespace
 
-void Dispatcher::register_verb(std::string verb, Handler handler) {
+const char* priority_name(Priority p) noexcept {
+    switch (p) {
+        case Priority::Interactive: return "interactive";
+        case Priority::Preview: return "preview";
+        case Priority::Regen: return "regen";
+        case Priority::Bulk: return "bulk";
+    }
+    return "regen";
+}
+
+std::optional<Priority> parse_priority(const std::string& name) noexcept {
+    for (std::size_t i = 0; i < kPriorityCount; ++i) {
+        const auto p = static_cast<Priority>(i);
+        if (name == priority_name(p)) return p;
+    }
+    return std::nullopt;
+}
+
+void Dispatcher::LaneStats::note_depth(std::size_t size) noexcept {
+    const auto d = static_cast<std::uint64_t>(size);
+    depth.store(d, std::memory_order_relaxed);
+    std::uint64_t peak = peak_depth.load(std::memory_order_relaxed);
+    while (d > peak && !peak_depth.compare_exchange_weak(peak, d, std::memory_order_relaxed)) {
+    }
+}
+
+void Dispatcher::LaneStats::note_start(const Job& job) {
+    const auto now = std::chrono::steady_clock::now();
+    wait.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - job.enqueued_at).count()));
+    trace::record("queue.wait", job.env.verb, job.enqueued_at, now);
+}
+
+nlohmann::json Dispatcher::LaneStats::to_json() const {
+    return nlohmann::json{{"depth", depth.load(std::memory_order_relaxed)},
+                          {"peakDepth", peak_depth.load(std::memory_order_relaxed)},
+                          {"wait", wait.to_json()}};
+}
+
+void Dispatcher::register_verb(std::string verb, Handler handler, Priority priority,
+                               Scope scope) {
+    if (!verb_stats_[verb]) verb_stats_[verb] = std::make_unique<VerbStats>();
+    kernel_priorities_[verb] = priority;
+    kernel_scopes_[verb] = scope;
     handlers_[std::move(verb)] = std::move(handler);
 }
 
 void Dispatcher::register_solver_verb(std::string verb, Handler handler) {
+    if (!verb_stats_[verb]) verb_stats_[verb] = std::make_unique<VerbStats>();
     solver_verbs_.insert(verb);
     handlers_[std::move(verb)] = std::move(handler);
 }
 
-void Dispatcher::set_stamp_source(std::function<Stamp()> source) {
+void Dispatcher::set_stamp_source(std::function<Stamp(const std::string& session_id)> source) {
     stamp_source_ = std::move(source);
 }
 
@@ -46,6 +97,7 @@ Envelope Dispatcher::execute(const Job& job, const std::function<void(Envelope&)
         // KNOWN verb with an unsupported op/param.
         WLOG_ERROR("unknown verb '%s' (id %llu)", req.verb.c_str(),
                    static_cast<unsigned long long>(req.id));
+        unknown_verbs_.add();
         return Envelope::error_response(
             req.id, ErrorInfo{"PROTOCOL_ERROR", "unknown verb: " + req.verb,
                               /*retriable=*/false});
@@ -67,12 +119,13 @@ Envelope Dispatcher::execute(const Job& job, const std::function<void(Envelope&)
             .count();
     };
 
+    Envelope resp;
     try {
-        Envelope resp = it->second(req, job.bin, ctx);
+        const trace::Span span("handler", req.verb);
+        resp = it->second(req, job.bin, ctx);
         WLOG_DEBUG("verb '%s' id %llu ok in %lld ms", req.verb.c_str(),
                    static_cast<unsigned long long>(req.id),
                    static_cast<long long>(elapsed_ms()));
-        return resp;
     } catch (const Standard_Failure& f) {
         // `GetMessageString()` is shared by OCCT 7.9 and 8.0; `what()` and
         // `ExceptionType()` are not available on the comparison kernel.
@@ -81,7 +134,7 @@ Envelope Dispatcher::execute(const Job& job, const std::function<void(Envelope&)
         WLOG_ERROR("handler for verb '%s' id %llu threw Standard_Failure after %lld ms: %s",
                    req.verb.c_str(), static_cast<unsigned long long>(req.id),
                    static_cast<long long>(elapsed_ms()), message.c_str());
-        return Envelope::error_response(
+        resp = Envelope::error_response(
             req.id, ErrorInfo{"OP_FAILED", message, /*retriable=*/false});
     } catch (const std::exception& ex) {
         WLOG_ERROR("handler for verb '%s' id %llu threw after %lld ms: %s", req.verb.c_str(),
@@ -89,23 +142,35 @@ Envelope Dispatcher::execute(const Job& job, const std::function<void(Envelope&)
                    static_cast<long long>(elapsed_ms()), ex.what());
         // A handler failure is a recoverable op failure (SCHEMA §8 OP_FAILED):
         // the session is untouched (all work was in scratch).
-        return Envelope::error_response(
+        resp = Envelope::error_response(
             req.id, ErrorInfo{"OP_FAILED", ex.what(), /*retriable=*/false});
     }
+
+    const auto stats = verb_stats_.find(req.verb);
+    if (stats != verb_stats_.end()) {
+        stats->second->latency.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started)
+                .count()));
+        if (!resp.ok.value_or(true)) stats->second->errors.add();
+    }
+    return resp;
 }
 
-void Dispatcher::stamp_and_write(int out_fd, Envelope& resp) {
+void Dispatcher::stamp_and_write(int out_fd, Envelope& resp, const std::string& session_id) {
     std::lock_guard<std::mutex> lk(write_mu_);
     if (stamp_source_) {
-        const Stamp head = stamp_source_();  // §3 session-head fencing tokens
+        const Stamp head = stamp_source_(session_id);  // §3 session-head fencing tokens
         resp.stamp.document_revision = head.document_revision;
         resp.stamp.worker_epoch = head.worker_epoch;
         resp.stamp.snapshot_id = head.snapshot_id;
     }
+    if (!session_id.empty()) resp.stamp.session_id = session_id;
     resp.stamp.seq = out_seq_++;  // §2: monotonic across every emitted frame
 
     Frame f;
     try {
+        const trace::Span span("frame.serialize");
         f.json = serialize(resp);
     } catch (const EnvelopeError& ex) {
         WLOG_ERROR("failed to serialize response for id %llu: %s",
@@ -117,13 +182,68 @@ void Dispatcher::stamp_and_write(int out_fd, Envelope& resp) {
         f.bin.clear();
     }
     f.bin = resp.out_bin;
+    const trace::Span span("frame.write");
     if (!write_frame(out_fd, f)) {
         WLOG_ERROR("write_frame failed (broken stdout); stopping lanes");
         shutdown_requested_.store(true, std::memory_order_relaxed);
     }
 }
 
+Priority Dispatcher::kernel_priority(const Envelope& req) const {
+    const auto it = kernel_priorities_.find(req.verb);
+    // Unknown verbs stay in order too: their PROTOCOL_ERROR resp is not reordered.
+    const Priority registered = it == kernel_priorities_.end() ? Priority::Regen : it->second;
+    if (registered == Priority::Regen) return registered;
+    // A malformed or unknown override is ignored (§4 tolerate-malformed-optional).
+    if (req.args.is_object() && req.args.contains("priority") &&
+        req.args["priority"].is_string()) {
+        if (const auto p = parse_priority(req.args["priority"].get<std::string>())) return *p;
+    }
+    return registered;
+}
+
+std::size_t Dispatcher::pick_kernel_job(std::chrono::steady_clock::time_point now) const {
+    const auto step_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                             kPriorityAgingStep)
+                             .count();
+    std::size_t best = 0;
+    std::int64_t best_score = 0;
+    bool behind_writer = false;       // a scratch-only writer is queued ahead
+    bool scratch_read_ahead = false;  // a read of the scratch is queued ahead
+    for (std::size_t i = 0; i < queue_.size(); ++i) {
+        const Job& job = queue_[i];
+        if (job.priority == Priority::Regen) {
+            if (job.scope != Scope::Scratch) {
+                // A barrier: it runs when it reaches the front, and nothing behind
+                // it may start first.
+                if (i == 0) return 0;
+                break;
+            }
+            // Writes only the scratch: head reads may cross it, writers never do.
+            if (behind_writer) break;
+            behind_writer = true;
+            if (scratch_read_ahead) continue;  // that read must see the old scratch
+        } else if (job.scope == Scope::Scratch) {
+            if (behind_writer) continue;  // must see the writer's scratch
+            scratch_read_ahead = true;
+        }
+        const auto waited_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - job.enqueued_at)
+                .count();
+        // Lower is sooner: the class rank, less one class per aging step waited.
+        // Strict `<` keeps arrival order among equal scores.
+        const std::int64_t score =
+            static_cast<std::int64_t>(job.priority) * step_us - waited_us;
+        if (i == 0 || score < best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
 void Dispatcher::kernel_loop(int out_fd) {
+    trace::set_thread_name("kernel");
     for (;;) {
         Job job;
         {
@@ -132,16 +252,26 @@ void Dispatcher::kernel_loop(int out_fd) {
             if (queue_.empty()) {
                 return;  // stop requested and drained
             }
-            job = std::move(queue_.front());
-            queue_.pop();
+            const std::size_t next = pick_kernel_job(std::chrono::steady_clock::now());
+            if (next != 0) kernel_reordered_.add();
+            job = std::move(queue_[next]);
+            queue_.erase(queue_.begin() + static_cast<std::ptrdiff_t>(next));
+            kernel_stats_.note_depth(queue_.size());
         }
-
-        Envelope resp = execute(job, [this, out_fd](Envelope& e) { stamp_and_write(out_fd, e); });
+        kernel_stats_.note_start(job);
+        kernel_class_wait_[static_cast<std::size_t>(job.priority)].record(
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                           std::chrono::steady_clock::now() - job.enqueued_at)
+                                           .count()));
+
+        Envelope resp = execute(job, [this, out_fd, &job](Envelope& e) {
+            stamp_and_write(out_fd, e, job.session_id);
+        });
         {
             std::lock_guard<std::mutex> lk(tokens_mu_);
             tokens_.erase(job.env.id);
         }
-        stamp_and_write(out_fd, resp);
+        stamp_and_write(out_fd, resp, job.session_id);
 
         // If a handler asked to shut down, unblock the reader by closing stdin.
         if (shutdown_requested_.load(std::memory_order_relaxed)) {
@@ -155,6 +285,7 @@ void Dispatcher::kernel_loop(int out_fd) {
 }
 
 void Dispatcher::solver_loop(int out_fd) {
+    trace::set_thread_name("solver");
     for (;;) {
         Job job;
         {
@@ -165,40 +296,74 @@ void Dispatcher::solver_loop(int out_fd) {
             }
             job = std::move(solver_queue_.front());
             solver_queue_.pop_front();
+            solver_stats_.note_depth(solver_queue_.size());
+            if (job.is_drag) {
+                running_drag_ = RunningDrag{job.session_id, job.drag_gesture, job.drag_seq,
+                                            job.cancel};
+            }
         }
+        solver_stats_.note_start(job);
 
-        Envelope resp = execute(job, [this, out_fd](Envelope& e) { stamp_and_write(out_fd, e); });
+        Envelope resp = execute(job, [this, out_fd, &job](Envelope& e) {
+            stamp_and_write(out_fd, e, job.session_id);
+        });
+        bool superseded = false;
+        if (job.is_drag) {
+            std::lock_guard<std::mutex> lk(solver_mu_);
+            superseded = running_drag_ && running_drag_->superseded;
+            running_drag_.reset();
+        }
+        if (superseded && resp.error && resp.error->code == "CANCELLED") {
+            // The lane cannot tell a newer drag from a cancel frame; we can.
+            resp = Envelope::error_response(
+                job.env.id, ErrorInfo{"CANCELLED", "superseded", /*retriable=*/false});
+        }
         {
             std::lock_guard<std::mutex> lk(tokens_mu_);
             tokens_.erase(job.env.id);
         }
-        stamp_and_write(out_fd, resp);
+        stamp_and_write(out_fd, resp, job.session_id);
     }
 }
 
 void Dispatcher::enqueue_solver_job(Job job, int out_fd) {
-    std::vector<std::uint64_t> to_cancel;  // superseded request ids
+    std::vector<std::uint64_t> to_cancel;  // superseded request ids (all of job's session)
+    const std::string session_id = job.session_id;
     bool enqueue = true;
     {
         std::lock_guard<std::mutex> lk(solver_mu_);
         if (job.is_drag) {
             // Latest-wins: at most one unprocessed drag per gesture survives.
             for (auto it = solver_queue_.begin(); it != solver_queue_.end(); ++it) {
-                if (it->is_drag && it->drag_gesture == job.drag_gesture) {
+                if (it->is_drag && it->drag_gesture == job.drag_gesture &&
+                    it->session_id == job.session_id) {
                     if (it->drag_seq < job.drag_seq) {
                         to_cancel.push_back(it->env.id);  // drop older
                         solver_queue_.erase(it);
+                        drags_coalesced_.add();
                     } else {
                         to_cancel.push_back(job.env.id);  // incoming stale
                         enqueue = false;
+                        drags_stale_.add();
                     }
                     break;
                 }
             }
+            // ...and a drag already solving for the gesture is interrupted: its
+            // answer would be stale before it is sent.
+            if (enqueue && running_drag_ && !running_drag_->superseded &&
+                running_drag_->gesture == job.drag_gesture &&
+                running_drag_->session_id == job.session_id &&
+                running_drag_->seq < job.drag_seq) {
+                running_drag_->superseded = true;
+                running_drag_->cancel->cancel();
+                drags_interrupted_.add();
+            }
         }
         if (enqueue) {
             solver_queue_.push_back(std::move(job));
         }
+        solver_stats_.note_depth(solver_queue_.size());
     }
     if (enqueue) {
         solver_cv_.notify_one();
@@ -212,21 +377,23 @@ void Dispatcher::enqueue_solver_job(Job job, int out_fd) {
         }
         Envelope resp = Envelope::error_response(
             id, ErrorInfo{"CANCELLED", "superseded", /*retriable=*/false});
-        stamp_and_write(out_fd, resp);
+        stamp_and_write(out_fd, resp, session_id);
     }
 }
 
 int Dispatcher::run(int in_fd, int out_fd, const Envelope* hello) {
     in_fd_ = in_fd;
+    started_ms_.store(steady_ms(), std::memory_order_relaxed);
     kernel_stop_ = false;
     solver_stop_ = false;
 
     // SCHEMA §6: emit the unsolicited hello (seq 0) before reading any request.
     if (hello != nullptr) {
         Envelope h = *hello;
-        stamp_and_write(out_fd, h);
+        stamp_and_write(out_fd, h, "");
     }
 
+    trace::set_thread_name("reader");
     std::thread kernel(&Dispatcher::kernel_loop, this, out_fd);
     std::thread solver(&Dispatcher::solver_loop, this, out_fd);
 
@@ -251,6 +418,7 @@ int Dispatcher::run(int in_fd, int out_fd, const Envelope* hello) {
 
         Envelope env;
         try {
+            const trace::Span span("frame.parse");
             env = parse(rr.frame.json);
         } catch (const EnvelopeError& ex) {
             WLOG_ERROR("protocol: malformed envelope: %s", ex.what());
@@ -285,6 +453,15 @@ int Dispatcher::run(int in_fd, int out_fd, const Envelope* hello) {
 
         Job job;
         job.cancel = std::make_shared<CancelToken>();
+        if (env.args.is_object() && env.args.contains("sessionId") &&
+            env.args["sessionId"].is_string()) {
+            job.session_id = env.args["sessionId"].get<std::string>();
+        }
+        if (!solver_routed) {
+            job.priority = kernel_priority(env);
+            const auto scope = kernel_scopes_.find(env.verb);
+            if (scope != kernel_scopes_.end()) job.scope = scope->second;
+        }
         if (solver_routed && env.verb == "SolveDrag") {
             job.is_drag = true;
             job.drag_gesture = read_u64(env.args, "gestureId");
@@ -292,6 +469,7 @@ int Dispatcher::run(int in_fd, int out_fd, const Envelope* hello) {
         }
         job.env = std::move(env);
         job.bin = std::move(rr.frame.bin);
+        job.enqueued_at = std::chrono::steady_clock::now();
         {
             std::lock_guard<std::mutex> lk(tokens_mu_);
             tokens_[job.env.id] = job.cancel;
@@ -302,7 +480,8 @@ int Dispatcher::run(int in_fd, int out_fd, const Envelope* hello) {
         } else {
             {
                 std::lock_guard<std::mutex> lk(queue_mu_);
-                queue_.push(std::move(job));
+                queue_.push_back(std::move(job));
+                kernel_stats_.note_depth(queue_.size());
             }
             queue_cv_.notify_one();
         }
@@ -335,4 +514,33 @@ Envelope Dispatcher::dispatch_once(const Envelope& req,
     return execute(job, [](Envelope&) {});
 }
 
+nlohmann::json Dispatcher::stats_json() const {
+    nlohmann::json verbs = nlohmann::json::object();
+    for (const auto& [verb, stats] : verb_stats_) {
+        if (stats->latency.count() == 0) continue;
+        nlohmann::json entry = stats->latency.to_json();
+        entry["errors"] = stats->errors.value();
+        verbs[verb] = std::move(entry);
+    }
+    nlohmann::json kernel = kernel_stats_.to_json();
+    nlohmann::json classes = nlohmann::json::object();
+    for (std::size_t i = 0; i < kPriorityCount; ++i) {
+        if (kernel_class_wait_[i].count() == 0) continue;
+        classes[priority_name(static_cast<Priority>(i))] = kernel_class_wait_[i].to_json();
+    }
+    kernel["classWait"] = std::move(classes);
+    kernel["reordered"] = kernel_reordered_.value();
+    const std::int64_t started = started_ms_.load(std::memory_order_relaxed);
+    return nlohmann::json{
+        {"uptimeMs", started == 0 ? 0 : steady_ms() - started},
+        {"verbs", std::move(verbs)},
+        {"unknownVerbs", unknown_verbs_.value()},
+        {"lanes", {{"kernel", std::move(kernel)}, {"solver", solver_stats_.to_json()}}},
+        {"drags",
+         {{"coalesced", drags_coalesced_.value()},
+          {"stale", drags_stale_.value()},
+          {"interrupted", drags_interrupted_.value()}}},
+    };
+}
+
 }  // namespace onecad::protocol
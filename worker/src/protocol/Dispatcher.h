@@ -8,12 +8,32 @@
 //     drags never queue behind modeling (plan: "solver lane in V1"). Its mailbox
 //     is LATEST-WINS per gesture for SolveDrag (only the newest unprocessed
 //     target survives; superseded ones get a terminal CANCELLED/superseded resp
-//     so the one-resp-per-id contract holds). Non-drag Sketch verbs are FIFO.
+//     so the one-resp-per-id contract holds). The drag already RUNNING is
+//     superseded too: its cancel token is flipped, the solve stops between
+//     iterations and rolls back, and it answers CANCELLED/superseded (SCHEMA
+//     §5.4). Non-drag Sketch verbs are FIFO.
 //   * Both lanes write terminal frames to stdout under a shared write mutex, so
 //     frame bytes never interleave; each emitted frame is stamped with the §3
-//     stamp — the session head (documentRevision/workerEpoch/snapshotId, via the
-//     stamp source) plus a monotonic `seq` — under that same lock (§2).
+//     stamp — the head of the session the request addressed (documentRevision/
+//     workerEpoch/snapshotId, via the stamp source, keyed by the request's
+//     `sessionId`) plus a monotonic `seq` — under that same lock (§2).
+//   * One worker hosts several documents (session/SessionRegistry.h): the lanes
+//     are shared by every session, and a request names its session in
+//     `args.sessionId` (absent ⇒ the default session).
+//   * The kernel queue is PRIORITY-ordered (SCHEMA §5.5). Each kernel verb is
+//     registered with a Priority class; `args.priority` may override it per
+//     request. A Regen-class (mutating) job is a barrier: it runs in arrival order
+//     and nothing queued crosses it in either direction, so the single-writer
+//     order of mutations — and what each read observes — is exactly FIFO. Only
+//     the read-only jobs between two barriers are reordered, best class first;
+//     a waiting job gains one class per kPriorityAgingStep so bulk work is never
+//     starved by a stream of hovers. The one exception is a Regen verb that
+//     writes only the prepared scratch job (Scope::Scratch, ExecutePlan): reads
+//     of the published head may cross it, since it changes nothing they observe.
 //   * Cancel frames flip the atomic CancelToken registered under the target id.
+//   * Every job is measured (util/Stats.h): per-verb handler latency, per-lane
+//     queue depth + enqueue-to-start wait, superseded drags. `stats_json` reads
+//     them lock-free from any thread (GetWorkerStats).
 //
 // Contract:
 //   * exactly one terminal resp per req.
@@ -23,13 +43,16 @@
 //   * a handler may request clean shutdown via HandlerContext::request_shutdown.
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -37,6 +60,7 @@
 
 #include "protocol/Envelope.h"
 #include "util/Cancel.h"
+#include "util/Stats.h"
 
 namespace onecad::protocol {
 
@@ -58,22 +82,46 @@ using Handler =
     std::function<Envelope(const Envelope& req, const std::vector<std::uint8_t>& bin,
                            HandlerContext& ctx)>;
 
+// Kernel-lane scheduling class (SCHEMA §5.5), best first. Interactive, Preview
+// and Bulk verbs must not mutate session state; Regen is the class of every verb
+// that does (and the safe default), and is never reordered.
+enum class Priority : std::uint8_t { Interactive, Preview, Regen, Bulk };
+inline constexpr std::size_t kPriorityCount = 4;
+
+// What a kernel verb touches besides the published head (SCHEMA §5.5). A Regen
+// verb registered `Scratch` writes NOTHING but the session's prepared scratch job
+// (ExecutePlan), so queued `Head` reads may start before it; every other Regen
+// verb is a full barrier. A read-only verb registered `Scratch` also reads the
+// scratch (GetWorkerHead's `hasScratch`) and so never crosses such a writer.
+enum class Scope : std::uint8_t { Head, Scratch };
+
+// A queued read-only job is treated as one class better per this much waiting.
+inline constexpr std::chrono::milliseconds kPriorityAgingStep{250};
+
+const char* priority_name(Priority p) noexcept;
+std::optional<Priority> parse_priority(const std::string& name) noexcept;
+
 class Dispatcher {
 public:
     Dispatcher() = default;
 
-    // Register (or replace) the handler for a verb routed to the KERNEL lane.
-    void register_verb(std::string verb, Handler handler);
+    // Register (or replace) the handler for a verb routed to the KERNEL lane,
+    // scheduled in `priority`'s class and reordered within `scope`.
+    void register_verb(std::string verb, Handler handler,
+                       Priority priority = Priority::Regen, Scope scope = Scope::Head);
 
     // Register (or replace) the handler for a verb routed to the SOLVER lane
     // (Sketch* verbs). SolveDrag on this lane is coalesced latest-wins.
     void register_solver_verb(std::string verb, Handler handler);
 
     // Source of the §3 session-head stamp (documentRevision/workerEpoch/
-    // snapshotId) applied to every worker frame. Set by main from WorkerSession;
-    // when unset the head is all-zero (pre-session). `seq` is always assigned by
-    // the Dispatcher and is NOT taken from the source.
-    void set_stamp_source(std::function<Stamp()> source);
+    // snapshotId) applied to every worker frame, given the `sessionId` of the
+    // request the frame answers ("" for the default session and the hello). Set
+    // by main from the SessionRegistry; when unset the head is all-zero
+    // (pre-session). `seq` is always assigned by the Dispatcher and is NOT taken
+    // from the source; a non-empty session id is echoed as the stamp's
+    // `sessionId`.
+    void set_stamp_source(std::function<Stamp(const std::string& session_id)> source);
 
     // Run the full reader/kernel/solver loop over the given fds until EOF,
     // shutdown, or protocol error. If `hello` is non-null it is emitted as the
@@ -86,15 +134,42 @@ public:
     Envelope dispatch_once(const Envelope& req,
                            const std::vector<std::uint8_t>& bin = {});
 
+    // Runtime counters (SCHEMA §7.1 GetWorkerStats): `verbs` (per registered verb
+    // that ran: handler latency + error count), `unknownVerbs`, `lanes` (kernel/
+    // solver: current + peak queue depth, enqueue-to-start wait; kernel also per
+    // priority class + jobs run out of arrival order), `drags`
+    // (coalesced/stale/interrupted SolveDrag), `uptimeMs` since `run`. Safe from
+    // any thread.
+    nlohmann::json stats_json() const;
+
 private:
     struct Job {
         Envelope env;
         std::vector<std::uint8_t> bin;
         CancelTokenPtr cancel;
-        // Latest-wins coalescing hints (SolveDrag only).
+        std::string session_id;  // args.sessionId ("" ⇒ the default session)
+        // Latest-wins coalescing hints (SolveDrag only; gestures are per session).
         bool is_drag = false;
         std::uint64_t drag_gesture = 0;
         std::uint64_t drag_seq = 0;
+        Priority priority = Priority::Regen;  // kernel lane only
+        Scope scope = Scope::Head;            // kernel lane only
+        std::chrono::steady_clock::time_point enqueued_at{};
+    };
+
+    struct VerbStats {
+        stats::Histogram latency;  // handler time (queue wait excluded)
+        stats::Counter errors;     // terminal resps with ok:false
+    };
+
+    struct LaneStats {
+        stats::Histogram wait;  // enqueue → handler start
+        std::atomic<std::uint64_t> depth{0};
+        std::atomic<std::uint64_t> peak_depth{0};
+
+        void note_depth(std::size_t size) noexcept;
+        void note_start(const Job& job);
+        nlohmann::json to_json() const;
     };
 
     // Execute one job's handler, translating unknown verbs and handler
@@ -102,6 +177,13 @@ private:
     // frames the handler streams (wired to `stamp_and_write` on the lane's fd).
     Envelope execute(const Job& job, const std::function<void(Envelope&)>& emit);
 
+    // The registered class of a kernel verb, overridden by a well-formed
+    // `args.priority`. A mutating (Regen) verb cannot be demoted out of order.
+    Priority kernel_priority(const Envelope& req) const;
+
+    // Index into `queue_` of the job to run next (queue_mu_ held, queue_ non-empty).
+    std::size_t pick_kernel_job(std::chrono::steady_clock::time_point now) const;
+
     void kernel_loop(int out_fd);
     void solver_loop(int out_fd);
 
@@ -109,27 +191,53 @@ private:
     // Superseded drags are terminal-responded CANCELLED/superseded on `out_fd`.
     void enqueue_solver_job(Job job, int out_fd);
 
-    // Serialize + stamp (monotonic seq) + write a terminal resp under the write
-    // mutex, copying any handler binary (`out_bin`) into the frame tail.
-    void stamp_and_write(int out_fd, Envelope& resp);
+    // Serialize + stamp (the head of `session_id` + monotonic seq) + write a
+    // terminal resp under the write mutex, copying any handler binary (`out_bin`)
+    // into the frame tail.
+    void stamp_and_write(int out_fd, Envelope& resp, const std::string& session_id);
 
     std::unordered_map<std::string, Handler> handlers_;
     std::unordered_set<std::string> solver_verbs_;  // routing set (subset of handlers_)
+    std::unordered_map<std::string, Priority> kernel_priorities_;
+    std::unordered_map<std::string, Scope> kernel_scopes_;
+    // One entry per registered verb, created at registration — i.e. before `run`
+    // starts the lanes — so the lanes only ever READ this map.
+    std::unordered_map<std::string, std::unique_ptr<VerbStats>> verb_stats_;
+    stats::Counter unknown_verbs_;
 
     // §3 session-head stamp source (documentRevision/workerEpoch/snapshotId).
-    std::function<Stamp()> stamp_source_;
+    std::function<Stamp(const std::string& session_id)> stamp_source_;
 
-    // Kernel work queue (reader -> kernel).
+    // Kernel work queue (reader -> kernel), in arrival order; `pick_kernel_job`
+    // chooses which entry runs next. Holds tens of jobs, so a linear scan is fine.
     std::mutex queue_mu_;
     std::condition_variable queue_cv_;
-    std::queue<Job> queue_;
+    std::deque<Job> queue_;
     bool kernel_stop_ = false;
+    LaneStats kernel_stats_;
+    std::array<stats::Histogram, kPriorityCount> kernel_class_wait_;
+    stats::Counter kernel_reordered_;  // jobs started ahead of an earlier arrival
 
     // Solver mailbox (reader -> solver lane); deque so drags can be coalesced.
     std::mutex solver_mu_;
     std::condition_variable solver_cv_;
     std::deque<Job> solver_queue_;
     bool solver_stop_ = false;
+    LaneStats solver_stats_;
+    stats::Counter drags_coalesced_;  // a queued drag replaced by a newer one
+    stats::Counter drags_stale_;      // an incoming drag older than the queued one
+    stats::Counter drags_interrupted_;  // a RUNNING drag cancelled by a newer one
+
+    // The drag the solver lane is executing, so a newer drag for its gesture
+    // can cancel it instead of waiting behind it (solver_mu_).
+    struct RunningDrag {
+        std::string session_id;
+        std::uint64_t gesture = 0;
+        std::uint64_t seq = 0;
+        CancelTokenPtr cancel;
+        bool superseded = false;  // cancelled by a newer drag, not a cancel frame
+    };
+    std::optional<RunningDrag> running_drag_;
 
     // Single writer discipline across both lanes + monotonic output seq (§2).
     std::mutex write_mu_;
@@ -143,6 +251,7 @@ private:
     std::atomic<bool> shutdown_requested_{false};
     std::atomic<int> exit_code_{0};
     int in_fd_ = -1;  // closed by a lane on shutdown to unblock the reader
+    std::atomic<std::int64_t> started_ms_{0};  // steady clock at `run`, for uptimeMs
 };
 
 }  // namespace onecad::protocol
@@ -105,6 +105,7 @@ void write_stamp(json& j, const Stamp& s) {
     j["workerEpoch"] = s.worker_epoch;
     j["snapshotId"] = s.snapshot_id;
     if (s.job_id.has_value()) j["jobId"] = *s.job_id;
+    if (s.session_id.has_value()) j["sessionId"] = *s.session_id;
     j["seq"] = s.seq;
 }
 
@@ -10,7 +10,8 @@
 //   cancel(Rust->worker):   { v, t:"cancel", id }
 //
 //   error object (§8):      { code, message, detail?, retriable }
-//   <stamp>  (§2/§3):       documentRevision, workerEpoch, snapshotId, jobId?, seq
+//   <stamp>  (§2/§3):       documentRevision, workerEpoch, snapshotId, jobId?,
+//                           sessionId?, seq
 //
 // `id` is a u64 JSON number (§2). 64-bit hashes are lowercase hex strings.
 // Serialization rejects NaN/Inf floats (nlohmann would coerce them to null).
@@ -68,12 +69,15 @@ struct BinSection {
 // worker-originated frame except `hello` carries it. Pre-session (pre-W-WP4) the
 // fencing tokens are the session head OpenSession last set (0/0/0 before any
 // OpenSession); `seq` is the monotonic output counter assigned by the Dispatcher
-// at write time; `jobId` is present only while an ExecutePlan job is in flight.
+// at write time; `jobId` is present only while an ExecutePlan job is in flight;
+// `sessionId` echoes the request's non-default session handle, whose head the
+// fencing tokens are (§7.1 multi-document worker).
 struct Stamp {
     std::uint64_t document_revision = 0;
     std::uint64_t worker_epoch = 0;
     std::uint64_t snapshot_id = 0;
     std::optional<std::uint64_t> job_id;
+    std::optional<std::string> session_id;
     std::uint64_t seq = 0;
 };
 
@@ -2,12 +2,17 @@
 #include "protocol/SolverLane.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <functional>
+#include <mutex>
 #include <numbers>
 #include <optional>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 
@@ -15,9 +20,11 @@
 #include "loop/PolygonFill.h"
 #include "loop/RegionTable.h"
 #include "loop/RegionUtils.h"
+#include "ops/ProfileCache.h"
 #include "sketch/SketchArc.h"
 #include "sketch/SketchCircle.h"
 #include "sketch/SketchPoint.h"
+#include "util/Trace.h"
 
 namespace onecad::protocol {
 
@@ -36,6 +43,29 @@ constexpr double kAngleEpsilon = 1e-9;  // "changed angle" threshold (rad)
 // may refuse and re-offer.
 constexpr double kMinArcSweep = 1e-3;  // rad
 
+// SCHEMA §7.4 per-verb solve budgets, overridable per request by `budgetMs`. A
+// drag step is a preview: a few frames late it is stale anyway, so it is bounded
+// tightly, its substeps share the one budget, and a step over budget is rolled
+// back (`partial`). EndGesture commits the gesture, so each of its solves (every
+// substep of the final drag) gets the budget on its own, and a final drag that
+// still runs out is rolled back whole rather than committing part of the way.
+constexpr std::chrono::milliseconds kDragBudget{100};
+constexpr std::chrono::milliseconds kEndBudget{1000};
+
+// Drag predictor (see SolverLane::predict_seed). Two converged samples give a
+// first-order step; a new cursor delta more than kMaxExtrapolation times the
+// last one is past what a straight line says about a linkage, so it goes
+// unseeded rather than seeded far off.
+constexpr std::size_t kPredictorHistory = 2;
+
+constexpr double kMaxExtrapolation = 8.0;
+
+// SketchUpsertBatch pool bound (further capped by the hardware threads). A
+// document open is the batch's one real caller; past a handful of threads the
+// kernel lane, regenerating on the same cores, would lose more than the
+// solves gain.
+constexpr std::size_t kUpsertBatchWorkers = 4;
+
 using PointPosMap = std::unordered_map<sk::EntityID, std::pair<double, double>>;
 
 Envelope err(const Envelope& req, const char* code, const std::string& msg) {
@@ -107,15 +137,126 @@ bool curve_center_and_radius(const sk::Sketch& sketch, const sk::EntityID& curve
     return false;
 }
 
+// `args.budgetMs` when it is a positive integer, else the verb's default.
+std::chrono::milliseconds solve_budget(const json& args, std::chrono::milliseconds fallback) {
+    if (args.contains("budgetMs") && args["budgetMs"].is_number_unsigned() &&
+        args["budgetMs"].get<std::uint64_t>() > 0) {
+        return std::chrono::milliseconds(args["budgetMs"].get<std::uint64_t>());
+    }
+    return fallback;
+}
+
+// How a request's budget spreads over the solves it makes: one deadline they
+// all share (a drag step), or the whole budget for each solve (EndGesture).
+enum class BudgetScope { Request, PerSolve };
+
+// Bounds every solve on a gesture's sketch for the span of one request. The
+// sketch outlives the request, so the bound is lifted again on exit.
+class BoundedSolve {
+public:
+    BoundedSolve(sk::Sketch& sketch, std::chrono::milliseconds budget, const CancelToken* cancel,
+                 BudgetScope scope = BudgetScope::Request)
+        : sketch_(sketch) {
+        sk::SolveLimits limits{.cancel = cancel};
+        if (scope == BudgetScope::PerSolve) limits.perSolve = budget;
+        else limits.deadline = std::chrono::steady_clock::now() + budget;
+        sketch_.setSolveLimits(limits);
+    }
+    ~BoundedSolve() { sketch_.setSolveLimits(sk::SolveLimits{}); }
+    BoundedSolve(const BoundedSolve&) = delete;
+    BoundedSolve& operator=(const BoundedSolve&) = delete;
+
+private:
+    sk::Sketch& sketch_;
+};
+
+// SketchUpsertBatch's helper threads. Every session's lane runs on the
+// Dispatcher's one solver thread, so one pool serves them all: started by the
+// first batch that needs it and parked between batches for the life of the
+// process. A batch never starts threads of its own — with tracing on, every
+// new thread would keep a trace ring for good. Batches run only in a worker, so
+// a zygote never starts it before forking.
+class UpsertPool {
+public:
+    ~UpsertPool() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        wake_cv_.notify_all();
+        for (std::thread& t : threads_) t.join();
+    }
+
+    // Runs `work` on the calling thread and on `helpers` pool threads, and
+    // returns once every copy has. Concurrent callers take turns.
+    void run(std::size_t helpers, const std::function<void()>& work) {
+        const std::lock_guard<std::mutex> turn(run_mu_);
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            while (threads_.size() < helpers) threads_.emplace_back(&UpsertPool::loop, this);
+            work_ = &work;
+            unclaimed_ = helpers;
+        }
+        wake_cv_.notify_all();
+        work();
+        std::unique_lock<std::mutex> lk(mu_);
+        done_cv_.wait(lk, [this] { return unclaimed_ == 0 && running_ == 0; });
+        work_ = nullptr;
+    }
+
+private:
+    void loop() {
+        trace::set_thread_name("upsert");
+        std::unique_lock<std::mutex> lk(mu_);
+        for (;;) {
+            wake_cv_.wait(lk, [this] { return unclaimed_ > 0 || stop_; });
+            if (stop_) return;
+            --unclaimed_;
+            ++running_;
+            const std::function<void()>& work = *work_;
+            lk.unlock();
+            work();
+            lk.lock();
+            if (--running_ == 0 && unclaimed_ == 0) done_cv_.notify_one();
+        }
+    }
+
+    std::mutex run_mu_;  // one batch at a time
+    std::mutex mu_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    std::vector<std::thread> threads_;
+    const std::function<void()>* work_ = nullptr;  // the batch in progress
+    std::size_t unclaimed_ = 0;  // helper turns of that batch not yet taken
+    std::size_t running_ = 0;    // helpers inside `work`
+    bool stop_ = false;
+};
+
+UpsertPool& upsert_pool() {
+    static UpsertPool pool;
+    return pool;
+}
+
 std::uint64_t u64(const json& p, const char* key) {
     if (p.is_object() && p.contains(key) && p[key].is_number()) return p[key].get<std::uint64_t>();
     return 0;
 }
 
-// Snapshot every Point entity's position by internal id.
+using EntityScope = std::optional<std::unordered_set<sk::EntityID>>;
+
+// Snapshot every Point entity's position by internal id — or, with a scope,
+// only the points in it (a gesture's drag component).
 std::unordered_map<sk::EntityID, std::pair<double, double>> collect_positions(
-    const sk::Sketch& sketch) {
+    const sk::Sketch& sketch, const EntityScope& scope = std::nullopt) {
     std::unordered_map<sk::EntityID, std::pair<double, double>> out;
+    if (scope) {
+        for (const sk::EntityID& id : *scope) {
+            if (const auto* p = sketch.getEntityAs<sk::SketchPoint>(id)) {
+                out[id] = {p->position().X(), p->position().Y()};
+            }
+        }
+        return out;
+    }
     for (const auto& e : sketch.getAllEntities()) {
         if (e && e->type() == sk::EntityType::Point) {
             const auto* p = dynamic_cast<const sk::SketchPoint*>(e.get());
@@ -146,22 +287,27 @@ json changed_positions(const std::unordered_map<sk::EntityID, std::pair<double,
 // Every SOLVER-REGISTERED curve's parameters by internal id (the `curves`
 // mirror of collect_positions). An Ellipse is deliberately absent: it is not
 // registered with PlaneGCS, so no drag can move it and SCHEMA §7.4 forbids
-// reporting one.
-CurveMap collect_curves(const sk::Sketch& sketch) {
+// reporting one. Scoped like collect_positions.
+CurveMap collect_curves(const sk::Sketch& sketch, const EntityScope& scope = std::nullopt) {
     CurveMap out;
-    for (const auto& e : sketch.getAllEntities()) {
-        if (!e) continue;
+    const auto collect = [&out](const sk::SketchEntity* e) {
+        if (!e) return;
         if (e->type() == sk::EntityType::Circle) {
-            const auto* c = dynamic_cast<const sk::SketchCircle*>(e.get());
+            const auto* c = dynamic_cast<const sk::SketchCircle*>(e);
             if (c) out[c->id()] = CurveParams{c->radius(), 0.0, 0.0, /*has_angles=*/false};
         } else if (e->type() == sk::EntityType::Arc) {
-            const auto* a = dynamic_cast<const sk::SketchArc*>(e.get());
+            const auto* a = dynamic_cast<const sk::SketchArc*>(e);
             if (a) {
                 out[a->id()] = CurveParams{a->radius(), a->startAngle(), a->endAngle(),
                                            /*has_angles=*/true};
             }
         }
+    };
+    if (scope) {
+        for (const sk::EntityID& id : *scope) collect(sketch.getEntity(id));
+        return out;
     }
+    for (const auto& e : sketch.getAllEntities()) collect(e.get());
     return out;
 }
 
@@ -288,66 +434,168 @@ void append_u32(std::vector<std::uint8_t>& buf, std::uint32_t u) {
 // --- verb registration ------------------------------------------------------
 
 void SolverLane::register_verbs(Dispatcher& dispatcher) {
-    dispatcher.register_solver_verb(
-        "SketchUpsert",
-        [this](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
-            return on_upsert(r);
-        });
-    dispatcher.register_solver_verb(
-        "BeginGesture",
-        [this](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
-            return on_begin(r);
-        });
-    dispatcher.register_solver_verb(
-        "SolveDrag",
-        [this](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
-            return on_drag(r);
-        });
-    dispatcher.register_solver_verb(
-        "EndGesture",
-        [this](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
-            return on_end(r);
-        });
-    dispatcher.register_solver_verb(
-        "SketchRegions",
-        [this](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
-            return on_regions(r);
-        });
+    for (const std::string& verb : verbs()) {
+        dispatcher.register_solver_verb(
+            verb, [this](const Envelope& r, const std::vector<std::uint8_t>&,
+                         HandlerContext& ctx) { return handle(r, &ctx.cancel); });
+    }
+}
+
+const std::vector<std::string>& SolverLane::verbs() {
+    static const std::vector<std::string> kVerbs = {
+        "SketchUpsert", "SketchUpsertBatch", "BeginGesture", "SolveDrag", "EndGesture",
+        "SketchRegions"};
+    return kVerbs;
+}
+
+Envelope SolverLane::handle(const Envelope& req, const CancelToken* cancel) {
+    if (req.verb == "SketchUpsert") return on_upsert(req);
+    if (req.verb == "SketchUpsertBatch") return on_upsert_batch(req);
+    if (req.verb == "BeginGesture") return on_begin(req);
+    if (req.verb == "SolveDrag") return on_drag(req, cancel);
+    if (req.verb == "EndGesture") return on_end(req);
+    if (req.verb == "SketchRegions") return on_regions(req);
+    return err(req, "PROTOCOL_ERROR", "not a solver-lane verb: " + req.verb);
 }
 
 // --- SketchUpsert -----------------------------------------------------------
 
-Envelope SolverLane::on_upsert(const Envelope& req) {
-    const json& args = req.args;
-    const std::string sketch_id = args.value("sketchId", std::string{});
-    if (sketch_id.empty()) return err(req, "OP_FAILED", "SketchUpsert: missing sketchId");
+SolverLane::PreparedUpsert SolverLane::prepare_upsert(const json& args,
+                                                      const sk::ComponentSolveCache& previous) {
+    PreparedUpsert p;
+    p.sketch_id = args.value("sketchId", std::string{});
+    if (p.sketch_id.empty()) {
+        p.error = "missing sketchId";
+        return p;
+    }
+    const trace::Span span("upsert", p.sketch_id);
 
     wire::TranslateResult tr = wire::translate(args);
-    if (!tr.ok) return err(req, "OP_FAILED", "SketchUpsert: " + tr.error);
-
-    const sk::SolveResult solve = tr.sketch->solve();
-    const int dof = tr.sketch->getDegreesOfFreedom();
-    const auto conflicting = tr.sketch->getConflictingConstraints();
-    const bool redundant = tr.sketch->hasRedundantConstraints();
-    const std::string state = upsert_state(dof, !conflicting.empty(), redundant);
+    if (!tr.ok) {
+        p.error = tr.error;
+        return p;
+    }
 
-    json stored_args = args;
+    // Solved and diagnosed per constraint-graph component: a component this
+    // upsert carries unchanged from the sketch's last one is taken from the
+    // cache, so an edit pays only for the components it touches.
+    const wire::ComponentKeys keys(args, tr.index);
+    const sk::ComponentSolveResult solved = tr.sketch->solveByComponent(
+        [&keys](const std::vector<sk::EntityID>& entities,
+                const std::vector<sk::ConstraintID>& constraints) {
+            return keys(entities, constraints);
+        },
+        previous, p.solves);
+    const sk::SolveResult& solve = solved.solve;
+    p.dof = solved.dof;
+    p.state = upsert_state(p.dof, !solve.conflictingConstraints.empty(), solved.redundant);
+    // Per-constraint conflict ids (SCHEMA §7.4): the constraints PlaneGCS reports
+    // as mutually unsatisfiable, wire-mapped (empty when the sketch is solvable).
+    p.conflicting = map_conflicting(tr.index, solve.conflictingConstraints);
+
+    p.stored_args = args;
     if (solve.success) {
-        wire::apply_solved_positions(stored_args, *tr.sketch, tr.index);
+        wire::apply_solved_positions(p.stored_args, *tr.sketch, tr.index);
+        // The solved sketch IS the stored wire translated and solved again.
+        p.translated = {std::move(tr.sketch), std::move(tr.index)};
     }
-    const std::uint64_t revision = store_.upsert(sketch_id, std::move(stored_args));
+    return p;
+}
 
-    json result = {
+const sk::ComponentSolveCache& SolverLane::previous_solves(const std::string& sketch_id) const {
+    static const sk::ComponentSolveCache kNone;
+    const auto it = component_solves_.find(sketch_id);
+    return it == component_solves_.end() ? kNone : it->second;
+}
+
+json SolverLane::commit_upsert(PreparedUpsert& p) {
+    const std::uint64_t revision =
+        store_.upsert(p.sketch_id, std::move(p.stored_args), std::move(p.translated));
+    component_solves_[p.sketch_id] = std::move(p.solves);
+    // Faces built from the superseded revision can no longer be hit (the cache is
+    // content-keyed); drop them now rather than at LRU eviction.
+    ops::profile_face_cache().invalidate_sketch(p.sketch_id);
+
+    return {
         {"upserted", true},
-        {"sketchId", sketch_id},
+        {"sketchId", p.sketch_id},
         {"sketchRevision", revision},
-        {"dof", dof},
-        {"state", state},
-        // Per-constraint conflict ids (SCHEMA §7.4): the constraints PlaneGCS reports
-        // as mutually unsatisfiable, wire-mapped (empty when the sketch is solvable).
-        {"conflicting", map_conflicting(tr.index, conflicting)},
+        {"dof", p.dof},
+        {"state", p.state},
+        {"conflicting", std::move(p.conflicting)},
     };
-    return Envelope::ok_response(req.id, std::move(result));
+}
+
+Envelope SolverLane::on_upsert(const Envelope& req) {
+    const json& args = req.args;
+    PreparedUpsert p =
+        prepare_upsert(args, previous_solves(args.value("sketchId", std::string{})));
+    if (!p.error.empty()) return err(req, "OP_FAILED", "SketchUpsert: " + p.error);
+    return Envelope::ok_response(req.id, commit_upsert(p));
+}
+
+// --- SketchUpsertBatch ------------------------------------------------------
+
+Envelope SolverLane::on_upsert_batch(const Envelope& req) {
+    const json& args = req.args;
+    if (!args.contains("sketches") || !args["sketches"].is_array()) {
+        return err(req, "OP_FAILED", "SketchUpsertBatch: missing sketches");
+    }
+    const json& sketches = args["sketches"];
+    const std::size_t n = sketches.size();
+
+    // Every sketch's cached solves are looked up BEFORE the pool starts: the
+    // workers read them, and nothing writes the map until every worker is done.
+    std::vector<const sk::ComponentSolveCache*> previous(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const json& s = sketches[i];
+        previous[i] = &previous_solves(s.is_object() ? s.value("sketchId", std::string{})
+                                                     : std::string{});
+    }
+
+    // Independent sketches share nothing but the read-only caches above, so
+    // they are prepared on the lane thread and up to kUpsertBatchWorkers - 1
+    // pool threads, each claiming the next unprepared index.
+    std::vector<PreparedUpsert> prepared(n);
+    std::atomic<std::size_t> next{0};
+    const auto work = [&] {
+        for (std::size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+            const json& s = sketches[i];
+            try {
+                if (!s.is_object()) {
+                    prepared[i].error = "not a sketch object";
+                } else {
+                    prepared[i] = prepare_upsert(s, *previous[i]);
+                }
+            } catch (const std::exception& ex) {
+                prepared[i].error = ex.what();
+            } catch (...) {
+                prepared[i].error = "solve failed";
+            }
+        }
+    };
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t workers = std::min({n, kUpsertBatchWorkers, std::size_t{hardware}});
+    if (workers > 1) upsert_pool().run(workers - 1, work);
+    else work();
+
+    // Committed in request order on the lane thread: the store sees exactly the
+    // writes, and hands out exactly the revisions, of n sequential SketchUpserts.
+    json results = json::array();
+    for (std::size_t i = 0; i < n; ++i) {
+        PreparedUpsert& p = prepared[i];
+        if (!p.error.empty()) {
+            results.push_back({{"sketchId", p.sketch_id},
+                               {"upserted", false},
+                               {"error",
+                                {{"code", "OP_FAILED"},
+                                 {"message", "SketchUpsertBatch: sketches[" +
+                                                 std::to_string(i) + "]: " + p.error}}}});
+            continue;
+        }
+        results.push_back(commit_upsert(p));
+    }
+    return Envelope::ok_response(req.id, {{"results", std::move(results)}});
 }
 
 // --- BeginGesture -----------------------------------------------------------
@@ -357,7 +605,9 @@ Envelope SolverLane::on_begin(const Envelope& req) {
     const std::string sketch_id = args.value("sketchId", std::string{});
     const std::uint64_t gesture_id = u64(args, "gestureId");
 
-    std::optional<session::StoredSketch> stored = store_.snapshot(sketch_id);
+    // The gesture mutates its sketch, so it translates its own from the pinned
+    // wire rather than sharing the version's.
+    const session::SketchVersion stored = store_.pin(sketch_id);
     if (!stored) return err(req, "REF_UNRESOLVED", "BeginGesture: unknown sketch " + sketch_id);
     if (args.contains("sketchRevision") &&
         u64(args, "sketchRevision") != stored->revision) {
@@ -487,11 +737,22 @@ Envelope SolverLane::on_begin(const Envelope& req) {
     g.redundant = redundant;
     g.conflicting = map_conflicting(tr.index, conflicting_internal);
     g.baseline = collect_positions(*tr.sketch);
-    g.last_reported = g.baseline;
     g.kind = kind;
     g.drag_entity = drag_entity;
     g.body_points = std::move(body_points);
 
+    // The same seeds run_step hands the sketch, so the scope is exactly the
+    // component each step solves.
+    std::vector<sk::EntityID> seeds;
+    switch (kind) {
+        case DragKind::Point:
+        case DragKind::ArcEnd: seeds = {g.drag_point}; break;
+        case DragKind::Radius: seeds = {g.drag_entity}; break;
+        case DragKind::EntityBody: seeds = g.body_points; break;
+    }
+    g.scope = tr.sketch->dragComponent(seeds);
+    g.last_reported = g.scope ? collect_positions(*tr.sketch, g.scope) : g.baseline;
+
     // The grab-derived offsets are captured HERE, once, from the POST-diagnosis
     // pose (the same pose `baseline` records) — SCHEMA §7.4: re-deriving them per
     // step would let the gesture drift under the cursor.
@@ -521,7 +782,8 @@ Envelope SolverLane::on_begin(const Envelope& req) {
     }
 
     g.baseline_curves = collect_curves(*tr.sketch);
-    g.last_reported_curves = g.baseline_curves;
+    g.last_reported_curves =
+        g.scope ? collect_curves(*tr.sketch, g.scope) : g.baseline_curves;
     g.sketch = std::move(tr.sketch);
     g.index = std::move(tr.index);
     gestures_[gesture_id] = std::move(g);
@@ -544,11 +806,13 @@ Envelope SolverLane::on_begin(const Envelope& req) {
 sk::SolveResult SolverLane::run_step(Gesture& g, double tx, double ty) {
     sk::Sketch& sketch = *g.sketch;
 
+    const sk::DragSeed seed = predict_seed(g, tx, ty);
+
     switch (g.kind) {
         case DragKind::Point:
             // Byte-identical to the pre-SP-2 lane: one point, one position,
             // `beginPointDrag`'s pins, `solveWithDrag`.
-            return sketch.solveWithDrag(g.drag_point, sk::Vec2d{tx, ty});
+            return sketch.solveWithDrag(g.drag_point, sk::Vec2d{tx, ty}, seed);
 
         case DragKind::ArcEnd: {
             // Pin every point EXCEPT the arc's own two endpoints. The CENTER is
@@ -568,13 +832,15 @@ sk::SolveResult SolverLane::run_step(Gesture& g, double tx, double ty) {
                 pins.insert(e->id());
             }
             sk::SolveResult r = sketch.solveWithTargets({{g.drag_point, sk::Vec2d{tx, ty}}}, {},
-                                                        pins);
+                                                        pins, seed);
             // §7.4 arc sweep floor: a collapsed arc cannot be recovered by
             // dragging further, so the pose is never entered. Restore what was
             // last REPORTED (positions AND curves, so the incremental deltas
             // stay honest) and answer partial with the gesture still OPEN.
             // (`arc` survives the solve — solving never reallocates entities.)
-            if (r.success && arc && arc_sweep_collapsed(*arc)) {
+            // An over-budget step may still have moved (its converged substeps
+            // stay), so the check is not limited to a successful one.
+            if ((r.success || r.interrupted) && arc && arc_sweep_collapsed(*arc)) {
                 restore_pose(sketch, g.last_reported, g.last_reported_curves);
                 r.success = false;
                 r.errorMessage = "Arc sweep below MIN_ARC_SWEEP";
@@ -605,7 +871,7 @@ sk::SolveResult SolverLane::run_step(Gesture& g, double tx, double ty) {
                 sk::constants::MIN_GEOMETRY_SIZE);  // §7.4 floor: never zero/negative
             std::unordered_set<sk::EntityID> pins;
             if (!center.empty()) pins.insert(center);
-            return sketch.solveWithTargets({}, {{g.drag_entity, target}}, pins);
+            return sketch.solveWithTargets({}, {{g.drag_entity, target}}, pins, seed);
         }
 
         case DragKind::EntityBody: {
@@ -623,7 +889,7 @@ sk::SolveResult SolverLane::run_step(Gesture& g, double tx, double ty) {
                 if (it == g.body_baseline.end()) continue;
                 targets[pid] = sk::Vec2d{it->second.first + dx, it->second.second + dy};
             }
-            return sketch.solveWithTargets(targets, {}, {});
+            return sketch.solveWithTargets(targets, {}, {}, seed);
         }
     }
 
@@ -633,9 +899,35 @@ sk::SolveResult SolverLane::run_step(Gesture& g, double tx, double ty) {
     return unreachable;
 }
 
+sk::DragSeed SolverLane::predict_seed(const Gesture& g, double tx, double ty) {
+    sk::DragSeed seed;
+    if (g.history.size() < 2) return seed;
+    const PoseSample& prev = g.history[g.history.size() - 2];
+    const PoseSample& last = g.history.back();
+
+    // How far along the LAST cursor step the new one goes. Only the component
+    // along the drag direction is predicted; the solver corrects the rest.
+    const double px = last.target.first - prev.target.first;
+    const double py = last.target.second - prev.target.second;
+    const double len2 = (px * px) + (py * py);
+    if (len2 < kPosEpsilon * kPosEpsilon) return seed;
+    const double k = (((tx - last.target.first) * px) + ((ty - last.target.second) * py)) / len2;
+    if (k <= 0.0 || k > kMaxExtrapolation) return seed;  // reversal, or a jump past trust
+
+    for (const auto& [id, at] : last.pose) {
+        const auto it = prev.pose.find(id);
+        if (it == prev.pose.end()) continue;
+        const double dx = at.first - it->second.first;
+        const double dy = at.second - it->second.second;
+        if (std::abs(dx) <= kPosEpsilon && std::abs(dy) <= kPosEpsilon) continue;
+        seed[id] = sk::Vec2d{at.first + (k * dx), at.second + (k * dy)};
+    }
+    return seed;
+}
+
 // --- SolveDrag --------------------------------------------------------------
 
-Envelope SolverLane::on_drag(const Envelope& req) {
+Envelope SolverLane::on_drag(const Envelope& req, const CancelToken* cancel) {
     const json& args = req.args;
     const std::uint64_t gesture_id = u64(args, "gestureId");
     const std::uint64_t seq = u64(args, "seq");
@@ -652,13 +944,23 @@ Envelope SolverLane::on_drag(const Envelope& req) {
     const auto before = g.last_reported;  // deltas are reported incrementally
     const auto before_curves = g.last_reported_curves;
     const auto t0 = std::chrono::steady_clock::now();
-    sk::SolveResult r = run_step(g, tx, ty);
+    sk::SolveResult r;
+    {
+        const BoundedSolve bounded(*g.sketch, solve_budget(args, kDragBudget), cancel);
+        r = run_step(g, tx, ty);
+    }
     const auto t1 = std::chrono::steady_clock::now();
     const auto solve_micros =
         std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
 
-    const auto cur = collect_positions(*g.sketch);
-    const auto cur_curves = collect_curves(*g.sketch);
+    // Cancelled mid-solve (a newer drag for this gesture, §7.4): the step was
+    // rolled back, so the pose is still the one last reported — nothing to diff.
+    if (r.interrupted && cancel != nullptr && cancel->cancelled()) {
+        return err(req, "CANCELLED", "SolveDrag: cancelled");
+    }
+
+    const auto cur = collect_positions(*g.sketch, g.scope);
+    const auto cur_curves = collect_curves(*g.sketch, g.scope);
 
     // Status precedence (SCHEMA §7.4: success | partial | conflicting | redundant):
     // conflicting > redundant > success, with partial for a non-converged solve.
@@ -679,6 +981,15 @@ Envelope SolverLane::on_drag(const Envelope& req) {
         status = "partial";
     }
 
+    // Only a pose the solver converged to on the drag path feeds the predictor;
+    // a refused, partial or restored step leaves the pose off it.
+    if (r.success && !r.interrupted) {
+        g.history.push_back({{tx, ty}, cur});
+        if (g.history.size() > kPredictorHistory) g.history.pop_front();
+    } else {
+        g.history.clear();
+    }
+
     json positions = changed_positions(before, cur, g.index);
     json curves = changed_curves(before_curves, cur_curves, g.index);
     g.last_reported = cur;
@@ -696,6 +1007,8 @@ Envelope SolverLane::on_drag(const Envelope& req) {
         // cannot carry. Emitted for every kind (an absent one parses as {}).
         {"curves", std::move(curves)},
         {"solveMicros", solve_micros},
+        {"iterations", r.iterations},
+        {"substeps", r.substeps},
     };
     return Envelope::ok_response(req.id, std::move(result));
 }
@@ -718,6 +1031,9 @@ Envelope SolverLane::on_end(const Envelope& req) {
     // failed gesture (rollback determinism, corpus g).
     sk::SolveResult r;
     bool did_final_drag = false;
+    // Not cancellable: the gesture is already dropped, so the commit must land.
+    std::optional<BoundedSolve> bounded;
+    bounded.emplace(*g.sketch, solve_budget(args, kEndBudget), nullptr, BudgetScope::PerSolve);
     if (args.contains("commit") && args["commit"].is_object() &&
         args["commit"].contains("finalTarget")) {
         const json ft = args["commit"]["finalTarget"];
@@ -726,6 +1042,10 @@ Envelope SolverLane::on_end(const Envelope& req) {
             // must be produced by the same pin sets that produced the preview.
             r = run_step(g, ft[0].get<double>(), ft[1].get<double>());
             did_final_drag = true;
+            // A substep over budget stops the drag with the converged substeps
+            // kept: back to the last reported pose, so the wire never commits
+            // a point part of the way to the pointer (`partial`).
+            if (r.interrupted) restore_pose(*g.sketch, g.last_reported, g.last_reported_curves);
         }
     }
     // Only the Point kind ever opened a point drag (see on_begin), and
@@ -752,13 +1072,7 @@ Envelope SolverLane::on_end(const Envelope& req) {
                                                ? map_conflicting(g.index, r.conflictingConstraints)
                                                : g.conflicting;
 
-    // Commit into the session store: bump revision + write back solved positions.
     const std::uint64_t new_rev = g.sketch_revision + 1;
-    if (std::optional<session::StoredSketch> s = store_.snapshot(g.sketch_id)) {
-        wire::apply_solved_positions(s->wire_args, *g.sketch, g.index);
-        store_.put(g.sketch_id, std::move(s->wire_args), new_rev);
-    }
-
     json result = {
         {"gestureId", gesture_id},
         {"status", status},
@@ -769,6 +1083,22 @@ Envelope SolverLane::on_end(const Envelope& req) {
         {"curves", changed_curves(g.baseline_curves, cur_curves, g.index)},
         {"sketchRevision", new_rev},
     };
+
+    // Commit into the session store: bump revision + write back solved positions.
+    // A converged gesture's sketch becomes the version's translated sketch — but
+    // only over the wire the gesture began from (an upsert mid-gesture replaced
+    // it), and only once its solve limits are gone: a version is immutable.
+    if (const session::SketchVersion current = store_.pin(g.sketch_id)) {
+        json wire_args = current->wire_args;
+        wire::apply_solved_positions(wire_args, *g.sketch, g.index);
+        session::TranslatedSketch translated;
+        if (r.success && current->revision == g.sketch_revision) {
+            bounded.reset();
+            translated = {std::move(g.sketch), std::move(g.index)};
+        }
+        store_.put(g.sketch_id, std::move(wire_args), new_rev, std::move(translated));
+    }
+    ops::profile_face_cache().invalidate_sketch(g.sketch_id);
     return Envelope::ok_response(req.id, std::move(result));
 }
 
@@ -777,16 +1107,26 @@ Envelope SolverLane::on_end(const Envelope& req) {
 Envelope SolverLane::on_regions(const Envelope& req) {
     const json& args = req.args;
     const std::string sketch_id = args.value("sketchId", std::string{});
-    std::optional<session::StoredSketch> stored = store_.snapshot(sketch_id);
+    const session::SketchVersion stored = store_.pin(sketch_id);
     if (!stored) return err(req, "REF_UNRESOLVED", "SketchRegions: unknown sketch " + sketch_id);
 
-    wire::TranslateResult tr = wire::translate(stored->wire_args);
-    if (!tr.ok) return err(req, "OP_FAILED", "SketchRegions: " + tr.error);
-    const sk::SolveResult solve = tr.sketch->solve();
-    if (!solve.success) {
-        const std::string detail =
-            solve.errorMessage.empty() ? "constraint solve did not converge" : solve.errorMessage;
-        return err(req, "OP_FAILED", "SketchRegions: solve failed: " + detail);
+    // The version's own solved sketch when its commit converged; otherwise the
+    // wire is translated and solved here, and the failure reported.
+    wire::TranslateResult tr;
+    const sk::Sketch* sketch = stored->translated.sketch.get();
+    const wire::WireIndex* index = &stored->translated.index;
+    if (!sketch) {
+        tr = wire::translate(stored->wire_args);
+        if (!tr.ok) return err(req, "OP_FAILED", "SketchRegions: " + tr.error);
+        const sk::SolveResult solve = tr.sketch->solve();
+        if (!solve.success) {
+            const std::string detail = solve.errorMessage.empty()
+                                           ? "constraint solve did not converge"
+                                           : solve.errorMessage;
+            return err(req, "OP_FAILED", "SketchRegions: solve failed: " + detail);
+        }
+        sketch = tr.sketch.get();
+        index = &tr.index;
     }
 
     loop::LoopDetectorConfig detection_config = loop::makeRegionDetectionConfig();
@@ -794,10 +1134,10 @@ Envelope SolverLane::on_regions(const Envelope& req) {
         loop::CurveRefinementPolicy::V3PhysicalProximity;
     loop::LoopDetector detector;
     detector.setConfig(detection_config);
-    const loop::LoopDetectionResult det = detector.detect(*tr.sketch);
+    const loop::LoopDetectionResult det = detector.detect(*sketch);
     const auto map_edge = [&](const sk::EntityID& internalId) {
-        const auto it = tr.index.internal_edge_to_wire.find(internalId);
-        return it != tr.index.internal_edge_to_wire.end() ? it->second : internalId;
+        const auto it = index->internal_edge_to_wire.find(internalId);
+        return it != index->internal_edge_to_wire.end() ? it->second : internalId;
     };
     const loop::RegionTable table = loop::buildRegionTable(
         det, map_edge, sk::constants::COINCIDENCE_TOLERANCE,
@@ -2,18 +2,27 @@
 //
 // Holds the live drag gestures (lane-local, unlocked) and a REFERENCE to the
 // session-owned, mutex-guarded `SketchStore` (W-WP4: sketch state is
-// session-owned — see Session.h / SketchStore.h). All five verbs (SketchUpsert /
+// session-owned — see Session.h / SketchStore.h). All the verbs (SketchUpsert[Batch] /
 // BeginGesture / SolveDrag / EndGesture / SketchRegions) run on the Dispatcher's
 // SOLVER lane; the store's own mutex makes the committed-sketch handoff to the
 // kernel lane (ExecutePlan regen reads) safe, while the warm PlaneGCS systems +
-// gestures stay lane-local here (never crossing lanes).
+// gestures stay lane-local here (never crossing lanes). SketchUpsertBatch (a
+// document's sketches at open) solves its sketches on a small pool of helper
+// threads shared by every session's lane, each on its own Sketch, and still
+// commits them on the lane thread.
 //
 // Gesture model: BeginGesture translates a fresh working `Sketch` from the
 // stored wire, builds + diagnoses the GCS system ONCE (warm start held for the
 // gesture), then each SolveDrag re-solves warm via the ported
 // `Sketch::solveWithDrag` (which rebuilds the solver only when dirty — it never
-// is mid-gesture). EndGesture does the final exact solve, writes the committed
-// positions back into the store, and drops the gesture.
+// is mid-gesture), starting from the pose predicted from the gesture's last
+// steps. A sketch of several independent profiles is solved per connected
+// component: a step builds, solves and diffs only the dragged one.
+// EndGesture does the final exact solve, writes the committed positions back
+// into the store, and drops the gesture. Both run under a per-verb time budget,
+// checked between PlaneGCS iterations; a SolveDrag is also cancellable, so a
+// newer drag for the gesture stops the one in flight (Dispatcher) and the
+// interrupted step rolls back instead of finishing a pose nobody will see.
 //
 // SP-2: a gesture also carries WHAT the pointer grabbed (SCHEMA §7.4
 // `drag.kind`). `point` is the pre-SP-2 behaviour and what an absent kind means;
@@ -25,9 +34,12 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -64,13 +76,26 @@ public:
     // reference. It must outlive the SolverLane (main owns both).
     explicit SolverLane(session::SketchStore& store) : store_(store) {}
 
-    // Register all five §7.4 verbs on the dispatcher's solver lane.
+    // Register all six §7.4 verbs on the dispatcher's solver lane.
     void register_verbs(Dispatcher& dispatcher);
 
+    // The six §7.4 verbs, and running one against this lane's session. A
+    // multi-document worker registers the verbs ONCE and routes each request to
+    // its session's lane (session/SessionRegistry.h).
+    // `cancel` (the Dispatcher job's token) interrupts a SolveDrag mid-solve;
+    // the other verbs are bounded by their time budget only.
+    static const std::vector<std::string>& verbs();
+    Envelope handle(const Envelope& req, const CancelToken* cancel = nullptr);
+
 private:
     // Point position by internal id (x,y).
     using PosMap = std::unordered_map<core::sketch::EntityID, std::pair<double, double>>;
 
+    struct PoseSample {
+        std::pair<double, double> target;
+        PosMap pose;
+    };
+
     struct Gesture {
         std::uint64_t id = 0;
         std::string sketch_id;
@@ -102,20 +127,62 @@ private:
         double radius_offset = 0.0;  // |grab − center| − radius, both at Begin
         CurveMap baseline_curves;       // curves at BeginGesture (EndGesture delta)
         CurveMap last_reported_curves;  // for incremental SolveDrag deltas
+        // The entities a step can move (`Sketch::dragComponent` of this kind's
+        // seeds); nullopt = the whole sketch. SolveDrag collects and diffs only
+        // these, so an untouched profile costs a step nothing. `last_reported*`
+        // are scoped to it; `baseline*` stay whole for EndGesture's final solve.
+        std::optional<std::unordered_set<core::sketch::EntityID>> scope;
+
+        // --- drag predictor (warm start) --------------------------------------
+        // The last converged steps, oldest first: the cursor target and the
+        // `scope` pose it solved to. Cleared by any step that leaves the pose
+        // off the drag path (refused, partial, interrupted, restored).
+        std::deque<PoseSample> history;
     };
 
     // One drag step toward (tx, ty) for this gesture's kind. Shared by SolveDrag
     // and EndGesture's `commit.finalTarget` branch so the two can never diverge.
     core::sketch::SolveResult run_step(Gesture& g, double tx, double ty);
 
+    // Where this step's moving points should start: the last converged pose
+    // advanced along its own last motion, scaled by how far the new cursor
+    // delta goes along the last one. Empty (no warm start) without two
+    // samples, on a reversal, or for a jump past kMaxExtrapolation.
+    static core::sketch::DragSeed predict_seed(const Gesture& g, double tx, double ty);
+
+    // One SketchUpsert up to its store write: translated, solved, diagnosed and
+    // answered. It reads nothing of the lane but the sketch's last component
+    // solves (`previous`), so SketchUpsertBatch prepares its sketches
+    // concurrently; `commit_upsert` then applies them one by one, in request
+    // order, on the lane thread.
+    struct PreparedUpsert {
+        std::string sketch_id;
+        std::string error;  // non-empty: nothing to commit (OP_FAILED)
+        nlohmann::json stored_args;
+        session::TranslatedSketch translated;  // the solved sketch (converged only)
+        core::sketch::ComponentSolveCache solves;
+        int dof = 0;
+        std::string state;
+        std::vector<std::string> conflicting;  // wire constraint ids
+    };
+    static PreparedUpsert prepare_upsert(const nlohmann::json& args,
+                                         const core::sketch::ComponentSolveCache& previous);
+    const core::sketch::ComponentSolveCache& previous_solves(const std::string& sketch_id) const;
+    // Store write, cache swap, face-cache invalidation; the SketchUpsert result.
+    nlohmann::json commit_upsert(PreparedUpsert& prepared);
+
     Envelope on_upsert(const Envelope& req);
+    Envelope on_upsert_batch(const Envelope& req);
     Envelope on_begin(const Envelope& req);
-    Envelope on_drag(const Envelope& req);
+    Envelope on_drag(const Envelope& req, const CancelToken* cancel);
     Envelope on_end(const Envelope& req);
     Envelope on_regions(const Envelope& req);
 
     session::SketchStore& store_;  // session-owned, self-locked (see Session.h)
     std::unordered_map<std::uint64_t, Gesture> gestures_;
+    // Each sketch's component solves from its last SketchUpsert, by sketch id
+    // (`Sketch::solveByComponent`; lane-local like the gestures).
+    std::unordered_map<std::string, core::sketch::ComponentSolveCache> component_solves_;
 };
 
 }  // namespace onecad::protocol
@@ -0,0 +1,223 @@
+// Zygote.cpp — see Zygote.h.
+#include "protocol/Zygote.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "util/Log.h"
+
+namespace onecad::protocol {
+
+namespace {
+
+constexpr char kMagic[4] = {'O', 'C', 'Z', '1'};
+
+bool socket_address(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+bool write_all(int fd, const void* data, std::size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        const ssize_t n = ::write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool read_all(int fd, void* data, std::size_t len) {
+    char* p = static_cast<char*>(data);
+    while (len > 0) {
+        const ssize_t n = ::read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+void write_pid(int fd, std::int64_t pid) {
+    unsigned char le[8];
+    const auto raw = static_cast<std::uint64_t>(pid);
+    for (int i = 0; i < 8; ++i) le[i] = static_cast<unsigned char>(raw >> (8 * i));
+    write_all(fd, le, sizeof(le));
+}
+
+// Receive the magic + the two or three descriptors of one spawn request.
+// `err_fd` stays -1 when the requester passed no stderr.
+bool receive_request(int conn, int& in_fd, int& out_fd, int& err_fd) {
+    char magic[4];
+    alignas(cmsghdr) char control[CMSG_SPACE(3 * sizeof(int))];
+    iovec iov{magic, sizeof(magic)};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n;
+    do {
+        n = ::recvmsg(conn, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n != static_cast<ssize_t>(sizeof(magic))) return false;
+    const cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+    if (cm == nullptr || cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS) {
+        return false;
+    }
+    std::size_t count = 0;
+    if (cm->cmsg_len == CMSG_LEN(2 * sizeof(int))) count = 2;
+    if (cm->cmsg_len == CMSG_LEN(3 * sizeof(int))) count = 3;
+    if (count == 0) return false;
+    int fds[3] = {-1, -1, -1};
+    std::memcpy(fds, CMSG_DATA(cm), count * sizeof(int));
+    if (std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+        for (std::size_t i = 0; i < count; ++i) ::close(fds[i]);
+        return false;
+    }
+    in_fd = fds[0];
+    out_fd = fds[1];
+    err_fd = fds[2];
+    return true;
+}
+
+}  // namespace
+
+int run_zygote(const std::string& socket_path, const std::function<int()>& child_main) {
+    sockaddr_un addr;
+    if (!socket_address(socket_path, addr)) {
+        WLOG_ERROR("zygote: socket path '%s' is empty or too long", socket_path.c_str());
+        return 2;
+    }
+    const int listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        WLOG_ERROR("zygote: socket(): %s", std::strerror(errno));
+        return 2;
+    }
+    ::unlink(socket_path.c_str());
+    if (::bind(listen_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd, 16) != 0) {
+        WLOG_ERROR("zygote: cannot listen on '%s': %s", socket_path.c_str(),
+                   std::strerror(errno));
+        ::close(listen_fd);
+        return 2;
+    }
+
+    // Auto-reap children: nothing in the zygote waits on them.
+    struct sigaction reap {};
+    reap.sa_handler = SIG_IGN;
+    reap.sa_flags = SA_NOCLDWAIT;
+    ::sigaction(SIGCHLD, &reap, nullptr);
+
+    WLOG_INFO("zygote: ready on %s (pid %d)", socket_path.c_str(), static_cast<int>(::getpid()));
+    for (;;) {
+        const int conn = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conn < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            WLOG_ERROR("zygote: accept(): %s", std::strerror(errno));
+            break;
+        }
+        int in_fd = -1;
+        int out_fd = -1;
+        int err_fd = -1;
+        if (!receive_request(conn, in_fd, out_fd, err_fd)) {
+            WLOG_WARN("zygote: dropping malformed spawn request");
+            ::close(conn);
+            continue;
+        }
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            // Child: an ordinary worker on the requester's descriptors.
+            ::close(listen_fd);
+            ::close(conn);
+            struct sigaction dfl {};
+            dfl.sa_handler = SIG_DFL;
+            ::sigaction(SIGCHLD, &dfl, nullptr);
+            ::setsid();  // outlives a signal aimed at the zygote's process group
+            if (::dup2(in_fd, STDIN_FILENO) < 0 || ::dup2(out_fd, STDOUT_FILENO) < 0) _exit(2);
+            if (err_fd >= 0 && ::dup2(err_fd, STDERR_FILENO) < 0) _exit(2);
+            ::close(in_fd);
+            ::close(out_fd);
+            if (err_fd >= 0) ::close(err_fd);
+            log::set_line_tag("worker " + std::to_string(::getpid()));
+            _exit(child_main());
+        }
+        if (pid < 0) WLOG_ERROR("zygote: fork(): %s", std::strerror(errno));
+        ::close(in_fd);
+        ::close(out_fd);
+        if (err_fd >= 0) ::close(err_fd);
+        write_pid(conn, pid);
+        ::close(conn);
+    }
+    ::close(listen_fd);
+    ::unlink(socket_path.c_str());
+    return 2;
+}
+
+pid_t zygote_spawn(const std::string& socket_path, int child_stdin, int child_stdout,
+                   int child_stderr, std::string& error) {
+    sockaddr_un addr;
+    if (!socket_address(socket_path, addr)) {
+        error = "socket path is empty or too long";
+        return -1;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        error = std::string("connect: ") + std::strerror(errno);
+        if (fd >= 0) ::close(fd);
+        return -1;
+    }
+    const int fds[3] = {child_stdin, child_stdout, child_stderr};
+    const std::size_t fds_len = (child_stderr >= 0 ? 3 : 2) * sizeof(int);
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))];
+    std::memset(control, 0, sizeof(control));
+    iovec iov{const_cast<char*>(kMagic), sizeof(kMagic)};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = CMSG_SPACE(fds_len);
+    cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(fds_len);
+    std::memcpy(CMSG_DATA(cm), fds, fds_len);
+    ssize_t n;
+    do {
+        n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    unsigned char le[8];
+    if (n != static_cast<ssize_t>(sizeof(kMagic)) || !read_all(fd, le, sizeof(le))) {
+        error = "zygote closed the request without a reply";
+        ::close(fd);
+        return -1;
+    }
+    ::close(fd);
+    std::uint64_t raw = 0;
+    for (int i = 0; i < 8; ++i) raw |= static_cast<std::uint64_t>(le[i]) << (8 * i);
+    const auto pid = static_cast<std::int64_t>(raw);
+    if (pid <= 0) {
+        error = "zygote could not fork";
+        return -1;
+    }
+    return static_cast<pid_t>(pid);
+}
+
+pid_t zygote_spawn(const std::string& socket_path, int child_stdin, int child_stdout,
+                   std::string& error) {
+    return zygote_spawn(socket_path, child_stdin, child_stdout, -1, error);
+}
+
+}  // namespace onecad::protocol
@@ -0,0 +1,57 @@
+// Zygote.h — pre-initialized worker spawning (`onecad-worker --zygote <socket>`).
+//
+// A cold worker start pays, before its hello: loading the OCCT toolkits, the
+// messenger redirect, STEP controller registration, and the first-use warm-up of
+// OCCT's allocator and lazily built tables. Rust respawns a worker after a crash,
+// on ResetSession escalation and per document, so every one of those waits is
+// user-visible. In zygote mode the process does all of that ONCE, then serves
+// spawn requests on a Unix-domain control socket and `fork()`s a fully warmed
+// child per request. The child is an ordinary worker: it runs on the descriptors
+// the requester passed and emits its own hello (SCHEMA §6) as its first frame.
+//
+// ── Control protocol ─────────────────────────────────────────────────────────
+// One request per connection: the requester sends the 4 bytes "OCZ1" with two or
+// three descriptors attached (SCM_RIGHTS) — the child's stdin, its stdout and,
+// optionally, its stderr — and reads back an i64 LE: the child's pid, or -1 when
+// the fork failed. The zygote closes its copies of the descriptors right after
+// the fork, so the child's stdin reaches EOF exactly when the requester closes its
+// end, as for a spawned process. Children are reaped by the zygote (SIGCHLD
+// ignored); the requester observes exit through the pipes and may signal the pid.
+//
+// A child without its own stderr descriptor writes to the zygote's, concurrently
+// with every sibling; each child therefore tags its log lines with its pid
+// (log::set_line_tag), whichever stderr it ends up on.
+//
+// ── Fork safety ──────────────────────────────────────────────────────────────
+// `fork()` copies only the calling thread, so the zygote must hold NO other
+// thread when it forks: the warm-up runs sequential OCCT (no `parallel`, no
+// OSD_ThreadPool), and the Dispatcher's lanes start only in the child. Process-
+// wide state configured before `run_zygote` (log level, the op-result cache) is
+// inherited by every child.
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <sys/types.h>
+
+namespace onecad::protocol {
+
+// Serve spawn requests on `socket_path` (a stale socket file is replaced) until
+// the process is signalled. Each child runs `child_main()` on the passed
+// descriptors as stdin/stdout and exits with its result. Returns 2 when the
+// socket cannot be set up.
+int run_zygote(const std::string& socket_path, const std::function<int()>& child_main);
+
+// Requester side: ask the zygote at `socket_path` for a worker on `child_stdin`
+// / `child_stdout` and, when `child_stderr` >= 0, logging to `child_stderr` (the
+// caller keeps, and should close, its own copies). Returns the child's pid, or
+// -1 with `error` set.
+pid_t zygote_spawn(const std::string& socket_path, int child_stdin, int child_stdout,
+                   int child_stderr, std::string& error);
+
+// As above, the child logging to the zygote's stderr.
+pid_t zygote_spawn(const std::string& socket_path, int child_stdin, int child_stdout,
+                   std::string& error);
+
+}  // namespace onecad::protocol
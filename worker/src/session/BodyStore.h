@@ -21,12 +21,15 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include <TopoDS_Shape.hxx>
 
+#include "session/ShapeMetrics.h"
+
 namespace onecad::session {
 
 // The single swap point: W-WP4 had `using BodyGeometry = StubBody;`. W-WP5 holds
@@ -35,6 +38,13 @@ using BodyGeometry = TopoDS_Shape;
 
 enum class BodyHealth { Healthy, Quarantined };
 
+// `compute_shape_metrics` of one exact shape value (TShape + location +
+// orientation). Immutable once built, so clones may share it freely.
+struct MetricsMemo {
+    BodyGeometry shape;
+    ShapeMetrics metrics;
+};
+
 inline const char* body_health_name(BodyHealth health) {
     return health == BodyHealth::Quarantined ? "quarantined" : "healthy";
 }
@@ -61,6 +71,13 @@ struct BodyRecord {
     // TopoKey is snapshot-scoped, so neither is a place to persist a color. Replay
     // restores them from the `xbf` import blob instead (SCHEMA §14, 2026-08-02).
     std::vector<std::uint32_t> face_colors;
+
+    // Memoized metrics for the geometry signature (`body_metrics`, Signatures.h).
+    // Keyed by the exact shape it was computed from, so replacing or moving `geom`
+    // invalidates it with no bookkeeping at the write sites. Shared across store
+    // clones, so a scratch step re-measures only the bodies it rebuilt. Written
+    // only by the lane that owns the store, like every other field here.
+    mutable std::shared_ptr<const MetricsMemo> metrics_memo;
 };
 
 // A registry of bodies keyed by BodyId, iterated in sorted id order for
@@ -28,10 +28,7 @@ std::string get_str(const json& o, const char* key, const std::string& dflt = ""
 // The partition entry (if any) whose body_id==bodyId and topo_key==topo.
 const em::PartitionEntry* entry_by_topokey(const em::ElementMapPartition& part,
                                            const std::string& body_id, const std::string& topo) {
-    for (const em::PartitionEntry* e : part.entries_for_body(body_id)) {
-        if (e->topo_key == topo) return e;
-    }
-    return nullptr;
+    return part.find_by_topokey(body_id, topo);
 }
 
 // Anchor-fallback sanity bound (VF-M3). `nearest_subshape` ranks candidates by
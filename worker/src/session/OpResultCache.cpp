@@ -0,0 +1,458 @@
+// OpResultCache.cpp — see OpResultCache.h.
+#include "session/OpResultCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+#include "elementmap/Scoring.h"
+#include "io/BrepCodec.h"
+#include "session/PlanExecutor.h"
+#include "util/Hashing.h"
+#include "util/Log.h"
+
+namespace onecad::session {
+
+using nlohmann::json;
+namespace em = onecad::elementmap;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[4] = {'O', 'C', 'R', '1'};
+constexpr const char* kSuffix = ".ocr";
+constexpr int kRecordVersion = 1;
+
+std::string get_str(const json& o, const char* key, const std::string& dflt = "") {
+    if (o.is_object() && o.contains(key) && o[key].is_string()) return o[key].get<std::string>();
+    return dflt;
+}
+
+json entry_json(const em::PartitionEntry& e) {
+    return json{{"elementId", e.element_id},
+                {"bodyId", e.body_id},
+                {"kind", em::ElementMapPartition::kind_name(e.kind)},
+                {"topoKey", e.topo_key},
+                {"anchor", e.anchor}};
+}
+
+json body_fields_json(const BodyRecord& rec) {
+    json j{{"bodyId", rec.id},
+           {"provenance", rec.provenance},
+           {"visible", rec.visible},
+           {"health", body_health_name(rec.health)}};
+    if (!rec.health_reason.empty()) j["healthReason"] = rec.health_reason;
+    if (!rec.face_colors.empty()) j["faceColors"] = rec.face_colors;
+    return j;
+}
+
+bool same_record(const BodyRecord& a, const BodyRecord& b) {
+    return a.geom.IsEqual(b.geom) && a.provenance == b.provenance && a.visible == b.visible &&
+           a.health == b.health && a.health_reason == b.health_reason &&
+           a.face_colors == b.face_colors;
+}
+
+json body_event_json(const BodyEvent& e) {
+    json j{{"kind", e.kind}, {"bodyId", e.body_id}};
+    if (e.rank_key) j["rankKey"] = *e.rank_key;
+    if (e.health) j["health"] = *e.health;
+    return j;
+}
+
+BodyEvent body_event_from_json(const json& j) {
+    BodyEvent e;
+    e.kind = get_str(j, "kind");
+    e.body_id = get_str(j, "bodyId");
+    if (j.contains("rankKey") && j["rankKey"].is_array()) e.rank_key = j["rankKey"].get<RankKey>();
+    if (j.contains("health") && j["health"].is_string()) e.health = j["health"].get<std::string>();
+    return e;
+}
+
+em::DeltaEntry delta_entry_from_json(const json& j) {
+    return em::DeltaEntry{get_str(j, "elementId"), get_str(j, "topoKey"), get_str(j, "kind"),
+                          get_str(j, "bodyId")};
+}
+
+// sha256 of an external file's bytes, or "" when it cannot be read.
+std::string file_digest(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return "";
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (in.bad()) return "";
+    return hashing::sha256_hex(bytes);
+}
+
+// The files a step reads besides the session state: `ImportStep`'s `params.path`
+// and a component blob source's `params.source.path`. Keyed by content, so a
+// re-materialized temp path with the same bytes still hits.
+bool external_inputs(const json& op, json& out) {
+    out = json::array();
+    const json params = op.contains("params") && op["params"].is_object() ? op["params"]
+                                                                          : json::object();
+    std::vector<std::string> paths;
+    if (!get_str(params, "path").empty()) paths.push_back(get_str(params, "path"));
+    if (params.contains("source") && !get_str(params["source"], "path").empty())
+        paths.push_back(get_str(params["source"], "path"));
+    for (const std::string& path : paths) {
+        const std::string digest = file_digest(path);
+        if (digest.empty()) return false;
+        out.push_back(digest);
+    }
+    return true;
+}
+
+// The op with its file paths blanked: the content digests stand in for them.
+json op_without_paths(json op) {
+    if (!op.contains("params") || !op["params"].is_object()) return op;
+    json& params = op["params"];
+    if (params.contains("path")) params["path"] = "";
+    if (params.contains("source") && params["source"].is_object() &&
+        params["source"].contains("path"))
+        params["source"]["path"] = "";
+    return op;
+}
+
+bool read_file(const fs::path& path, OpResultRecord& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 8 || std::memcmp(bytes.data(), kMagic, 4) != 0) return false;
+    std::uint32_t json_len = 0;
+    for (int i = 0; i < 4; ++i)
+        json_len |= static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[4 + i])) << (8 * i);
+    if (json_len > bytes.size() - 8) return false;
+    out.meta = json::parse(bytes.begin() + 8, bytes.begin() + 8 + json_len, nullptr,
+                           /*allow_exceptions=*/false);
+    if (!out.meta.is_object() || out.meta.value("version", 0) != kRecordVersion) return false;
+    out.bin.assign(bytes.begin() + 8 + json_len, bytes.end());
+    return hashing::sha256_hex(out.bin.data(), out.bin.size()) == get_str(out.meta, "binSha256");
+}
+
+}  // namespace
+
+// --- store -----------------------------------------------------------------
+
+void OpResultCache::configure(const fs::path& dir, std::uint64_t max_bytes, bool verify) {
+    std::lock_guard<std::mutex> lk(mu_);
+    dir_.clear();
+    files_.clear();
+    bytes_ = 0;
+    max_bytes_ = max_bytes;
+    verify_ = verify;
+    if (dir.empty()) return;
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (!fs::is_directory(dir, ec)) {
+        WLOG_WARN("op-result cache: '%s' is not a usable directory; cache off",
+                  dir.string().c_str());
+        return;
+    }
+    dir_ = dir;
+    // Index existing entries oldest-first so the LRU order survives restarts.
+    std::vector<std::pair<fs::file_time_type, std::pair<std::string, std::uint64_t>>> found;
+    for (const fs::directory_entry& de : fs::directory_iterator(dir_, ec)) {
+        if (!de.is_regular_file(ec) || de.path().extension() != kSuffix) continue;
+        found.push_back({de.last_write_time(ec), {de.path().stem().string(), de.file_size(ec)}});
+    }
+    std::sort(found.begin(), found.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [mtime, file] : found) {
+        files_[file.first] = FileInfo{file.second, ++tick_};
+        bytes_ += file.second;
+    }
+    evict_locked();
+    WLOG_INFO("op-result cache: %s (%zu entries, %llu bytes, cap %llu%s)", dir_.string().c_str(),
+              files_.size(), static_cast<unsigned long long>(bytes_),
+              static_cast<unsigned long long>(max_bytes_), verify_ ? ", verify" : "");
+}
+
+bool OpResultCache::enabled() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return !dir_.empty();
+}
+
+bool OpResultCache::verify() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return verify_;
+}
+
+fs::path OpResultCache::path_of(const std::string& key) const { return dir_ / (key + kSuffix); }
+
+std::optional<OpResultRecord> OpResultCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (dir_.empty()) return std::nullopt;
+    auto it = files_.find(key);
+    OpResultRecord record;
+    if (it == files_.end() || !read_file(path_of(key), record)) {
+        if (it != files_.end()) {
+            WLOG_WARN("op-result cache: dropping unreadable entry %s", key.c_str());
+            erase_locked(key);
+        }
+        ++misses_;
+        return std::nullopt;
+    }
+    it->second.tick = ++tick_;
+    std::error_code ec;
+    fs::last_write_time(path_of(key), fs::file_time_type::clock::now(), ec);
+    ++hits_;
+    return record;
+}
+
+void OpResultCache::insert(const std::string& key, const OpResultRecord& record) {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (dir_.empty()) return;
+    json meta = record.meta;
+    meta["version"] = kRecordVersion;
+    meta["binSha256"] = hashing::sha256_hex(record.bin.data(), record.bin.size());
+    const std::string text = meta.dump();
+    const auto json_len = static_cast<std::uint32_t>(text.size());
+
+    // Unique per process and per write: concurrent workers sharing the directory
+    // never write the same temp file, and the rename publishes whole entries only.
+    static std::atomic<std::uint64_t> serial{0};
+    const fs::path tmp = dir_ / (key + ".tmp." + std::to_string(::getpid()) + "." +
+                                 std::to_string(serial.fetch_add(1)));
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(kMagic, 4);
+        for (int i = 0; i < 4; ++i) out.put(static_cast<char>((json_len >> (8 * i)) & 0xFF));
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        out.write(reinterpret_cast<const char*>(record.bin.data()),
+                  static_cast<std::streamsize>(record.bin.size()));
+        if (!out.good()) {
+            out.close();
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            WLOG_WARN("op-result cache: write failed for %s", key.c_str());
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp, path_of(key), ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        WLOG_WARN("op-result cache: rename failed for %s", key.c_str());
+        return;
+    }
+    const std::uint64_t size = 8 + text.size() + record.bin.size();
+    auto it = files_.find(key);
+    if (it != files_.end()) bytes_ -= it->second.size;
+    files_[key] = FileInfo{size, ++tick_};
+    bytes_ += size;
+    evict_locked();
+}
+
+void OpResultCache::erase_locked(const std::string& key) {
+    auto it = files_.find(key);
+    if (it == files_.end()) return;
+    bytes_ -= it->second.size;
+    files_.erase(it);
+    std::error_code ec;
+    fs::remove(path_of(key), ec);
+}
+
+void OpResultCache::evict_locked() {
+    while (bytes_ > max_bytes_ && !files_.empty()) {
+        auto oldest = std::min_element(
+            files_.begin(), files_.end(),
+            [](const auto& a, const auto& b) { return a.second.tick < b.second.tick; });
+        erase_locked(std::string(oldest->first));
+    }
+}
+
+void OpResultCache::note_mismatch() {
+    std::lock_guard<std::mutex> lk(mu_);
+    ++mismatches_;
+}
+
+std::size_t OpResultCache::size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return files_.size();
+}
+
+std::uint64_t OpResultCache::bytes() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return bytes_;
+}
+
+std::uint64_t OpResultCache::hits() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return hits_;
+}
+
+std::uint64_t OpResultCache::misses() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return misses_;
+}
+
+std::uint64_t OpResultCache::mismatches() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return mismatches_;
+}
+
+OpResultCache& op_result_cache() {
+    static OpResultCache cache;
+    return cache;
+}
+
+// --- keys --------------------------------------------------------------------
+
+std::string state_digest(const BodyStore& bodies, const em::ElementMapPartition& part) {
+    json state{{"bodies", json::array()}, {"partition", partition_entries_json(part)}};
+    for (const auto& [id, rec] : bodies.all()) {
+        std::vector<std::uint8_t> blob;
+        io::write_brep_shape(rec.geom, blob);
+        json body = body_fields_json(rec);
+        body["brep"] = hashing::sha256_hex(blob.data(), blob.size());
+        state["bodies"].push_back(std::move(body));
+    }
+    return hashing::sha256_hex("state0|" + state.dump());
+}
+
+std::string op_result_key(const std::string& state, const json& op, bool post_edit,
+                          bool from_zero_replay, ops::ValidationMode validation_mode) {
+    json files;
+    if (!external_inputs(op, files)) return "";
+    // json objects are key-sorted, so dump() is canonical.
+    const json material{{"seed", ONECAD_OCCT_FINGERPRINT_SEED},
+                        {"resolverVersion", em::kResolverVersion},
+                        {"brepFormat", io::kBrepFormatVersion},
+                        {"record", kRecordVersion},
+                        {"state", state},
+                        {"postEdit", post_edit},
+                        {"fromZeroReplay", from_zero_replay},
+                        {"validationMode", static_cast<int>(validation_mode)},
+                        {"op", op_without_paths(op)},
+                        {"files", std::move(files)}};
+    return hashing::sha256_hex(material.dump());
+}
+
+std::string next_state_digest(const std::string& key) {
+    return hashing::sha256_hex("state|" + key);
+}
+
+// --- records -----------------------------------------------------------------
+
+json outcome_json(const CandidateResult& result) {
+    json events = json::array();
+    for (const BodyEvent& e : result.body_events) events.push_back(body_event_json(e));
+    json out{{"bodyEvents", std::move(events)},
+             {"bodyIds", result.body_ids},
+             {"delta", result.delta.to_json()},
+             {"needsRepair", result.needs_repair},
+             {"diagnostics", result.diagnostics}};
+    if (result.mate_placement) out["matePlacement"] = *result.mate_placement;
+    return out;
+}
+
+json partition_entries_json(const em::ElementMapPartition& part) {
+    json entries = json::array();
+    for (const em::PartitionEntry* e : part.entries()) entries.push_back(entry_json(*e));
+    return entries;
+}
+
+OpResultRecord capture_op_result(const BodyStore& before_bodies,
+                                 const em::ElementMapPartition& before_part,
+                                 const BodyStore& after_bodies,
+                                 const em::ElementMapPartition& after_part,
+                                 const CandidateResult& result) {
+    OpResultRecord record;
+    json bodies = json::array();
+    for (const auto& [id, rec] : after_bodies.all()) {
+        const BodyRecord* before = before_bodies.get(id);
+        if (before != nullptr && same_record(*before, rec)) continue;
+        std::vector<std::uint8_t> blob;
+        io::write_brep_shape(rec.geom, blob);
+        json body = body_fields_json(rec);
+        body["off"] = record.bin.size();
+        body["len"] = blob.size();
+        record.bin.insert(record.bin.end(), blob.begin(), blob.end());
+        bodies.push_back(std::move(body));
+    }
+    json erased_bodies = json::array();
+    for (const auto& [id, rec] : before_bodies.all()) {
+        if (!after_bodies.contains(id)) erased_bodies.push_back(id);
+    }
+
+    // Copy-on-write: an entry the step wrote is a different object than before.
+    json entries = json::array();
+    for (const em::PartitionEntry* e : after_part.entries()) {
+        if (before_part.find(e->element_id) != e) entries.push_back(entry_json(*e));
+    }
+    json erased_entries = json::array();
+    for (const em::PartitionEntry* e : before_part.entries()) {
+        if (!after_part.contains(e->element_id)) erased_entries.push_back(e->element_id);
+    }
+
+    record.meta = json{{"bodies", std::move(bodies)},
+                       {"erasedBodies", std::move(erased_bodies)},
+                       {"entries", std::move(entries)},
+                       {"erasedEntries", std::move(erased_entries)},
+                       {"outcome", outcome_json(result)}};
+    return record;
+}
+
+bool apply_op_result(const OpResultRecord& record, BodyStore& bodies,
+                     em::ElementMapPartition& part, CandidateResult& result) {
+    const json& meta = record.meta;
+    for (const json& id : meta.value("erasedBodies", json::array())) {
+        bodies.erase(id.get<std::string>());
+    }
+    for (const json& b : meta.value("bodies", json::array())) {
+        const std::uint64_t off = b.value("off", std::uint64_t{0});
+        const std::uint64_t len = b.value("len", std::uint64_t{0});
+        if (off > record.bin.size() || len > record.bin.size() - off) return false;
+        TopoDS_Shape shape;
+        if (!io::read_brep_shape(record.bin.data() + off, len, shape).empty()) return false;
+        const std::string id = get_str(b, "bodyId");
+        BodyRecord& rec = bodies.create(id, get_str(b, "provenance"), shape);
+        rec.visible = b.value("visible", true);
+        if (get_str(b, "health") == body_health_name(BodyHealth::Quarantined))
+            bodies.quarantine(id, get_str(b, "healthReason"));
+        if (b.contains("faceColors") && b["faceColors"].is_array())
+            rec.face_colors = b["faceColors"].get<std::vector<std::uint32_t>>();
+    }
+
+    for (const json& id : meta.value("erasedEntries", json::array())) {
+        part.erase(id.get<std::string>());
+    }
+    for (const json& e : meta.value("entries", json::array())) {
+        const std::string key = get_str(e, "topoKey");
+        const BodyRecord* rec = bodies.get(get_str(e, "bodyId"));
+        if (rec == nullptr) return false;
+        const TopoDS_Shape sub = em::ElementMapPartition::shape_for_topokey(rec->geom, key);
+        if (sub.IsNull()) return false;
+        const em::DeltaEntry bound =
+            part.mint(rec->id, get_str(e, "elementId"),
+                      em::ElementMapPartition::kind_from_name(get_str(e, "kind")), sub, rec->geom,
+                      e.value("anchor", json()));
+        if (bound.topo_key != key) return false;
+    }
+
+    const json outcome = meta.value("outcome", json::object());
+    result.status = CandidateResult::Status::Ok;
+    for (const json& e : outcome.value("bodyEvents", json::array()))
+        result.body_events.push_back(body_event_from_json(e));
+    result.body_ids = outcome.value("bodyIds", std::vector<std::string>{});
+    const json delta = outcome.value("delta", json::object());
+    for (const json& e : delta.value("added", json::array()))
+        result.delta.added.push_back(delta_entry_from_json(e));
+    for (const json& e : delta.value("relabeled", json::array()))
+        result.delta.relabeled.push_back(delta_entry_from_json(e));
+    for (const json& id : delta.value("removed", json::array()))
+        result.delta.removed.push_back(id.get<std::string>());
+    for (const json& r : outcome.value("needsRepair", json::array()))
+        result.needs_repair.push_back(r);
+    for (const json& d : outcome.value("diagnostics", json::array()))
+        result.diagnostics.push_back(d);
+    if (outcome.contains("matePlacement")) result.mate_placement = outcome["matePlacement"];
+    return true;
+}
+
+}  // namespace onecad::session
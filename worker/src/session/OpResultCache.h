@@ -0,0 +1,153 @@
+// OpResultCache.h — optional on-disk, content-addressed cache of ExecutePlan step
+// results, shared across worker restarts.
+//
+// A step is a pure function of what it runs on: the op record, the scratch state
+// it finds (bodies + partition + the plan's sketches), the plan flags that steer
+// the resolution ladder, the bytes of any external file it reads, and the kernel
+// build (`ONECAD_OCCT_FINGERPRINT_SEED`, which folds in the OCCT version and
+// `ONECAD_KERNEL_POLICY_VERSION`). Re-opening a document replays the same steps
+// on the same states, so every step's outcome can be reused from a previous
+// process instead of being rebuilt.
+//
+// ── Keys: a digest chain ─────────────────────────────────────────────────────
+// Hashing the whole BRep state before every step would cost a BinTools write of
+// every body per step. Instead the plan's BASE state is digested once (bodies'
+// BinTools bytes + metadata + partition entries; a from-0 plan's empty base is a
+// constant) and each step's successor state is named by the key of the step that
+// produced it:
+//
+//   key_k   = sha256(seed, resolver/brep versions, state_k, flags, op_k, files_k)
+//   state_0 = state_digest(base)          state_k+1 = sha256("state", key_k)
+//
+// so a key covers every input BRep the step can see without re-serializing it.
+// Sketch steps only advance the chain; a step that does not complete Ok stops
+// the plan and is never stored.
+//
+// ── Values ───────────────────────────────────────────────────────────────────
+// What the step CHANGED, not the whole state: each created/replaced body as a
+// BinTools blob (triangulation kept, io/BrepCodec.h) + its record fields, the
+// erased body ids, every partition entry the step wrote as {elementId, bodyId,
+// kind, topoKey, anchor} (re-minted at its topoKey on replay, which recomputes
+// the shape and descriptor from the same sub-shape), the erased element ids, and
+// the step's wire outcome (bodyEvents, bodyIds, elementMapDelta, needsRepair,
+// diagnostics, matePlacement). Written entries are found by pointer identity
+// against the pre-step partition: entries are copy-on-write, so an entry the
+// step did not touch is still the SAME object (ElementMapPartition.h).
+//
+// ── Store ────────────────────────────────────────────────────────────────────
+// One file per key, `<dir>/<key>.ocr`: "OCR1" + u32 LE json length + json +
+// blob bytes, the blob's sha256 in the json. Written to a unique temp file and
+// renamed into place, so a reader (or a crash) never sees a torn entry; an
+// unreadable or corrupt file is a miss and is deleted. A hit refreshes the
+// file's mtime; inserts evict least-recently-used files until the directory is
+// under its byte cap. Off unless a directory is configured (`--op-cache-dir`).
+//
+// VERIFY mode (`--op-cache-verify`) still runs every step on a hit and compares
+// the recorded outcome, geometry signature and partition against the computed
+// ones; a mismatch is logged, counted and overwritten with the computed result,
+// which is the one published.
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "elementmap/ElementMapPartition.h"
+#include "nlohmann/json.hpp"
+#include "ops/OpTypes.h"
+#include "session/BodyStore.h"
+
+namespace onecad::session {
+
+struct CandidateResult;  // PlanExecutor.h
+
+// One stored step: the json record + the blob bytes its body entries address.
+struct OpResultRecord {
+    nlohmann::json meta;
+    std::vector<std::uint8_t> bin;
+};
+
+// The on-disk store. Thread-safe; a single instance per process.
+class OpResultCache {
+public:
+    static constexpr std::uint64_t kDefaultMaxBytes = 1024ull * 1024 * 1024;
+
+    // Point the cache at `dir` (created if missing) and index what is already
+    // there. An empty `dir` switches the cache off.
+    void configure(const std::filesystem::path& dir, std::uint64_t max_bytes, bool verify);
+
+    bool enabled() const;
+    bool verify() const;
+
+    std::optional<OpResultRecord> find(const std::string& key);
+    // Atomically writes (or replaces) the entry, then evicts down to the cap.
+    void insert(const std::string& key, const OpResultRecord& record);
+    void note_mismatch();
+
+    std::size_t size() const;
+    std::uint64_t bytes() const;
+    std::uint64_t hits() const;
+    std::uint64_t misses() const;
+    std::uint64_t mismatches() const;
+
+private:
+    struct FileInfo {
+        std::uint64_t size = 0;
+        std::uint64_t tick = 0;  // last use; lower == older
+    };
+
+    std::filesystem::path path_of(const std::string& key) const;
+    void erase_locked(const std::string& key);
+    void evict_locked();
+
+    mutable std::mutex mu_;
+    std::filesystem::path dir_;
+    std::uint64_t max_bytes_ = kDefaultMaxBytes;
+    bool verify_ = false;
+    std::map<std::string, FileInfo> files_;
+    std::uint64_t bytes_ = 0;
+    std::uint64_t tick_ = 0;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+    std::uint64_t mismatches_ = 0;
+};
+
+// The process-wide instance ExecutePlan consults (configured by main.cpp).
+OpResultCache& op_result_cache();
+
+// Digest of a base state: every body's BinTools bytes + record fields, and the
+// partition entries. The empty state has a fixed digest.
+std::string state_digest(const BodyStore& bodies, const elementmap::ElementMapPartition& part);
+
+// The key of running `op` on the state named `state`, or "" when the op is not
+// cacheable (it names an external file that cannot be read).
+std::string op_result_key(const std::string& state, const nlohmann::json& op, bool post_edit,
+                          bool from_zero_replay, ops::ValidationMode validation_mode);
+
+// The digest of the state a step keyed `key` leaves behind.
+std::string next_state_digest(const std::string& key);
+
+// Record what a completed Ok step changed between `before_*` and `after_*`.
+OpResultRecord capture_op_result(const BodyStore& before_bodies,
+                                 const elementmap::ElementMapPartition& before_part,
+                                 const BodyStore& after_bodies,
+                                 const elementmap::ElementMapPartition& after_part,
+                                 const CandidateResult& result);
+
+// Replay a record onto `bodies`/`part` and fill `result`'s outcome fields. False
+// (state partly written — callers apply to copies) when a blob does not decode
+// or an entry does not rebind at its topoKey.
+bool apply_op_result(const OpResultRecord& record, BodyStore& bodies,
+                     elementmap::ElementMapPartition& part, CandidateResult& result);
+
+// The step outcome fields a record carries, as compared by verify mode.
+nlohmann::json outcome_json(const CandidateResult& result);
+
+// Every partition entry as recorded ({elementId, bodyId, kind, topoKey, anchor}).
+nlohmann::json partition_entries_json(const elementmap::ElementMapPartition& part);
+
+}  // namespace onecad::session
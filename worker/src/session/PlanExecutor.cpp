@@ -31,11 +31,14 @@
 #include "ops/RevolveOp.h"
 #include "ops/ShellOp.h"
 #include "protocol/Limits.h"
+#include "session/OpResultCache.h"
 #include "session/Signatures.h"
 #include "tess/MeshHandle.h"
 #include "tess/Tessellate.h"
 #include "util/Hashing.h"
 #include "util/Log.h"
+#include "util/Stats.h"
+#include "util/Trace.h"
 
 namespace onecad::session {
 
@@ -97,6 +100,8 @@ void resolve_input_refs(ScratchJob& job, const json& op, const std::string& op_i
                         const em::LadderEditContext& edit, em::ElementMapDelta& delta,
                         std::vector<json>& needs_repair) {
     if (!op.contains("inputs") || !op["inputs"].is_array()) return;
+    const trace::Span span("ladder", op_id);
+    const stats::PhaseTimer phase(stats::Phase::Ladder);
 
     // Group sub-element refs by owning body (assignment/scoring is per-body pool).
     std::map<std::string, std::vector<em::LadderRef>> by_body;
@@ -168,6 +173,8 @@ json make_needs_repair(const json& op, const std::string& op_id) {
 
 json signatures_json(const BodyStore& bodies, const std::vector<BodyEvent>& events,
                      const std::vector<RefBinding>& bindings) {
+    const trace::Span span("signature");
+    const stats::PhaseTimer phase(stats::Phase::Signature);
     return json{{"geometry", geometry_signature(bodies)},
                 {"bodyLifecycle", body_lifecycle_signature(events)},
                 {"referencedBinding", referenced_binding_signature(bindings)}};
@@ -177,7 +184,8 @@ void emit_plan_step(HandlerContext& ctx, std::uint64_t req_id, std::uint64_t job
                     std::uint64_t step_index, const std::vector<BodyEvent>& events,
                     const json& element_map_delta, const json& needs_repair, const json& signatures,
                     const json& diagnostics,
-                    const std::optional<json>& mate_placement = std::nullopt) {
+                    const std::optional<json>& mate_placement = std::nullopt,
+                    const json& timings = json()) {
     json body_events = json::array();
     for (const auto& e : events) {
         json be = {{"kind", e.kind}, {"bodyId", e.body_id}};
@@ -200,11 +208,62 @@ void emit_plan_step(HandlerContext& ctx, std::uint64_t req_id, std::uint64_t job
     // step that actually reseated a mate — absence keeps every other step
     // byte-identical to the pre-WP-3.1 wire.
     if (mate_placement) payload["matePlacement"] = *mate_placement;
+    // `stepTimings` plans only (SCHEMA §7.2); absent otherwise.
+    if (!timings.is_null()) payload["timings"] = timings;
     Envelope ev = Envelope::event(req_id, "planStep", step_index, std::move(payload));
     ev.stamp.job_id = job_id;
     if (ctx.emit) ctx.emit(ev);
 }
 
+std::int64_t signed_delta(std::optional<std::uint64_t> before,
+                          std::optional<std::uint64_t> after) {
+    return static_cast<std::int64_t>(*after) - static_cast<std::int64_t>(*before);
+}
+
+// The cost of ONE plan step for a `stepTimings` plan (SCHEMA §7.2): exclusive
+// per-phase wall time (stats::PhaseScope) plus the RSS / malloc deltas across the
+// step. Inert — no clock, no /proc read — for every other plan.
+class StepCost {
+public:
+    explicit StepCost(bool enabled) {
+        if (!enabled) return;
+        rss_before_ = stats::current_rss_bytes();
+        allocated_before_ = stats::allocated_bytes();
+        started_ = std::chrono::steady_clock::now();
+        scope_.emplace(totals_);
+    }
+
+    // The `timings` object, or null when disabled. Call once, after the step's last
+    // timed phase (its signatures) and before emitting it.
+    json finish() {
+        if (!scope_) return json();
+        scope_.reset();
+        const auto total = std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::steady_clock::now() - started_)
+                               .count();
+        json t = {{"totalUs", total},
+                  {"ladderUs", totals_.of(stats::Phase::Ladder)},
+                  {"buildUs", totals_.of(stats::Phase::Build)},
+                  {"auditUs", totals_.of(stats::Phase::Audit)},
+                  {"historyUs", totals_.of(stats::Phase::History)},
+                  {"signatureUs", totals_.of(stats::Phase::Signature)}};
+        const std::optional<std::uint64_t> rss_after = stats::current_rss_bytes();
+        if (rss_before_ && rss_after) t["rssDeltaBytes"] = signed_delta(rss_before_, rss_after);
+        const std::optional<std::uint64_t> allocated_after = stats::allocated_bytes();
+        if (allocated_before_ && allocated_after) {
+            t["allocatedDeltaBytes"] = signed_delta(allocated_before_, allocated_after);
+        }
+        return t;
+    }
+
+private:
+    stats::PhaseTotals totals_;
+    std::optional<stats::PhaseScope> scope_;
+    std::optional<std::uint64_t> rss_before_;
+    std::optional<std::uint64_t> allocated_before_;
+    std::chrono::steady_clock::time_point started_{};
+};
+
 json fail_diagnostic(const std::string& code, const std::string& message) {
     return json{{"severity", "error"},
                 {"code", code.size() <= 128 ? code : "OP_FAILED"},
@@ -339,9 +398,11 @@ void merge_outcome(CandidateResult& result, ops::OpOutcome outcome) {
         // NeedsRepair evidence (Component Library P3 WP-3.1: a mated
         // `PlaceComponent` publishes at its frozen `placement` AND flags a
         // stale mate simultaneously — spec §5.5 "never drop it, never
-        // silently move it"). Every OTHER op's needs_repair path returns
-        // BEFORE building any geometry (Hole/Fillet/Chamfer/Shell/
-        // OffsetFace all early-return on an unresolved ref, e.g.
+        // silently move it"); a multi-seat `points[]` Hole likewise drills
+        // its resolvable seats and flags the rest per seat. Every OTHER
+        // needs_repair path returns BEFORE building any geometry (Hole/
+        // Fillet/Chamfer/Shell/OffsetFace all early-return on an
+        // unresolved ref, e.g.
         // `HoleOp.cpp`'s `if (face.IsNull()) { out.needs_repair...; return
         // out; }` before the tool solid is ever built) — `result.
         // body_events` is empty there, so this branch is unreachable for
@@ -541,6 +602,80 @@ json candidate_diagnostics(const CandidateResult& candidate) {
 
 namespace {
 
+// `execute_candidate_op` behind the op-result cache (session/OpResultCache.h). A
+// hit is replayed onto copies of the scratch state and installed only if every
+// body decodes and every entry rebinds at its recorded topoKey; anything else
+// falls through to a real execution, whose Ok result is stored under the key.
+CandidateResult run_plan_step(ScratchJob& job, const json& op, const std::string& op_id,
+                              std::string& last_sketch_id, const onecad::CancelToken& cancel) {
+    OpResultCache& cache = op_result_cache();
+    if (!cache.enabled() || cancel.cancelled()) {
+        return execute_candidate_op(job, op, op_id, last_sketch_id, cancel);
+    }
+    // The base digest covers bodies + partition only, so it can (re)start the
+    // chain only while the plan has materialized no sketch.
+    if (job.state_digest.empty() && job.sketches.empty() && last_sketch_id.empty()) {
+        job.state_digest = state_digest(job.bodies, job.partition);
+    }
+    const std::string key =
+        job.state_digest.empty()
+            ? std::string()
+            : op_result_key(job.state_digest, op, step_is_post_edit(job, op),
+                            job.from_zero_replay, ops::ValidationMode::CommitAuthoritative);
+    if (key.empty()) {
+        job.state_digest.clear();
+        return execute_candidate_op(job, op, op_id, last_sketch_id, cancel);
+    }
+    const bool sketch = get_str(op, "opType") == "Sketch";
+
+    std::optional<CandidateResult> hit;
+    BodyStore hit_bodies;
+    em::ElementMapPartition hit_partition;
+    if (!sketch) {
+        if (std::optional<OpResultRecord> record = cache.find(key)) {
+            CandidateResult replayed;
+            replayed.ref_bindings = collect_ref_bindings(op, op_id);
+            hit_bodies = job.bodies;
+            hit_partition = job.partition;
+            if (apply_op_result(*record, hit_bodies, hit_partition, replayed)) {
+                hit = std::move(replayed);
+            } else {
+                WLOG_WARN("op-result cache: entry for op '%s' did not replay; rebuilding",
+                          op_id.c_str());
+            }
+        }
+    }
+    if (hit && !cache.verify()) {
+        job.bodies = std::move(hit_bodies);
+        job.partition = std::move(hit_partition);
+        job.state_digest = next_state_digest(key);
+        return std::move(*hit);
+    }
+
+    const BodyStore before_bodies = job.bodies;
+    const em::ElementMapPartition before_partition = job.partition;
+    CandidateResult computed = execute_candidate_op(job, op, op_id, last_sketch_id, cancel);
+    if (computed.status != CandidateResult::Status::Ok) {
+        job.state_digest.clear();
+        return computed;
+    }
+    const bool agrees = hit && outcome_json(*hit) == outcome_json(computed) &&
+                        geometry_signature(hit_bodies) == geometry_signature(job.bodies) &&
+                        partition_entries_json(hit_partition) ==
+                            partition_entries_json(job.partition);
+    if (hit && !agrees) {
+        WLOG_WARN("op-result cache: verify mismatch at op '%s'; replacing the entry",
+                  op_id.c_str());
+        cache.note_mismatch();
+    }
+    if (!sketch && !agrees) {
+        cache.insert(key, capture_op_result(before_bodies, before_partition, job.bodies,
+                                            job.partition, computed));
+    }
+    job.state_digest = next_state_digest(key);
+    return computed;
+}
+
 // Drive the ordered op slice into `job`, streaming one planStep per executed step
 // and stopping at the first failure / NeedsRepair (SCHEMA §7.2).
 ExecResult execute_ops(ScratchJob& job, const json& ops, std::uint64_t job_id, std::uint64_t req_id,
@@ -555,6 +690,8 @@ ExecResult execute_ops(ScratchJob& job, const json& ops, std::uint64_t job_id, s
                                              ? op["stepIndex"].get<std::uint64_t>()
                                              : exec_idx;
         const std::string op_id = get_str(op, "opId", "op_" + std::to_string(step_index));
+        const trace::Span step_span("plan.step", op_id);
+        StepCost cost(job.step_timings);
 
         // --- test hooks (documented; harmless in production) ---
         if (op_id.find("__crash") != std::string::npos) {
@@ -581,7 +718,10 @@ ExecResult execute_ops(ScratchJob& job, const json& ops, std::uint64_t job_id, s
             candidate.needs_repair.push_back(make_needs_repair(op, op_id));
             candidate.ref_bindings = collect_ref_bindings(op, op_id);
         } else {
-            candidate = execute_candidate_op(job, op, op_id, last_sketch_id, ctx.cancel);
+            // Everything the op's own kernel work costs, cache replay included; the
+            // ladder / audit / history phases nested inside are subtracted out.
+            const stats::PhaseTimer phase(stats::Phase::Build);
+            candidate = run_plan_step(job, op, op_id, last_sketch_id, ctx.cancel);
         }
 
         if (candidate.status == CandidateResult::Status::Cancelled) {
@@ -591,28 +731,32 @@ ExecResult execute_ops(ScratchJob& job, const json& ops, std::uint64_t job_id, s
         const json diagnostics = candidate_diagnostics(candidate);
 
         if (candidate.status == CandidateResult::Status::Ok) {
+            const json signatures =
+                signatures_json(job.bodies, candidate.body_events, candidate.ref_bindings);
+            const json timings = cost.finish();
             emit_plan_step(ctx, req_id, job_id, step_index, candidate.body_events,
-                           candidate.delta.to_json(), candidate.needs_repair,
-                           signatures_json(job.bodies, candidate.body_events,
-                                           candidate.ref_bindings),
-                           diagnostics, candidate.mate_placement);
+                           candidate.delta.to_json(), candidate.needs_repair, signatures,
+                           diagnostics, candidate.mate_placement, timings);
             StepResult r;
             r.step_index = step_index;
             r.status = "ok";
             r.body_ids = std::move(candidate.body_ids);
+            r.timings = timings;
             job.per_step.push_back(std::move(r));
             last_ok_step = step_index;
             res.last_ok_exec_idx = exec_idx;
         } else if (candidate.status == CandidateResult::Status::NeedsRepair) {
+            const json signatures =
+                signatures_json(job.bodies, /*events=*/{}, candidate.ref_bindings);
+            const json timings = cost.finish();
             emit_plan_step(ctx, req_id, job_id, step_index, /*events=*/{},
-                           em::ElementMapDelta{}.to_json(), candidate.needs_repair,
-                           signatures_json(job.bodies, /*events=*/{},
-                                           candidate.ref_bindings),
-                           diagnostics);
+                           em::ElementMapDelta{}.to_json(), candidate.needs_repair, signatures,
+                           diagnostics, std::nullopt, timings);
             StepResult r;
             r.step_index = step_index;
             r.status = "needsRepair";
             r.ref_count = candidate.needs_repair.size();
+            r.timings = timings;
             job.per_step.push_back(std::move(r));
             job.stopped_reason = "needsRepair";
             job.last_valid_step = last_ok_step;  // prepare m−1 (SCHEMA §8)
@@ -622,6 +766,7 @@ ExecResult execute_ops(ScratchJob& job, const json& ops, std::uint64_t job_id, s
             r.step_index = step_index;
             r.status = "opFailed";
             r.diagnostics = diagnostics;
+            r.timings = cost.finish();
             // Carry the op's §8 message into perStepResults (the failed step emits no
             // planStep, so this is the only channel to Rust — see the emit below).
             if (!diagnostics.empty()) r.message = diagnostics.back().value("message", "");
@@ -733,6 +878,10 @@ Envelope handle_execute_plan(Session& session, const Envelope& req, HandlerConte
         args["checkpointFallbackReplay"].is_boolean()) {
         job.from_zero_replay = args["checkpointFallbackReplay"].get<bool>();
     }
+    // OPTIONAL `stepTimings` (SCHEMA §7.2), same tolerate-malformed rule.
+    if (args.contains("stepTimings") && args["stepTimings"].is_boolean()) {
+        job.step_timings = args["stepTimings"].get<bool>();
+    }
 
     const ExecResult exec = execute_ops(job, ops, job_id, req.id, ctx);
     if (exec.status == ExecStatus::Cancelled) {
@@ -765,6 +914,8 @@ Envelope handle_execute_plan(Session& session, const Envelope& req, HandlerConte
         // worker-local. Additive (readers ignore unknown keys; §4).
         if (!ps.message.empty()) e["message"] = ps.message;
         if (!ps.diagnostics.empty()) e["diagnostics"] = ps.diagnostics;
+        // Mirrors planStep.timings; for a failed step the only place it appears.
+        if (!ps.timings.is_null()) e["timings"] = ps.timings;
         per_step.push_back(std::move(e));
     }
     json last_valid = job.last_valid_step.has_value() ? json(*job.last_valid_step) : json(nullptr);
@@ -789,8 +940,16 @@ Envelope handle_execute_plan(Session& session, const Envelope& req, HandlerConte
     // preparedSnapshotId/historyPrefixHash/perStepResults — meshes are re-fetchable
     // via Tessellate. The artifact reference is attached to the live resp only.
     job.prepared_result = result;
+    const auto mesh_started = std::chrono::steady_clock::now();
     json tess = attach_tessellate(job, artifacts, r);
     if (!tess.is_null()) {
+        if (job.step_timings) {
+            // Mesh attach runs once per plan, after the last step — reported with
+            // the artifact, not on any planStep.
+            tess["meshAttachUs"] = std::chrono::duration_cast<std::chrono::microseconds>(
+                                       std::chrono::steady_clock::now() - mesh_started)
+                                       .count();
+        }
         result["artifacts"] = json{{"tessellate", tess}};
         r.result = std::move(result);  // live resp references the inlined sections
     }
@@ -133,7 +133,7 @@ bool seed_profile_sketch(Session& session, const Envelope& req, const json& op,
         return false;
     }
     if (sketch_id->empty()) return true;
-    std::optional<StoredSketch> stored = session.sketches().snapshot(*sketch_id);
+    const SketchVersion stored = session.sketches().pin(*sketch_id);
     if (!stored) {
         error = err(req, "REF_UNRESOLVED",
                     "PreviewOp: profile sketch not found: " + *sketch_id);
@@ -44,6 +44,7 @@ struct StepResult {
     std::optional<std::uint64_t> ref_count;  // needsRepair: number of unresolved refs
     std::string message;                 // opFailed: the §8 recoverable message (why)
     nlohmann::json diagnostics = nlohmann::json::array();  // optional structured evidence
+    nlohmann::json timings;              // `stepTimings` plans only (null otherwise)
 };
 
 struct ScratchJob {
@@ -75,6 +76,10 @@ struct ScratchJob {
     // (D5) and so mis-flagged the shipped edit lane.
     bool from_zero_replay = false;
 
+    // The plan's OPTIONAL `stepTimings` (SCHEMA §7.2): attach per-phase wall times
+    // and memory deltas to every step. Diagnostic only; absent ⇒ wire unchanged.
+    bool step_timings = false;
+
     // The scratch body state (clone of live at fence time, mutated by ops).
     BodyStore bodies;
 
@@ -88,6 +93,12 @@ struct ScratchJob {
     // these are NOT republished on accept.
     std::vector<std::pair<std::string, nlohmann::json>> sketches;
 
+    // Content digest of the scratch state the NEXT step runs on, chained step to
+    // step through the op-result cache keys (session/OpResultCache.h). Empty when
+    // the cache is off or the chain broke; recomputed from bodies + partition only
+    // while the plan has materialized no sketch.
+    std::string state_digest;
+
     // Terminal bookkeeping.
     std::uint64_t prepared_snapshot_id = 0;
     std::optional<std::uint64_t> last_valid_step;  // nullopt ⇒ only the base is valid
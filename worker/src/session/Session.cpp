@@ -47,10 +47,7 @@ bool valid_topo_key(const std::string& key, char prefix) {
 const elementmap::PartitionEntry* binding_at(
     const elementmap::ElementMapPartition& partition, const std::string& body_id,
     const std::string& topo_key) {
-    for (const auto* entry : partition.entries_for_body(body_id)) {
-        if (entry->topo_key == topo_key) return entry;
-    }
-    return nullptr;
+    return partition.find_by_topokey(body_id, topo_key);
 }
 
 std::optional<ErrorInfo> stage_binding(const BodyStore& bodies,
@@ -384,13 +381,24 @@ CheckpointState Session::save_checkpoint(std::uint64_t step) {
 
 RestoreOutcome Session::restore_checkpoint(std::uint64_t step, const std::string& expected_hash) {
     std::lock_guard<std::mutex> lk(mu_);
-    RestoreOutcome out;
     auto it = checkpoints_.find(step);
     if (it == checkpoints_.end()) {
-        out.restored = false;  // absent (e.g. post-restart) ⇒ Rust replays from 0
-        return out;
+        return RestoreOutcome{};  // absent (e.g. post-restart) ⇒ persisted bytes or replay
     }
-    const CheckpointState& st = it->second;
+    return install_checkpoint_locked(it->second, expected_hash);
+}
+
+RestoreOutcome Session::restore_checkpoint_state(std::uint64_t step, CheckpointState st,
+                                                 const std::string& expected_hash) {
+    std::lock_guard<std::mutex> lk(mu_);
+    RestoreOutcome out = install_checkpoint_locked(st, expected_hash);
+    if (out.restored) checkpoints_[step] = std::move(st);
+    return out;
+}
+
+RestoreOutcome Session::install_checkpoint_locked(const CheckpointState& st,
+                                                  const std::string& expected_hash) {
+    RestoreOutcome out;
     out.stored_hash = st.history_prefix_hash;
     // Staleness: the checkpoint's stored hash must match the base the plan expects.
     if (!expected_hash.empty() && expected_hash != st.history_prefix_hash) {
@@ -1,7 +1,8 @@
 // Session.h — the worker's per-document session (W-WP4).
 //
 // SUPERSEDES the pre-W-WP4 `protocol/WorkerSession.h` placeholder. One session
-// per document (V1). Owns:
+// per document; a worker hosts several, by handle (session/SessionRegistry.h).
+// Owns:
 //   * the head fencing tokens {documentRevision, workerEpoch, snapshotId} + the
 //     `historyPrefixHash` (SCHEMA §7.1/§7.2), and stamps every worker frame via
 //     `head_stamp()` (the Dispatcher's stamp source);
@@ -21,7 +22,7 @@
 //
 // The `SketchStore` carries its OWN mutex (it is touched by both lanes
 // independently of the head), so it is NOT guarded by `mu_`; the solver lane
-// writes committed sketches, the kernel lane reads snapshots, with no head-lock
+// writes committed sketch versions, the kernel lane pins them, with no head-lock
 // contention. Live PlaneGCS solve state stays lane-local in SolverLane.
 #pragma once
 
@@ -68,11 +69,12 @@ struct AcceptOutcome {
 };
 
 // One in-session checkpoint (SCHEMA §7.7): the head state at a step, retained so a
-// later incremental regen can restore it WITHOUT the geometry crossing the wire again
-// (the transport carries no request-binary). Persistence to the .onecad container is
-// Rust-side (SaveCheckpoint also serializes these to the resp for durability); on a
-// worker restart the map is empty ⇒ RestoreCheckpoint reports restored=false ⇒ Rust
-// replays from 0 (Invariant 7 — the cache degrades to replay, never a wrong result).
+// later incremental regen can restore it WITHOUT the geometry crossing the wire again.
+// Persistence is Rust-side (SaveCheckpoint also serializes these to the resp); on a
+// worker restart the map is empty, so RestoreCheckpoint rebuilds the state from the
+// persisted bytes Rust ships back in the request tail (io/Checkpoint.h). Absent both,
+// it reports restored=false ⇒ Rust replays from 0 (Invariant 7 — the cache degrades
+// to replay, never a wrong result).
 struct CheckpointState {
     BodyStore bodies;
     elementmap::ElementMapPartition partition;
@@ -81,7 +83,7 @@ struct CheckpointState {
 
 // Outcome of RestoreCheckpoint.
 struct RestoreOutcome {
-    bool restored = false;          // false ⇒ no such in-session checkpoint (replay-from-0)
+    bool restored = false;          // false ⇒ nothing installed (Rust replays from 0)
     bool drift_detected = false;    // stored hash != expected (staleness)
     std::uint64_t snapshot_id = 0;
     std::string stored_hash;        // the checkpoint's history-prefix hash
@@ -200,8 +202,17 @@ public:
     // historyPrefixHash). `restored=false` when absent (⇒ Rust replays from 0);
     // `drift_detected=true` when the stored hash != `expected_hash` (staleness).
     RestoreOutcome restore_checkpoint(std::uint64_t step, const std::string& expected_hash);
+    // Restore a checkpoint DESERIALIZED from persisted bytes (post-restart, the map
+    // holds nothing): same drift check and install as `restore_checkpoint`, and the
+    // state is retained at `step` like a save so a later restore stays in-session.
+    RestoreOutcome restore_checkpoint_state(std::uint64_t step, CheckpointState st,
+                                            const std::string& expected_hash);
 
 private:
+    // Drift check + install `st` as the head. Caller holds `mu_`.
+    RestoreOutcome install_checkpoint_locked(const CheckpointState& st,
+                                             const std::string& expected_hash);
+
     mutable std::mutex mu_;
     bool open_ = false;
     std::string document_id_;
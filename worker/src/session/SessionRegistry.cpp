@@ -0,0 +1,59 @@
+// SessionRegistry.cpp — see SessionRegistry.h.
+#include "session/SessionRegistry.h"
+
+namespace onecad::session {
+
+SessionRegistry::SessionRegistry() { slots_.emplace("", std::make_shared<SessionSlot>()); }
+
+std::shared_ptr<SessionSlot> SessionRegistry::find(const std::string& handle) const {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = slots_.find(handle);
+    return it != slots_.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<SessionSlot> SessionRegistry::open(const std::string& handle) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = slots_.find(handle);
+    if (it != slots_.end()) return it->second;
+    if (slots_.size() >= kMaxSessions) return nullptr;
+    return slots_.emplace(handle, std::make_shared<SessionSlot>()).first->second;
+}
+
+bool SessionRegistry::erase(const std::string& handle) {
+    if (handle.empty()) return false;
+    std::shared_ptr<SessionSlot> dropped;  // destroyed outside the lock
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = slots_.find(handle);
+    if (it == slots_.end()) return false;
+    dropped = std::move(it->second);
+    slots_.erase(it);
+    return true;
+}
+
+protocol::Stamp SessionRegistry::head_stamp(const std::string& handle) const {
+    const std::shared_ptr<SessionSlot> slot = find(handle);
+    return slot ? slot->session.head_stamp() : protocol::Stamp{};
+}
+
+std::vector<std::string> SessionRegistry::handles() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::vector<std::string> out;
+    out.reserve(slots_.size());
+    for (const auto& [handle, _] : slots_) out.push_back(handle);
+    return out;
+}
+
+std::size_t SessionRegistry::size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return slots_.size();
+}
+
+std::string session_handle(const protocol::Envelope& req) {
+    if (req.args.is_object() && req.args.contains("sessionId") &&
+        req.args["sessionId"].is_string()) {
+        return req.args["sessionId"].get<std::string>();
+    }
+    return "";
+}
+
+}  // namespace onecad::session
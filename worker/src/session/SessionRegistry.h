@@ -0,0 +1,80 @@
+// SessionRegistry.h — the worker's open documents, by session handle.
+//
+// One worker process hosts several documents. Each is a `Session` (head, fencing,
+// bodies, partition, sketches, scratch, checkpoints — Session.h) paired with its
+// OWN `SolverLane` (live drag gestures over that session's SketchStore), filed
+// under the string handle Rust chose at OpenSession (SCHEMA §7.1 `sessionId`).
+// What the documents SHARE is everything process-wide: the Dispatcher's kernel
+// and solver threads (one OCCT writer lane for every document), OCCT's one-time
+// initialization and static registration, and the content-keyed caches
+// (GeneratorCache, the profile-face cache, the op-result cache), so a tenth open
+// drawing costs its own geometry and nothing else.
+//
+// The EMPTY handle is the default session: it always exists, and a request with
+// no `sessionId` addresses it, so a single-document client is unaffected.
+//
+// ── Lifetime ─────────────────────────────────────────────────────────────────
+// Slots are handed out as `shared_ptr`: a handler keeps its slot alive for the
+// duration of the request, so a CloseSession on the kernel lane can drop the
+// handle while a solver-lane request on the same document is still running; the
+// slot is destroyed when the last request holding it returns. The registry's own
+// mutex guards only the handle map, never a session's state.
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "protocol/Envelope.h"
+#include "protocol/SolverLane.h"
+#include "session/Session.h"
+
+namespace onecad::session {
+
+// One open document: its session and the solver lane bound to its sketches.
+struct SessionSlot {
+    Session session;
+    protocol::SolverLane solver;
+
+    SessionSlot() : solver(session.sketches()) {}
+    SessionSlot(const SessionSlot&) = delete;
+    SessionSlot& operator=(const SessionSlot&) = delete;
+};
+
+class SessionRegistry {
+public:
+    // Documents one worker hosts at once, the default session included. Past it,
+    // OpenSession fails and Rust spawns another worker.
+    static constexpr std::size_t kMaxSessions = 32;
+
+    SessionRegistry();
+
+    // The slot `handle` names, or null when it is not open ("" always resolves).
+    std::shared_ptr<SessionSlot> find(const std::string& handle) const;
+
+    // The slot for `handle`, created on first use. Null when the registry is full.
+    std::shared_ptr<SessionSlot> open(const std::string& handle);
+
+    // Forget `handle` (its slot lives on until in-flight requests release it).
+    // The default session is never erased. Returns whether a slot was dropped.
+    bool erase(const std::string& handle);
+
+    // §3 stamp of the session `handle` names; all-zero for an unknown handle
+    // (a frame answering a request to a closed or never-opened document).
+    protocol::Stamp head_stamp(const std::string& handle) const;
+
+    std::vector<std::string> handles() const;
+    std::size_t size() const;
+
+private:
+    mutable std::mutex mu_;
+    std::map<std::string, std::shared_ptr<SessionSlot>> slots_;
+};
+
+// The `sessionId` a request addresses ("" — the default session — when absent).
+std::string session_handle(const protocol::Envelope& req);
+
+}  // namespace onecad::session
@@ -1,16 +1,28 @@
 // Signatures.cpp — the geometry signature (OCCT-backed). See Signatures.h.
 #include "session/Signatures.h"
 
+#include <memory>
+
 #include "session/ShapeMetrics.h"
 
 namespace onecad::session {
 
+const ShapeMetrics& body_metrics(const BodyRecord& rec) {
+    // IsEqual: same TShape, same location, same orientation — the metrics'
+    // full input (a moved body keeps its TShape but not its bbox).
+    if (!rec.metrics_memo || !rec.metrics_memo->shape.IsEqual(rec.geom)) {
+        rec.metrics_memo = std::make_shared<const MetricsMemo>(
+            MetricsMemo{rec.geom, compute_shape_metrics(rec.geom)});
+    }
+    return rec.metrics_memo->metrics;
+}
+
 std::string geometry_signature(const BodyStore& bodies) {
     std::uint64_t h = hashing::kFnvOffset;
     // bodies.all() iterates in ascending BodyId order (std::map), so the fold is
     // deterministic regardless of insertion order.
     for (const auto& [id, rec] : bodies.all()) {
-        const ShapeMetrics m = compute_shape_metrics(rec.geom);
+        const ShapeMetrics& m = body_metrics(rec);
         h = fold_str(h, id);
         h = fold_u64(h, m.face_count);
         h = fold_u64(h, m.edge_count);
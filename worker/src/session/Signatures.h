@@ -85,9 +85,16 @@ inline std::uint64_t fold_str(std::uint64_t h, const std::string& s) {
     return hashing::fnv1a_update(h, s.data(), s.size());
 }
 
+// `compute_shape_metrics(rec.geom)`, memoized on the record (`BodyRecord::
+// metrics_memo`): recomputed only when `geom` is no longer the shape the memo was
+// built from. The metrics are a pure function of the shape, so a hit is
+// bit-identical to a fresh computation.
+const ShapeMetrics& body_metrics(const BodyRecord& rec);
+
 // geometry signature — over every body in the store (sorted id order). Folds each
-// body's OCCT metrics (counts + quantized bbox + quantized volume). Defined in
-// Signatures.cpp because it inspects the TopoDS_Shape (needs OCCT).
+// body's OCCT metrics (counts + quantized bbox + quantized volume), memoized per
+// body, so a step pays the BRepGProp integration only for bodies it created or
+// modified. Defined in Signatures.cpp because it inspects the TopoDS_Shape.
 std::string geometry_signature(const BodyStore& bodies);
 
 // bodyLifecycle signature — over the ordered step events.
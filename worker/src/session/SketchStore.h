@@ -8,35 +8,54 @@
 //   * SOLVER lane (owner of sketch SOLVE state) writes committed sketches on
 //     SketchUpsert / EndGesture (`upsert` / `put`). The live, warm PlaneGCS
 //     systems + drag gestures stay lane-local in SolverLane (never here) — only
-//     the committed authoritative wire lands in the store.
-//   * KERNEL lane READS committed sketches during ExecutePlan regen (`snapshot`),
+//     the committed authoritative wire (and the solved sketch it translates
+//     to) lands in the store.
+//   * KERNEL lane READS committed sketches during ExecutePlan regen (`pin`),
 //     e.g. a Sketch op materializing / an Extrude reading its profile.
 //
-// The handoff is value-copy under the lock: cross-lane readers get a `snapshot`
-// (a copy), so no pointer into the map escapes the lock (the old pointer-
-// returning `get`/`get_mut` are gone). Copies are cheap (sketches are small).
+// Each commit is an immutable, reference-counted VERSION: a reader `pin`s it (a
+// refcount bump under the lock) and reads it with no lock held, for as long as
+// it likes — a later commit installs a new version and never touches a pinned
+// one. Nothing is copied on read, so a version also carries the work its writer
+// already did: the wire translated into a solved `Sketch` plus its `WireIndex`,
+// which the solver lane's readers use instead of translating the wire again.
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <mutex>
-#include <optional>
 #include <string>
 #include <unordered_map>
 
 #include "nlohmann/json.hpp"
+#include "sketch/WireSketch.h"
 
 namespace onecad::session {
 
+// A committed wire already translated and solved: `wire_args` translated and
+// solved again would land on this pose. Only a converged solve's sketch is
+// kept, so a reader holding one can skip both steps.
+struct TranslatedSketch {
+    // Read on the SOLVER lane only: Sketch's const API fills lazy caches.
+    std::shared_ptr<const core::sketch::Sketch> sketch;
+    wire::WireIndex index;
+};
+
 struct StoredSketch {
     nlohmann::json wire_args;  // {plane, entities[], constraints[]} as upserted
     std::uint64_t revision = 0;
+    TranslatedSketch translated;  // null sketch: translate `wire_args` yourself
 };
 
+// A pinned committed version (null: no such sketch).
+using SketchVersion = std::shared_ptr<const StoredSketch>;
+
 class SketchStore {
 public:
     SketchStore() = default;
     // Movable/copyable value semantics require a fresh mutex on copy/move (a
-    // std::mutex is not copyable). Sketch state is copied; the lock is not.
+    // std::mutex is not copyable). The versions are shared (they are
+    // immutable); the lock is not.
     SketchStore(const SketchStore& other) { copy_from(other); }
     SketchStore& operator=(const SketchStore& other) {
         if (this != &other) copy_from(other);
@@ -44,28 +63,35 @@ public:
     }
 
     // Replace the sketch's full state; bump + return the new revision.
-    std::uint64_t upsert(const std::string& sketch_id, nlohmann::json wire_args) {
+    std::uint64_t upsert(const std::string& sketch_id, nlohmann::json wire_args,
+                         TranslatedSketch translated = {}) {
+        auto next = std::make_shared<StoredSketch>();
+        next->wire_args = std::move(wire_args);
+        next->translated = std::move(translated);
         std::lock_guard<std::mutex> lk(mu_);
-        StoredSketch& s = sketches_[sketch_id];
-        s.wire_args = std::move(wire_args);
-        s.revision += 1;
-        return s.revision;
+        SketchVersion& slot = sketches_[sketch_id];
+        next->revision = (slot ? slot->revision : 0) + 1;
+        slot = std::move(next);
+        return slot->revision;
     }
 
     // Write an exact (wire, revision) — used by EndGesture to commit solved
     // positions at the gesture's post-solve revision.
-    void put(const std::string& sketch_id, nlohmann::json wire_args, std::uint64_t revision) {
+    void put(const std::string& sketch_id, nlohmann::json wire_args, std::uint64_t revision,
+             TranslatedSketch translated = {}) {
+        auto next = std::make_shared<StoredSketch>();
+        next->wire_args = std::move(wire_args);
+        next->revision = revision;
+        next->translated = std::move(translated);
         std::lock_guard<std::mutex> lk(mu_);
-        StoredSketch& s = sketches_[sketch_id];
-        s.wire_args = std::move(wire_args);
-        s.revision = revision;
+        sketches_[sketch_id] = std::move(next);
     }
 
-    // Cross-lane-safe read: returns a COPY (or nullopt). No pointer escapes.
-    std::optional<StoredSketch> snapshot(const std::string& sketch_id) const {
+    // Cross-lane-safe read: the current version (or null), pinned. No copy.
+    SketchVersion pin(const std::string& sketch_id) const {
         std::lock_guard<std::mutex> lk(mu_);
         auto it = sketches_.find(sketch_id);
-        if (it == sketches_.end()) return std::nullopt;
+        if (it == sketches_.end()) return nullptr;
         return it->second;
     }
 
@@ -87,7 +113,7 @@ private:
     }
 
     mutable std::mutex mu_;
-    std::unordered_map<std::string, StoredSketch> sketches_;
+    std::unordered_map<std::string, SketchVersion> sketches_;
 };
 
 }  // namespace onecad::session
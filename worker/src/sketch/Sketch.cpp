@@ -1294,6 +1294,7 @@ SolveResult Sketch::solve() {
         return result;
     }
 
+    solver_->setSolveLimits(solveLimits_);
     SolverResult solverResult = solver_->solve();
     result.success = solverResult.success;
     result.iterations = solverResult.iterations;
@@ -1301,9 +1302,185 @@ SolveResult Sketch::solve() {
     result.conflictingConstraints = solverResult.conflictingConstraints;
     lastConflictingConstraints_ = solverResult.conflictingConstraints;
     result.errorMessage = solverResult.errorMessage;
+    result.interrupted = solverResult.status == SolverResult::Status::Timeout ||
+                         solverResult.status == SolverResult::Status::Cancelled;
     return result;
 }
 
+ComponentSolveResult Sketch::solveByComponent(const ComponentKeyFn& keyOf,
+                                              const ComponentSolveCache& previous,
+                                              ComponentSolveCache& next) {
+    ComponentSolveResult result;
+    next.clear();
+    const auto wholeSketch = [this]() {
+        ComponentSolveResult whole;
+        whole.solve = solve();
+        whole.dof = getDegreesOfFreedom();
+        whole.redundant = hasRedundantConstraints();
+        return whole;
+    };
+    if (hasSolverUnsupportedEntities() || firstUnsupportedConstraint(*this)) {
+        return wholeSketch();
+    }
+
+    const std::vector<std::vector<EntityID>> components = SolverAdapter::solverComponents(*this);
+    std::unordered_map<EntityID, size_t> componentOf;
+    for (size_t i = 0; i < components.size(); ++i) {
+        for (const auto& id : components[i]) {
+            componentOf.emplace(id, i);
+        }
+    }
+    // Every entity a constraint references is in one component (the constraint
+    // is what joined them), so its first one names it.
+    std::vector<std::vector<ConstraintID>> constraintsOf(components.size());
+    for (const auto& constraint : constraints_) {
+        const std::vector<EntityID> refs =
+            constraint ? constraint->referencedEntities() : std::vector<EntityID>{};
+        const auto it = refs.empty() ? componentOf.end() : componentOf.find(refs.front());
+        if (it != componentOf.end()) {
+            constraintsOf[it->second].push_back(constraint->id());
+        }
+    }
+
+    result.solve.success = true;
+    for (size_t i = 0; i < components.size(); ++i) {
+        const std::string key = keyOf(components[i], constraintsOf[i]);
+        const auto hit = key.empty() ? previous.end() : previous.find(key);
+        std::optional<ComponentSolve> entry;
+        bool cacheable = !key.empty();
+        if (hit != previous.end() && applyComponentValues(components[i], hit->second.values)) {
+            entry = hit->second;
+            ++result.reusedComponents;
+        } else {
+            const bool interruptedBefore = result.solve.interrupted;
+            entry = solveComponent(components[i], constraintsOf[i], result.solve);
+            if (!entry) {
+                WLOG_WARN("%s", "solveByComponent:component-translation-failed");
+                next.clear();
+                return wholeSketch();
+            }
+            // A solve stopped by a bound says nothing about the component.
+            cacheable = cacheable && result.solve.interrupted == interruptedBefore;
+            ++result.solvedComponents;
+        }
+
+        result.solve.success = result.solve.success && entry->success;
+        result.dof += entry->dof;
+        result.redundant = result.redundant || entry->redundant;
+        for (size_t position : entry->conflicting) {
+            if (position < constraintsOf[i].size()) {
+                result.solve.conflictingConstraints.push_back(constraintsOf[i][position]);
+            }
+        }
+        if (cacheable) {
+            next[key] = std::move(*entry);
+        }
+    }
+
+    lastConflictingConstraints_ = result.solve.conflictingConstraints;
+    cachedDOF_ = result.dof;
+    dofDirty_ = false;
+    return result;
+}
+
+std::optional<ComponentSolve> Sketch::solveComponent(const std::vector<EntityID>& members,
+                                                     const std::vector<ConstraintID>& constraints,
+                                                     SolveResult& merged) {
+    ComponentSolve entry;
+
+    // Plain geometry nothing constrains has no equation to solve or diagnose:
+    // it stays where it is and every parameter it owns is free.
+    const bool coupled = std::any_of(members.begin(), members.end(), [this](const EntityID& id) {
+        const SketchEntity* entity = getEntity(id);
+        const auto* arc = dynamic_cast<const SketchArc*>(entity);
+        return (entity && entity->isReferenceLocked()) || (arc && arc->hasEndpointPoints());
+    });
+    if (constraints.empty() && !coupled) {
+        entry.success = true;
+        for (const auto& id : members) {
+            if (const SketchEntity* entity = getEntity(id)) {
+                entry.dof += entity->degreesOfFreedom();
+            }
+        }
+        entry.values = componentValues(members);
+        return entry;
+    }
+
+    const std::unordered_set<EntityID> component(members.begin(), members.end());
+    ConstraintSolver solver;
+    if (!SolverAdapter::populateSolver(*this, solver, &component)) {
+        return std::nullopt;
+    }
+    solver.setSolveLimits(solveLimits_);
+    const SolverResult solved = solver.solve();
+    merged.iterations += solved.iterations;
+    merged.residual = std::max(merged.residual, solved.residual);
+    merged.interrupted = merged.interrupted ||
+                         solved.status == SolverResult::Status::Timeout ||
+                         solved.status == SolverResult::Status::Cancelled;
+    if (!solved.success && merged.errorMessage.empty()) {
+        merged.errorMessage = solved.errorMessage;
+    }
+
+    entry.success = solved.success;
+    entry.dof = std::max(solver.diagnose(), 0);
+    entry.redundant = solver.hasRedundant();
+    std::unordered_map<ConstraintID, size_t> position;
+    for (size_t i = 0; i < constraints.size(); ++i) {
+        position.emplace(constraints[i], i);
+    }
+    for (const auto& id : solved.conflictingConstraints) {
+        if (const auto it = position.find(id); it != position.end()) {
+            entry.conflicting.push_back(it->second);
+        }
+    }
+    entry.values = componentValues(members);
+    return entry;
+}
+
+std::vector<double> Sketch::componentValues(const std::vector<EntityID>& members) const {
+    std::vector<double> values;
+    for (const auto& id : members) {
+        const SketchEntity* entity = getEntity(id);
+        if (const auto* point = dynamic_cast<const SketchPoint*>(entity)) {
+            values.push_back(point->position().X());
+            values.push_back(point->position().Y());
+        } else if (const auto* arc = dynamic_cast<const SketchArc*>(entity)) {
+            values.push_back(arc->radius());
+            values.push_back(arc->startAngle());
+            values.push_back(arc->endAngle());
+        } else if (const auto* circle = dynamic_cast<const SketchCircle*>(entity)) {
+            values.push_back(circle->radius());
+        }
+    }
+    return values;
+}
+
+bool Sketch::applyComponentValues(const std::vector<EntityID>& members,
+                                  const std::vector<double>& values) {
+    if (componentValues(members).size() != values.size()) {
+        return false;
+    }
+    // Raw writes, as the solver makes them: the setters would normalize angles.
+    size_t next = 0;
+    for (const auto& id : members) {
+        SketchEntity* entity = getEntity(id);
+        if (auto* point = dynamic_cast<SketchPoint*>(entity)) {
+            point->setPosition(values[next], values[next + 1]);
+            next += 2;
+        } else if (auto* arc = dynamic_cast<SketchArc*>(entity)) {
+            arc->radius() = values[next];
+            arc->startAngle() = values[next + 1];
+            arc->endAngle() = values[next + 2];
+            next += 3;
+        } else if (auto* circle = dynamic_cast<SketchCircle*>(entity)) {
+            circle->radius() = values[next];
+            next += 1;
+        }
+    }
+    return true;
+}
+
 void Sketch::beginPointDrag(EntityID draggedPoint) {
     activeDragFixedPoints_.clear();
     isDraggingPoint_ = false;
@@ -1502,23 +1679,28 @@ SolveResult Sketch::solveWithGroupDrag(
         return result;
     }
 
-    if (!solver_ || solverDirty_) {
-        rebuildSolver();
+    std::vector<EntityID> seeds;
+    seeds.reserve(rigidTargets.size());
+    for (const auto& [pointId, _] : rigidTargets) {
+        seeds.push_back(pointId);
     }
-
-    if (!solver_) {
+    ConstraintSolver* solver = dragSolverFor(seeds);
+    if (!solver) {
         result.success = false;
         result.errorMessage = "Solver not available";
         return result;
     }
 
-    SolverResult solverResult = solver_->solveWithGroupDrag(rigidTargets);
+    SolverResult solverResult = solver->solveWithGroupDrag(rigidTargets);
     result.success = solverResult.success;
     result.iterations = solverResult.iterations;
+    result.substeps = solverResult.substeps;
     result.residual = solverResult.residual;
     result.conflictingConstraints = solverResult.conflictingConstraints;
     lastConflictingConstraints_ = solverResult.conflictingConstraints;
     result.errorMessage = solverResult.errorMessage;
+    result.interrupted = solverResult.status == SolverResult::Status::Timeout ||
+                         solverResult.status == SolverResult::Status::Cancelled;
 
     if (result.success) {
         for (const auto& [pointId, rigidTarget] : rigidTargets) {
@@ -1551,7 +1733,8 @@ void Sketch::endGroupDrag() {
     isDraggingGroup_ = false;
 }
 
-SolveResult Sketch::solveWithDrag(EntityID draggedPoint, const Vec2d& targetPos) {
+SolveResult Sketch::solveWithDrag(EntityID draggedPoint, const Vec2d& targetPos,
+                                  const DragSeed& seed) {
     SolveResult result;
 
     auto* point = getEntityAs<SketchPoint>(draggedPoint);
@@ -1583,29 +1766,34 @@ SolveResult Sketch::solveWithDrag(EntityID draggedPoint, const Vec2d& targetPos)
         return result;
     }
 
-    if (!solver_ || solverDirty_) {
-        rebuildSolver();
-    }
-
-    if (!solver_) {
+    ConstraintSolver* solver = dragSolverFor({draggedPoint});
+    if (!solver) {
         result.success = false;
         result.errorMessage = "Solver not available";
         return result;
     }
 
+    // A component solver ignores fixed points outside its component: nothing
+    // there can move anyway.
     static const std::unordered_set<EntityID> kNoFixedPoints;
     const std::unordered_set<EntityID>& pointIdsToFix =
         isDraggingPoint_ ? activeDragFixedPoints_ : kNoFixedPoints;
 
-    SolverResult solverResult = solver_->solveWithDrag(draggedPoint, targetPos, pointIdsToFix);
+    SolverResult solverResult =
+        solver->solveWithDrag(draggedPoint, targetPos, pointIdsToFix, seed);
     result.success = solverResult.success;
     result.iterations = solverResult.iterations;
+    result.substeps = solverResult.substeps;
     result.residual = solverResult.residual;
     result.conflictingConstraints = solverResult.conflictingConstraints;
     lastConflictingConstraints_ = solverResult.conflictingConstraints;
     result.errorMessage = solverResult.errorMessage;
+    result.interrupted = solverResult.status == SolverResult::Status::Timeout ||
+                         solverResult.status == SolverResult::Status::Cancelled;
 
-    if (isDraggingPoint_ && !result.success) {
+    // An interrupted step was rolled back, not refused: it says nothing about
+    // whether the gesture's constraints hold, so it must not void the gesture.
+    if (isDraggingPoint_ && !result.success && !result.interrupted) {
         dragSessionHadFailure_ = true;
     }
 
@@ -1614,7 +1802,8 @@ SolveResult Sketch::solveWithDrag(EntityID draggedPoint, const Vec2d& targetPos)
 
 SolveResult Sketch::solveWithTargets(const std::unordered_map<EntityID, Vec2d>& pointTargets,
                                      const std::unordered_map<EntityID, double>& radiusTargets,
-                                     const std::unordered_set<EntityID>& pinnedPoints) {
+                                     const std::unordered_set<EntityID>& pinnedPoints,
+                                     const DragSeed& seed) {
     SolveResult result;
 
     if (pointTargets.empty() && radiusTargets.empty()) {
@@ -1694,11 +1883,18 @@ SolveResult Sketch::solveWithTargets(const std::unordered_map<EntityID, Vec2d>&
         return result;
     }
 
-    if (!solver_ || solverDirty_) {
-        rebuildSolver();
+    // Pins are not seeds: a pin outside the driven component holds geometry
+    // the component solve cannot move in the first place.
+    std::vector<EntityID> seeds;
+    seeds.reserve(pointTargets.size() + radiusTargets.size());
+    for (const auto& [pointId, _] : pointTargets) {
+        seeds.push_back(pointId);
     }
-
-    if (!solver_) {
+    for (const auto& [curveId, _] : radiusTargets) {
+        seeds.push_back(curveId);
+    }
+    ConstraintSolver* solver = dragSolverFor(seeds);
+    if (!solver) {
         result.success = false;
         result.errorMessage = "Solver not available";
         return result;
@@ -1708,14 +1904,18 @@ SolveResult Sketch::solveWithTargets(const std::unordered_map<EntityID, Vec2d>&
     targets.points = pointTargets;
     targets.radii = radiusTargets;
     targets.pinnedPoints = pinnedPoints;
+    targets.seed = seed;
 
-    SolverResult solverResult = solver_->solveWithTargets(targets);
+    SolverResult solverResult = solver->solveWithTargets(targets);
     result.success = solverResult.success;
     result.iterations = solverResult.iterations;
+    result.substeps = solverResult.substeps;
     result.residual = solverResult.residual;
     result.conflictingConstraints = solverResult.conflictingConstraints;
     lastConflictingConstraints_ = solverResult.conflictingConstraints;
     result.errorMessage = solverResult.errorMessage;
+    result.interrupted = solverResult.status == SolverResult::Status::Timeout ||
+                         solverResult.status == SolverResult::Status::Cancelled;
 
     return result;
 }
@@ -2147,6 +2347,8 @@ std::vector<EntityID> Sketch::findInRect(const Vec2d& min, const Vec2d& max) con
 void Sketch::invalidateSolver() {
     solverDirty_ = true;
     dofDirty_ = true;
+    componentsDirty_ = true;
+    componentSolvers_.clear();
     lastConflictingConstraints_.clear();
 }
 
@@ -2163,6 +2365,67 @@ void Sketch::rebuildSolver() {
     solverDirty_ = false;
 }
 
+std::optional<size_t> Sketch::dragComponentIndex(const std::vector<EntityID>& seeds) const {
+    if (componentsDirty_) {
+        solverComponents_ = SolverAdapter::solverComponents(*this);
+        solverComponentOf_.clear();
+        for (size_t i = 0; i < solverComponents_.size(); ++i) {
+            for (const auto& id : solverComponents_[i]) {
+                solverComponentOf_[id] = i;
+            }
+        }
+        componentsDirty_ = false;
+    }
+
+    if (solverComponents_.size() < 2 || seeds.empty()) {
+        return std::nullopt;
+    }
+    std::optional<size_t> index;
+    for (const auto& seed : seeds) {
+        const auto it = solverComponentOf_.find(seed);
+        if (it == solverComponentOf_.end() || (index && *index != it->second)) {
+            return std::nullopt;
+        }
+        index = it->second;
+    }
+    return index;
+}
+
+std::optional<std::unordered_set<EntityID>> Sketch::dragComponent(
+    const std::vector<EntityID>& seeds) const {
+    const std::optional<size_t> index = dragComponentIndex(seeds);
+    if (!index) {
+        return std::nullopt;
+    }
+    const auto& members = solverComponents_[*index];
+    return std::unordered_set<EntityID>(members.begin(), members.end());
+}
+
+ConstraintSolver* Sketch::dragSolverFor(const std::vector<EntityID>& seeds) {
+    if (const std::optional<size_t> index = dragComponentIndex(seeds)) {
+        if (const auto it = componentSolvers_.find(*index); it != componentSolvers_.end()) {
+            it->second->setSolveLimits(solveLimits_);
+            return it->second.get();
+        }
+        const auto& members = solverComponents_[*index];
+        const std::unordered_set<EntityID> component(members.begin(), members.end());
+        auto componentSolver = std::make_unique<ConstraintSolver>();
+        if (SolverAdapter::populateSolver(*this, *componentSolver, &component)) {
+            componentSolver->setSolveLimits(solveLimits_);
+            return (componentSolvers_[*index] = std::move(componentSolver)).get();
+        }
+        WLOG_WARN("%s", "dragSolverFor:component-translation-failed");
+    }
+
+    if (!solver_ || solverDirty_) {
+        rebuildSolver();
+    }
+    if (solver_) {
+        solver_->setSolveLimits(solveLimits_);
+    }
+    return solver_.get();
+}
+
 void Sketch::rebuildEntityIndex() {
     entityIndex_.clear();
     for (size_t i = 0; i < entities_.size(); ++i) {
@@ -25,6 +25,7 @@
 #include "SketchEllipse.h"
 #include "SketchConstraint.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -126,10 +127,48 @@ struct HostFaceAttachment {
 struct SolveResult {
     bool success = false;
     int iterations = 0;
+    int substeps = 0;  ///< drag substeps solved, retries included (0 for a full solve)
     double residual = 0.0;
     std::vector<EntityID> movedEntities;
     std::vector<ConstraintID> conflictingConstraints;
     std::string errorMessage;
+    bool interrupted = false;  ///< stopped by a time bound or cancel (see SolveLimits)
+};
+
+/**
+ * @brief One solver component's solve and PlaneGCS diagnosis, in
+ *        component-local terms so it can outlive the Sketch it came from
+ *
+ * Entities are addressed by their position in the component (sketch order, as
+ * SolverAdapter::solverComponents lists them) and constraints by their position
+ * among the component's constraints (sketch order), never by id: translating
+ * the same content again mints fresh ids.
+ */
+struct ComponentSolve {
+    bool success = false;
+    int dof = 0;
+    bool redundant = false;
+    std::vector<size_t> conflicting;  ///< constraint positions
+    std::vector<double> values;       ///< solved parameters, entity by entity
+};
+
+/// Component solves by content key (see Sketch::solveByComponent).
+using ComponentSolveCache = std::unordered_map<std::string, ComponentSolve>;
+
+/// Content key of a component from its entities and constraints, both in
+/// sketch order; an empty key keeps the component out of the cache.
+using ComponentKeyFn = std::function<std::string(const std::vector<EntityID>& entities,
+                                                 const std::vector<ConstraintID>& constraints)>;
+
+/**
+ * @brief Merged result of Sketch::solveByComponent
+ */
+struct ComponentSolveResult {
+    SolveResult solve;  ///< success iff every component solved; conflicts merged
+    int dof = 0;
+    bool redundant = false;
+    size_t solvedComponents = 0;  ///< components solved and diagnosed afresh
+    size_t reusedComponents = 0;  ///< components taken from the cache
 };
 
 /**
@@ -489,12 +528,47 @@ public:
      */
     SolveResult solve();
 
+    /**
+     * @brief Solve and diagnose one solver component at a time, reusing the
+     *        components `previous` already holds
+     * @param keyOf Content key of a component. A component whose key is in
+     *        `previous` is not solved again: its solved parameters are written
+     *        back and its diagnosis reused.
+     * @param next Receives the entry of every keyed component, reused or not —
+     *        the cache to hand the next call (components since removed drop out).
+     *
+     * Decoupled components share no parameter, so the DOF is the sum of theirs
+     * and no redundancy or conflict spans two: the merged result is what
+     * diagnosing each component from scratch reports, however much came from the
+     * cache. Like solve() followed by getDegreesOfFreedom() and
+     * hasRedundantConstraints(), a component is diagnosed at its solved pose and
+     * reports the conflicts found by its solve. A sketch PlaneGCS cannot hold
+     * (ellipses, unsupported constraints) takes exactly that path and caches
+     * nothing. getDegreesOfFreedom() and getConflictingConstraints() then
+     * answer from this result.
+     */
+    ComponentSolveResult solveByComponent(const ComponentKeyFn& keyOf,
+                                          const ComponentSolveCache& previous,
+                                          ComponentSolveCache& next);
+
+    /**
+     * @brief Bound every subsequent solve (full and drag) by `limits`
+     *
+     * In force until replaced; `SolveLimits{}` lifts it. A bound that fires
+     * sets `interrupted` and never fails a point-drag session by itself.
+     */
+    void setSolveLimits(const SolveLimits& limits) { solveLimits_ = limits; }
+
     /**
      * @brief Solve constraints with a specific point being dragged
      * @param draggedPoint Point being moved by user
      * @param targetPos Target position for dragged point
+     * @param seed Predicted pose to start the solve from (see DragSeed). Where
+     *        the targets and pins determine the pose, the result is the same
+     *        within tolerance; only the iterations and substeps to reach it drop.
      */
-    SolveResult solveWithDrag(EntityID draggedPoint, const Vec2d& targetPos);
+    SolveResult solveWithDrag(EntityID draggedPoint, const Vec2d& targetPos,
+                              const DragSeed& seed = {});
 
     /**
      * @brief Start a point-drag session and compute point-fixing strategy.
@@ -527,6 +601,7 @@ public:
      * @param pointTargets Where each named point should go.
      * @param radiusTargets What each named Arc/Circle radius should become.
      * @param pinnedPoints Points held at their CURRENT position for this solve.
+     * @param seed Predicted pose to start the solve from, as for solveWithDrag.
      *
      * The sibling of solveWithDrag for gestures that are not "one point to one
      * position": `radius` moves no point at all, `arcEnd` needs the sibling
@@ -540,7 +615,23 @@ public:
      */
     SolveResult solveWithTargets(const std::unordered_map<EntityID, Vec2d>& pointTargets,
                                  const std::unordered_map<EntityID, double>& radiusTargets,
-                                 const std::unordered_set<EntityID>& pinnedPoints);
+                                 const std::unordered_set<EntityID>& pinnedPoints,
+                                 const DragSeed& seed = {});
+
+    /**
+     * @brief The entities a drag driving `seeds` is solved over, when that is
+     *        less than the whole sketch.
+     * @return The one connected component of the entity–constraint graph
+     *         (SolverAdapter::solverComponents) holding every seed, or nullopt
+     *         when the drag falls back to the whole-sketch solver: the sketch
+     *         is a single component, or the seeds span several.
+     *
+     * solveWithDrag / solveWithGroupDrag / solveWithTargets solve only this
+     * component, so nothing outside it can move — callers diffing the pose
+     * after a step (the solver lane) may restrict the diff to it.
+     */
+    std::optional<std::unordered_set<EntityID>> dragComponent(
+        const std::vector<EntityID>& seeds) const;
 
     /**
      * @brief Every point entity the given entity OWNS, in handle order.
@@ -731,8 +822,17 @@ private:
     // Solver (PlaneGCS wrapper)
     std::unique_ptr<ConstraintSolver> solver_;
     bool solverDirty_ = true;  // Needs rebuild if true
+    SolveLimits solveLimits_;  // handed to whichever solver runs next
     std::vector<ConstraintID> lastConflictingConstraints_;
 
+    // Drag decomposition: the entity–constraint graph's connected components
+    // and a lazily built solver per dragged component. Dropped together with
+    // solver_ by invalidateSolver().
+    mutable std::vector<std::vector<EntityID>> solverComponents_;
+    mutable std::unordered_map<EntityID, size_t> solverComponentOf_;
+    mutable bool componentsDirty_ = true;
+    std::unordered_map<size_t, std::unique_ptr<ConstraintSolver>> componentSolvers_;
+
     // Cached DOF calculation
     mutable int cachedDOF_ = -1;
     mutable bool dofDirty_ = true;
@@ -760,6 +860,34 @@ private:
      */
     void rebuildSolver();
 
+    /**
+     * @brief Index of the one component holding every seed, if the sketch has
+     *        more than one component
+     */
+    std::optional<size_t> dragComponentIndex(const std::vector<EntityID>& seeds) const;
+
+    /**
+     * @brief The solver a drag driving `seeds` runs on: its component's, else
+     *        the whole-sketch solver_ (rebuilt if dirty). Null if neither builds.
+     */
+    ConstraintSolver* dragSolverFor(const std::vector<EntityID>& seeds);
+
+    /**
+     * @brief Solve and diagnose one component on a solver of its own
+     * @param merged Accumulates the solve's iterations, interruption and first error.
+     * @return nullopt if its constraints do not translate
+     */
+    std::optional<ComponentSolve> solveComponent(const std::vector<EntityID>& members,
+                                                 const std::vector<ConstraintID>& constraints,
+                                                 SolveResult& merged);
+
+    /// The solver parameters of `members`, entity by entity (see ComponentSolve).
+    std::vector<double> componentValues(const std::vector<EntityID>& members) const;
+
+    /// Write `values` back over `members`; false (nothing written) on a size mismatch.
+    bool applyComponentValues(const std::vector<EntityID>& members,
+                              const std::vector<double>& values);
+
     /**
      * @brief Update entity index map after removal
      */
@@ -10,7 +10,11 @@
 #ifndef ONECAD_CORE_SKETCH_TYPES_H
 #define ONECAD_CORE_SKETCH_TYPES_H
 
+#include <chrono>
 #include <string>
+#include <unordered_map>
+
+#include "util/Cancel.h"
 
 namespace onecad::core::sketch {
 
@@ -131,6 +135,39 @@ struct Vec3d {
     double z = 0.0;
 };
 
+//==============================================================================
+// Solver Bounds
+//==============================================================================
+
+/**
+ * @brief Caller-owned bounds on a solve, checked between PlaneGCS iterations
+ *
+ * `SolverConfig::timeoutMs` bounds each solve() on its own; a deadline here
+ * bounds EVERY solve until it passes, so a drag's substeps share one budget,
+ * while `perSolve` gives each solve() its own budget from the moment it starts
+ * (a drag's substeps each get the full amount). Any bound firing rolls the
+ * solve back to its pre-solve values (status Timeout / Cancelled) — a partial
+ * iterate is never applied. A substepped drag that runs out of time keeps the
+ * substeps that already converged; a cancelled one is undone whole. The token
+ * must outlive the limits.
+ */
+struct SolveLimits {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    std::chrono::milliseconds perSolve{0};  ///< 0 = no per-solve bound
+    const onecad::CancelToken* cancel = nullptr;
+};
+
+/**
+ * @brief Predicted end pose of a drag step (warm start), by point id
+ *
+ * Each drag substep starts its points that share of the way toward these
+ * positions instead of where they stand, and the solver corrects from there.
+ * Advisory only: pins and targets are read from the pose BEFORE seeding, so a
+ * seed moves where a solve starts, never what it solves for. Ids the solver
+ * does not hold are ignored.
+ */
+using DragSeed = std::unordered_map<EntityID, Vec2d>;
+
 //==============================================================================
 // Constants
 //==============================================================================
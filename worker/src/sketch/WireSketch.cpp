@@ -497,6 +497,80 @@ TranslateResult translate(const json& args) {
     return result;
 }
 
+// --- component keys ---------------------------------------------------------
+
+ComponentKeys::ComponentKeys(const json& args, const WireIndex& index) : args_(args) {
+    std::unordered_map<std::string, std::size_t> entity_by_wire;
+    if (args.contains("entities") && args["entities"].is_array()) {
+        for (std::size_t i = 0; i < args["entities"].size(); ++i) {
+            entity_by_wire.emplace(args["entities"][i].value("id", std::string{}), i);
+        }
+    }
+    for (const auto& [wire_id, internal] : index.wire_to_internal) {
+        if (const auto it = entity_by_wire.find(wire_id); it != entity_by_wire.end()) {
+            entity_slot_.emplace(internal, it->second);
+        }
+    }
+    // Points the wire never names on their own (inline line ends, centers, arc
+    // ends) belong to the entity their handle is rooted at: "l.p0" -> "l".
+    for (const auto& [handle, point] : index.handle_to_point) {
+        const std::size_t dot = handle.rfind('.');
+        if (entity_slot_.count(point) != 0 || dot == std::string::npos) continue;
+        if (const auto it = entity_by_wire.find(handle.substr(0, dot));
+            it != entity_by_wire.end()) {
+            entity_slot_.emplace(point, it->second);
+        }
+    }
+
+    std::unordered_map<std::string, std::size_t> constraint_by_wire;
+    if (args.contains("constraints") && args["constraints"].is_array()) {
+        for (std::size_t i = 0; i < args["constraints"].size(); ++i) {
+            constraint_by_wire.emplace(args["constraints"][i].value("id", std::string{}), i);
+        }
+    }
+    for (const auto& [internal, wire_id] : index.internal_constraint_to_wire) {
+        if (const auto it = constraint_by_wire.find(wire_id); it != constraint_by_wire.end()) {
+            constraint_slot_.emplace(internal, it->second);
+        }
+    }
+}
+
+std::string ComponentKeys::operator()(const std::vector<sk::EntityID>& entities,
+                                      const std::vector<sk::ConstraintID>& constraints) const {
+    // Wire slots, in wire order, each once (an inline line and its two end
+    // points are one wire entity).
+    const auto slots = [](const auto& ids, const auto& slot_of, std::vector<std::size_t>& out) {
+        for (const auto& id : ids) {
+            const auto it = slot_of.find(id);
+            if (it == slot_of.end()) return false;
+            out.push_back(it->second);
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return true;
+    };
+    std::vector<std::size_t> entity_slots;
+    std::vector<std::size_t> constraint_slots;
+    if (!slots(entities, entity_slot_, entity_slots) ||
+        !slots(constraints, constraint_slot_, constraint_slots)) {
+        return {};
+    }
+
+    // One compact dump per line (a dump never holds a raw newline), the
+    // entities and constraints separated by an empty line.
+    std::string key;
+    for (std::size_t slot : entity_slots) {
+        key += args_["entities"][slot].dump();
+        key += '\n';
+    }
+    key += '\n';
+    for (std::size_t slot : constraint_slots) {
+        key += args_["constraints"][slot].dump();
+        key += '\n';
+    }
+    return key;
+}
+
 // --- write-back -------------------------------------------------------------
 
 void apply_solved_positions(json& args, const sk::Sketch& sketch, const WireIndex& index) {
@@ -80,6 +80,25 @@ struct TranslateResult {
 // live `Sketch`. On failure `ok` is false and `error` explains why.
 TranslateResult translate(const nlohmann::json& args);
 
+// Content keys of a translated sketch's solver components, the `keyOf` of
+// `Sketch::solveByComponent`: a component's key is the wire entities and
+// constraints it was translated from, verbatim and in wire order, so two upserts
+// carrying a component byte for byte — coordinates included — share its key.
+// Built once per translate; `args` must outlive it.
+class ComponentKeys {
+public:
+    ComponentKeys(const nlohmann::json& args, const WireIndex& index);
+
+    // Empty when a member cannot be traced back to the wire (never cached).
+    std::string operator()(const std::vector<sk::EntityID>& entities,
+                           const std::vector<sk::ConstraintID>& constraints) const;
+
+private:
+    const nlohmann::json& args_;
+    std::unordered_map<sk::EntityID, std::size_t> entity_slot_;  // -> args.entities index
+    std::unordered_map<sk::ConstraintID, std::size_t> constraint_slot_;
+};
+
 // Overwrite the coordinate fields of a stored wire `args` in place from the
 // solved positions of `sketch` (used after EndGesture to keep the pre-session
 // store consistent). Points, line endpoints, and circle/arc/ellipse centers +
@@ -13,15 +13,26 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <iterator>
 #include <limits>
 #include "util/Log.h"
+#include "util/Stats.h"
 
 namespace onecad::core::sketch {
 
 namespace {
 
+// Drag substepping. An unseeded drag is split by distance: one substep per
+// kDragSubstepThreshold of travel, up to kMaxDragSubsteps. A seeded drag is
+// first tried as ONE solve, then four, both seeded, and re-run from the
+// pre-drag pose in more substeps only when a solve fails or lands far from
+// where the predictor said it would (it most likely crossed to another branch
+// of the linkage). Its last level is the unseeded distance split, so a missed
+// prediction ends exactly where an unseeded drag would, and a failure there
+// is final.
 constexpr double kDragSubstepThreshold = 100.0;
 constexpr int kMaxDragSubsteps = 10;
+constexpr int kSeededDragSubsteps[] = {1, 4};
 
 int computeDragSubsteps(double maxDeltaMagnitude) {
     if (maxDeltaMagnitude <= kDragSubstepThreshold) {
@@ -31,6 +42,10 @@ int computeDragSubsteps(double maxDeltaMagnitude) {
     return std::min(kMaxDragSubsteps, std::max(1, static_cast<int>(rawSteps)));
 }
 
+// A seeded substep whose solved pose strays from its seed by more than this
+// fraction of the substep's length is refined rather than accepted.
+constexpr double kPredictorTrust = 0.5;
+
 double* coordPtr(SketchPoint* point, int coordIndex) {
     gp_XY& coords = point->position().ChangeCoord();
     return &coords.ChangeCoord(coordIndex);
@@ -407,17 +422,45 @@ SolverResult ConstraintSolver::solve() {
     gcsSystem_->declareUnknowns(parameters_);
     gcsSystem_->declareDrivenParams(drivenParameters_);
 
+    solveDeadline_ = limits_.deadline;
+    if (limits_.perSolve.count() > 0) {
+        solveDeadline_ = std::min(solveDeadline_, start + limits_.perSolve);
+    }
+    if (config_.timeoutMs > 0) {
+        solveDeadline_ = std::min(solveDeadline_,
+                                  start + std::chrono::milliseconds(config_.timeoutMs));
+    }
+
     GCS::Algorithm alg = toGcsAlgorithm(config_.algorithm);
     gcsSystem_->initSolution(alg);
 
+    // Installed only around the solve proper: PlaneGCS's diagnosis runs solves
+    // of its own, and a bound firing there would corrupt the redundancy report.
+    gcsSystem_->setInterruptCheck([this] {
+        return (limits_.cancel != nullptr && limits_.cancel->cancelled()) ||
+               std::chrono::steady_clock::now() >= solveDeadline_;
+    });
     int status = gcsSystem_->solve(true, alg, false);
-    if (status == GCS::Failed && config_.algorithm == SolverConfig::Algorithm::DogLeg) {
+    result.iterations = gcsSystem_->lastIterations();
+    if (status == GCS::Failed && config_.algorithm == SolverConfig::Algorithm::DogLeg &&
+        !gcsSystem_->wasInterrupted()) {
         WLOG_WARN("%s", "solve:dogleg-failed-fallback-to-lm");
         status = gcsSystem_->solve(true, GCS::LevenbergMarquardt, false);
+        result.iterations += gcsSystem_->lastIterations();
     }
+    const bool interrupted = gcsSystem_->wasInterrupted();
+    gcsSystem_->setInterruptCheck({});
 
     result.status = toSolverStatus(status);
     result.success = (status == GCS::Success || status == GCS::Converged);
+    if (interrupted) {
+        // Stopped between iterations: the iterate is not a solution, roll back.
+        const bool cancelled = limits_.cancel != nullptr && limits_.cancel->cancelled();
+        result.status = cancelled ? SolverResult::Status::Cancelled
+                                  : SolverResult::Status::Timeout;
+        result.success = false;
+        result.errorMessage = cancelled ? "Solve cancelled" : "Solve deadline exceeded";
+    }
 
     if (result.success) {
         gcsSystem_->applySolution();
@@ -456,22 +499,19 @@ SolverResult ConstraintSolver::solve() {
         successfulSolves_++;
     }
     totalSolveTime_ += result.solveTime;
-
-    if (config_.timeoutMs > 0) {
-        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(result.solveTime).count();
-        if (elapsedMs > config_.timeoutMs) {
-            result.status = SolverResult::Status::Timeout;
-            result.success = false;
-            gcsSystem_->undoSolution();
-            restoreParameters();
-        }
+    static stats::Histogram& solveTiming = stats::histogram("solver.solve");
+    static stats::Counter& solveFailures = stats::counter("solver.failed");
+    solveTiming.record(static_cast<std::uint64_t>(result.solveTime.count()));
+    if (!result.success) {
+        solveFailures.add();
     }
 
     return result;
 }
 
 SolverResult ConstraintSolver::solveWithDrag(EntityID pointId, const Vec2d& targetPos,
-                                             const std::unordered_set<EntityID>& pointIdsToFix) {
+                                             const std::unordered_set<EntityID>& pointIdsToFix,
+                                             const DragSeed& seed) {
     auto draggedIt = pointsById_.find(pointId);
     if (draggedIt == pointsById_.end() || !draggedIt->second) {
         SolverResult result;
@@ -493,29 +533,16 @@ SolverResult ConstraintSolver::solveWithDrag(EntityID pointId, const Vec2d& targ
     const double deltaX = targetPos.x - startPos.x;
     const double deltaY = targetPos.y - startPos.y;
     const double deltaMagnitude = std::sqrt((deltaX * deltaX) + (deltaY * deltaY));
-    const int substeps = computeDragSubsteps(deltaMagnitude);
-    if (substeps > 1) {
-    }
-
-    const ConstraintSolver::DragSolveSnapshot snapshot = captureDragSolveSnapshot();
-    SolverResult lastResult;
-    for (int step = 1; step <= substeps; ++step) {
-        const double t = static_cast<double>(step) / static_cast<double>(substeps);
-        const Vec2d intermediateTarget{
-            .x = startPos.x + (deltaX * t),
-            .y = startPos.y + (deltaY * t),
-        };
-        lastResult = solveWithDragSingleStep(pointId, intermediateTarget, pointIdsToFix);
-        if (!lastResult.success) {
-            restoreDragSolveSnapshot(snapshot);
-            if (lastResult.errorMessage.empty()) {
-                lastResult.errorMessage = "Drag rejected by constraints";
-            }
-            return lastResult;
-        }
-    }
 
-    return lastResult;
+    return runDragSubsteps(
+        deltaMagnitude, seed, true, "Drag rejected by constraints",
+        [&](double t, const DragSeed& stepSeed) {
+            const Vec2d intermediateTarget{
+                .x = startPos.x + (deltaX * t),
+                .y = startPos.y + (deltaY * t),
+            };
+            return solveWithDragSingleStep(pointId, intermediateTarget, pointIdsToFix, stepSeed);
+        });
 }
 
 SolverResult ConstraintSolver::solveWithGroupDrag(
@@ -556,36 +583,23 @@ SolverResult ConstraintSolver::solveWithGroupDrag(
         maxDeltaMagnitude = std::max(maxDeltaMagnitude, std::sqrt((dx * dx) + (dy * dy)));
     }
 
-    const int substeps = computeDragSubsteps(maxDeltaMagnitude);
-    if (substeps > 1) {
-    }
-
-    const ConstraintSolver::DragSolveSnapshot snapshot = captureDragSolveSnapshot();
-    SolverResult lastResult;
+    // Rigid-or-reject: a group drag never keeps a partial path, not even the
+    // converged substeps of one that ran out of time.
     std::unordered_map<EntityID, Vec2d> intermediateTargets;
     intermediateTargets.reserve(targetPositions.size());
-    for (int step = 1; step <= substeps; ++step) {
-        intermediateTargets.clear();
-        const double t = static_cast<double>(step) / static_cast<double>(substeps);
-        for (const auto& [pointId, targetPos] : targetPositions) {
-            const Vec2d& startPos = startPositions.at(pointId);
-            intermediateTargets[pointId] = Vec2d{
-                .x = startPos.x + ((targetPos.x - startPos.x) * t),
-                .y = startPos.y + ((targetPos.y - startPos.y) * t),
-            };
-        }
-
-        lastResult = solveWithGroupDragSingleStep(intermediateTargets);
-        if (!lastResult.success) {
-            restoreDragSolveSnapshot(snapshot);
-            if (lastResult.errorMessage.empty()) {
-                lastResult.errorMessage = "Group drag rejected by constraints";
+    return runDragSubsteps(
+        maxDeltaMagnitude, {}, false, "Group drag rejected by constraints",
+        [&](double t, const DragSeed&) {
+            intermediateTargets.clear();
+            for (const auto& [pointId, targetPos] : targetPositions) {
+                const Vec2d& startPos = startPositions.at(pointId);
+                intermediateTargets[pointId] = Vec2d{
+                    .x = startPos.x + ((targetPos.x - startPos.x) * t),
+                    .y = startPos.y + ((targetPos.y - startPos.y) * t),
+                };
             }
-            return lastResult;
-        }
-    }
-
-    return lastResult;
+            return solveWithGroupDragSingleStep(intermediateTargets);
+        });
 }
 
 SolverResult ConstraintSolver::solveWithTargets(const ConstraintSolver::DragTargets& targets) {
@@ -649,101 +663,163 @@ SolverResult ConstraintSolver::solveWithTargets(const ConstraintSolver::DragTarg
         maxDeltaMagnitude = std::max(maxDeltaMagnitude, std::abs(targetRadius - startRadius));
     }
 
-    const int substeps = computeDragSubsteps(maxDeltaMagnitude);
-
-    const ConstraintSolver::DragSolveSnapshot snapshot = captureDragSolveSnapshot();
-    SolverResult lastResult;
     ConstraintSolver::DragTargets intermediate;
     intermediate.pinnedPoints = targets.pinnedPoints;
     intermediate.points.reserve(targets.points.size());
     intermediate.radii.reserve(targets.radii.size());
-    for (int step = 1; step <= substeps; ++step) {
-        intermediate.points.clear();
-        intermediate.radii.clear();
-        const double t = static_cast<double>(step) / static_cast<double>(substeps);
-        for (const auto& [pointId, targetPos] : targets.points) {
-            const Vec2d& startPos = startPositions.at(pointId);
-            intermediate.points[pointId] = Vec2d{
-                .x = startPos.x + ((targetPos.x - startPos.x) * t),
-                .y = startPos.y + ((targetPos.y - startPos.y) * t),
-            };
-        }
-        for (const auto& [curveId, targetRadius] : targets.radii) {
-            const double startRadius = startRadii.at(curveId);
-            intermediate.radii[curveId] = startRadius + ((targetRadius - startRadius) * t);
-        }
-
-        lastResult = solveWithTargetsSingleStep(intermediate);
-        if (!lastResult.success) {
-            restoreDragSolveSnapshot(snapshot);
-            if (lastResult.errorMessage.empty()) {
-                lastResult.errorMessage = "Drag rejected by constraints";
+    return runDragSubsteps(
+        maxDeltaMagnitude, targets.seed, true, "Drag rejected by constraints",
+        [&](double t, const DragSeed& stepSeed) {
+            intermediate.points.clear();
+            intermediate.radii.clear();
+            for (const auto& [pointId, targetPos] : targets.points) {
+                const Vec2d& startPos = startPositions.at(pointId);
+                intermediate.points[pointId] = Vec2d{
+                    .x = startPos.x + ((targetPos.x - startPos.x) * t),
+                    .y = startPos.y + ((targetPos.y - startPos.y) * t),
+                };
             }
-            return lastResult;
-        }
-    }
-
-    return lastResult;
+            for (const auto& [curveId, targetRadius] : targets.radii) {
+                const double startRadius = startRadii.at(curveId);
+                intermediate.radii[curveId] = startRadius + ((targetRadius - startRadius) * t);
+            }
+            intermediate.seed = stepSeed;
+            return solveWithTargetsSingleStep(intermediate);
+        });
 }
 
-ConstraintSolver::DragSolveSnapshot ConstraintSolver::captureDragSolveSnapshot() const {
-    ConstraintSolver::DragSolveSnapshot snapshot;
-    snapshot.pointPositions.reserve(pointsById_.size());
-    for (const auto& [id, point] : pointsById_) {
-        if (!point) {
-            continue;
-        }
-        snapshot.pointPositions[id] = Vec2d{.x = point->position().X(), .y = point->position().Y()};
-    }
+SolverResult ConstraintSolver::runDragSubsteps(
+    double maxDeltaMagnitude, const DragSeed& seed, bool keepConvergedOnTimeout,
+    const char* rejectMessage,
+    const std::function<SolverResult(double t, const DragSeed& stepSeed)>& solveStep) {
+    const ConstraintSolver::DragSolveSnapshot snapshot = captureDragSolveSnapshot();
 
-    snapshot.arcStates.reserve(arcsById_.size());
-    for (const auto& [id, arc] : arcsById_) {
-        if (!arc) {
-            continue;
+    // Substep k of n starts its seeded points k/n of the way along the
+    // predictor, from where they stood before the drag.
+    DragSeed seedStart;
+    seedStart.reserve(seed.size());
+    for (const auto& [id, predicted] : seed) {
+        auto pointIt = pointsById_.find(id);
+        if (pointIt != pointsById_.end() && pointIt->second) {
+            seedStart[id] = Vec2d{pointIt->second->position().X(),
+                                  pointIt->second->position().Y()};
         }
-        snapshot.arcStates[id] = ConstraintSolver::DragSolveSnapshot::ArcState{
-            .radius = arc->radius(),
-            .startAngle = arc->startAngle(),
-            .endAngle = arc->endAngle(),
-        };
     }
 
-    snapshot.circleRadii.reserve(circlesById_.size());
-    for (const auto& [id, circle] : circlesById_) {
-        if (!circle) {
-            continue;
+    SolverResult lastResult;
+    DragSeed stepSeed;
+    stepSeed.reserve(seedStart.size());
+    int iterations = 0;
+    int solves = 0;
+    const auto finish = [&](SolverResult& result) -> SolverResult& {
+        result.iterations = iterations;
+        result.substeps = solves;
+        return result;
+    };
+
+    const int seededLevels =
+        seedStart.empty() ? 0 : static_cast<int>(std::size(kSeededDragSubsteps));
+    for (int level = 0; level <= seededLevels; ++level) {
+        const bool finest = level == seededLevels;
+        const int substeps =
+            finest ? computeDragSubsteps(maxDeltaMagnitude) : kSeededDragSubsteps[level];
+        bool refine = false;
+        for (int step = 1; step <= substeps && !refine; ++step) {
+            const double t = static_cast<double>(step) / static_cast<double>(substeps);
+            // The finest level runs unseeded: it is the whole of an unseeded
+            // drag, and the fallback for a prediction that kept missing.
+            stepSeed.clear();
+            if (!finest) {
+                for (const auto& [id, from] : seedStart) {
+                    const Vec2d& to = seed.at(id);
+                    stepSeed[id] = Vec2d{.x = from.x + ((to.x - from.x) * t),
+                                         .y = from.y + ((to.y - from.y) * t)};
+                }
+            }
+
+            lastResult = solveStep(t, stepSeed);
+            ++solves;
+            iterations += lastResult.iterations;
+            if (lastResult.success) {
+                refine = !finest && predictorMissed(stepSeed, maxDeltaMagnitude / substeps);
+                continue;
+            }
+
+            const bool bounded = lastResult.status == SolverResult::Status::Timeout ||
+                                 lastResult.status == SolverResult::Status::Cancelled;
+            if (keepConvergedOnTimeout && lastResult.status == SolverResult::Status::Timeout &&
+                step > 1) {
+                // Out of time, not refused: the substeps already taken are
+                // converged poses toward the target, so the furthest one stays.
+                return finish(lastResult);
+            }
+            // A bound leaves no time to refine, and a conflict is structural:
+            // shorter substeps cannot resolve it.
+            if (bounded || finest || !lastResult.conflictingConstraints.empty()) {
+                restoreDragSolveSnapshot(snapshot);
+                if (lastResult.errorMessage.empty()) {
+                    lastResult.errorMessage = rejectMessage;
+                }
+                return finish(lastResult);
+            }
+            refine = true;
+        }
+        if (!refine) {
+            return finish(lastResult);
         }
-        snapshot.circleRadii[id] = circle->radius();
+        restoreDragSolveSnapshot(snapshot);
     }
 
-    return snapshot;
+    return finish(lastResult);
 }
 
-void ConstraintSolver::restoreDragSolveSnapshot(const ConstraintSolver::DragSolveSnapshot& snapshot) {
-    for (const auto& [id, pos] : snapshot.pointPositions) {
+bool ConstraintSolver::predictorMissed(const DragSeed& stepSeed, double stepLength) const {
+    const double trust = (kPredictorTrust * stepLength) + config_.tolerance;
+    for (const auto& [id, predicted] : stepSeed) {
         auto pointIt = pointsById_.find(id);
         if (pointIt == pointsById_.end() || !pointIt->second) {
             continue;
         }
-        pointIt->second->setPosition(pos.x, pos.y);
+        const double dx = pointIt->second->position().X() - predicted.x;
+        const double dy = pointIt->second->position().Y() - predicted.y;
+        if ((dx * dx) + (dy * dy) > trust * trust) {
+            return true;
+        }
     }
+    return false;
+}
 
-    for (const auto& [id, arcState] : snapshot.arcStates) {
-        auto arcIt = arcsById_.find(id);
-        if (arcIt == arcsById_.end() || !arcIt->second) {
+DragSeed ConstraintSolver::applyDragSeed(const DragSeed& seed) {
+    DragSeed previous;
+    previous.reserve(seed.size());
+    for (const auto& [id, position] : seed) {
+        auto pointIt = pointsById_.find(id);
+        if (pointIt == pointsById_.end() || !pointIt->second) {
             continue;
         }
-        arcIt->second->setRadius(arcState.radius);
-        arcIt->second->setStartAngle(arcState.startAngle);
-        arcIt->second->setEndAngle(arcState.endAngle);
+        SketchPoint* point = pointIt->second;
+        previous[id] = Vec2d{point->position().X(), point->position().Y()};
+        point->setPosition(position.x, position.y);
     }
+    return previous;
+}
 
-    for (const auto& [id, radius] : snapshot.circleRadii) {
-        auto circleIt = circlesById_.find(id);
-        if (circleIt == circlesById_.end() || !circleIt->second) {
-            continue;
+ConstraintSolver::DragSolveSnapshot ConstraintSolver::captureDragSolveSnapshot() const {
+    ConstraintSolver::DragSolveSnapshot snapshot;
+    snapshot.values.resize(parameters_.size());
+    for (std::size_t i = 0; i < parameters_.size(); ++i) {
+        snapshot.values[i] = *parameters_[i];
+    }
+    return snapshot;
+}
+
+void ConstraintSolver::restoreDragSolveSnapshot(const ConstraintSolver::DragSolveSnapshot& snapshot) {
+    // Bit-exact, like PlaneGCS's own undo: the entity setters would clamp a
+    // radius and normalize an angle the solve left outside [0, 2*pi).
+    if (snapshot.values.size() == parameters_.size()) {
+        for (std::size_t i = 0; i < parameters_.size(); ++i) {
+            *parameters_[i] = snapshot.values[i];
         }
-        circleIt->second->setRadius(radius);
     }
 
     if (gcsSystem_) {
@@ -755,7 +831,8 @@ void ConstraintSolver::restoreDragSolveSnapshot(const ConstraintSolver::DragSolv
 SolverResult ConstraintSolver::solveWithDragSingleStep(
     EntityID pointId,
     const Vec2d& targetPos,
-    const std::unordered_set<EntityID>& pointIdsToFix) {
+    const std::unordered_set<EntityID>& pointIdsToFix,
+    const DragSeed& seed) {
     auto it = pointsById_.find(pointId);
     if (it == pointsById_.end() || !it->second) {
         SolverResult result;
@@ -807,7 +884,12 @@ SolverResult ConstraintSolver::solveWithDragSingleStep(
     gcsSystem_->addConstraintCoordinateX(dragPoint, &targetX, dragTag, true);
     gcsSystem_->addConstraintCoordinateY(dragPoint, &targetY, dragTag, true);
 
+    // Seeded only now that the pins hold their pre-seed values.
+    const DragSeed unseeded = applyDragSeed(seed);
     SolverResult result = solve();
+    if (!result.success) {
+        applyDragSeed(unseeded);
+    }
 
     gcsSystem_->clearByTag(dragTag);
     gcsSystem_->invalidatedDiagnosis();
@@ -958,9 +1040,14 @@ SolverResult ConstraintSolver::solveWithTargetsSingleStep(
         return reject(SolverResult::Status::InvalidInput, "Drag target curve not found");
     }
 
+    // Seeded only now that the pins hold their pre-seed values.
+    const DragSeed unseeded = applyDragSeed(targets.seed);
     SolverResult result = solve();
-    if (!result.success && result.errorMessage.empty()) {
-        result.errorMessage = "Drag rejected by constraints";
+    if (!result.success) {
+        applyDragSeed(unseeded);
+        if (result.errorMessage.empty()) {
+            result.errorMessage = "Drag rejected by constraints";
+        }
     }
 
     gcsSystem_->clearByTag(dragTag);
@@ -1022,71 +1109,18 @@ bool ConstraintSolver::hasRedundant() const {
     return gcsSystem_ && gcsSystem_->hasRedundant();
 }
 void ConstraintSolver::backupParameters() {
-    parameterBackup_.clear();
-
-    for (const auto& [id, point] : pointsById_) {
-        if (!point) {
-            continue;
-        }
-        ParameterBackup backup;
-        backup.entityId = id;
-        backup.type = EntityType::Point;
-        backup.values = {point->x(), point->y()};
-        parameterBackup_.push_back(std::move(backup));
-    }
-
-    for (const auto& [id, arc] : arcsById_) {
-        if (!arc) {
-            continue;
-        }
-        ParameterBackup backup;
-        backup.entityId = id;
-        backup.type = EntityType::Arc;
-        backup.values = {arc->radius(), arc->startAngle(), arc->endAngle()};
-        parameterBackup_.push_back(std::move(backup));
-    }
-
-    for (const auto& [id, circle] : circlesById_) {
-        if (!circle) {
-            continue;
-        }
-        ParameterBackup backup;
-        backup.entityId = id;
-        backup.type = EntityType::Circle;
-        backup.values = {circle->radius()};
-        parameterBackup_.push_back(std::move(backup));
+    parameterBackup_.resize(parameters_.size());
+    for (std::size_t i = 0; i < parameters_.size(); ++i) {
+        parameterBackup_[i] = *parameters_[i];
     }
 }
 
 void ConstraintSolver::restoreParameters() {
-    for (const auto& backup : parameterBackup_) {
-        switch (backup.type) {
-            case EntityType::Point: {
-                auto it = pointsById_.find(backup.entityId);
-                if (it != pointsById_.end() && it->second && backup.values.size() >= 2) {
-                    it->second->setPosition(backup.values[0], backup.values[1]);
-                }
-                break;
-            }
-            case EntityType::Arc: {
-                auto it = arcsById_.find(backup.entityId);
-                if (it != arcsById_.end() && it->second && backup.values.size() >= 3) {
-                    it->second->setRadius(backup.values[0]);
-                    it->second->setStartAngle(backup.values[1]);
-                    it->second->setEndAngle(backup.values[2]);
-                }
-                break;
-            }
-            case EntityType::Circle: {
-                auto it = circlesById_.find(backup.entityId);
-                if (it != circlesById_.end() && it->second && !backup.values.empty()) {
-                    it->second->setRadius(backup.values[0]);
-                }
-                break;
-            }
-            default:
-                break;
-        }
+    if (parameterBackup_.size() != parameters_.size()) {
+        return;
+    }
+    for (std::size_t i = 0; i < parameters_.size(); ++i) {
+        *parameters_[i] = parameterBackup_[i];
     }
 }
 
@@ -1724,6 +1758,7 @@ void ConstraintSolver::configureSystem() {
     gcsSystem_->setMaxIterations(config_.maxIterations);
     gcsSystem_->setConvergenceRedundant(config_.tolerance);
     gcsSystem_->setMaxIterationsRedundant(config_.maxIterations);
+    gcsSystem_->setSparseThreshold(config_.sparseThreshold);
 }
 
 } // namespace onecad::core::sketch
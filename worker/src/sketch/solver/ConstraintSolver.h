@@ -73,8 +73,16 @@ struct SolverConfig {
     /// Whether to apply results on partial solve
     bool applyPartialSolution = false;
 
-    /// Timeout in milliseconds (0 = no timeout)
+    /// Per-solve() time limit in milliseconds, checked between iterations (0 = none)
     int timeoutMs = 1000;
+
+    /// Parameter count from which a PlaneGCS subsystem, and the diagnosis, run on
+    /// sparse factorizations instead of dense ones (0 = always dense). Set where
+    /// a dense solve starts to crowd a drag budget (~15 ms at 256 parameters,
+    /// ~110 ms at 512), so everyday sketches keep the dense path and its DogLeg
+    /// steps; the sparse DogLeg takes least-norm steps, which may settle free DOF
+    /// elsewhere.
+    int sparseThreshold = 256;
 };
 
 /**
@@ -84,9 +92,12 @@ struct SolverResult {
     /// Overall success status
     bool success = false;
 
-    /// Number of iterations used
+    /// Number of iterations used (a drag sums them over its substeps)
     int iterations = 0;
 
+    /// Drag substeps solved, refinement retries included (0 for a plain solve)
+    int substeps = 0;
+
     /// Final residual error
     double residual = 0.0;
 
@@ -99,7 +110,8 @@ struct SolverResult {
         Success,           ///< Fully converged
         PartialSuccess,    ///< Partially converged (some constraints satisfied)
         MaxIterations,     ///< Hit iteration limit
-        Timeout,           ///< Hit time limit
+        Timeout,           ///< Hit time limit (config timeout or SolveLimits deadline)
+        Cancelled,         ///< SolveLimits cancel token fired mid-solve
         Diverged,          ///< Solution diverged
         Redundant,         ///< Redundant constraints detected
         Overconstrained,   ///< System is overconstrained
@@ -156,6 +168,13 @@ public:
     void setConfig(const SolverConfig& config);
     const SolverConfig& getConfig() const { return config_; }
 
+    /**
+     * @brief Bound subsequent solves by a deadline and/or a cancel token
+     *
+     * Stays in force until replaced; pass `SolveLimits{}` to lift it.
+     */
+    void setSolveLimits(const SolveLimits& limits) { limits_ = limits; }
+
     // ========== System Building ==========
 
     /**
@@ -258,9 +277,12 @@ public:
      * Implements rubber-band dragging with spring resistance
      *
      * Current implementation adds temporary coordinate constraints for the dragged point.
+     * `seed` warm-starts the solve (see DragSeed); the solved pose is the same
+     * within tolerance, it is only reached in fewer iterations and substeps.
      */
     SolverResult solveWithDrag(EntityID pointId, const Vec2d& targetPos,
-                               const std::unordered_set<EntityID>& pointIdsToFix = {});
+                               const std::unordered_set<EntityID>& pointIdsToFix = {},
+                               const DragSeed& seed = {});
 
     SolverResult solveWithGroupDrag(const std::unordered_map<EntityID, Vec2d>& targetPositions);
 
@@ -273,12 +295,13 @@ public:
      * them (pinning every other point over-determines an arc-endpoint reshape,
      * pinning nothing lets a body drag translate the whole sketch).
      * A point that is both a target and a pin is TARGETED: the target is the
-     * user's intent, the pin is a default.
+     * user's intent, the pin is a default. `seed` is a warm start only.
      */
     struct DragTargets {
         std::unordered_map<EntityID, Vec2d> points;
         std::unordered_map<EntityID, double> radii;
         std::unordered_set<EntityID> pinnedPoints;
+        DragSeed seed;
     };
 
     /**
@@ -292,8 +315,9 @@ public:
      *
      * Targets are ADVISORY: they are temporary tag(−1) drives, so any committed
      * constraint outranks them and a converged solve that lands away from the
-     * target is still a success. Substepped like the other drag entries; a
-     * substep that fails restores the pre-drag pose and returns.
+     * target is still a success. Substepped like the other drag entries (see
+     * runDragSubsteps); a drag refused at the finest substep restores the
+     * pre-drag pose and returns.
      *
      * The caller owns the SCHEMA §7.4 `MIN_GEOMETRY_SIZE` radius floor — a
      * radius target is handed to PlaneGCS verbatim.
@@ -347,20 +371,32 @@ public:
     /// True when the last solve/diagnose found redundant constraints.
     bool hasRedundant() const;
 
-private:
+    /**
+     * @brief Every unknown's value, in `parameters_` order
+     *
+     * One contiguous copy of the solver's parameter set (point x/y, arc
+     * radius/start/end, circle radius, as registered), so a capture is a
+     * gather and a restore a scatter over the bound `double*` list: no
+     * per-entity lookup or allocation. Only valid for the solver that took it,
+     * with the same entities registered.
+     */
     struct DragSolveSnapshot {
-        std::unordered_map<EntityID, Vec2d> pointPositions;
-        struct ArcState {
-            double radius = 0.0;
-            double startAngle = 0.0;
-            double endAngle = 0.0;
-        };
-        std::unordered_map<EntityID, ArcState> arcStates;
-        std::unordered_map<EntityID, double> circleRadii;
+        std::vector<double> values;
     };
 
+    DragSolveSnapshot captureDragSolveSnapshot() const;
+    void restoreDragSolveSnapshot(const DragSolveSnapshot& snapshot);
+
+private:
     SolverConfig config_;
 
+    /// Caller bounds, and the effective deadline of the solve() in flight
+    /// (the earliest of `limits_.deadline`, `limits_.perSolve` and the config
+    /// timeout).
+    SolveLimits limits_;
+    std::chrono::steady_clock::time_point solveDeadline_ =
+        std::chrono::steady_clock::time_point::max();
+
     /// PlaneGCS system instance
     std::unique_ptr<GCS::System> gcsSystem_;
 
@@ -371,13 +407,8 @@ private:
     std::unordered_map<ConstraintID, int> constraintToGcsTag_;
     std::unordered_map<int, ConstraintID> gcsTagToConstraint_;
 
-    /// Direct pointers to entity parameters for backup/restore
-    struct ParameterBackup {
-        EntityID entityId;
-        EntityType type = EntityType::Point;
-        std::vector<double> values;
-    };
-    std::vector<ParameterBackup> parameterBackup_;
+    /// Values of `parameters_` before the solve in flight, in the same order
+    std::vector<double> parameterBackup_;
 
     std::unordered_map<EntityID, SketchPoint*> pointsById_;
     std::unordered_map<EntityID, SketchLine*> linesById_;
@@ -433,10 +464,30 @@ private:
 
     void configureSystem();
 
-    DragSolveSnapshot captureDragSolveSnapshot() const;
-    void restoreDragSolveSnapshot(const DragSolveSnapshot& snapshot);
+    /**
+     * @brief Drive one drag from the current pose to `t = 1` in substeps
+     *
+     * `solveStep(t, stepSeed)` solves the substep ending at fraction `t`, its
+     * points seeded `t` of the way along `seed`. Without a seed, the drag is
+     * split by distance (computeDragSubsteps). With one, it tries one seeded
+     * substep, then four, and falls back to that unseeded split after a refusal
+     * or a predictor miss. `iterations` and `substeps` of the result count every
+     * solve, retries included.
+     */
+    SolverResult runDragSubsteps(
+        double maxDeltaMagnitude, const DragSeed& seed, bool keepConvergedOnTimeout,
+        const char* rejectMessage,
+        const std::function<SolverResult(double t, const DragSeed& stepSeed)>& solveStep);
+
+    /// True when a solved point strayed from its seed past kPredictorTrust.
+    bool predictorMissed(const DragSeed& stepSeed, double stepLength) const;
+
+    /// Move the seeded points to their seed; returns where they stood.
+    DragSeed applyDragSeed(const DragSeed& seed);
+
     SolverResult solveWithDragSingleStep(EntityID pointId, const Vec2d& targetPos,
-                                         const std::unordered_set<EntityID>& pointIdsToFix);
+                                         const std::unordered_set<EntityID>& pointIdsToFix,
+                                         const DragSeed& seed);
     SolverResult solveWithGroupDragSingleStep(const std::unordered_map<EntityID, Vec2d>& targetPositions);
     SolverResult solveWithTargetsSingleStep(const DragTargets& targets);
 };
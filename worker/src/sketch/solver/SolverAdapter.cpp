@@ -5,20 +5,28 @@
 #include "ConstraintSolver.h"
 #include "util/Log.h"
 
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
 
 namespace onecad::core::sketch {
 
-bool SolverAdapter::populateSolver(Sketch& sketch, ConstraintSolver& solver) {
+bool SolverAdapter::populateSolver(Sketch& sketch, ConstraintSolver& solver,
+                                   const std::unordered_set<EntityID>* component) {
     solver.clear();
 
+    auto inComponent = [component](const EntityID& id) {
+        return !component || component->count(id) != 0;
+    };
+
     for (const auto& entity : sketch.getAllEntities()) {
-        if (entity && entity->type() == EntityType::Point) {
+        if (entity && entity->type() == EntityType::Point && inComponent(entity->id())) {
             solver.addPoint(dynamic_cast<SketchPoint*>(entity.get()));
         }
     }
 
     for (const auto& entity : sketch.getAllEntities()) {
-        if (!entity) {
+        if (!entity || !inComponent(entity->id())) {
             continue;
         }
 
@@ -39,6 +47,14 @@ bool SolverAdapter::populateSolver(Sketch& sketch, ConstraintSolver& solver) {
 
     bool ok = true;
     for (const auto& constraint : sketch.getAllConstraints()) {
+        if (component && constraint) {
+            // A component is closed under constraints: one referenced entity
+            // inside means all of them are.
+            const std::vector<EntityID> refs = constraint->referencedEntities();
+            if (std::none_of(refs.begin(), refs.end(), inComponent)) {
+                continue;
+            }
+        }
         if (!addConstraintToSolver(constraint.get(), solver)) {
             ok = false;
             WLOG_WARN("%s", "populateSolver:constraint-translation-failed");
@@ -62,6 +78,73 @@ bool SolverAdapter::populateSolver(Sketch& sketch, ConstraintSolver& solver) {
     return ok;
 }
 
+std::vector<std::vector<EntityID>> SolverAdapter::solverComponents(const Sketch& sketch) {
+    const auto& entities = sketch.getAllEntities();
+    std::unordered_map<EntityID, std::size_t> slot;
+    slot.reserve(entities.size());
+    for (const auto& entity : entities) {
+        if (entity) {
+            slot.emplace(entity->id(), slot.size());
+        }
+    }
+
+    // Union-find over entity slots (path halving, union by index).
+    std::vector<std::size_t> parent(slot.size());
+    std::iota(parent.begin(), parent.end(), std::size_t{0});
+    auto find = [&parent](std::size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    auto unite = [&](const EntityID& a, const EntityID& b) {
+        const auto ia = slot.find(a);
+        const auto ib = slot.find(b);
+        if (ia == slot.end() || ib == slot.end()) {
+            return;
+        }
+        const std::size_t ra = find(ia->second);
+        const std::size_t rb = find(ib->second);
+        if (ra != rb) {
+            parent[std::max(ra, rb)] = std::min(ra, rb);
+        }
+    };
+
+    for (const auto& entity : entities) {
+        if (!entity) {
+            continue;
+        }
+        for (const EntityID& pointId : sketch.entityPointIds(entity->id())) {
+            unite(entity->id(), pointId);
+        }
+    }
+    for (const auto& constraint : sketch.getAllConstraints()) {
+        if (!constraint) {
+            continue;
+        }
+        const std::vector<EntityID> refs = constraint->referencedEntities();
+        for (std::size_t i = 1; i < refs.size(); ++i) {
+            unite(refs.front(), refs[i]);
+        }
+    }
+
+    std::vector<std::vector<EntityID>> components;
+    std::unordered_map<std::size_t, std::size_t> componentOfRoot;
+    for (const auto& entity : entities) {
+        if (!entity) {
+            continue;
+        }
+        const std::size_t root = find(slot.at(entity->id()));
+        const auto [it, fresh] = componentOfRoot.emplace(root, components.size());
+        if (fresh) {
+            components.emplace_back();
+        }
+        components[it->second].push_back(entity->id());
+    }
+    return components;
+}
+
 bool SolverAdapter::addConstraintToSolver(SketchConstraint* constraint, ConstraintSolver& solver) {
     if (!constraint) {
         return false;
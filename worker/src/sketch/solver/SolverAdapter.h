@@ -10,6 +10,9 @@
 
 #include "../SketchTypes.h"
 
+#include <unordered_set>
+#include <vector>
+
 namespace onecad::core::sketch {
 
 class Sketch;
@@ -23,9 +26,25 @@ class SolverAdapter {
 public:
     /**
      * @brief Populate solver with all entities and constraints from a sketch
+     * @param component When non-null, only the entities in this set and the
+     *        constraints over them are registered (one entry of
+     *        solverComponents()); reference-lock pins outside it are skipped
+     *        by the solver itself.
      * @return true if every constraint was translated
      */
-    static bool populateSolver(Sketch& sketch, ConstraintSolver& solver);
+    static bool populateSolver(Sketch& sketch, ConstraintSolver& solver,
+                               const std::unordered_set<EntityID>* component = nullptr);
+
+    /**
+     * @brief Connected components of the entity–constraint graph
+     *
+     * Two entities share a component when a constraint references both, or one
+     * owns the other as a handle point (line endpoints, arc/circle centers, an
+     * arc's endpoint points). No solve can move geometry outside the component
+     * of what it drives, so a drag may be solved on that component alone.
+     * Components are returned in first-entity order, members in entity order.
+     */
+    static std::vector<std::vector<EntityID>> solverComponents(const Sketch& sketch);
 
     /**
      * @brief Add a single constraint to the solver
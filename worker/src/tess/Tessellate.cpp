@@ -25,6 +25,8 @@
 #include <gp_Vec.hxx>
 
 #include "tess/Mesh1.h"
+#include "util/Stats.h"
+#include "util/Trace.h"
 
 namespace onecad::tess {
 
@@ -134,6 +136,32 @@ std::vector<gp_Pnt> sample_edge(const BRepAdaptor_Curve& curve, double lin,
     return points;
 }
 
+// Mesh `shape` (single-threaded for determinism; the ids/ordinal are threading-
+// independent regardless — Invariant 5) and return the deflection in `lin`/`ang`.
+//
+// `prototype` (Tessellate {instances:true}) meshes the UN-LOCATED shape at the
+// deflection of its own bbox instead. Instances of one shared prototype
+// (ops/Instancing.h) then all ask BRepMesh for the same deflection: the first
+// stores its triangulation on the shared TFaces, every later instance finds them
+// already meshed, and a rotated instance (whose world AABB diagonal differs) can
+// never re-mesh the prototype to another density.
+void mesh_shape(const TopoDS_Shape& shape, const std::string& lod, bool prototype, double& lin,
+                double& ang) {
+    const TopoDS_Shape meshed = prototype ? shape.Located(TopLoc_Location()) : shape;
+    Bnd_Box box;
+    BRepBndLib::Add(meshed, box);
+    double diag = 1.0;
+    if (!box.IsVoid()) {
+        Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+        box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+        diag = gp_Pnt(xmin, ymin, zmin).Distance(gp_Pnt(xmax, ymax, zmax));
+    }
+    deflections(lod, diag, lin, ang);
+
+    BRepMesh_IncrementalMesh mesher(meshed, lin, Standard_False, ang, Standard_False);
+    mesher.Perform();
+}
+
 // TopoKey → minted ElementId lookup for one body (empty map when no partition).
 std::map<std::string, std::string> minted_ids(const elementmap::ElementMapPartition* partition,
                                               const std::string& body_id) {
@@ -150,27 +178,20 @@ std::map<std::string, std::string> minted_ids(const elementmap::ElementMapPartit
 BodyMesh tessellate_body(const TopoDS_Shape& shape, const std::string& body_id,
                          const std::string& lod, bool include_edges,
                          const elementmap::ElementMapPartition* partition,
-                         const std::vector<std::uint32_t>* face_colors) {
+                         const std::vector<std::uint32_t>* face_colors,
+                         bool instances) {
     BodyMesh out;
     out.body_id = body_id;
     if (shape.IsNull()) return out;
+    static stats::Histogram& timing = stats::histogram("tessellate.body");
+    static stats::Counter& triangles = stats::counter("tessellate.triangles");
+    const stats::ScopedTimer timer(timing);
+    const trace::Span span("tessellate", body_id);
 
     Bnd_Box box;
     BRepBndLib::Add(shape, box);
-    double diag = 1.0;
-    if (!box.IsVoid()) {
-        Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
-        box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
-        diag = gp_Pnt(xmin, ymin, zmin).Distance(gp_Pnt(xmax, ymax, zmax));
-        out.body_id = body_id;
-    }
     double lin = 0.1, ang = 0.5;
-    deflections(lod, diag, lin, ang);
-
-    // Mesh (single-threaded for determinism; the ids/ordinal are threading-
-    // independent regardless — Invariant 5).
-    BRepMesh_IncrementalMesh mesher(shape, lin, Standard_False, ang, Standard_False);
-    mesher.Perform();
+    mesh_shape(shape, lod, instances, lin, ang);
 
     const std::map<std::string, std::string> ids = minted_ids(partition, body_id);
     auto label = [&](char prefix, int index) {
@@ -312,6 +333,7 @@ BodyMesh tessellate_body(const TopoDS_Shape& shape, const std::string& body_id,
     }
 
     out.triangle_count = static_cast<std::uint32_t>(mi.indices.size() / 3);
+    triangles.add(out.triangle_count);
     out.blob = encode_mesh1(mi);
     out.ok = true;
     return out;
@@ -321,21 +343,9 @@ RawMesh tessellate_raw(const TopoDS_Shape& shape, const std::string& lod) {
     RawMesh out;
     if (shape.IsNull()) return out;
 
-    Bnd_Box box;
-    BRepBndLib::Add(shape, box);
-    double diag = 1.0;
-    if (!box.IsVoid()) {
-        Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
-        box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
-        diag = gp_Pnt(xmin, ymin, zmin).Distance(gp_Pnt(xmax, ymax, zmax));
-    }
+    // Same params as tessellate_body, so the produced triangle set is identical.
     double lin = 0.1, ang = 0.5;
-    deflections(lod, diag, lin, ang);
-
-    // Single-threaded meshing for determinism (Invariant 5). Same params as
-    // tessellate_body, so the produced triangle set is identical.
-    BRepMesh_IncrementalMesh mesher(shape, lin, Standard_False, ang, Standard_False);
-    mesher.Perform();
+    mesh_shape(shape, lod, /*prototype=*/false, lin, ang);
 
     TopTools_IndexedMapOfShape faces;
     TopExp::MapShapes(shape, TopAbs_FACE, faces);
@@ -391,4 +401,14 @@ RawMesh tessellate_raw(const TopoDS_Shape& shape, const std::string& lod) {
     return out;
 }
 
+bool instance_of(const TopoDS_Shape& instance, const TopoDS_Shape& prototype_body,
+                 gp_Trsf& trsf_out) {
+    if (instance.IsNull() || prototype_body.IsNull()) return false;
+    if (instance.TShape() != prototype_body.TShape()) return false;
+    if (instance.Orientation() != prototype_body.Orientation()) return false;
+    trsf_out = instance.Location().Transformation() *
+               prototype_body.Location().Transformation().Inverted();
+    return true;
+}
+
 }  // namespace onecad::tess
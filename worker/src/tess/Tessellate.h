@@ -11,6 +11,11 @@
 // angular cap); coarse remains suitable for transient interaction. Planar
 // prisms/booleans tessellate identically across tiers (2 triangles per rectangular
 // face), so the W-WP5 corpus meshes are byte-stable.
+//
+// Shared prototypes (ops/Instancing.h): with `instances` the deflection is derived
+// from a body's UN-LOCATED shape, so every instance of one prototype meshes it
+// ONCE — BRepMesh keeps the triangulation on the shared TFaces and later instances
+// reuse it. Without it a body is meshed as located, exactly as before.
 #pragma once
 
 #include <cstdint>
@@ -18,6 +23,7 @@
 #include <vector>
 
 #include <TopoDS_Shape.hxx>
+#include <gp_Trsf.hxx>
 
 #include "elementmap/ElementMapPartition.h"
 
@@ -51,13 +57,23 @@ struct RawMesh {
 // verbatim into the MESH1 FACE_COLORS section; a null pointer, an empty vector, or
 // a length that is not the face count leaves the section out and the flag bit clear
 // (mesh_format.md §2/§4), so a body without colors produces byte-identical output.
+//
+// `instances` (Tessellate {instances:true}, for a body that may ship as another's
+// instance) meshes the body's un-located prototype; see above.
 BodyMesh tessellate_body(const TopoDS_Shape& shape, const std::string& body_id,
                          const std::string& lod, bool include_edges,
                          const elementmap::ElementMapPartition* partition,
-                         const std::vector<std::uint32_t>* face_colors = nullptr);
+                         const std::vector<std::uint32_t>* face_colors = nullptr,
+                         bool instances = false);
 
 // Mesh one body into raw triangle arrays (no ids, no edges). `lod` selects the same
 // deflection tier as tessellate_body, so the triangles match the viewport mesh.
 RawMesh tessellate_raw(const TopoDS_Shape& shape, const std::string& lod);
 
+// True iff `instance` is `prototype_body`'s TShape (same orientation) under
+// another location. `trsf_out` then maps `prototype_body`'s world positions onto
+// `instance`'s — the per-instance transform `Tessellate {instances:true}` emits.
+bool instance_of(const TopoDS_Shape& instance, const TopoDS_Shape& prototype_body,
+                 gp_Trsf& trsf_out);
+
 }  // namespace onecad::tess
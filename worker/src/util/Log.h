@@ -18,6 +18,7 @@
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <utility>
 
 namespace onecad::log {
 
@@ -57,6 +58,20 @@ inline std::mutex& log_mutex() {
     return m;
 }
 
+// Per-process tag written after the level of every line ("" = none). Set once,
+// before the process starts any thread that logs: a zygote child (protocol/
+// Zygote.h) tags itself with its pid so that children sharing the zygote's stderr
+// stay distinguishable.
+inline std::string& line_tag_storage() {
+    static std::string tag;
+    return tag;
+}
+
+inline void set_line_tag(std::string tag) {
+    std::lock_guard<std::mutex> guard(log_mutex());
+    line_tag_storage() = std::move(tag);
+}
+
 // Millisecond-precision UTC-ish local timestamp: "YYYY-MM-DD HH:MM:SS.mmm".
 inline void write_timestamp(char* buf, size_t n) {
     using namespace std::chrono;
@@ -88,6 +103,7 @@ __attribute__((format(printf, 2, 3))) inline void emit(Level lvl, const char* fm
     char ts[32];
     write_timestamp(ts, sizeof(ts));
     std::fprintf(stderr, "[%s] %-5s ", ts, level_name(lvl).data());
+    if (!line_tag_storage().empty()) std::fprintf(stderr, "[%s] ", line_tag_storage().c_str());
     std::va_list ap;
     va_start(ap, fmt);
     std::vfprintf(stderr, fmt, ap);
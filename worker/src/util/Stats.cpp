@@ -0,0 +1,204 @@
+// Stats.cpp — see Stats.h.
+#include "util/Stats.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace onecad::stats {
+
+namespace {
+
+struct Registry {
+    std::mutex mu;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+thread_local PhaseTotals* t_phase_totals = nullptr;
+thread_local PhaseTimer* t_open_phase = nullptr;
+
+int msb_of(std::uint64_t v) noexcept {
+    int msb = 0;
+    while (v >>= 1) ++msb;
+    return msb;
+}
+
+}  // namespace
+
+int Histogram::bucket_of(std::uint64_t micros) noexcept {
+    if (micros < static_cast<std::uint64_t>(kSubBuckets)) return static_cast<int>(micros);
+    const int msb = msb_of(micros);
+    const int shift = msb - kSubBits;
+    const int sub = static_cast<int>((micros >> shift) & (kSubBuckets - 1));
+    return (shift + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t Histogram::bucket_upper(int bucket) noexcept {
+    if (bucket < kSubBuckets) return static_cast<std::uint64_t>(bucket);
+    const int shift = bucket / kSubBuckets - 1;
+    const std::uint64_t lower =
+        static_cast<std::uint64_t>(kSubBuckets + bucket % kSubBuckets) << shift;
+    return lower + ((std::uint64_t{1} << shift) - 1);
+}
+
+void Histogram::record(std::uint64_t micros) noexcept {
+    buckets_[static_cast<std::size_t>(bucket_of(micros))].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(micros, std::memory_order_relaxed);
+    std::uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (micros > seen &&
+           !max_.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t Histogram::quantile(double q) const noexcept {
+    std::uint64_t total = 0;
+    for (const auto& b : buckets_) total += b.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+    // Rank of the q-quantile, 1-based: the smallest value with >= q of the samples.
+    auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total) + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += buckets_[static_cast<std::size_t>(i)].load(std::memory_order_relaxed);
+        if (seen >= rank) return std::min(bucket_upper(i), max());
+    }
+    return max();
+}
+
+nlohmann::json Histogram::to_json() const {
+    const std::uint64_t n = count();
+    return nlohmann::json{
+        {"count", n},
+        {"meanUs", n == 0 ? 0 : sum() / n},
+        {"p50Us", quantile(0.50)},
+        {"p95Us", quantile(0.95)},
+        {"p99Us", quantile(0.99)},
+        {"maxUs", max()},
+    };
+}
+
+Histogram& histogram(const std::string& name) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);
+    std::unique_ptr<Histogram>& slot = r.histograms[name];
+    if (!slot) slot = std::make_unique<Histogram>();
+    return *slot;
+}
+
+Counter& counter(const std::string& name) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);
+    std::unique_ptr<Counter>& slot = r.counters[name];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+nlohmann::json snapshot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);
+    nlohmann::json timings = nlohmann::json::object();
+    for (const auto& [name, h] : r.histograms) timings[name] = h->to_json();
+    nlohmann::json counters = nlohmann::json::object();
+    for (const auto& [name, c] : r.counters) counters[name] = c->value();
+    return nlohmann::json{{"timings", std::move(timings)}, {"counters", std::move(counters)}};
+}
+
+std::uint64_t peak_rss_bytes() {
+    rusage usage{};
+    if (::getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<std::uint64_t>(usage.ru_maxrss);  // bytes on macOS
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;  // KiB on Linux
+#endif
+}
+
+std::optional<std::uint64_t> current_rss_bytes() {
+#if defined(__APPLE__)
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return std::nullopt;
+    }
+    return static_cast<std::uint64_t>(info.resident_size);
+#elif defined(__linux__)
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (f == nullptr) return std::nullopt;
+    unsigned long long size_pages = 0;
+    unsigned long long resident_pages = 0;
+    const int read = std::fscanf(f, "%llu %llu", &size_pages, &resident_pages);
+    std::fclose(f);
+    if (read != 2) return std::nullopt;
+    return static_cast<std::uint64_t>(resident_pages) *
+           static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+#else
+    return std::nullopt;
+#endif
+}
+
+std::optional<std::uint64_t> allocated_bytes() {
+#if defined(__APPLE__)
+    malloc_statistics_t st{};
+    malloc_zone_statistics(nullptr, &st);  // null zone ⇒ all zones
+    return static_cast<std::uint64_t>(st.size_in_use);
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 mi = ::mallinfo2();
+    return static_cast<std::uint64_t>(mi.uordblks + mi.hblkhd);
+#else
+    return std::nullopt;
+#endif
+}
+
+PhaseScope::PhaseScope(PhaseTotals& totals)
+    : outer_totals_(t_phase_totals), outer_open_(t_open_phase) {
+    t_phase_totals = &totals;
+    t_open_phase = nullptr;
+}
+
+PhaseScope::~PhaseScope() {
+    t_phase_totals = outer_totals_;
+    t_open_phase = outer_open_;
+}
+
+PhaseTimer::PhaseTimer(Phase phase) : phase_(phase) {
+    if (t_phase_totals == nullptr) return;
+    totals_ = t_phase_totals;
+    parent_ = t_open_phase;
+    t_open_phase = this;
+    started_ = std::chrono::steady_clock::now();
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (totals_ == nullptr) return;
+    const auto elapsed = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                              started_)
+            .count());
+    totals_->micros[static_cast<std::size_t>(phase_)] +=
+        elapsed > child_us_ ? elapsed - child_us_ : 0;
+    if (parent_ != nullptr) parent_->child_us_ += elapsed;
+    t_open_phase = parent_;
+}
+
+}  // namespace onecad::stats
@@ -0,0 +1,146 @@
+// Stats.h — process-wide runtime counters and latency histograms (GetWorkerStats).
+//
+// Everything here is written from the kernel and solver lanes while GetWorkerStats
+// reads it from either, so the hot path is lock-free: a Histogram is a fixed array
+// of relaxed atomics, a Counter one atomic. Only the name → instance REGISTRY takes
+// a mutex, once per call site — callers keep the returned reference in a
+// function-local static:
+//
+//     static stats::Histogram& h = stats::histogram("boolean");
+//     stats::ScopedTimer timer(h);
+//
+// Instances are never destroyed or moved, so a cached reference stays valid for
+// the process's life. A snapshot is not an atomic cut across instances (a reader
+// may see a count without its matching bucket yet); it is a monitoring view.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "nlohmann/json.hpp"
+
+namespace onecad::stats {
+
+// HDR-style log-linear histogram over microseconds. Values below 16 us are exact;
+// above, each power of two is split into 16 sub-buckets, so a reported quantile
+// is within 1/16 (6.25%) of the true value. Covers the whole u64 range.
+class Histogram {
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    void record(std::uint64_t micros) noexcept;
+
+    std::uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+    std::uint64_t max() const noexcept { return max_.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the q-quantile (0 < q <= 1), capped at the
+    // recorded max. 0 when empty.
+    std::uint64_t quantile(double q) const noexcept;
+
+    // {count, meanUs, p50Us, p95Us, p99Us, maxUs}.
+    nlohmann::json to_json() const;
+
+    static int bucket_of(std::uint64_t micros) noexcept;
+    static std::uint64_t bucket_upper(int bucket) noexcept;
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+class Counter {
+public:
+    void add(std::uint64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+// Records the scope's wall time into `h` on destruction.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& h) : h_(h), started_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        h_.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started_)
+                .count()));
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram& h_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+// The process-wide named instances (created on first use). Names are dotted,
+// subsystem first: "tessellate.body", "audit.tierB", "solver.failed".
+Histogram& histogram(const std::string& name);
+Counter& counter(const std::string& name);
+
+// {"timings": {name: Histogram::to_json}, "counters": {name: value}}.
+nlohmann::json snapshot();
+
+// Peak resident set size of this process in bytes (0 when unavailable).
+std::uint64_t peak_rss_bytes();
+
+// Current resident set size, and bytes currently allocated through malloc (which
+// OCCT's default memory manager sits on). nullopt where the platform has no
+// cheap source.
+std::optional<std::uint64_t> current_rss_bytes();
+std::optional<std::uint64_t> allocated_bytes();
+
+// ── Phase accounting for ONE unit of work (ExecutePlan `stepTimings`) ─────────
+// A PhaseScope collects, on its thread, the time of every PhaseTimer opened while
+// it is live. Times are EXCLUSIVE: a timer nested in another (an audit inside an
+// op build) is subtracted from its parent, so the phases of a scope add up to at
+// most its wall time. With no scope open a PhaseTimer reads no clock.
+enum class Phase : std::size_t { Ladder, Build, Audit, History, Signature, Count };
+
+class PhaseTimer;
+
+struct PhaseTotals {
+    std::array<std::uint64_t, static_cast<std::size_t>(Phase::Count)> micros{};
+    std::uint64_t of(Phase p) const { return micros[static_cast<std::size_t>(p)]; }
+};
+
+class PhaseScope {
+public:
+    explicit PhaseScope(PhaseTotals& totals);
+    ~PhaseScope();
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+private:
+    PhaseTotals* outer_totals_;
+    PhaseTimer* outer_open_;
+};
+
+class PhaseTimer {
+public:
+    explicit PhaseTimer(Phase phase);
+    ~PhaseTimer();
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    Phase phase_;
+    PhaseTotals* totals_ = nullptr;  // null ⇒ inert
+    PhaseTimer* parent_ = nullptr;
+    std::uint64_t child_us_ = 0;
+    std::chrono::steady_clock::time_point started_{};
+};
+
+}  // namespace onecad::stats
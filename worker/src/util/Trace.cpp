@@ -0,0 +1,176 @@
+// Trace.cpp — see Trace.h.
+#include "util/Trace.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+namespace onecad::trace {
+
+namespace {
+
+// The detail travels as whole words so that every payload field is an atomic.
+constexpr std::size_t kDetailWords = (kDetailBytes + 1 + 7) / 8;
+
+// One slot of a seqlock ring. The payload is read while its owner may be
+// rewriting it, so it is made of relaxed atomics: a torn read is then merely
+// stale (and rejected by the sequence check), never a data race.
+struct Event {
+    std::atomic<std::uint32_t> seq{0};  // odd while being written
+    std::atomic<const char*> name{nullptr};
+    std::atomic<std::int64_t> begin_us{0};
+    std::atomic<std::int64_t> dur_us{0};
+    std::array<std::atomic<std::uint64_t>, kDetailWords> detail{};
+};
+
+struct ThreadRing {
+    int tid = 0;
+    char thread_name[32] = {};
+    std::atomic<std::uint64_t> written{0};  // events ever recorded (monotonic)
+    std::array<Event, kRingEvents> events;
+};
+
+struct Registry {
+    std::mutex mu;
+    std::vector<std::unique_ptr<ThreadRing>> rings;  // never freed: dumps outlive threads
+    Clock::time_point epoch = Clock::now();
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+thread_local ThreadRing* t_ring = nullptr;
+thread_local const char* t_pending_name = nullptr;
+
+ThreadRing& ring() {
+    if (t_ring == nullptr) {
+        auto fresh = std::make_unique<ThreadRing>();
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.mu);
+        fresh->tid = static_cast<int>(r.rings.size()) + 1;
+        if (t_pending_name != nullptr) {
+            std::strncpy(fresh->thread_name, t_pending_name, sizeof(fresh->thread_name) - 1);
+        }
+        t_ring = fresh.get();
+        r.rings.push_back(std::move(fresh));
+    }
+    return *t_ring;
+}
+
+std::int64_t micros_since_epoch(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(t - registry().epoch).count();
+}
+
+}  // namespace
+
+void enable() {
+    registry();  // pin the epoch before the first span
+    enabled_storage().store(true, std::memory_order_relaxed);
+}
+
+void disable() { enabled_storage().store(false, std::memory_order_relaxed); }
+
+void set_thread_name(const char* name) {
+    // The ring is allocated lazily, so a thread that never records costs nothing.
+    t_pending_name = name;
+    if (t_ring != nullptr) {
+        // Under the registry lock: a dump reads the name concurrently.
+        std::lock_guard<std::mutex> lk(registry().mu);
+        std::strncpy(t_ring->thread_name, name, sizeof(t_ring->thread_name) - 1);
+    }
+}
+
+void record(const char* name, std::string_view detail, Clock::time_point begin,
+            Clock::time_point end) {
+    if (!enabled()) return;
+    ThreadRing& r = ring();
+    const std::uint64_t n = r.written.load(std::memory_order_relaxed);
+    Event& e = r.events[n % kRingEvents];
+    const std::uint32_t seq = e.seq.load(std::memory_order_relaxed);
+    e.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    e.name.store(name, std::memory_order_relaxed);
+    e.begin_us.store(micros_since_epoch(begin), std::memory_order_relaxed);
+    e.dur_us.store(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count(),
+                   std::memory_order_relaxed);
+    std::uint64_t words[kDetailWords] = {};
+    std::memcpy(words, detail.data(), std::min(detail.size(), kDetailBytes));
+    for (std::size_t w = 0; w < kDetailWords; ++w) {
+        e.detail[w].store(words[w], std::memory_order_relaxed);
+    }
+    e.seq.store(seq + 2, std::memory_order_release);
+    r.written.store(n + 1, std::memory_order_release);
+}
+
+long write_chrome_trace(const std::string& path, std::string& error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "cannot open " + path;
+        return -1;
+    }
+    const int pid = static_cast<int>(::getpid());
+    long spans = 0;
+    bool first = true;
+    const auto emit = [&](const nlohmann::json& ev) {
+        // `replace`: a detail truncated mid-codepoint must not abort the dump.
+        out << (first ? "\n" : ",\n")
+            << ev.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);  // the ring list only; writers never take it
+    for (const std::unique_ptr<ThreadRing>& ring_ptr : r.rings) {
+        const ThreadRing& ring = *ring_ptr;
+        if (ring.thread_name[0] != '\0') {
+            emit({{"name", "thread_name"}, {"ph", "M"}, {"pid", pid}, {"tid", ring.tid},
+                  {"args", {{"name", ring.thread_name}}}});
+        }
+        const std::uint64_t written = ring.written.load(std::memory_order_acquire);
+        const std::uint64_t first_kept = written > kRingEvents ? written - kRingEvents : 0;
+        for (std::uint64_t i = first_kept; i < written; ++i) {
+            const Event& e = ring.events[i % kRingEvents];
+            const std::uint32_t before = e.seq.load(std::memory_order_acquire);
+            if (before & 1u) continue;
+            const char* name = e.name.load(std::memory_order_relaxed);
+            const std::int64_t begin_us = e.begin_us.load(std::memory_order_relaxed);
+            const std::int64_t dur_us = e.dur_us.load(std::memory_order_relaxed);
+            std::uint64_t words[kDetailWords];
+            for (std::size_t w = 0; w < kDetailWords; ++w) {
+                words[w] = e.detail[w].load(std::memory_order_relaxed);
+            }
+            char detail[kDetailBytes + 1];
+            std::memcpy(detail, words, sizeof(detail));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (e.seq.load(std::memory_order_relaxed) != before || name == nullptr) continue;
+            detail[kDetailBytes] = '\0';
+            nlohmann::json ev = {{"name", name}, {"cat", "worker"}, {"ph", "X"},
+                                 {"ts", begin_us}, {"dur", dur_us}, {"pid", pid},
+                                 {"tid", ring.tid}};
+            if (detail[0] != '\0') ev["args"] = {{"detail", detail}};
+            emit(ev);
+            ++spans;
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    if (!out) {
+        error = "write failed: " + path;
+        return -1;
+    }
+    return spans;
+}
+
+}  // namespace onecad::trace
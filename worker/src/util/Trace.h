@@ -0,0 +1,82 @@
+// Trace.h — opt-in span tracing of worker activity, dumped as Chrome trace-event
+// JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Off by default. Turned on by ONECAD_WORKER_TRACE=<file> (from startup; the file
+// is written when the worker exits) or at runtime by `OpenSession{trace:true}`,
+// and dumped on demand by the `DumpTrace` verb (SCHEMA §7.1). The switch is
+// process-wide, not per session: once on, every session's spans are recorded
+// until the worker exits. While off, a Span costs one relaxed atomic load.
+//
+// Each thread records into its OWN fixed ring (kRingEvents; the oldest events are
+// overwritten), so recording takes no lock. A dump may run concurrently with the
+// writers: every slot carries a sequence number (seqlock) over a payload of
+// relaxed atomics, and a slot being rewritten while it is copied is skipped
+// rather than emitted torn.
+//
+// Span names are static strings (`"boolean"`, `"plan.step"`); the per-span detail
+// (a verb, an op id) is copied into a short inline buffer and truncated.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace onecad::trace {
+
+using Clock = std::chrono::steady_clock;
+
+inline constexpr std::size_t kRingEvents = 1u << 15;  // per thread
+inline constexpr std::size_t kDetailBytes = 47;
+
+inline std::atomic<bool>& enabled_storage() {
+    static std::atomic<bool> on{false};
+    return on;
+}
+
+inline bool enabled() noexcept { return enabled_storage().load(std::memory_order_relaxed); }
+void enable();
+void disable();
+
+// Name the calling thread in the trace ("reader", "kernel", "solver").
+void set_thread_name(const char* name);
+
+// Record one complete span on the calling thread. `name` must outlive the process
+// (a string literal). No-op while tracing is off.
+void record(const char* name, std::string_view detail, Clock::time_point begin,
+            Clock::time_point end);
+
+// Records its own lifetime as a span. Inert when tracing was off at construction.
+// The detail is copied (truncated) at construction, so a temporary is fine.
+class Span {
+public:
+    explicit Span(const char* name, std::string_view detail = {}) {
+        if (!enabled()) return;
+        name_ = name;
+        detail_len_ = std::min(detail.size(), kDetailBytes);
+        std::memcpy(detail_, detail.data(), detail_len_);
+        begin_ = Clock::now();
+    }
+    ~Span() {
+        if (name_ != nullptr) {
+            record(name_, std::string_view(detail_, detail_len_), begin_, Clock::now());
+        }
+    }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name_ = nullptr;
+    char detail_[kDetailBytes];
+    std::size_t detail_len_ = 0;
+    Clock::time_point begin_{};
+};
+
+// Write every retained event of every thread as Chrome trace-event JSON to `path`.
+// Returns the number of span events written, or -1 with `error` set.
+long write_chrome_trace(const std::string& path, std::string& error);
+
+}  // namespace onecad::trace
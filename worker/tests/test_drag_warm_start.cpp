@@ -0,0 +1,197 @@
+// Drag warm start — `SolverLane::predict_seed` and the adaptive substepping in
+// `ConstraintSolver::runDragSubsteps`.
+//
+// A SolveDrag step used to start from the pose last reported and, past a fixed
+// 100 mm jump, split into up to ten full solves. A gesture now keeps its last two
+// converged steps and starts the next one from the pose extrapolated along the
+// drag, and a jump is substepped only when one solve fails or lands far from the
+// prediction.
+//
+// Pins:
+//   1. a seeded flick on a linkage solves to the SAME pose (within tolerance),
+//      step by step, as the pre-warm-start path: unseeded, split into one
+//      substep per 100 mm of travel (up to ten), from the last pose;
+//   2. every flick step, the 160 mm ones included, is a single solve, and the
+//      seeded gesture spends no more PlaneGCS iterations than the old path;
+//   3. SolveDrag reports `iterations` and `substeps`.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "protocol/SolverLane.h"
+#include "session/SketchStore.h"
+#include "sketch/Sketch.h"
+#include "sketch/SketchPoint.h"
+#include "sketch/WireSketch.h"
+
+using nlohmann::json;
+namespace sk = onecad::core::sketch;
+using onecad::protocol::Envelope;
+
+namespace {
+int g_failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message.c_str());
+        ++g_failures;
+    }
+}
+
+json point_entity(const char* id, double x, double y) {
+    return {{"id", id}, {"type", "Point"}, {"at", {x, y}}};
+}
+
+json line_ref(const char* id, const char* p0, const char* p1) {
+    return {{"id", id}, {"type", "Line"}, {"p0Ref", p0}, {"p1Ref", p1}};
+}
+
+// A rigid L pivoting on a fixed point: o—a is 60 long, a—b 40 and square to it.
+// Its one DOF is the rotation about o, so a body drag of the short leg can only
+// swing it, and where it swings to is the pose nearest the cursor's targets.
+json swing_arm() {
+    return {{"sketchId", "arm"},
+            {"plane", {{"kind", "XY"}}},
+            {"entities", json::array({point_entity("o", 0, 0), point_entity("a", 60, 0),
+                                      point_entity("b", 60, 40), line_ref("l1", "o", "a"),
+                                      line_ref("l2", "a", "b")})},
+            {"constraints",
+             json::array({{{"id", "fix"}, {"type", "Fixed"}, {"entities", {"o"}}},
+                          {{"id", "d1"}, {"type", "Distance"}, {"entities", {"l1"}},
+                           {"value", 60.0}},
+                          {{"id", "d2"}, {"type", "Distance"}, {"entities", {"l2"}},
+                           {"value", 40.0}},
+                          {{"id", "sq"}, {"type", "Perpendicular"},
+                           {"entities", {"l1", "l2"}}}})}};
+}
+
+// The drag path before warm start, spelled out: the jump split into
+// ceil(d / 100 mm) substeps (at most ten), each an unseeded solve toward its
+// share of the targets. Every substep here moves at most 100 mm, which the solver
+// takes as one unseeded solve, so this does not go through the seeded ladder.
+sk::SolveResult fixed_substep_drag(sk::Sketch& sketch,
+                                   const std::unordered_map<sk::EntityID, sk::Vec2d>& targets) {
+    std::unordered_map<sk::EntityID, sk::Vec2d> from;
+    double jump = 0.0;
+    for (const auto& [id, to] : targets) {
+        const auto* p = sketch.getEntityAs<sk::SketchPoint>(id);
+        if (!p) continue;
+        from[id] = sk::Vec2d{p->position().X(), p->position().Y()};
+        jump = std::max(jump, std::hypot(to.x - p->position().X(), to.y - p->position().Y()));
+    }
+    const int substeps =
+        jump <= 100.0 ? 1 : std::min(10, static_cast<int>(std::ceil(jump / 100.0)));
+    sk::SolveResult total;
+    for (int k = 1; k <= substeps; ++k) {
+        const double t = static_cast<double>(k) / substeps;
+        std::unordered_map<sk::EntityID, sk::Vec2d> step;
+        for (const auto& [id, to] : targets) {
+            const sk::Vec2d& f = from.at(id);
+            step[id] = sk::Vec2d{f.x + ((to.x - f.x) * t), f.y + ((to.y - f.y) * t)};
+        }
+        const sk::SolveResult r = sketch.solveWithTargets(step, {}, {});
+        total.success = r.success;
+        total.errorMessage = r.errorMessage;
+        total.iterations += r.iterations;
+        total.substeps += r.substeps;
+        if (!r.success) break;
+    }
+    return total;
+}
+
+// ── 1–3. A flick, seeded on the lane and on the old path on a bare Sketch ────
+void test_seeded_flick_matches_the_old_path() {
+    onecad::session::SketchStore store;
+    onecad::protocol::Dispatcher dispatcher;
+    onecad::protocol::SolverLane lane(store);
+    lane.register_verbs(dispatcher);
+    std::uint64_t next_id = 1;
+    const auto call = [&](const char* verb, json args) {
+        return dispatcher.dispatch_once(Envelope::request(next_id++, verb, std::move(args)));
+    };
+
+    Envelope up = call("SketchUpsert", swing_arm());
+    check(up.ok.value_or(false), "the arm upserts");
+    const std::uint64_t rev = up.result.value("sketchRevision", std::uint64_t{0});
+    Envelope b = call("BeginGesture",
+                      {{"sketchId", "arm"}, {"sketchRevision", rev}, {"gestureId", 1},
+                       {"drag", {{"kind", "entityBody"}, {"entity", "l2"}, {"grab", {60, 20}}}}});
+    check(b.ok.value_or(false), "the body drag of the short leg begins");
+
+    onecad::wire::TranslateResult reference = onecad::wire::translate(swing_arm());
+    check(reference.ok, "the reference arm translates: " + reference.error);
+    if (!reference.ok) return;
+    reference.sketch->solve();
+    const sk::EntityID a = reference.index.resolve_point("a", "");
+    const sk::EntityID bp = reference.index.resolve_point("b", "");
+    const sk::Vec2d a0{60, 0};
+    const sk::Vec2d b0{60, 40};
+
+    // An accelerating swipe up and to the left: the last frames jump 160 mm,
+    // past the old fixed substep threshold.
+    const double steps[] = {2, 4, 8, 16, 32, 64, 128, 160, 160};
+    double gx = 0.0;
+    double gy = 0.0;
+    int seeded_iterations = 0;
+    int old_iterations = 0;
+    double lane_a[2] = {a0.x, a0.y};
+    double lane_b[2] = {b0.x, b0.y};
+    std::uint64_t seq = 0;
+    for (double step : steps) {
+        gx -= step * 0.6;
+        gy += step * 0.8;
+        Envelope d = call("SolveDrag", {{"gestureId", 1},
+                                        {"seq", ++seq},
+                                        {"target", json::array({60 + gx, 20 + gy})}});
+        const std::string at = " (step " + std::to_string(seq) + ")";
+        check(d.ok.value_or(false) && d.result.value("status", std::string{}) == "success",
+              "the seeded step succeeds" + at);
+        check(d.result.contains("iterations") && d.result.contains("substeps"),
+              "SolveDrag reports iterations and substeps" + at);
+        check(d.result.value("substeps", 0) == 1, "the step is one solve" + at);
+        seeded_iterations += d.result.value("iterations", 0);
+        const json& pos = d.result["positions"];
+        if (pos.contains("a")) {
+            lane_a[0] = pos["a"][0].get<double>();
+            lane_a[1] = pos["a"][1].get<double>();
+        }
+        if (pos.contains("b")) {
+            lane_b[0] = pos["b"][0].get<double>();
+            lane_b[1] = pos["b"][1].get<double>();
+        }
+
+        const sk::SolveResult r = fixed_substep_drag(
+            *reference.sketch,
+            {{a, sk::Vec2d{a0.x + gx, a0.y + gy}}, {bp, sk::Vec2d{b0.x + gx, b0.y + gy}}});
+        check(r.success, "the old-path step succeeds" + at + ": " + r.errorMessage);
+        old_iterations += r.iterations;
+        const auto* ca = reference.sketch->getEntityAs<sk::SketchPoint>(a);
+        const auto* cb = reference.sketch->getEntityAs<sk::SketchPoint>(bp);
+        const double tol = sk::constants::SOLVER_TOLERANCE;
+        check(ca && cb && std::abs(ca->position().X() - lane_a[0]) < tol &&
+                  std::abs(ca->position().Y() - lane_a[1]) < tol &&
+                  std::abs(cb->position().X() - lane_b[0]) < tol &&
+                  std::abs(cb->position().Y() - lane_b[1]) < tol,
+              "the seeded pose is the old path's pose" + at);
+    }
+    std::fprintf(stderr, "  flick: %d iterations seeded, %d on the old path\n",
+                 seeded_iterations, old_iterations);
+    check(seeded_iterations <= old_iterations,
+          "the seeded flick spends no more iterations than the old path");
+
+    check(call("EndGesture", {{"gestureId", 1}}).ok.value_or(false), "the gesture ends");
+}
+}  // namespace
+
+int main() {
+    test_seeded_flick_matches_the_old_path();
+    if (g_failures == 0) std::fprintf(stderr, "test_drag_warm_start: OK\n");
+    return g_failures;
+}
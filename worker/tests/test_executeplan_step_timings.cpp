@@ -0,0 +1,205 @@
+// test_executeplan_step_timings.cpp — ExecutePlan `stepTimings` (SCHEMA §7.2)
+// end to end against the real worker binary.
+//
+// One plan — sketch → extrude NewBody → a forced failure (the `__fail` op hook)
+// — with `artifacts.tessellate`, run in a fresh worker per flag value. Pins:
+//   1. `stepTimings: true`: every planStep payload carries `timings` with the
+//      ladder/build/audit/history/signature/total keys, every perStepResults row
+//      does too (the failed step included — it emits no planStep, so that row is
+//      its only channel), and the tessellate artifact carries `meshAttachUs`;
+//   2. flag absent, or malformed (not a boolean): no `timings` and no
+//      `meshAttachUs` anywhere — the response is the pre-`stepTimings` shape.
+//
+// No test framework: exit code == failure count. Usage: <worker-path>.
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Envelope.h"
+#include "protocol/Frame.h"
+
+using nlohmann::json;
+using onecad::protocol::Envelope;
+using onecad::protocol::Frame;
+using onecad::protocol::ReadStatus;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) { std::fprintf(stderr, "FAIL: %s\n", msg.c_str()); ++g_failures; }
+}
+
+constexpr const char* kEmpty =
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+struct Worker { pid_t pid = -1; int to = -1, from = -1; };
+
+bool spawn(const std::string& path, Worker& w) {
+    int p2c[2], c2p[2];
+    if (pipe(p2c) != 0 || pipe(c2p) != 0) return false;
+    const pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        dup2(p2c[0], STDIN_FILENO);
+        dup2(c2p[1], STDOUT_FILENO);
+        close(p2c[0]); close(p2c[1]); close(c2p[0]); close(c2p[1]);
+        char* const argv[] = {const_cast<char*>(path.c_str()), nullptr};
+        execv(path.c_str(), argv);
+        _exit(127);
+    }
+    close(p2c[0]); close(c2p[1]);
+    w.pid = pid; w.to = p2c[1]; w.from = c2p[0];
+    return true;
+}
+
+void send(const Worker& w, const Envelope& env) {
+    Frame f;
+    f.json = onecad::protocol::serialize(env);
+    onecad::protocol::write_frame(w.to, f);
+}
+
+bool recv(const Worker& w, json& out) {
+    auto rr = onecad::protocol::read_frame(w.from);
+    if (rr.status != ReadStatus::Ok) return false;
+    out = json::parse(rr.frame.json);
+    return true;
+}
+
+// `step_timings` is copied into the args verbatim; null leaves the key out.
+json plan(const json& step_timings) {
+    json args = {
+        {"jobId", 88}, {"documentRevision", 0}, {"workerEpoch", 3},
+        {"expectedBaseHash", kEmpty},
+        {"prefixHashes", json::array({"t0", "t1", "t2"})},
+        {"targetStep", 2},
+        {"artifacts", {{"tessellate", {{"lod", "coarse"}, {"includeEdges", true}}}}},
+        {"ops",
+         json::array(
+             {json{{"opType", "Sketch"}, {"opId", "op0"}, {"stepIndex", 0},
+                   {"params",
+                    {{"sketchId", "sk1"}, {"plane", {{"kind", "XY"}}},
+                     {"entities",
+                      json::array(
+                          {json{{"id", "e1"}, {"type", "Line"}, {"p0", {0, 0}}, {"p1", {40, 0}}},
+                           json{{"id", "e2"}, {"type", "Line"}, {"p0", {40, 0}}, {"p1", {40, 20}}},
+                           json{{"id", "e3"}, {"type", "Line"}, {"p0", {40, 20}}, {"p1", {0, 20}}},
+                           json{{"id", "e4"}, {"type", "Line"}, {"p0", {0, 20}}, {"p1", {0, 0}}}})},
+                     {"constraints", json::array()}}}},
+              json{{"opType", "Extrude"}, {"opId", "op1"}, {"stepIndex", 1},
+                   {"inputs", json::array({json{{"primary", {{"bodyId", ""},
+                                                             {"elementId", "sk1.region.r0"},
+                                                             {"kind", "face"}}}}})},
+                   {"params", {{"sketchId", "sk1"}, {"distance", 25.0},
+                               {"extrudeMode", "Blind"}, {"booleanMode", "NewBody"}}}},
+              json{{"opType", "Extrude"}, {"opId", "op2__fail"}, {"stepIndex", 2},
+                   {"params", {{"sketchId", "sk1"}, {"distance", 10.0},
+                               {"extrudeMode", "Blind"}, {"booleanMode", "NewBody"}}}}})}};
+    if (!step_timings.is_null()) args["stepTimings"] = step_timings;
+    return args;
+}
+
+struct PlanRun {
+    std::vector<json> step_payloads;  // planStep event payloads, in order
+    json result;                      // the terminal resp's result
+};
+
+PlanRun run(const std::string& worker_path, const json& the_plan) {
+    PlanRun out;
+    Worker w;
+    if (!spawn(worker_path, w)) return out;
+    json resp;
+    if (recv(w, resp)) {  // hello
+        send(w, Envelope::request(1, "OpenSession",
+                                  json{{"documentId", "doc_1"}, {"documentRevision", 0},
+                                       {"workerEpoch", 3}}));
+        recv(w, resp);
+        send(w, Envelope::request(2, "ExecutePlan", the_plan));
+        while (recv(w, resp)) {
+            const std::string t = resp.value("t", std::string{});
+            if (t == "event" && resp.value("event", std::string{}) == "planStep") {
+                out.step_payloads.push_back(resp["payload"]);
+            } else if (t == "resp" && resp.value("id", 0) == 2) {
+                check(resp.value("ok", false), "the plan is prepared");
+                if (resp.contains("result")) out.result = resp["result"];
+                break;
+            }
+        }
+        send(w, Envelope::request(9, "Shutdown", json::object()));
+        recv(w, resp);
+    }
+    close(w.to);
+    int status = 0;
+    waitpid(w.pid, &status, 0);
+    close(w.from);
+    return out;
+}
+
+bool has_timing_keys(const json& container) {
+    if (!container.is_object() || !container.contains("timings")) return false;
+    const json& t = container["timings"];
+    for (const char* key :
+         {"ladderUs", "buildUs", "auditUs", "historyUs", "signatureUs", "totalUs"}) {
+        if (!t.contains(key) || !t[key].is_number_integer()) return false;
+    }
+    return true;
+}
+
+// ── 1. stepTimings: true ─────────────────────────────────────────────────────
+void test_timings_reported(const std::string& worker) {
+    const PlanRun r = run(worker, plan(true));
+    check(r.step_payloads.size() == 2, "the sketch and the extrude emit planSteps");
+    for (const json& payload : r.step_payloads) {
+        check(has_timing_keys(payload),
+              "planStep " + std::to_string(payload.value("stepIndex", -1)) +
+                  " carries every timing key");
+    }
+    check(r.result.value("stoppedReason", std::string{}) == "opFailed",
+          "the plan stops at the forced failure");
+    const json rows = r.result.value("perStepResults", json::array());
+    check(rows.size() == 3, "one perStepResults row per executed step");
+    for (const json& row : rows) {
+        check(has_timing_keys(row), "perStepResults row " +
+                                        std::to_string(row.value("stepIndex", -1)) +
+                                        " carries every timing key");
+    }
+    check(!rows.empty() && rows.back().value("status", std::string{}) == "opFailed" &&
+              has_timing_keys(rows.back()),
+          "the failed step's row carries its timings");
+    check(r.result.contains("artifacts") &&
+              r.result["artifacts"]["tessellate"].contains("meshAttachUs") &&
+              r.result["artifacts"]["tessellate"]["meshAttachUs"].is_number_integer(),
+          "the tessellate artifact carries meshAttachUs");
+}
+
+// ── 2. Flag absent or malformed ──────────────────────────────────────────────
+void test_timings_absent(const std::string& worker, const json& flag, const std::string& label) {
+    const PlanRun r = run(worker, plan(flag));
+    check(r.step_payloads.size() == 2, label + ": the sketch and the extrude emit planSteps");
+    for (const json& payload : r.step_payloads) {
+        check(!payload.contains("timings"), label + ": no planStep timings");
+    }
+    for (const json& row : r.result.value("perStepResults", json::array())) {
+        check(!row.contains("timings"), label + ": no perStepResults timings");
+    }
+    check(r.result.contains("artifacts") && r.result["artifacts"].contains("tessellate") &&
+              !r.result["artifacts"]["tessellate"].contains("meshAttachUs"),
+          label + ": the tessellate artifact has no meshAttachUs");
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <worker-path>\n", argv[0]);
+        return 2;
+    }
+    test_timings_reported(argv[1]);
+    test_timings_absent(argv[1], json(), "absent");
+    test_timings_absent(argv[1], "yes", "malformed");
+    test_timings_absent(argv[1], false, "false");
+    if (g_failures == 0) std::fprintf(stderr, "executeplan step timings: OK\n");
+    return g_failures;
+}
@@ -0,0 +1,193 @@
+// test_generator_cache.cpp — the process-wide generated-solid cache behind
+// PlaceComponent/DetachComponent generator sources and Gear
+// (ops/GeneratorCache.h). In-process, real OCCT.
+//
+// Pins:
+//   1. a repeated component placement is ONE generator run and publishes a
+//      bit-identical, independent (deep-copied) solid;
+//   2. any source.params change is a miss;
+//   3. a repeated Gear is a hit with a bit-identical volume, and the published
+//      bodies never share the cached TShape;
+//   4. a preview (TierA) entry is re-audited once for an authoritative publish
+//      and upgraded to TierB;
+//   5. keys carry family + kernel policy version; the LRU is bounded.
+//
+// No framework: exit code == failure count.
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+
+#include "nlohmann/json.hpp"
+#include "ops/ComponentOp.h"
+#include "ops/GearOp.h"
+#include "ops/GeneratorCache.h"
+#include "ops/OpTypes.h"
+#include "session/BodyStore.h"
+#include "session/ShapeMetrics.h"
+#include "util/Cancel.h"
+
+using nlohmann::json;
+namespace ops = onecad::ops;
+namespace em = onecad::elementmap;
+namespace kv = onecad::kernel::validation;
+using onecad::session::BodyStore;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) {
+        std::fprintf(stderr, "FAIL: %s\n", msg.c_str());
+        ++g_failures;
+    }
+}
+
+double vol(const TopoDS_Shape& s) { return onecad::session::shape_volume(s); }
+
+struct Ctx {
+    std::vector<std::pair<std::string, json>> sketches;
+    std::string last_sketch;
+    onecad::CancelToken cancel;
+    ops::OpContext make(BodyStore& bodies, em::ElementMapPartition& part) {
+        return ops::OpContext{bodies, &sketches, part, &last_sketch, false, json::object(), &cancel};
+    }
+};
+
+json place_op(const std::string& op_id, double length) {
+    return json{{"opType", "PlaceComponent"},
+                {"opId", op_id},
+                {"params",
+                 {{"componentId", "onecad.std.iso4762"},
+                  {"componentVersion", "1.0.0"},
+                  {"componentRevision", "sha256:" + std::string(64, '0')},
+                  {"source",
+                   {{"kind", "generator"},
+                    {"generatorId", "iso4762"},
+                    {"generatorVersion", 1},
+                    {"params", {{"thread", "M6"}, {"length", length}}}}},
+                  {"placement", {{"translate", {0.0, 0.0, 0.0}}}}}}};
+}
+
+json gear_op(const std::string& op_id) {
+    const json block = {{"teeth", 20},        {"module", 2.0},   {"height", 5.0},
+                        {"pressureAngleDeg", 20.0}, {"shift", 0.0},    {"helixAngleDeg", 0.0},
+                        {"doubleHelix", false},     {"propertiesFromTool", false},
+                        {"undercut", false},        {"backlash", 0.0}, {"clearance", 0.25},
+                        {"head", 0.0},              {"sampleCount", 12}};
+    return json{{"opType", "Gear"},
+                {"opId", op_id},
+                {"inputs", json::array()},
+                {"params",
+                 {{"recipe", "involuteExternal"},
+                  {"placement",
+                   {{"face", nullptr},
+                    {"frame",
+                     {{"origin", {0.0, 0.0, 0.0}},
+                      {"axis", {0.0, 0.0, 1.0}},
+                      {"xDir", {1.0, 0.0, 0.0}}}},
+                    {"point", {0.0, 0.0, 0.0}}}},
+                  {"involuteExternal", block}}}};
+}
+
+// ── 1 + 2. Component generator: one run, independent bit-identical copies ──────
+void test_component_hits() {
+    ops::GeneratorCache& cache = ops::generator_cache();
+    cache.clear();
+    const std::uint64_t misses0 = cache.misses();
+    const std::uint64_t hits0 = cache.hits();
+
+    BodyStore bodies;
+    em::ElementMapPartition part;
+    Ctx c;
+    ops::OpContext ctx = c.make(bodies, part);
+    const ops::OpOutcome a = ops::execute_place_component(ctx, place_op("opa", 20.0), "opa");
+    const ops::OpOutcome b = ops::execute_place_component(ctx, place_op("opb", 20.0), "opb");
+    check(a.status == ops::OpOutcome::Status::Ok && b.status == ops::OpOutcome::Status::Ok,
+          "placements: Ok");
+    check(cache.misses() == misses0 + 1 && cache.hits() == hits0 + 1,
+          "second placement reuses the generator run");
+    const onecad::session::BodyRecord* ra = bodies.get("body_opa");
+    const onecad::session::BodyRecord* rb = bodies.get("body_opb");
+    check(ra != nullptr && rb != nullptr, "both placements published");
+    if (ra == nullptr || rb == nullptr) return;
+    check(vol(ra->geom) == vol(rb->geom), "hit volume is bit-identical to the cold build");
+    check(ra->geom.TShape() != rb->geom.TShape(), "each placement is its own deep copy");
+
+    ops::execute_place_component(ctx, place_op("opc", 30.0), "opc");
+    check(cache.misses() == misses0 + 2 && cache.size() == 2, "a params change is a miss");
+}
+
+// ── 3 + 4. Gear: audited local solid, re-placed per regen ──────────────────────
+void test_gear_hits_and_tiers() {
+    ops::GeneratorCache& cache = ops::generator_cache();
+    cache.clear();
+
+    BodyStore bodies;
+    em::ElementMapPartition part;
+    Ctx c;
+    ops::OpContext ctx = c.make(bodies, part);
+    ctx.validation_mode = ops::ValidationMode::PreviewInteractive;
+    const ops::OpOutcome preview = ops::execute_gear(ctx, gear_op("opg0"), "opg0");
+    check(preview.status == ops::OpOutcome::Status::Ok, "preview gear: Ok");
+    check(cache.size() == 1, "preview gear cached");
+
+    ctx.validation_mode = ops::ValidationMode::CommitAuthoritative;
+    const std::uint64_t hits0 = cache.hits();
+    const ops::OpOutcome g1 = ops::execute_gear(ctx, gear_op("opg1"), "opg1");
+    const ops::OpOutcome g2 = ops::execute_gear(ctx, gear_op("opg2"), "opg2");
+    check(g1.status == ops::OpOutcome::Status::Ok && g2.status == ops::OpOutcome::Status::Ok,
+          "authoritative gears: Ok");
+    check(cache.hits() == hits0 + 2 && cache.size() == 1,
+          "authoritative gears reuse the preview build");
+
+    const onecad::session::BodyRecord* p = bodies.get("body_opg0");
+    const onecad::session::BodyRecord* r1 = bodies.get("body_opg1");
+    const onecad::session::BodyRecord* r2 = bodies.get("body_opg2");
+    check(p != nullptr && r1 != nullptr && r2 != nullptr, "gears published");
+    if (p == nullptr || r1 == nullptr || r2 == nullptr) return;
+    check(vol(p->geom) == vol(r1->geom) && vol(r1->geom) == vol(r2->geom),
+          "hit volumes are bit-identical");
+    check(r1->geom.TShape() != r2->geom.TShape() && p->geom.TShape() != r1->geom.TShape(),
+          "published gears never share the cached TShape");
+}
+
+// ── 5. Keys and bound ──────────────────────────────────────────────────────────
+void test_keys_and_bound() {
+    const json params = {{"thread", "M6"}, {"length", 20.0}};
+    const std::string k = ops::generator_cache_key("component:iso4762", params);
+    check(k.find("|k" + std::to_string(ONECAD_KERNEL_POLICY_VERSION) + "|") != std::string::npos,
+          "key carries the kernel policy version");
+    check(k == ops::generator_cache_key("component:iso4762",
+                                        json{{"length", 20.0}, {"thread", "M6"}}),
+          "key is independent of params insertion order");
+    check(k != ops::generator_cache_key("component:iso4017", params),
+          "key carries the family");
+
+    check(ops::audit_covers(kv::PublicationTier::TierB, kv::PublicationTier::TierB) &&
+              ops::audit_covers(kv::PublicationTier::TierB, kv::PublicationTier::TierA) &&
+              ops::audit_covers(kv::PublicationTier::TierA, kv::PublicationTier::TierA) &&
+              !ops::audit_covers(kv::PublicationTier::TierA, kv::PublicationTier::TierB),
+          "a TierA audit never stands in for TierB");
+
+    ops::GeneratorCache small(2);
+    const TopoDS_Shape box = BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Shape();
+    small.insert("a", ops::GeneratedSolid{box});
+    small.insert("b", ops::GeneratedSolid{box});
+    small.insert("c", ops::GeneratedSolid{box});
+    check(small.size() == 2, "capacity bounds the entry count");
+    check(!small.find("a").has_value(), "least-recently-used entry evicted");
+    check(small.find("c").has_value(), "most recent entry retained");
+}
+}  // namespace
+
+int main() {
+    test_component_hits();
+    test_gear_hits_and_tiers();
+    test_keys_and_bound();
+    if (g_failures == 0) std::fprintf(stderr, "test_generator_cache: OK\n");
+    return g_failures;
+}
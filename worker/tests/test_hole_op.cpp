@@ -10,7 +10,8 @@
 //                       csDepth = (csD − d)/2 / tan(csAngle/2)
 //
 // plus the recoverable guards (non-planar seat, point off the plane, point off the
-// face boundary, cb/cs invariants) and bit-equal determinism.
+// face boundary, cb/cs invariants), the multi-seat `points[]` form (N seats in one
+// Cut, per-seat NeedsRepair) and bit-equal determinism.
 //
 // NOT named test_hole_*.cpp by accident: `test_hole_extrude.cpp` is an EXTRUDE
 // test (a profile with a hole in it) and is unrelated.
@@ -428,6 +429,91 @@ void test_determinism() {
     check(volume[0] == volume[1], "determinism: volume bit-equal across runs");
 }
 
+// ── 9. MULTI-SEAT `points[]`: N seats, ONE cut, per-seat NeedsRepair ─────────
+//      Four r=1.5 through holes on a 10 mm grid never touch, so the removed volume
+//      is exactly 4·π·r²·25; a counterbore seat's drill and cb pieces overlap
+//      inside the single tool set exactly as they would after a pre-fuse.
+void test_multi_seat() {
+    const json grid = json::array({json::array({5.0, 5.0, 25.0}), json::array({15.0, 5.0, 25.0}),
+                                   json::array({5.0, 15.0, 25.0}),
+                                   json::array({15.0, 15.0, 25.0})});
+    {  // (a) every seat drills; one modified host, no repairs.
+        BodyStore bodies;
+        em::ElementMapPartition part;
+        const ops::OpOutcome oc = run_hole(
+            bodies, part, json{{"point", nullptr}, {"points", grid}, {"diameter", 3.0}});
+        check(oc.status == ops::OpOutcome::Status::Ok, "multi-seat: Ok");
+        check(oc.needs_repair.empty(), "multi-seat: no NeedsRepair");
+        check(oc.body_events.size() == 1 && oc.body_events[0].kind == "modified" &&
+                  oc.body_events[0].body_id == "body_1",
+              "multi-seat: ONE modified host, nothing minted");
+        check_rel(vol(bodies.get("body_1")->geom), kBoxVol - 4.0 * kPi * 1.5 * 1.5 * 25.0, 1e-6,
+                  "multi-seat: 10000 − 4·π·1.5²·25");
+        check(solid_count(bodies.get("body_1")->geom) == 1, "multi-seat: host stays one solid");
+    }
+    {  // (b) counterbore seats: each seat's pieces overlap inside the tool set.
+        BodyStore bodies;
+        em::ElementMapPartition part;
+        const ops::OpOutcome oc =
+            run_hole(bodies, part,
+                     json{{"point", nullptr},
+                          {"points", json::array({grid[0], grid[3]})},
+                          {"diameter", 3.0},
+                          {"holeType", "counterbore"},
+                          {"depth", 20.0},
+                          {"cbDiameter", 6.0},
+                          {"cbDepth", 4.0}});
+        check(oc.status == ops::OpOutcome::Status::Ok, "multi-seat counterbore: Ok");
+        const double per_seat = kPi * 1.5 * 1.5 * (20.0 - 4.0) + kPi * 3.0 * 3.0 * 4.0;
+        check_rel(vol(bodies.get("body_1")->geom), kBoxVol - 2.0 * per_seat, 1e-6,
+                  "multi-seat counterbore: 10000 − 2·(π·1.5²·16 + π·3²·4)");
+    }
+    {  // (c) one seat off the plane, one off the face: both flagged, the rest drill.
+        BodyStore bodies;
+        em::ElementMapPartition part;
+        const json mixed = json::array({grid[0], json::array({10.0, 10.0, 30.0}),
+                                        json::array({50.0, 50.0, 25.0}), grid[3]});
+        const ops::OpOutcome oc = run_hole(
+            bodies, part, json{{"point", nullptr}, {"points", mixed}, {"diameter", 3.0}});
+        check(oc.status == ops::OpOutcome::Status::Ok, "partial seats: Ok");
+        check(oc.body_events.size() == 1, "partial seats: surviving seats still publish");
+        check(oc.needs_repair.size() == 2, "partial seats: one NeedsRepair per failed seat");
+        if (oc.needs_repair.size() == 2) {
+            check(oc.needs_repair[0].value("refId", "") == "ophl.seat1" &&
+                      oc.needs_repair[1].value("refId", "") == "ophl.seat2",
+                  "partial seats: repairs name the seat index");
+            check(oc.needs_repair[0].value("uiLabel", "").find("off the resolved face plane") !=
+                          std::string::npos &&
+                      oc.needs_repair[1].value("uiLabel", "").find(
+                          "outside the resolved face boundary") != std::string::npos,
+                  "partial seats: each repair names its fence");
+        }
+        check_rel(vol(bodies.get("body_1")->geom), kBoxVol - 2.0 * kPi * 1.5 * 1.5 * 25.0, 1e-6,
+                  "partial seats: only the two good seats are cut");
+    }
+    {  // (d) no seat survives ⇒ NeedsRepair state, host untouched.
+        BodyStore bodies;
+        em::ElementMapPartition part;
+        const ops::OpOutcome oc =
+            run_hole(bodies, part,
+                     json{{"point", nullptr},
+                          {"points", json::array({json::array({50.0, 50.0, 25.0})})},
+                          {"diameter", 3.0}});
+        check(oc.status == ops::OpOutcome::Status::Ok && oc.body_events.empty() &&
+                  oc.needs_repair.size() == 1,
+              "no surviving seat: NeedsRepair only, no geometry");
+        check_rel(vol(bodies.get("body_1")->geom), kBoxVol, 1e-12,
+                  "no surviving seat: host untouched");
+    }
+    {  // (e) `point` and `points` together is an authoring error, not a guess.
+        BodyStore bodies;
+        em::ElementMapPartition part;
+        const ops::OpOutcome oc = run_hole(bodies, part, json{{"points", grid}});
+        check(oc.status == ops::OpOutcome::Status::Failed && oc.error_code == "OP_FAILED",
+              "point + points: recoverable OP_FAILED");
+    }
+}
+
 }  // namespace
 
 int main() {
@@ -441,6 +527,7 @@ int main() {
     test_result_policy_versions();
     test_quarantined_host_is_not_modelable();
     test_determinism();
+    test_multi_seat();
     if (g_failures == 0) std::fprintf(stderr, "test_hole_op: all checks passed\n");
     return g_failures;
 }
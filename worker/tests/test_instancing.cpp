@@ -0,0 +1,263 @@
+// test_instancing.cpp — `determinism.occtOptions.instancing` (ops/Instancing.h):
+// shared-prototype placement for PlaceComponent, TransformBody copies and unfused
+// patterns, plus the tessellation side. In-process, real OCCT.
+//
+// Pins:
+//   1. two generator placements share ONE prototype TShape (and one generator
+//      run) — not the cached solid deep copies are taken from — and each still
+//      carries the exact M6 SHCS volume;
+//   2. without the option, placements stay independent deep copies;
+//   3. `TransformBody {copy:true}` and an unfused V2 LinearPattern re-locate the
+//      source instead of copying it;
+//   4. with `instances`, a rotated instance meshes to the same triangle count as
+//      its prototype, and `tess::instance_of` recovers the placement between two
+//      instances; without it a located body meshes as before (at its world bbox);
+//   5. `is_rigid` keeps scaled/mirrored transforms on the copy path.
+//
+// No framework: exit code == failure count.
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepTools.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+
+#include "nlohmann/json.hpp"
+#include "ops/ComponentOp.h"
+#include "ops/GeneratorCache.h"
+#include "ops/Instancing.h"
+#include "ops/OpTypes.h"
+#include "ops/PatternOp.h"
+#include "ops/TransformOp.h"
+#include "session/BodyStore.h"
+#include "session/ShapeMetrics.h"
+#include "tess/Tessellate.h"
+#include "util/Cancel.h"
+
+using nlohmann::json;
+namespace ops = onecad::ops;
+namespace em = onecad::elementmap;
+using onecad::session::BodyStore;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) {
+        std::fprintf(stderr, "FAIL: %s\n", msg.c_str());
+        ++g_failures;
+    }
+}
+void check_near(double got, double want, double tol, const std::string& msg) {
+    if (std::abs(got - want) > tol) {
+        std::fprintf(stderr, "FAIL: %s (got %.6f want %.6f)\n", msg.c_str(), got, want);
+        ++g_failures;
+    }
+}
+
+double vol(const TopoDS_Shape& s) { return onecad::session::shape_volume(s); }
+
+constexpr double kPi = 3.14159265358979323846;
+// test_component_ops.cpp: ISO 4762 M6x20 — head r=5 h=6 + shank r=3 h=20.
+constexpr double kM6ShcsVolume = kPi * 5.0 * 5.0 * 6.0 + kPi * 3.0 * 3.0 * 20.0;
+
+struct Ctx {
+    std::vector<std::pair<std::string, json>> sketches;
+    std::string last_sketch;
+    onecad::CancelToken cancel;
+    json occt_options = json::object();
+    ops::OpContext make(BodyStore& bodies, em::ElementMapPartition& part) {
+        return ops::OpContext{bodies, &sketches, part, &last_sketch, false, occt_options, &cancel};
+    }
+};
+
+json place_op(const std::string& op_id, double tx, double angle_deg) {
+    return json{{"opType", "PlaceComponent"},
+                {"opId", op_id},
+                {"params",
+                 {{"componentId", "onecad.std.iso4762"},
+                  {"componentVersion", "1.0.0"},
+                  {"componentRevision", "sha256:" + std::string(64, '0')},
+                  {"source",
+                   {{"kind", "generator"},
+                    {"generatorId", "iso4762"},
+                    {"generatorVersion", 1},
+                    {"params", {{"thread", "M6"}, {"length", 20.0}}}}},
+                  {"placement",
+                   {{"translate", {tx, 0.0, 0.0}},
+                    {"rotate",
+                     {{"center", {0.0, 0.0, 0.0}},
+                      {"axis", {1.0, 0.0, 0.0}},
+                      {"angleDeg", angle_deg}}}}}}}};
+}
+
+void place_two(bool instancing, BodyStore& bodies) {
+    em::ElementMapPartition part;
+    Ctx c;
+    if (instancing) c.occt_options = json{{"instancing", true}};
+    ops::OpContext ctx = c.make(bodies, part);
+    const ops::OpOutcome a = ops::execute_place_component(ctx, place_op("opa", 0.0, 0.0), "opa");
+    const ops::OpOutcome b = ops::execute_place_component(ctx, place_op("opb", 40.0, 30.0), "opb");
+    check(a.status == ops::OpOutcome::Status::Ok && b.status == ops::OpOutcome::Status::Ok,
+          "placements: Ok");
+}
+
+// ── 1 + 2. PlaceComponent: shared prototype vs independent copies ──────────────
+void test_place_component_shares_prototype() {
+    ops::generator_cache().clear();
+    const std::uint64_t misses0 = ops::generator_cache().misses();
+    const std::uint64_t hits0 = ops::generator_cache().hits();
+    BodyStore bodies;
+    place_two(/*instancing=*/true, bodies);
+    const onecad::session::BodyRecord* a = bodies.get("body_opa");
+    const onecad::session::BodyRecord* b = bodies.get("body_opb");
+    check(a != nullptr && b != nullptr, "instanced placements published");
+    if (a == nullptr || b == nullptr) return;
+    check(a->geom.TShape() == b->geom.TShape(), "instanced placements share one TShape");
+    check(!a->geom.Location().IsEqual(b->geom.Location()), "each instance has its own location");
+    check(ops::generator_cache().misses() == misses0 + 1 &&
+              ops::generator_cache().hits() == hits0 + 1,
+          "one generator run, one prototype hit");
+    check_near(vol(a->geom), kM6ShcsVolume, 1.0, "first instance: exact M6 SHCS volume");
+    check_near(vol(b->geom), vol(a->geom), 1e-6, "placed instance: same volume");
+    const std::optional<ops::GeneratedSolid> cached = ops::generator_cache().find(
+        ops::generator_cache_key("component:iso4762", {{"thread", "M6"}, {"length", 20.0}}));
+    check(cached && cached->shape.TShape() != a->geom.TShape(),
+          "instances never share the cached solid the deep-copy path copies");
+
+    BodyStore copied;
+    place_two(/*instancing=*/false, copied);
+    check(copied.get("body_opa")->geom.TShape() != copied.get("body_opb")->geom.TShape(),
+          "without instancing every placement is its own copy");
+    check_near(vol(copied.get("body_opb")->geom), vol(b->geom), 1e-6,
+               "instanced and copied placements carry the same volume");
+}
+
+// ── 3. TransformBody copy + unfused pattern re-locate the source ───────────────
+void test_copies_share_source() {
+    const TopoDS_Shape box = BRepPrimAPI_MakeBox(10.0, 10.0, 10.0).Shape();
+    {
+        BodyStore bodies;
+        bodies.create("body_1", "op0", box);
+        em::ElementMapPartition part;
+        Ctx c;
+        c.occt_options = json{{"instancing", true}};
+        ops::OpContext ctx = c.make(bodies, part);
+        const json op = {{"opType", "TransformBody"},
+                         {"opId", "opt"},
+                         {"params",
+                          {{"targets", json::array({"body_1"})},
+                           {"translate", {20.0, 0.0, 0.0}},
+                           {"copy", true}}}};
+        const ops::OpOutcome oc = ops::execute_transform_body(ctx, op, "opt");
+        check(oc.status == ops::OpOutcome::Status::Ok, "transform copy: Ok");
+        const onecad::session::BodyRecord* copy = bodies.get("body_opt");
+        check(copy != nullptr && copy->geom.TShape() == box.TShape(),
+              "transform copy shares the source TShape");
+        if (copy != nullptr) check_near(vol(copy->geom), 1000.0, 1e-9, "transform copy: volume");
+    }
+    {
+        BodyStore bodies;
+        bodies.create("body_1", "op0", box);
+        em::ElementMapPartition part;
+        Ctx c;
+        c.occt_options = json{{"instancing", true}};
+        ops::OpContext ctx = c.make(bodies, part);
+        const json op = {{"opType", "LinearPattern"},
+                         {"opId", "opp"},
+                         {"params",
+                          {{"sourceBodyId", "body_1"},
+                           {"direction", {1, 0, 0}},
+                           {"spacing", 20.0},
+                           {"count", 4},
+                           {"fuseResult", false},
+                           {"resultPolicyVersion", 2}}}};
+        const ops::OpOutcome oc = ops::execute_linear_pattern(ctx, op, "opp");
+        check(oc.status == ops::OpOutcome::Status::Ok && oc.body_ids.size() == 3,
+              "unfused pattern: three children");
+        for (const std::string& bid : oc.body_ids) {
+            const onecad::session::BodyRecord* rec = bodies.get(bid);
+            check(rec != nullptr && rec->geom.TShape() == box.TShape(),
+                  "pattern child " + bid + " shares the source TShape");
+        }
+    }
+}
+
+// ── 4. Tessellation: one prototype, one mesh density, recoverable transform ────
+// `shape`'s own topological copy under `trsf` (shares no TShape with `shape`).
+TopoDS_Shape place_instance_of_copy(const TopoDS_Shape& shape, const gp_Trsf& trsf) {
+    return ops::place_instance(BRepBuilderAPI_Copy(shape, Standard_False).Shape(), trsf);
+}
+
+void test_tessellation_of_instances() {
+    const TopoDS_Shape proto = BRepPrimAPI_MakeBox(30.0, 2.0, 2.0).Shape();
+    gp_Trsf move;
+    move.SetTranslation(gp_Vec(100.0, 0.0, 0.0));
+    gp_Trsf turn;
+    turn.SetRotation(gp_Ax1(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1)), kPi / 4.0);
+    const TopoDS_Shape a = ops::place_instance(proto, move);
+    const TopoDS_Shape b = ops::place_instance(proto, turn);
+    check(!a.IsNull() && !b.IsNull(), "rigid placements are instances");
+
+    // Without `instances`, each body meshes as located, exactly like a separately
+    // built copy of it placed the same way.
+    const TopoDS_Shape own = place_instance_of_copy(proto, turn);
+    const onecad::tess::BodyMesh located =
+        onecad::tess::tessellate_body(b, "b", "fine", false, nullptr);
+    const onecad::tess::BodyMesh copied =
+        onecad::tess::tessellate_body(own, "b", "fine", false, nullptr);
+    check(located.ok && located.blob == copied.blob,
+          "without instances a located body meshes as before");
+    BRepTools::Clean(proto);  // drop that mesh from the shared TFaces
+
+    const onecad::tess::BodyMesh ma =
+        onecad::tess::tessellate_body(a, "a", "fine", false, nullptr, nullptr, true);
+    const onecad::tess::BodyMesh mb =
+        onecad::tess::tessellate_body(b, "b", "fine", false, nullptr, nullptr, true);
+    check(ma.ok && mb.ok, "instances tessellate");
+    check(ma.triangle_count == mb.triangle_count,
+          "a rotated instance meshes at its prototype's density");
+
+    gp_Trsf rel;
+    check(onecad::tess::instance_of(b, a, rel), "instance_of recognises a shared prototype");
+    const gp_Pnt mapped = gp_Pnt(100.0, 0.0, 0.0).Transformed(rel);  // a's image of the origin
+    check(mapped.Distance(gp_Pnt(0.0, 0.0, 0.0)) < 1e-9,
+          "instance transform maps a's mesh onto b's");
+    check(!onecad::tess::instance_of(BRepPrimAPI_MakeBox(30.0, 2.0, 2.0).Shape(), a, rel),
+          "an equal but separately built shape is not an instance");
+}
+
+// ── 5. Only rigid motions become locations ─────────────────────────────────────
+void test_rigid_only() {
+    const TopoDS_Shape box = BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Shape();
+    gp_Trsf scale;
+    scale.SetScale(gp_Pnt(0, 0, 0), 2.0);
+    gp_Trsf mirror;
+    mirror.SetMirror(gp_Pnt(0, 0, 0));
+    check(!ops::is_rigid(scale) && ops::place_instance(box, scale).IsNull(),
+          "a scale is not an instance placement");
+    check(!ops::is_rigid(mirror) && ops::place_instance(box, mirror).IsNull(),
+          "a point mirror is not an instance placement");
+    check(!ops::instancing_enabled(json::object()) &&
+              !ops::instancing_enabled(json{{"instancing", "true"}}) &&
+              ops::instancing_enabled(json{{"instancing", true}}),
+          "instancing is an explicit boolean opt-in");
+}
+}  // namespace
+
+int main() {
+    test_place_component_shares_prototype();
+    test_copies_share_source();
+    test_tessellation_of_instances();
+    test_rigid_only();
+    if (g_failures == 0) std::fprintf(stderr, "test_instancing: OK\n");
+    return g_failures;
+}
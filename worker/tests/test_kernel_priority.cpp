@@ -0,0 +1,199 @@
+// test_kernel_priority.cpp — the kernel lane's priority queue (SCHEMA §5.5,
+// Dispatcher::pick_kernel_job). In-process, real OCCT (Dispatcher links it).
+//
+// Pins, each through Dispatcher::run with every request queued behind one slow
+// job:
+//   1. read-only jobs run best class first, FIFO within a class;
+//   2. a Regen (mutating) job is a barrier: nothing queued before it runs after
+//      it, nothing queued after it runs before it;
+//   3. `args.priority` overrides a read-only verb's class, but cannot move a
+//      mutating verb out of order; a malformed override is ignored;
+//   4. aging: a bulk job that has waited long enough beats a fresh interactive
+//      one (no starvation);
+//   5. a scratch-only writer (ExecutePlan) is crossed by head reads queued
+//      behind it, but never by a read of the scratch or by another writer.
+//
+// No framework: exit code == failure count.
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "protocol/Frame.h"
+
+using nlohmann::json;
+using onecad::protocol::Dispatcher;
+using onecad::protocol::Envelope;
+using onecad::protocol::HandlerContext;
+using onecad::protocol::Priority;
+using onecad::protocol::Scope;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) { std::fprintf(stderr, "FAIL: %s\n", msg.c_str()); ++g_failures; }
+}
+
+bool send(int fd, std::uint64_t id, const std::string& verb, const json& args = json::object()) {
+    onecad::protocol::Frame f;
+    f.json = onecad::protocol::serialize(Envelope::request(id, verb, args));
+    return onecad::protocol::write_frame(fd, f);
+}
+
+// Registers Block (Regen, sleeps `block`), Write (Regen), Hover (Interactive),
+// Tick (Preview), Export (Bulk), Plan (Regen, scratch only) and Peek
+// (Interactive, reads the scratch); runs `script` against the worker's stdin and
+// returns the request ids in the order their handlers ran.
+std::vector<std::uint64_t> run_script(std::chrono::milliseconds block,
+                                      const std::function<void(int fd)>& script,
+                                      json* stats = nullptr) {
+    Dispatcher d;
+    std::mutex mu;
+    std::vector<std::uint64_t> order;
+    const auto recorder = [&mu, &order](std::chrono::milliseconds sleep) {
+        return [&mu, &order, sleep](const Envelope& r, const std::vector<std::uint8_t>&,
+                                    HandlerContext&) {
+            std::this_thread::sleep_for(sleep);
+            {
+                std::lock_guard<std::mutex> lk(mu);
+                order.push_back(r.id);
+            }
+            return Envelope::ok_response(r.id, json{});
+        };
+    };
+    const std::chrono::milliseconds none{0};
+    d.register_verb("Block", recorder(block));
+    d.register_verb("Write", recorder(none));
+    d.register_verb("Hover", recorder(none), Priority::Interactive);
+    d.register_verb("Tick", recorder(none), Priority::Preview);
+    d.register_verb("Export", recorder(none), Priority::Bulk);
+    d.register_verb("Plan", recorder(none), Priority::Regen, Scope::Scratch);
+    d.register_verb("Peek", recorder(none), Priority::Interactive, Scope::Scratch);
+
+    int in[2];
+    int out[2];
+    check(pipe(in) == 0 && pipe(out) == 0, "pipes");
+    std::thread drain([fd = out[0]] {
+        char buf[4096];
+        while (::read(fd, buf, sizeof(buf)) > 0) {
+        }
+    });
+    std::thread writer([fd = in[1], &script, block] {
+        script(fd);
+        std::this_thread::sleep_for(block + std::chrono::milliseconds(200));
+        ::close(fd);
+    });
+    d.run(in[0], out[1]);
+    writer.join();
+    ::close(out[1]);
+    drain.join();
+    ::close(in[0]);
+    ::close(out[0]);
+    if (stats != nullptr) *stats = d.stats_json();
+    return order;
+}
+
+// ── 1 + 2. Classes and barriers ──────────────────────────────────────────────
+void test_classes_and_barriers() {
+    json stats;
+    const std::vector<std::uint64_t> order = run_script(
+        std::chrono::milliseconds(150),
+        [](int fd) {
+            send(fd, 1, "Block");
+            send(fd, 2, "Export");
+            send(fd, 3, "Tick");
+            send(fd, 4, "Export");
+            send(fd, 5, "Hover");
+            send(fd, 6, "Write");
+            send(fd, 7, "Hover");
+            send(fd, 8, "Export");
+            send(fd, 9, "Hover");
+        },
+        &stats);
+    const std::vector<std::uint64_t> expected = {1, 5, 3, 2, 4, 6, 7, 9, 8};
+    check(order == expected, "best class first, FIFO within a class, Write a barrier");
+    const json& kernel = stats["lanes"]["kernel"];
+    check(kernel.value("reordered", 0) >= 3, "out-of-order starts are counted");
+    check(kernel["classWait"]["interactive"].value("count", 0) == 3 &&
+              kernel["classWait"]["bulk"].value("count", 0) == 3,
+          "wait recorded per class");
+}
+
+// ── 3. Per-request override ──────────────────────────────────────────────────
+void test_override() {
+    const std::vector<std::uint64_t> order =
+        run_script(std::chrono::milliseconds(150), [](int fd) {
+            send(fd, 1, "Block");
+            send(fd, 2, "Hover");
+            send(fd, 3, "Export", json{{"priority", "interactive"}});
+            send(fd, 4, "Hover", json{{"priority", "bulk"}});
+            send(fd, 5, "Tick", json{{"priority", 7}});         // malformed: ignored
+            send(fd, 6, "Tick", json{{"priority", "urgent"}});  // unknown: ignored
+            send(fd, 7, "Write", json{{"priority", "interactive"}});
+            send(fd, 8, "Hover");
+        });
+    const std::vector<std::uint64_t> expected = {1, 2, 3, 5, 6, 4, 7, 8};
+    check(order == expected, "an override reorders reads but never moves a write");
+}
+
+// ── 4. Aging ─────────────────────────────────────────────────────────────────
+void test_aging() {
+    // The Export waits ~1200 ms (almost five aging steps; it needs three to catch
+    // up with Interactive), the Hover only ~100 ms.
+    const std::vector<std::uint64_t> order =
+        run_script(std::chrono::milliseconds(1200), [](int fd) {
+            send(fd, 1, "Block");
+            send(fd, 2, "Export");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+            send(fd, 3, "Hover");
+        });
+    const std::vector<std::uint64_t> expected = {1, 2, 3};
+    check(order == expected, "a long-waiting bulk job is not starved by a fresh hover");
+}
+
+// ── 5. Scratch-only writers ──────────────────────────────────────────────────
+void test_scratch_writer() {
+    const std::vector<std::uint64_t> behind =
+        run_script(std::chrono::milliseconds(150), [](int fd) {
+            send(fd, 1, "Block");
+            send(fd, 2, "Plan");
+            send(fd, 3, "Tick");
+            send(fd, 4, "Peek");
+            send(fd, 5, "Hover");
+            send(fd, 6, "Export");
+            send(fd, 7, "Write");
+            send(fd, 8, "Hover");
+        });
+    const std::vector<std::uint64_t> expected_behind = {1, 5, 3, 2, 4, 6, 7, 8};
+    check(behind == expected_behind,
+          "head reads cross a scratch writer; a scratch read and a Write do not");
+
+    // A scratch read queued ahead (demoted to bulk) still runs before the writer.
+    const std::vector<std::uint64_t> ahead =
+        run_script(std::chrono::milliseconds(150), [](int fd) {
+            send(fd, 1, "Block");
+            send(fd, 2, "Peek", json{{"priority", "bulk"}});
+            send(fd, 3, "Plan");
+            send(fd, 4, "Hover");
+        });
+    const std::vector<std::uint64_t> expected_ahead = {1, 4, 2, 3};
+    check(ahead == expected_ahead, "a writer never starts before a scratch read queued ahead");
+}
+}  // namespace
+
+int main() {
+    test_classes_and_barriers();
+    test_override();
+    test_aging();
+    test_scratch_writer();
+    if (g_failures == 0) std::fprintf(stderr, "test_kernel_priority: OK\n");
+    return g_failures;
+}
@@ -0,0 +1,176 @@
+// test_op_result_cache.cpp — the on-disk op-result cache (session/OpResultCache.h).
+// In-process, real OCCT.
+//
+// Pins:
+//   1. capture → apply reproduces a step's bodies, partition entries and outcome
+//      on the pre-step state (the record carries only what the step changed);
+//   2. a plan replayed in a FRESH session (a restarted worker) hits every body
+//      step and publishes the same geometry signature as the computed run;
+//   3. verify mode recomputes on a hit and reports no mismatch;
+//   4. a corrupt entry is a miss (and is dropped), never a wrong result;
+//   5. the byte cap evicts, and no temp file outlives a write.
+//
+// No framework: exit code == failure count.
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "session/OpResultCache.h"
+#include "session/PlanExecutor.h"
+#include "session/Session.h"
+#include "session/Signatures.h"
+#include "util/Cancel.h"
+
+using nlohmann::json;
+using onecad::CancelToken;
+using onecad::protocol::Envelope;
+using onecad::protocol::HandlerContext;
+using onecad::session::Session;
+namespace em = onecad::elementmap;
+namespace fs = std::filesystem;
+namespace km = onecad::kernel::elementmap;
+namespace ss = onecad::session;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) { std::fprintf(stderr, "FAIL: %s\n", msg.c_str()); ++g_failures; }
+}
+constexpr const char* kEmpty =
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+json rect(double x1, double y1) {
+    return json::array({{{"id", "e1"}, {"type", "Line"}, {"p0", {0, 0}}, {"p1", {x1, 0}}},
+                        {{"id", "e2"}, {"type", "Line"}, {"p0", {x1, 0}}, {"p1", {x1, y1}}},
+                        {{"id", "e3"}, {"type", "Line"}, {"p0", {x1, y1}}, {"p1", {0, y1}}},
+                        {{"id", "e4"}, {"type", "Line"}, {"p0", {0, y1}}, {"p1", {0, 0}}}});
+}
+
+// Extrude a box into a from-0 head of `s`. Returns the head's geometry signature.
+std::string build_box(Session& s, double w, double h, double dist) {
+    json ops = json::array(
+        {json{{"opType", "Sketch"}, {"opId", "op0"}, {"stepIndex", 0},
+              {"params", {{"sketchId", "sk"}, {"plane", {{"kind", "XY"}}},
+                          {"entities", rect(w, h)}, {"constraints", json::array()}}}},
+         json{{"opType", "Extrude"}, {"opId", "op1"}, {"stepIndex", 1},
+              {"params", {{"sketchId", "sk"}, {"distance", dist}, {"extrudeMode", "Blind"},
+                          {"booleanMode", "NewBody"}}}}});
+    CancelToken tok;
+    HandlerContext ctx{tok, [](int) {}, [](Envelope&) {}};
+    json args = {{"jobId", 1}, {"documentRevision", 0}, {"workerEpoch", 3},
+                 {"expectedBaseHash", kEmpty}, {"prefixHashes", json::array({"a", "b"})},
+                 {"targetStep", 1}, {"ops", ops}};
+    ss::handle_execute_plan(s, Envelope::request(1, "ExecutePlan", args), ctx);
+    ss::handle_accept_prepared(
+        s, Envelope::request(1, "AcceptPrepared",
+                             json{{"jobId", 1}, {"documentRevision", 0}, {"workerEpoch", 3}}));
+    return ss::geometry_signature(s.bodies_copy());
+}
+
+std::size_t count_files(const fs::path& dir, const std::string& needle) {
+    std::size_t n = 0;
+    for (const fs::directory_entry& de : fs::directory_iterator(dir)) {
+        if (de.path().filename().string().find(needle) != std::string::npos) ++n;
+    }
+    return n;
+}
+
+// ── 1. Record round trip ──────────────────────────────────────────────────────
+void test_record_round_trip() {
+    ss::BodyStore before_bodies;
+    em::ElementMapPartition before_part;
+    ss::BodyStore after_bodies;
+    em::ElementMapPartition after_part;
+    const TopoDS_Shape box = BRepPrimAPI_MakeBox(10.0, 20.0, 30.0).Shape();
+    after_bodies.create("body_op1", "op1", box);
+    TopTools_IndexedMapOfShape faces;
+    TopExp::MapShapes(box, TopAbs_FACE, faces);
+    after_part.mint("body_op1", "el_top", km::ElementKind::Face, faces(2), box,
+                    json{{"worldPoint", {5.0, 10.0, 30.0}}});
+
+    ss::CandidateResult result;
+    result.body_events.push_back(ss::BodyEvent{"created", "body_op1", std::nullopt, std::nullopt});
+    result.body_ids = {"body_op1"};
+    result.delta.added.push_back(em::DeltaEntry{"el_top", "f:2", "face", "body_op1"});
+
+    const ss::OpResultRecord record =
+        ss::capture_op_result(before_bodies, before_part, after_bodies, after_part, result);
+    check(record.meta["bodies"].size() == 1 && record.meta["entries"].size() == 1,
+          "the record carries the created body and the written entry");
+
+    ss::CandidateResult replayed;
+    check(ss::apply_op_result(record, before_bodies, before_part, replayed), "record applies");
+    check(ss::geometry_signature(before_bodies) == ss::geometry_signature(after_bodies),
+          "replayed bodies match the computed ones");
+    check(ss::partition_entries_json(before_part) == ss::partition_entries_json(after_part),
+          "replayed partition matches the computed one");
+    check(ss::outcome_json(replayed) == ss::outcome_json(result), "replayed outcome matches");
+}
+
+// ── 2–5. Through ExecutePlan ─────────────────────────────────────────────────
+void test_plan_replay(const fs::path& dir) {
+    ss::OpResultCache& cache = ss::op_result_cache();
+    cache.configure(dir, ss::OpResultCache::kDefaultMaxBytes, /*verify=*/false);
+
+    Session cold;
+    const std::string computed = build_box(cold, 10, 10, 10);
+    check(cache.size() == 1 && cache.hits() == 0, "the miss stored the Extrude step");
+    check(count_files(dir, ".tmp.") == 0, "no temp file outlives a write");
+
+    // A restarted worker: fresh process state, same directory.
+    cache.configure(dir, ss::OpResultCache::kDefaultMaxBytes, /*verify=*/false);
+    check(cache.size() == 1, "configure indexes the existing entry");
+    Session warm;
+    check(build_box(warm, 10, 10, 10) == computed, "a hit publishes the computed geometry");
+    check(cache.hits() == 1, "the replay hit");
+
+    cache.configure(dir, ss::OpResultCache::kDefaultMaxBytes, /*verify=*/true);
+    Session verified;
+    check(build_box(verified, 10, 10, 10) == computed, "verify mode publishes the same result");
+    check(cache.mismatches() == 0, "verify mode finds no mismatch");
+
+    Session other;
+    build_box(other, 12, 10, 10);
+    check(cache.size() == 2, "a different op is a different key");
+
+    // Corrupt every entry: the next run misses, rebuilds, and rewrites them.
+    for (const fs::directory_entry& de : fs::directory_iterator(dir)) {
+        std::ofstream(de.path(), std::ios::binary | std::ios::trunc) << "OCR1garbage";
+    }
+    const std::uint64_t misses = cache.misses();
+    Session corrupt;
+    check(build_box(corrupt, 10, 10, 10) == computed, "a corrupt entry never yields a result");
+    check(cache.misses() == misses + 1, "a corrupt entry is a miss");
+
+    // A cap below one entry keeps at most the newest write.
+    cache.configure(dir, /*max_bytes=*/1, /*verify=*/false);
+    check(cache.size() == 0 && cache.bytes() == 0, "the cap evicts on configure");
+    Session capped;
+    build_box(capped, 10, 10, 10);
+    check(cache.size() == 0 && count_files(dir, ".ocr") == 0, "the cap evicts on insert");
+
+    cache.configure(fs::path(), 0, false);
+    check(!cache.enabled(), "an empty directory switches the cache off");
+}
+}  // namespace
+
+int main() {
+    const fs::path dir =
+        fs::temp_directory_path() / ("onecad_op_cache_" + std::to_string(::getpid()));
+    fs::remove_all(dir);
+    test_record_round_trip();
+    test_plan_replay(dir);
+    fs::remove_all(dir);
+    if (g_failures == 0) std::fprintf(stderr, "test_op_result_cache: OK\n");
+    return g_failures;
+}
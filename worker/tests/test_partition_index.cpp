@@ -0,0 +1,170 @@
+// test_partition_index.cpp — the per-body index and copy-on-write entry storage
+// of ElementMapPartition (elementmap/ElementMapPartition.h). In-process, real OCCT.
+//
+// Pins:
+//   1. entries_for_body (all kinds, one kind) matches a full scan, in elementId
+//      order, through mint, re-mint onto another body, apply_history, remove_body;
+//   2. find_by_topokey agrees with the linear topoKey scan it replaces;
+//   3. a partition copy shares entries until a write, and a write on either
+//      side never leaks into the other (including the other's index).
+//
+// No framework: exit code == failure count.
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+
+#include "elementmap/ElementMapPartition.h"
+#include "nlohmann/json.hpp"
+
+namespace em = onecad::elementmap;
+namespace km = onecad::kernel::elementmap;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) {
+        std::fprintf(stderr, "FAIL: %s\n", msg.c_str());
+        ++g_failures;
+    }
+}
+
+// Every history channel empty and nothing deleted: each entry survives verbatim.
+class IdentityHistory final : public BRepBuilderAPI_MakeShape {
+public:
+    TopTools_ListOfShape none;
+    TopoDS_Shape doomed;  // the one sub-shape reported deleted (may be null)
+
+    const TopTools_ListOfShape& Modified(const TopoDS_Shape&) override { return none; }
+    const TopTools_ListOfShape& Generated(const TopoDS_Shape&) override { return none; }
+    Standard_Boolean IsDeleted(const TopoDS_Shape& s) override {
+        return !doomed.IsNull() && s.IsSame(doomed);
+    }
+};
+
+TopoDS_Shape sub(const TopoDS_Shape& body, TopAbs_ShapeEnum type, int index) {
+    TopTools_IndexedMapOfShape map;
+    TopExp::MapShapes(body, type, map);
+    return map(index);
+}
+
+std::vector<std::string> ids(const std::vector<const em::PartitionEntry*>& entries) {
+    std::vector<std::string> out;
+    for (const em::PartitionEntry* e : entries) out.push_back(e->element_id);
+    return out;
+}
+
+// The reference the index must match: ascending elementIds of one body, by scan
+// of every id the test minted.
+std::vector<std::string> scanned(const em::ElementMapPartition& part,
+                                 const std::vector<std::string>& universe,
+                                 const std::string& body_id) {
+    std::vector<std::string> out;
+    for (const std::string& id : universe) {
+        const em::PartitionEntry* e = part.find(id);
+        if (e != nullptr && e->body_id == body_id) out.push_back(id);
+    }
+    return out;
+}
+
+// ── 1 + 2. Index maintenance and topoKey lookup ──────────────────────────────
+void test_index() {
+    const TopoDS_Shape a = BRepPrimAPI_MakeBox(10.0, 10.0, 10.0).Shape();
+    const TopoDS_Shape b = BRepPrimAPI_MakeBox(5.0, 5.0, 5.0).Shape();
+    em::ElementMapPartition part;
+    // Minted out of id order: the index must still iterate sorted.
+    part.mint("body_a", "el_c", km::ElementKind::Face, sub(a, TopAbs_FACE, 3), a);
+    part.mint("body_a", "el_a", km::ElementKind::Face, sub(a, TopAbs_FACE, 1), a);
+    part.mint("body_a", "el_b", km::ElementKind::Edge, sub(a, TopAbs_EDGE, 2), a);
+    part.mint("body_b", "el_d", km::ElementKind::Face, sub(b, TopAbs_FACE, 1), b);
+    const std::vector<std::string> universe = {"el_a", "el_b", "el_c", "el_d"};
+
+    check(ids(part.entries_for_body("body_a")) == scanned(part, universe, "body_a"),
+          "body index == scan, in elementId order");
+    check(ids(part.entries_for_body("body_a", km::ElementKind::Face)) ==
+              std::vector<std::string>{"el_a", "el_c"},
+          "kind bucket holds exactly the body's faces");
+    check(ids(part.entries_for_body("body_a", km::ElementKind::Edge)) ==
+              std::vector<std::string>{"el_b"},
+          "kind bucket holds exactly the body's edges");
+    check(part.entries_for_body("body_z").empty(), "unknown body: empty");
+
+    const em::PartitionEntry* hit = part.find_by_topokey("body_a", "f:3");
+    check(hit != nullptr && hit->element_id == "el_c", "find_by_topokey resolves a face");
+    check(part.find_by_topokey("body_a", "e:2") == part.find("el_b"),
+          "find_by_topokey resolves an edge");
+    check(part.find_by_topokey("body_b", "f:3") == nullptr, "topoKey is body-scoped");
+    check(part.find_by_topokey("body_a", "f:2") == nullptr, "unminted topoKey: none");
+
+    // Re-mint onto another body and kind: the entry leaves its old buckets.
+    part.mint("body_b", "el_c", km::ElementKind::Edge, sub(b, TopAbs_EDGE, 1), b);
+    check(ids(part.entries_for_body("body_a")) == std::vector<std::string>{"el_a", "el_b"},
+          "re-mint leaves the old body's bucket");
+    check(ids(part.entries_for_body("body_b", km::ElementKind::Edge)) ==
+              std::vector<std::string>{"el_c"},
+          "re-mint joins the new body's kind bucket");
+    check(part.find_by_topokey("body_a", "f:3") == nullptr, "old binding no longer found");
+
+    // History drops one entry and keeps the other.
+    IdentityHistory hist;
+    hist.doomed = sub(a, TopAbs_FACE, 1);
+    em::ElementMapDelta delta;
+    part.apply_history("body_a", a, hist, delta);
+    check(delta.removed == std::vector<std::string>{"el_a"}, "history removes the deleted face");
+    check(ids(part.entries_for_body("body_a")) == std::vector<std::string>{"el_b"},
+          "history keeps the index in step");
+
+    em::ElementMapDelta gone;
+    part.remove_body("body_b", gone);
+    check(gone.removed == std::vector<std::string>{"el_c", "el_d"}, "remove_body in id order");
+    check(part.entries_for_body("body_b").empty() && part.size() == 1,
+          "remove_body empties the body");
+}
+
+// ── 3. Copy-on-write sharing ──────────────────────────────────────────────────
+void test_copy_on_write() {
+    const TopoDS_Shape a = BRepPrimAPI_MakeBox(10.0, 10.0, 10.0).Shape();
+    em::ElementMapPartition head;
+    const nlohmann::json anchor = {{"worldPoint", {1.0, 2.0, 3.0}}};
+    head.mint("body_a", "el_a", km::ElementKind::Face, sub(a, TopAbs_FACE, 1), a, anchor);
+    head.mint("body_a", "el_b", km::ElementKind::Face, sub(a, TopAbs_FACE, 2), a, anchor);
+
+    em::ElementMapPartition scratch = head;
+    check(scratch.find("el_a") == head.find("el_a"), "a copy shares its entries");
+
+    gp_Trsf shift;
+    shift.SetTranslation(gp_Vec(100.0, 0.0, 0.0));
+    scratch.apply_placement("body_a", shift);
+    const em::PartitionEntry* moved = scratch.find("el_a");
+    check(moved != head.find("el_a"), "a write un-shares the entry");
+    check(moved->anchor["worldPoint"][0].get<double>() == 101.0, "the copy sees its write");
+    check(head.find("el_a")->anchor["worldPoint"][0].get<double>() == 1.0,
+          "the original never sees the copy's write");
+    check(scratch.entries_for_body("body_a").front() == moved,
+          "the copy's index follows the clone");
+    check(head.entries_for_body("body_a").front() == head.find("el_a"),
+          "the original's index still names its own entry");
+
+    // The other direction, and a drop on one side only.
+    em::ElementMapPartition other = head;
+    em::ElementMapDelta delta;
+    head.remove_body("body_a", delta);
+    check(head.size() == 0 && other.size() == 2, "a drop stays on its side");
+    check(other.find_by_topokey("body_a", "f:2") == other.find("el_b"),
+          "a surviving copy still resolves by topoKey");
+}
+}  // namespace
+
+int main() {
+    test_index();
+    test_copy_on_write();
+    if (g_failures == 0) std::fprintf(stderr, "test_partition_index: OK\n");
+    return g_failures;
+}
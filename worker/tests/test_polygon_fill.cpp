@@ -114,6 +114,21 @@ int main() {
         check_case("rect + 3 holes", outer, holes, 3);
     }
 
+    // --- 4b. A perforated plate: many holes, and holes sharing a row/column ---
+    {
+        const auto outer = rect(0, 0, 200, 100);
+        std::vector<std::vector<sk::Vec2d>> holes;
+        for (int row = 0; row < 8; ++row) {
+            for (int col = 0; col < 16; ++col) {
+                const double cx = 6.25 + 12.5 * col;
+                const double cy = 6.25 + 12.5 * row;
+                holes.push_back((row + col) % 3 == 0 ? rect(cx - 3, cy - 3, cx + 3, cy + 3)
+                                                     : ngon(cx, cy, 4, 24));
+            }
+        }
+        check_case("perforated plate, 128 holes", outer, holes, holes.size());
+    }
+
     // --- 5. Concave outer (L-shape) with a hole in the thick arm ---
     {
         const std::vector<sk::Vec2d> ell = {{0, 0}, {30, 0}, {30, 10}, {10, 10}, {10, 30}, {0, 30}};
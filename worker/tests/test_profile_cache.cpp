@@ -0,0 +1,187 @@
+// test_profile_cache.cpp — the process-wide profile-face cache behind
+// `build_profile_face` (ops/ProfileCache.h). In-process, real OCCT.
+//
+// Pins the properties that make the cache safe to put under every Extrude /
+// Revolve / PreviewOp profile build:
+//   1. a repeated (params, region) build is a HIT and yields the same face area;
+//   2. a hit never hands out the cached TShape itself (topological copy);
+//   3. ANY change to the sketch params is a miss (content keying);
+//   4. `invalidate_sketch` drops exactly that sketch's entries;
+//   5. the extruded solid is identical with and without a hit;
+//   6. a Sketch op without `sketchId` is filed under the id the plan resolved
+//      it to ("sk_"+opId), so the solver lane's invalidation reaches it.
+//
+// No framework: exit code == failure count.
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <BRepGProp.hxx>
+#include <GProp_GProps.hxx>
+
+#include "nlohmann/json.hpp"
+#include "ops/ExtrudeOp.h"
+#include "ops/OpCommon.h"
+#include "ops/OpTypes.h"
+#include "ops/ProfileCache.h"
+#include "session/BodyStore.h"
+#include "session/ShapeMetrics.h"
+#include "util/Cancel.h"
+
+using nlohmann::json;
+namespace ops = onecad::ops;
+namespace em = onecad::elementmap;
+using onecad::session::BodyStore;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) {
+        std::fprintf(stderr, "FAIL: %s\n", msg.c_str());
+        ++g_failures;
+    }
+}
+
+json rect_sketch(const std::string& sid, double w, double h) {
+    return json{{"sketchId", sid},
+                {"plane", {{"kind", "XY"}}},
+                {"entities",
+                 json::array({json{{"id", "e1"}, {"type", "Line"}, {"p0", {0, 0}}, {"p1", {w, 0}}},
+                              json{{"id", "e2"}, {"type", "Line"}, {"p0", {w, 0}}, {"p1", {w, h}}},
+                              json{{"id", "e3"}, {"type", "Line"}, {"p0", {w, h}}, {"p1", {0, h}}},
+                              json{{"id", "e4"}, {"type", "Line"}, {"p0", {0, h}}, {"p1", {0, 0}}}})},
+                {"constraints", json::array()}};
+}
+
+double face_area(const TopoDS_Face& face) {
+    GProp_GProps props;
+    BRepGProp::SurfaceProperties(face, props);
+    return props.Mass();
+}
+
+void test_hit_miss_and_copy() {
+    ops::ProfileFaceCache& cache = ops::profile_face_cache();
+    cache.clear();
+    const json sk = rect_sketch("skA", 40.0, 20.0);
+
+    std::string err;
+    const std::uint64_t misses0 = cache.misses();
+    const std::uint64_t hits0 = cache.hits();
+    const std::optional<TopoDS_Face> first = ops::build_profile_face(sk, "", err);
+    check(first.has_value(), "first build succeeds: " + err);
+    check(cache.misses() == misses0 + 1, "first build is a miss");
+    check(cache.size() == 1, "first build is cached");
+
+    const std::optional<TopoDS_Face> second = ops::build_profile_face(sk, "", err);
+    check(second.has_value(), "second build succeeds");
+    check(cache.hits() == hits0 + 1, "second build is a hit");
+    if (!first || !second) return;
+    check(std::abs(face_area(*first) - 800.0) < 1e-9, "profile area == w*h");
+    check(std::abs(face_area(*second) - face_area(*first)) < 1e-12, "hit area == built area");
+    check(!second->IsSame(*first), "hit is a topological copy, not the built TShape");
+
+    // Any param change is a different key: here the rectangle grows by 1 mm.
+    const std::optional<TopoDS_Face> wider =
+        ops::build_profile_face(rect_sketch("skA", 41.0, 20.0), "", err);
+    check(wider.has_value() && std::abs(face_area(*wider) - 820.0) < 1e-9,
+          "edited params rebuild (no stale hit)");
+    check(cache.size() == 2, "edited params are a second entry");
+
+    ops::build_profile_face(rect_sketch("skB", 10.0, 10.0), "", err);
+    check(cache.size() == 3, "second sketch cached");
+    cache.invalidate_sketch("skA");
+    check(cache.size() == 1, "invalidate_sketch drops only skA entries");
+}
+
+void test_failures_are_not_cached() {
+    ops::ProfileFaceCache& cache = ops::profile_face_cache();
+    cache.clear();
+    json open_chain = rect_sketch("skOpen", 10.0, 10.0);
+    open_chain["entities"].erase(open_chain["entities"].size() - 1);  // no closed loop
+    std::string err;
+    check(!ops::build_profile_face(open_chain, "", err).has_value(), "open chain has no profile");
+    check(!err.empty(), "open chain reports why");
+    check(cache.size() == 0, "a failed build is never cached");
+}
+
+void test_bounded() {
+    ops::ProfileFaceCache small(2);
+    std::string err;
+    const json a = rect_sketch("a", 1.0, 1.0);
+    const json b = rect_sketch("b", 2.0, 2.0);
+    const json c = rect_sketch("c", 3.0, 3.0);
+    for (const json* sk : {&a, &b, &c}) {
+        const std::optional<TopoDS_Face> f = ops::build_profile_face(*sk, "", err);
+        if (f) small.insert(ops::ProfileCacheKey::of(*sk, "", std::nullopt), *f);
+    }
+    check(small.size() == 2, "capacity bounds the entry count");
+    check(!small.find(ops::ProfileCacheKey::of(a, "", std::nullopt)).has_value(),
+          "least-recently-used entry evicted");
+    check(small.find(ops::ProfileCacheKey::of(c, "", std::nullopt)).has_value(),
+          "most recent entry retained");
+}
+
+struct Ctx {
+    std::vector<std::pair<std::string, json>> sketches;
+    std::string last_sketch;
+    onecad::CancelToken cancel;
+    ops::OpContext make(BodyStore& b, em::ElementMapPartition& p) {
+        return ops::OpContext{b, &sketches, p, &last_sketch, false, json::object(), &cancel};
+    }
+};
+
+// Extrude `sk`, filed in the plan as `plan_id`; the Extrude names it only when
+// `named` (else it takes the plan's last sketch, as PlanExecutor resolves it).
+double extrude_volume(const json& sk, const std::string& plan_id = "sk1", bool named = true) {
+    BodyStore bodies;
+    em::ElementMapPartition part;
+    Ctx c;
+    c.sketches.push_back({plan_id, sk});
+    c.last_sketch = plan_id;
+    ops::OpContext ctx = c.make(bodies, part);
+    json op = {{"opType", "Extrude"},
+               {"opId", "ope"},
+               {"params",
+                {{"distance", 10.0}, {"extrudeMode", "Blind"}, {"booleanMode", "NewBody"}}}};
+    if (named) op["params"]["sketchId"] = plan_id;
+    const ops::OpOutcome oc = ops::execute_extrude(ctx, op, "ope");
+    if (oc.status != ops::OpOutcome::Status::Ok || !bodies.contains("body_ope")) return -1.0;
+    return onecad::session::shape_volume(bodies.get("body_ope")->geom);
+}
+
+void test_extrude_identical_on_hit() {
+    ops::profile_face_cache().clear();
+    const json sk = rect_sketch("sk1", 40.0, 20.0);
+    const double cold = extrude_volume(sk);
+    const std::uint64_t hits = ops::profile_face_cache().hits();
+    const double warm = extrude_volume(sk);
+    check(ops::profile_face_cache().hits() == hits + 1, "second extrude reuses the profile");
+    check(std::abs(cold - 8000.0) < 1e-6, "cold extrude volume");
+    check(cold == warm, "warm extrude volume is bit-identical to cold");
+}
+
+void test_unnamed_sketch_is_keyed_by_plan_id() {
+    ops::ProfileFaceCache& cache = ops::profile_face_cache();
+    cache.clear();
+    json sk = rect_sketch("", 30.0, 10.0);
+    sk.erase("sketchId");
+    check(extrude_volume(sk, "sk_opS", false) > 0.0, "an unnamed sketch extrudes");
+    check(cache.size() == 1, "its profile is cached");
+    cache.invalidate_sketch("");
+    check(cache.size() == 1, "it is not filed under the empty id");
+    cache.invalidate_sketch("sk_opS");
+    check(cache.size() == 0, "invalidating the plan's sketch id drops it");
+}
+}  // namespace
+
+int main() {
+    test_hit_miss_and_copy();
+    test_failures_are_not_cached();
+    test_bounded();
+    test_extrude_identical_on_hit();
+    test_unnamed_sketch_is_keyed_by_plan_id();
+    if (g_failures == 0) std::fprintf(stderr, "test_profile_cache: OK\n");
+    return g_failures;
+}
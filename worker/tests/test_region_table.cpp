@@ -209,6 +209,32 @@ json nested_sketch() {
     };
 }
 
+// A 200 x 100 flat pattern: a grid of `columns` x `rows` circular cut-outs,
+// every fourth holding a concentric island (a cut-out's slug kept as a part).
+json flat_pattern(int columns, int rows) {
+    json entities = json::array({
+        {{"id", uuid(1)}, {"type", "Line"}, {"p0", {0, 0}}, {"p1", {200, 0}}},
+        {{"id", uuid(2)}, {"type", "Line"}, {"p0", {200, 0}}, {"p1", {200, 100}}},
+        {{"id", uuid(3)}, {"type", "Line"}, {"p0", {200, 100}}, {"p1", {0, 100}}},
+        {{"id", uuid(4)}, {"type", "Line"}, {"p0", {0, 100}}, {"p1", {0, 0}}},
+    });
+    const double pitch_x = 200.0 / columns;
+    const double pitch_y = 100.0 / rows;
+    const double radius = 0.3 * std::min(pitch_x, pitch_y);
+    for (int i = 0; i < columns * rows; ++i) {
+        const double cx = pitch_x * (i % columns + 0.5);
+        const double cy = pitch_y * (i / columns + 0.5);
+        entities.push_back({{"id", uuid(1000 + i)}, {"type", "Circle"}, {"center", {cx, cy}},
+                            {"radius", radius}});
+        if (i % 4 == 0) {
+            entities.push_back({{"id", uuid(5000 + i)}, {"type", "Circle"},
+                                {"center", {cx, cy}}, {"radius", radius / 2}});
+        }
+    }
+    return {{"sketchId", "flat-pattern"}, {"plane", {{"kind", "XY"}}}, {"entities", entities},
+            {"constraints", json::array()}};
+}
+
 double face_area(const TopoDS_Face& face) {
     GProp_GProps props;
     BRepGProp::SurfaceProperties(face, props);
@@ -294,6 +320,38 @@ void test_nested_cells_and_profile_lookup() {
           "stale-id error lists canonical available ids");
 }
 
+void test_flat_pattern_cutouts_nest_in_one_outline() {
+    constexpr int kColumns = 12;
+    constexpr int kRows = 6;
+    constexpr int kCutouts = kColumns * kRows;
+    constexpr int kIslands = (kCutouts + 3) / 4;
+    onecad::wire::TranslateResult translated =
+        onecad::wire::translate(flat_pattern(kColumns, kRows));
+    check(translated.ok, "flat pattern translates");
+    if (!translated.ok) return;
+    const loop::LoopDetector detector(loop::makeRegionDetectionConfig());
+    const loop::LoopDetectionResult detected = detector.detect(*translated.sketch);
+    check(detected.success, "flat pattern detects");
+    check(detected.faces.size() == 1 + kIslands, "the outline and every island are faces");
+
+    int sheets = 0;
+    int islands = 0;
+    for (const loop::Face& face : detected.faces) {
+        if (face.innerLoops.size() == kCutouts) {
+            ++sheets;
+            check(face.outerLoop.wire.edges.size() == 4, "the sheet face is the outline");
+            check(face.outerLoop.isCCW(), "the sheet outline runs CCW");
+            for (const loop::Loop& hole : face.innerLoops) {
+                check(!hole.isCCW(), "every cut-out runs CW");
+            }
+        } else if (face.innerLoops.empty() && face.outerLoop.isCCW()) {
+            ++islands;
+        }
+    }
+    check(sheets == 1, "one face carries every cut-out as a hole");
+    check(islands == kIslands, "each island is its own face, inside its cut-out");
+}
+
 void test_v2_bytes_are_frozen_and_v3_is_separate() {
     const json sketch = nested_sketch();
     const loop::RegionTable v2 = table_from(sketch);
@@ -762,6 +820,7 @@ int main() {
     test_identity_determinism();
     test_simple_legacy_and_holes();
     test_nested_cells_and_profile_lookup();
+    test_flat_pattern_cutouts_nest_in_one_outline();
     test_v2_bytes_are_frozen_and_v3_is_separate();
     test_v3_provenance_validation();
     test_v3_identity_is_scale_and_entity_order_invariant();
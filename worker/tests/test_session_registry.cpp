@@ -0,0 +1,148 @@
+// test_session_registry.cpp — several documents in one worker
+// (session/SessionRegistry.h). In-process, real OCCT.
+//
+// Pins:
+//   1. the default session always exists and `sessionId` parsing falls back to it;
+//   2. two named sessions keep independent heads, geometry and sketches (a plan
+//      published in one never shows in the other; a solver-lane upsert lands
+//      only in its own session's store);
+//   3. erase drops the handle, but a slot held by an in-flight request lives on;
+//   4. the registry is bounded (kMaxSessions, default included);
+//   5. a named session's stamp echoes `sessionId` on the wire.
+//
+// No framework: exit code == failure count.
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "session/PlanExecutor.h"
+#include "session/SessionRegistry.h"
+#include "session/Signatures.h"
+#include "util/Cancel.h"
+
+using nlohmann::json;
+using onecad::CancelToken;
+using onecad::protocol::Envelope;
+using onecad::protocol::HandlerContext;
+using onecad::session::Session;
+using onecad::session::SessionRegistry;
+using onecad::session::SessionSlot;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) { std::fprintf(stderr, "FAIL: %s\n", msg.c_str()); ++g_failures; }
+}
+constexpr const char* kEmpty =
+    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+json rect(double x1, double y1) {
+    return json::array({{{"id", "e1"}, {"type", "Line"}, {"p0", {0, 0}}, {"p1", {x1, 0}}},
+                        {{"id", "e2"}, {"type", "Line"}, {"p0", {x1, 0}}, {"p1", {x1, y1}}},
+                        {{"id", "e3"}, {"type", "Line"}, {"p0", {x1, y1}}, {"p1", {0, y1}}},
+                        {{"id", "e4"}, {"type", "Line"}, {"p0", {0, y1}}, {"p1", {0, 0}}}});
+}
+
+// Extrude a box into a from-0 head of `s`. Returns the head's geometry signature.
+std::string build_box(Session& s, double w, double h, double dist) {
+    json ops = json::array(
+        {json{{"opType", "Sketch"}, {"opId", "op0"}, {"stepIndex", 0},
+              {"params", {{"sketchId", "sk"}, {"plane", {{"kind", "XY"}}},
+                          {"entities", rect(w, h)}, {"constraints", json::array()}}}},
+         json{{"opType", "Extrude"}, {"opId", "op1"}, {"stepIndex", 1},
+              {"params", {{"sketchId", "sk"}, {"distance", dist}, {"extrudeMode", "Blind"},
+                          {"booleanMode", "NewBody"}}}}});
+    CancelToken tok;
+    HandlerContext ctx{tok, [](int) {}, [](Envelope&) {}};
+    json args = {{"jobId", 1}, {"documentRevision", 0}, {"workerEpoch", 3},
+                 {"expectedBaseHash", kEmpty}, {"prefixHashes", json::array({"a", "b"})},
+                 {"targetStep", 1}, {"ops", ops}};
+    onecad::session::handle_execute_plan(s, Envelope::request(1, "ExecutePlan", args), ctx);
+    onecad::session::handle_accept_prepared(
+        s, Envelope::request(1, "AcceptPrepared",
+                             json{{"jobId", 1}, {"documentRevision", 0}, {"workerEpoch", 3}}));
+    return onecad::session::geometry_signature(s.bodies_copy());
+}
+
+// ── 1. Default session + handle parsing ───────────────────────────────────────
+void test_default_session() {
+    SessionRegistry registry;
+    check(registry.size() == 1 && registry.find("") != nullptr, "the default session exists");
+    check(onecad::session::session_handle(Envelope::request(1, "GetWorkerHead")).empty(),
+          "no sessionId addresses the default session");
+    check(onecad::session::session_handle(
+              Envelope::request(1, "GetWorkerHead", json{{"sessionId", "doc_a"}})) == "doc_a",
+          "sessionId names the session");
+    check(registry.find("doc_a") == nullptr, "an unopened handle does not resolve");
+    check(!registry.erase(""), "the default session is never erased");
+}
+
+// ── 2–3. Independent sessions, slot lifetime ─────────────────────────────────
+void test_independent_sessions() {
+    SessionRegistry registry;
+    const std::shared_ptr<SessionSlot> a = registry.open("doc_a");
+    const std::shared_ptr<SessionSlot> b = registry.open("doc_b");
+    check(a && b && a != b && registry.size() == 3, "two named sessions open");
+    check(registry.open("doc_a") == a, "re-opening a handle returns its slot");
+
+    a->session.open("doc_a", 0, 3, "determinism");
+    b->session.open("doc_b", 0, 7, "determinism");
+    const std::string sig_a = build_box(a->session, 10, 10, 10);
+    check(!b->session.has_scratch() && b->session.bodies_copy().size() == 0,
+          "a plan in one session never touches another");
+    check(registry.head_stamp("doc_a").snapshot_id > 0 &&
+              registry.head_stamp("doc_b").snapshot_id == 0,
+          "each session stamps its own head");
+    check(registry.head_stamp("doc_b").worker_epoch == 7, "fencing tokens are per session");
+
+    const Envelope up = a->solver.handle(Envelope::request(
+        2, "SketchUpsert",
+        json{{"sessionId", "doc_a"}, {"sketchId", "s1"}, {"plane", {{"kind", "XY"}}},
+             {"entities", rect(4, 4)}, {"constraints", json::array()}}));
+    check(up.ok.value_or(false), "a session's solver lane upserts");
+    check(a->session.sketches().contains("s1") && !b->session.sketches().contains("s1"),
+          "sketches are per session");
+
+    // A request holding the slot keeps it alive across a CloseSession.
+    const std::shared_ptr<SessionSlot> in_flight = registry.find("doc_a");
+    check(registry.erase("doc_a") && registry.find("doc_a") == nullptr, "erase drops the handle");
+    check(onecad::session::geometry_signature(in_flight->session.bodies_copy()) == sig_a,
+          "an in-flight request still sees its session");
+    check(registry.head_stamp("doc_a").snapshot_id == 0, "a dropped handle stamps all-zero");
+}
+
+// ── 4. Bounded ───────────────────────────────────────────────────────────────
+void test_cap() {
+    SessionRegistry registry;
+    for (std::size_t i = 1; i < SessionRegistry::kMaxSessions; ++i) {
+        check(registry.open("doc_" + std::to_string(i)) != nullptr, "open below the cap");
+    }
+    check(registry.open("one_too_many") == nullptr, "the cap refuses a new session");
+    check(registry.open("doc_1") != nullptr, "an open handle still resolves at the cap");
+    registry.erase("doc_1");
+    check(registry.open("one_too_many") != nullptr, "closing frees a place");
+}
+
+// ── 5. Wire stamp ────────────────────────────────────────────────────────────
+void test_stamp_echo() {
+    Envelope resp = Envelope::ok_response(9, json{{"sessionOpen", true}});
+    resp.stamp.session_id = "doc_a";
+    const json wire = json::parse(onecad::protocol::serialize(resp));
+    check(wire.value("sessionId", std::string{}) == "doc_a", "the stamp echoes sessionId");
+    const json plain = json::parse(
+        onecad::protocol::serialize(Envelope::ok_response(9, json{{"sessionOpen", true}})));
+    check(!plain.contains("sessionId"), "the default session adds no field");
+}
+}  // namespace
+
+int main() {
+    test_default_session();
+    test_independent_sessions();
+    test_cap();
+    test_stamp_echo();
+    if (g_failures == 0) std::fprintf(stderr, "test_session_registry: OK\n");
+    return g_failures;
+}
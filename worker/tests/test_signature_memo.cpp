@@ -0,0 +1,91 @@
+// test_signature_memo.cpp — per-body metric memoization behind the geometry
+// signature (SCHEMA §12, session/Signatures.h). In-process, real OCCT.
+//
+// Pins:
+//   1. the memoized signature is byte-identical to the un-memoized fold;
+//   2. a store clone shares the memo, and a signature over the clone re-measures
+//      only the body it replaced;
+//   3. moving a body (same TShape, new location) invalidates its memo.
+//
+// No framework: exit code == failure count.
+#include <cstdio>
+#include <string>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+
+#include "session/BodyStore.h"
+#include "session/ShapeMetrics.h"
+#include "session/Signatures.h"
+
+namespace s = onecad::session;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) {
+        std::fprintf(stderr, "FAIL: %s\n", msg.c_str());
+        ++g_failures;
+    }
+}
+
+// The pre-memo fold, verbatim: the reference the memoized one must match.
+std::string reference_signature(const s::BodyStore& bodies) {
+    std::uint64_t h = onecad::hashing::kFnvOffset;
+    for (const auto& [id, rec] : bodies.all()) {
+        const s::ShapeMetrics m = s::compute_shape_metrics(rec.geom);
+        h = s::fold_str(h, id);
+        h = s::fold_u64(h, m.face_count);
+        h = s::fold_u64(h, m.edge_count);
+        h = s::fold_u64(h, m.vertex_count);
+        for (double c : m.bbox_min) h = s::fold_i64(h, s::quantize(c));
+        for (double c : m.bbox_max) h = s::fold_i64(h, s::quantize(c));
+        h = s::fold_i64(h, s::quantize(m.volume));
+    }
+    return onecad::hashing::hex16(h);
+}
+
+void test_memo() {
+    s::BodyStore head;
+    head.create("body_a", "op1", BRepPrimAPI_MakeBox(10.0, 20.0, 30.0).Shape());
+    head.create("body_b", "op2", BRepPrimAPI_MakeCylinder(5.0, 12.0).Shape());
+    head.create("body_c", "op3", BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Shape());
+
+    const std::string cold = s::geometry_signature(head);
+    check(cold == reference_signature(head), "memoized signature == reference fold");
+    const s::MetricsMemo* memo_a = head.get("body_a")->metrics_memo.get();
+    const s::MetricsMemo* memo_b = head.get("body_b")->metrics_memo.get();
+    check(memo_a != nullptr && memo_b != nullptr, "signature memoizes every body");
+    check(s::geometry_signature(head) == cold, "warm signature == cold signature");
+    check(head.get("body_a")->metrics_memo.get() == memo_a, "warm signature re-measures nothing");
+
+    // A scratch clone replacing one body: the others keep the head's memo.
+    s::BodyStore scratch = head;
+    scratch.create("body_b", "op4", BRepPrimAPI_MakeCylinder(6.0, 12.0).Shape());
+    const std::string edited = s::geometry_signature(scratch);
+    check(edited == reference_signature(scratch), "edited signature == reference fold");
+    check(edited != cold, "the edit changes the signature");
+    check(scratch.get("body_a")->metrics_memo.get() == memo_a,
+          "untouched body reuses the head's memo in the clone");
+    check(scratch.get("body_b")->metrics_memo.get() != memo_b, "replaced body re-measured");
+    check(head.get("body_b")->metrics_memo.get() == memo_b, "the head's memo is untouched");
+
+    // Same TShape, new location: the bbox moved, so the memo must not hit.
+    gp_Trsf shift;
+    shift.SetTranslation(gp_Vec(100.0, 0.0, 0.0));
+    s::BodyRecord* c = scratch.get_mut("body_c");
+    c->geom = c->geom.Moved(TopLoc_Location(shift));
+    check(s::geometry_signature(scratch) == reference_signature(scratch),
+          "a moved body is re-measured");
+    check(s::body_metrics(*c).bbox_min[0] > 99.0, "moved body's memo carries the new bbox");
+}
+}  // namespace
+
+int main() {
+    test_memo();
+    if (g_failures == 0) std::fprintf(stderr, "test_signature_memo: OK\n");
+    return g_failures;
+}
@@ -0,0 +1,184 @@
+// Drag decomposition — `SolverAdapter::solverComponents` and the per-component
+// drag solve behind `Sketch::dragComponent`.
+//
+// A sketch of independent profiles used to re-solve EVERY profile on every drag
+// step: one Jacobian over the whole sketch, one position diff over every point.
+// The entity–constraint graph splits it into connected components, and a drag
+// now builds, solves and reports only the component of what it drives.
+//
+// Pins:
+//   1. components follow ownership (line endpoints, circle centers) and
+//      constraints, nothing else;
+//   2. `dragComponent` is that component for seeds inside one, and nullopt (the
+//      whole-sketch fallback) for a one-component sketch or seeds spanning two;
+//   3. a component drag still propagates through its own constraints, and every
+//      other component is left bit-for-bit untouched;
+//   4. a constraint joining two profiles is picked up on the next drag (the
+//      component index is dropped with the solver).
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "sketch/Sketch.h"
+#include "sketch/SketchPoint.h"
+#include "sketch/WireSketch.h"
+#include "sketch/solver/SolverAdapter.h"
+
+using nlohmann::json;
+namespace sk = onecad::core::sketch;
+
+namespace {
+int g_failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message.c_str());
+        ++g_failures;
+    }
+}
+
+std::string uuid(unsigned int value) {
+    char out[37];
+    std::snprintf(out, sizeof(out), "00000000-0000-0000-0000-%012u", value);
+    return out;
+}
+
+json point_entity(unsigned int id, double x, double y) {
+    return {{"id", uuid(id)}, {"type", "Point"}, {"at", {x, y}}};
+}
+
+json line_entity(unsigned int id, unsigned int p0, unsigned int p1) {
+    return {{"id", uuid(id)}, {"type", "Line"}, {"p0Ref", uuid(p0)}, {"p1Ref", uuid(p1)}};
+}
+
+json unary_constraint(unsigned int id, const char* type, unsigned int entity) {
+    return {{"id", uuid(id)}, {"type", type}, {"entities", {uuid(entity)}}};
+}
+
+// An axis-aligned H/V rectangle, ids base+0..3 (corners, CCW from bottom-left),
+// base+10..13 (edges), base+20..23 (constraints).
+void add_rect(json& entities, json& constraints, unsigned int base, double ox, double w,
+              double h) {
+    entities.push_back(point_entity(base + 0, ox, 0));
+    entities.push_back(point_entity(base + 1, ox + w, 0));
+    entities.push_back(point_entity(base + 2, ox + w, h));
+    entities.push_back(point_entity(base + 3, ox, h));
+    for (unsigned int i = 0; i < 4; ++i) {
+        entities.push_back(line_entity(base + 10 + i, base + i, base + (i + 1) % 4));
+        constraints.push_back(
+            unary_constraint(base + 20 + i, i % 2 == 0 ? "Horizontal" : "Vertical", base + 10 + i));
+    }
+}
+
+onecad::wire::TranslateResult two_rects_and_a_point() {
+    json entities = json::array();
+    json constraints = json::array();
+    add_rect(entities, constraints, 100, 0, 10, 10);
+    add_rect(entities, constraints, 200, 50, 10, 10);
+    entities.push_back(point_entity(300, 100, 100));
+    return onecad::wire::translate({{"sketchId", "components"},
+                                    {"plane", {{"kind", "XY"}}},
+                                    {"entities", std::move(entities)},
+                                    {"constraints", std::move(constraints)}});
+}
+
+sk::EntityID point(const onecad::wire::TranslateResult& tr, unsigned int wire_id) {
+    return tr.index.resolve_point(uuid(wire_id), "");
+}
+
+std::unordered_map<sk::EntityID, std::pair<double, double>> positions(const sk::Sketch& sketch) {
+    std::unordered_map<sk::EntityID, std::pair<double, double>> out;
+    for (const auto& e : sketch.getAllEntities()) {
+        if (const auto* p = dynamic_cast<const sk::SketchPoint*>(e.get())) {
+            out[p->id()] = {p->position().X(), p->position().Y()};
+        }
+    }
+    return out;
+}
+
+// ── 1 + 2. Components and the drag scope ─────────────────────────────────────
+void test_components() {
+    onecad::wire::TranslateResult tr = two_rects_and_a_point();
+    check(tr.ok, "two rects translate: " + tr.error);
+    if (!tr.ok) return;
+
+    const auto components = sk::SolverAdapter::solverComponents(*tr.sketch);
+    check(components.size() == 3, "two rects + a lone point are three components (got " +
+                                      std::to_string(components.size()) + ")");
+    if (components.size() == 3) {
+        check(components[0].size() == 8 && components[1].size() == 8 &&
+                  components[2].size() == 1,
+              "each rect is its 4 corners + 4 edges; the point stands alone");
+    }
+
+    const auto a = tr.sketch->dragComponent({point(tr, 102)});
+    check(a.has_value() && a->size() == 8, "a corner's drag scope is its rectangle");
+    if (a) {
+        check(a->count(point(tr, 100)) == 1 && a->count(point(tr, 200)) == 0,
+              "the scope holds its own corners and none of the other rect's");
+        check(a->count(tr.index.wire_to_internal.at(uuid(110))) == 1,
+              "the scope holds the rect's lines");
+    }
+    check(!tr.sketch->dragComponent({point(tr, 102), point(tr, 202)}).has_value(),
+          "seeds spanning two components fall back to the whole sketch");
+
+    json entities = json::array();
+    json constraints = json::array();
+    add_rect(entities, constraints, 100, 0, 10, 10);
+    onecad::wire::TranslateResult one = onecad::wire::translate(
+        {{"sketchId", "one"}, {"plane", {{"kind", "XY"}}}, {"entities", entities},
+         {"constraints", constraints}});
+    check(one.ok && !one.sketch->dragComponent({one.index.resolve_point(uuid(100), "")}),
+          "a one-component sketch drags on the whole-sketch solver");
+}
+
+// ── 3. Propagation inside, nothing outside ───────────────────────────────────
+void test_component_drag_leaves_the_rest_alone() {
+    onecad::wire::TranslateResult tr = two_rects_and_a_point();
+    check(tr.ok, "two rects translate: " + tr.error);
+    if (!tr.ok) return;
+    tr.sketch->solve();
+    const auto before = positions(*tr.sketch);
+
+    const std::unordered_set<sk::EntityID> pins{point(tr, 100), point(tr, 103)};
+    const sk::SolveResult r =
+        tr.sketch->solveWithTargets({{point(tr, 102), sk::Vec2d{25.0, 10.0}}}, {}, pins);
+    check(r.success, "the component drag succeeds: " + r.errorMessage);
+
+    const auto after = positions(*tr.sketch);
+    const auto& br = after.at(point(tr, 101));
+    check(std::abs(br.first - 25.0) < 1e-4 && std::abs(br.second) < 1e-4,
+          "Vertical still carried the bottom-right corner to x = 25");
+    for (unsigned int id : {200u, 201u, 202u, 203u, 300u}) {
+        check(after.at(point(tr, id)) == before.at(point(tr, id)),
+              "point " + std::to_string(id) + " outside the component is untouched");
+    }
+}
+
+// ── 4. A new joining constraint is seen by the next drag ─────────────────────
+void test_joining_constraint_merges_components() {
+    onecad::wire::TranslateResult tr = two_rects_and_a_point();
+    check(tr.ok, "two rects translate: " + tr.error);
+    if (!tr.ok) return;
+    const auto separate = tr.sketch->dragComponent({point(tr, 102)});
+    check(separate.has_value() && separate->size() == 8, "separate before the join");
+
+    tr.sketch->addParallel(tr.index.wire_to_internal.at(uuid(110)),
+                           tr.index.wire_to_internal.at(uuid(210)));
+    const auto merged = tr.sketch->dragComponent({point(tr, 102)});
+    check(merged.has_value() && merged->size() == 16,
+          "a Parallel across the rects merges their components");
+}
+}  // namespace
+
+int main() {
+    test_components();
+    test_component_drag_leaves_the_rest_alone();
+    test_joining_constraint_merges_components();
+    if (g_failures == 0) std::fprintf(stderr, "test_sketch_components: OK\n");
+    return g_failures;
+}
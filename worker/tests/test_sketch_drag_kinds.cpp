@@ -124,7 +124,7 @@ struct Lane {
 
     // The committed wire, after EndGesture wrote the solved pose back.
     json stored(const char* sketch_id) {
-        auto s = store.snapshot(sketch_id);
+        auto s = store.pin(sketch_id);
         return s ? s->wire_args : json::object();
     }
 };
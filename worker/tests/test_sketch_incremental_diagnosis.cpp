@@ -0,0 +1,242 @@
+// Incremental upsert diagnosis — `Sketch::solveByComponent` and the lane's
+// per-sketch cache of component solves (`wire::ComponentKeys`).
+//
+// Every SketchUpsert used to solve the whole sketch and then diagnose it twice
+// more (DOF, redundancy), so adding one dimension to one profile of a large
+// sketch paid three full PlaneGCS diagnoses. An upsert now solves and diagnoses
+// each constraint-graph component on its own and takes every component it
+// carries unchanged from the sketch's last upsert.
+//
+// Pins:
+//   1. the per-component DOF, redundancy, conflicting set and success are what
+//      the whole-sketch path reports, on sketches mixing clean, redundant and
+//      conflicting profiles, a lone point, a circle and a free arc;
+//   2. the same content again re-solves nothing and writes back the solved pose;
+//      one dimension added re-solves only its own component;
+//   3. SketchUpsert through the dispatcher reports the same dof/state/conflicting
+//      on a cold and on a warm cache.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "protocol/SolverLane.h"
+#include "session/SketchStore.h"
+#include "sketch/Sketch.h"
+#include "sketch/SketchPoint.h"
+#include "sketch/WireSketch.h"
+
+using nlohmann::json;
+namespace sk = onecad::core::sketch;
+using onecad::protocol::Envelope;
+
+namespace {
+int g_failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message.c_str());
+        ++g_failures;
+    }
+}
+
+std::string uuid(unsigned int value) {
+    char out[37];
+    std::snprintf(out, sizeof(out), "00000000-0000-0000-0000-%012u", value);
+    return out;
+}
+
+json point_entity(unsigned int id, double x, double y) {
+    return {{"id", uuid(id)}, {"type", "Point"}, {"at", {x, y}}};
+}
+
+json line_entity(unsigned int id, unsigned int p0, unsigned int p1) {
+    return {{"id", uuid(id)}, {"type", "Line"}, {"p0Ref", uuid(p0)}, {"p1Ref", uuid(p1)}};
+}
+
+json unary_constraint(unsigned int id, const char* type, unsigned int entity) {
+    return {{"id", uuid(id)}, {"type", type}, {"entities", {uuid(entity)}}};
+}
+
+json distance(unsigned int id, unsigned int line, double value) {
+    return {{"id", uuid(id)}, {"type", "Distance"}, {"entities", {uuid(line)}}, {"value", value}};
+}
+
+// An H/V rectangle drawn slightly skewed (so its solve moves it), ids base+0..3
+// (corners), base+10..13 (edges), base+20..23 (H/V constraints).
+void add_rect(json& entities, json& constraints, unsigned int base, double ox) {
+    entities.push_back(point_entity(base + 0, ox, 0));
+    entities.push_back(point_entity(base + 1, ox + 10, 0.3));
+    entities.push_back(point_entity(base + 2, ox + 10.2, 10));
+    entities.push_back(point_entity(base + 3, ox, 9.8));
+    for (unsigned int i = 0; i < 4; ++i) {
+        entities.push_back(line_entity(base + 10 + i, base + i, base + (i + 1) % 4));
+        constraints.push_back(
+            unary_constraint(base + 20 + i, i % 2 == 0 ? "Horizontal" : "Vertical", base + 10 + i));
+    }
+}
+
+struct Parts {
+    bool redundant = false;    // rect 200 carries a duplicate Horizontal
+    bool conflicting = false;  // rect 300's opposite edges dimensioned 10 and 14
+    bool extra_dimension = false;  // rect 100's left edge dimensioned too
+};
+
+// Rect 100 (one Distance), rect 200, rect 300, a lone point, a circle with a
+// Radius and a free arc: six components.
+json sketch_wire(const Parts& parts) {
+    json entities = json::array();
+    json constraints = json::array();
+    add_rect(entities, constraints, 100, 0);
+    constraints.push_back(distance(130, 110, 10.0));
+    if (parts.extra_dimension) constraints.push_back(distance(131, 113, 10.0));
+    add_rect(entities, constraints, 200, 30);
+    if (parts.redundant) constraints.push_back(unary_constraint(230, "Horizontal", 210));
+    add_rect(entities, constraints, 300, 60);
+    if (parts.conflicting) {
+        constraints.push_back(distance(330, 310, 10.0));
+        constraints.push_back(distance(331, 312, 14.0));
+    }
+    entities.push_back(point_entity(400, 100, 100));
+    entities.push_back(
+        {{"id", uuid(500)}, {"type", "Circle"}, {"center", {120, 0}}, {"radius", 5}});
+    constraints.push_back({{"id", uuid(530)}, {"type", "Radius"}, {"entities", {uuid(500)}},
+                           {"value", 4.0}});
+    entities.push_back({{"id", uuid(600)}, {"type", "Arc"}, {"center", {140, 0}}, {"radius", 5},
+                        {"startAngle", 0.0}, {"endAngle", 1.5}});
+    return {{"sketchId", "parts"}, {"plane", {{"kind", "XY"}}}, {"entities", entities},
+            {"constraints", constraints}};
+}
+
+std::vector<std::string> wire_ids(const onecad::wire::TranslateResult& tr,
+                                  const std::vector<sk::ConstraintID>& ids) {
+    std::vector<std::string> out;
+    for (const auto& id : ids) out.push_back(tr.index.internal_constraint_to_wire.at(id));
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+sk::ComponentSolveResult by_component(const json& wire, onecad::wire::TranslateResult& tr,
+                                      const sk::ComponentSolveCache& previous,
+                                      sk::ComponentSolveCache& next) {
+    const onecad::wire::ComponentKeys keys(wire, tr.index);
+    return tr.sketch->solveByComponent(
+        [&keys](const std::vector<sk::EntityID>& entities,
+                const std::vector<sk::ConstraintID>& constraints) {
+            return keys(entities, constraints);
+        },
+        previous, next);
+}
+
+// ── 1. Per component == whole sketch ─────────────────────────────────────────
+void test_matches_the_whole_sketch() {
+    for (int mask = 0; mask < 4; ++mask) {
+        const Parts parts{(mask & 1) != 0, (mask & 2) != 0, false};
+        const json wire = sketch_wire(parts);
+        const std::string at = " (redundant " + std::to_string(parts.redundant) +
+                               ", conflicting " + std::to_string(parts.conflicting) + ")";
+        onecad::wire::TranslateResult whole = onecad::wire::translate(wire);
+        onecad::wire::TranslateResult split = onecad::wire::translate(wire);
+        check(whole.ok && split.ok, "the parts translate: " + whole.error);
+        if (!whole.ok || !split.ok) return;
+
+        const sk::SolveResult w = whole.sketch->solve();
+        const int dof = whole.sketch->getDegreesOfFreedom();
+        const auto conflicting = wire_ids(whole, whole.sketch->getConflictingConstraints());
+        const bool redundant = whole.sketch->hasRedundantConstraints();
+
+        sk::ComponentSolveCache next;
+        const sk::ComponentSolveResult c = by_component(wire, split, {}, next);
+        check(c.solvedComponents == 6 && c.reusedComponents == 0,
+              "a cold cache solves all six components" + at);
+        check(c.dof == dof, "the DOF is the whole sketch's: " + std::to_string(c.dof) + " vs " +
+                                std::to_string(dof) + at);
+        check(split.sketch->getDegreesOfFreedom() == dof, "getDegreesOfFreedom agrees" + at);
+        check(c.redundant == redundant, "the redundancy is the whole sketch's" + at);
+        check(c.solve.success == w.success, "success is the whole sketch's" + at);
+        check(wire_ids(split, c.solve.conflictingConstraints) == conflicting &&
+                  wire_ids(split, split.sketch->getConflictingConstraints()) == conflicting,
+              "the conflicting set is the whole sketch's" + at);
+        check(parts.conflicting == !conflicting.empty() && parts.redundant == redundant,
+              "the whole sketch sees what was planted" + at);
+    }
+}
+
+// ── 2. Reuse ─────────────────────────────────────────────────────────────────
+void test_reuses_unchanged_components() {
+    const json wire = sketch_wire({true, false, false});
+    onecad::wire::TranslateResult first = onecad::wire::translate(wire);
+    check(first.ok, "the parts translate: " + first.error);
+    if (!first.ok) return;
+    sk::ComponentSolveCache cache;
+    const sk::ComponentSolveResult cold = by_component(wire, first, {}, cache);
+    check(cache.size() == 6, "every component is cached");
+
+    onecad::wire::TranslateResult again = onecad::wire::translate(wire);
+    sk::ComponentSolveCache next;
+    const sk::ComponentSolveResult warm = by_component(wire, again, cache, next);
+    check(warm.solvedComponents == 0 && warm.reusedComponents == 6,
+          "the same content re-solves nothing");
+    check(warm.dof == cold.dof && warm.redundant == cold.redundant &&
+              warm.solve.success == cold.solve.success,
+          "the reused diagnosis is the cold one");
+    for (unsigned int id : {201u, 202u, 203u}) {
+        const auto* a = first.sketch->getEntityAs<sk::SketchPoint>(
+            first.index.resolve_point(uuid(id), ""));
+        const auto* b = again.sketch->getEntityAs<sk::SketchPoint>(
+            again.index.resolve_point(uuid(id), ""));
+        check(a && b && a->position().X() == b->position().X() &&
+                  a->position().Y() == b->position().Y(),
+              "a reused corner takes the solved position (" + std::to_string(id) + ")");
+    }
+
+    const json edited = sketch_wire({true, false, true});
+    onecad::wire::TranslateResult third = onecad::wire::translate(edited);
+    sk::ComponentSolveCache after;
+    const sk::ComponentSolveResult dim = by_component(edited, third, next, after);
+    check(dim.solvedComponents == 1 && dim.reusedComponents == 5,
+          "one dimension re-solves only its own rectangle");
+    check(dim.dof == cold.dof - 1, "the dimension removes one DOF");
+    check(after.size() == 6, "the cache follows the new content");
+}
+
+// ── 3. Through the verb ──────────────────────────────────────────────────────
+void test_upsert_reports_the_same_state() {
+    onecad::session::SketchStore store;
+    onecad::protocol::Dispatcher dispatcher;
+    onecad::protocol::SolverLane lane(store);
+    lane.register_verbs(dispatcher);
+    std::uint64_t next_id = 1;
+    const auto upsert = [&](const json& args) {
+        return dispatcher.dispatch_once(Envelope::request(next_id++, "SketchUpsert", args));
+    };
+
+    for (const Parts& parts : {Parts{false, true, false}, Parts{true, false, false}}) {
+        const json wire = sketch_wire(parts);
+        const Envelope cold = upsert(wire);
+        const Envelope warm = upsert(wire);
+        check(cold.ok.value_or(false) && warm.ok.value_or(false), "both upserts succeed");
+        for (const char* field : {"dof", "state", "conflicting"}) {
+            check(cold.result.value(field, json()) == warm.result.value(field, json()),
+                  std::string("a warm upsert reports the cold ") + field);
+        }
+        const std::string want = parts.conflicting ? "Conflicting" : "OverConstrained";
+        check(warm.result.value("state", std::string{}) == want, "the state is " + want);
+        const json conflicting = warm.result.value("conflicting", json::array());
+        check(conflicting.empty() != parts.conflicting,
+              "conflicting is non-empty iff a conflict was planted: " + conflicting.dump());
+    }
+}
+}  // namespace
+
+int main() {
+    test_matches_the_whole_sketch();
+    test_reuses_unchanged_components();
+    test_upsert_reports_the_same_state();
+    if (g_failures == 0) std::fprintf(stderr, "test_sketch_incremental_diagnosis: OK\n");
+    return g_failures;
+}
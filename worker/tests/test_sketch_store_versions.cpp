@@ -0,0 +1,159 @@
+// SketchStore versions — immutable, pinned, pre-translated committed sketches.
+//
+// The store used to hold each sketch as bare wire JSON: every reader copied it
+// under the mutex and translated it again (fresh UUIDs, a new WireIndex, and
+// for SketchRegions a full re-solve). A commit now installs an immutable,
+// reference-counted version carrying the solved sketch its writer built.
+//
+// Pins:
+//   1. a pinned version outlives the commits after it, unchanged, and a store
+//      copy shares the versions it copies;
+//   2. SketchUpsert and a converged EndGesture commit the solved sketch; an
+//      unconverged upsert commits none;
+//   3. SketchRegions answers the same from a committed sketch as from bare wire
+//      translated and solved on the spot.
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "protocol/SolverLane.h"
+#include "session/SketchStore.h"
+
+using nlohmann::json;
+using onecad::protocol::Envelope;
+using onecad::session::SketchStore;
+using onecad::session::SketchVersion;
+
+namespace {
+int g_failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message.c_str());
+        ++g_failures;
+    }
+}
+
+json point_entity(const char* id, double x, double y) {
+    return {{"id", id}, {"type", "Point"}, {"at", {x, y}}};
+}
+
+json line_ref(const char* id, const char* p0, const char* p1) {
+    return {{"id", id}, {"type", "Line"}, {"p0Ref", p0}, {"p1Ref", p1}};
+}
+
+// A skewed H/V rectangle, 20 wide; `height` dimensions its right edge (a
+// negative height conflicts with an equal-and-opposite left one).
+json rect(double height) {
+    json constraints = json::array(
+        {{{"id", "h0"}, {"type", "Horizontal"}, {"entities", {"l0"}}},
+         {{"id", "v1"}, {"type", "Vertical"}, {"entities", {"l1"}}},
+         {{"id", "h2"}, {"type", "Horizontal"}, {"entities", {"l2"}}},
+         {{"id", "v3"}, {"type", "Vertical"}, {"entities", {"l3"}}},
+         {{"id", "w"}, {"type", "Distance"}, {"entities", {"l0"}}, {"value", 20.0}},
+         {{"id", "h"}, {"type", "Distance"}, {"entities", {"l1"}},
+          {"value", std::abs(height)}}});
+    if (height < 0) {
+        constraints.push_back({{"id", "bad"}, {"type", "Distance"}, {"entities", {"l3"}},
+                               {"value", -height + 5}});
+    }
+    return {{"sketchId", "rect"},
+            {"plane", {{"kind", "XY"}}},
+            {"entities", json::array({point_entity("a", 0, 0), point_entity("b", 19, 0.5),
+                                      point_entity("c", 19.5, 9), point_entity("d", 0.3, 10),
+                                      line_ref("l0", "a", "b"), line_ref("l1", "b", "c"),
+                                      line_ref("l2", "c", "d"), line_ref("l3", "d", "a")})},
+            {"constraints", constraints}};
+}
+
+struct Lane {
+    SketchStore store;
+    onecad::protocol::Dispatcher dispatcher;
+    onecad::protocol::SolverLane lane{store};
+    std::uint64_t next_id = 1;
+
+    Lane() { lane.register_verbs(dispatcher); }
+
+    Envelope call(const char* verb, json args) {
+        return dispatcher.dispatch_once(Envelope::request(next_id++, verb, std::move(args)));
+    }
+};
+
+// SketchRegions on `lane`, and on a lane whose store holds the same committed
+// wire bare (no translated sketch), which must translate and solve it itself.
+void check_regions_match_bare_wire(Lane& lane, const std::string& what) {
+    const SketchVersion committed = lane.store.pin("rect");
+    if (!committed) return;
+    Lane bare;
+    bare.store.put("rect", committed->wire_args, committed->revision);
+    const Envelope a = lane.call("SketchRegions", {{"sketchId", "rect"}});
+    const Envelope b = bare.call("SketchRegions", {{"sketchId", "rect"}});
+    check(a.ok == b.ok && a.result == b.result,
+          what + ": SketchRegions answers as from bare wire: " + a.result.dump() + " vs " +
+              b.result.dump());
+}
+
+// ── 1. Versions ──────────────────────────────────────────────────────────────
+void test_pinned_versions_are_immutable() {
+    SketchStore store;
+    check(store.upsert("s", {{"n", 1}}) == 1, "the first commit is revision 1");
+    const SketchVersion first = store.pin("s");
+    check(store.upsert("s", {{"n", 2}}) == 2, "the second commit is revision 2");
+    const SketchVersion second = store.pin("s");
+    check(first && first->revision == 1 && first->wire_args == json{{"n", 1}},
+          "a pinned version is untouched by a later commit");
+    check(second && second->revision == 2 && second != first, "a commit is a new version");
+    check(!store.pin("missing"), "an unknown sketch pins nothing");
+
+    const SketchStore copy = store;
+    check(copy.pin("s") == second, "a store copy shares its versions");
+    store.clear();
+    check(!store.pin("s") && second->revision == 2, "clear drops versions, not pins");
+}
+
+// ── 2 + 3. What the solver lane commits ──────────────────────────────────────
+void test_lane_commits_the_solved_sketch() {
+    Lane lane;
+    const Envelope up = lane.call("SketchUpsert", rect(10));
+    check(up.ok.value_or(false), "the rectangle upserts");
+    const SketchVersion solved = lane.store.pin("rect");
+    check(solved && solved->translated.sketch &&
+              !solved->translated.index.wire_to_internal.empty(),
+          "a converged upsert commits its solved sketch");
+    check_regions_match_bare_wire(lane, "after SketchUpsert");
+
+    Envelope b = lane.call("BeginGesture", {{"sketchId", "rect"},
+                                            {"sketchRevision", 1},
+                                            {"gestureId", 7},
+                                            {"drag", {{"kind", "point"}, {"pointId", "c"}}}});
+    check(b.ok.value_or(false), "a corner drag begins");
+    lane.call("SolveDrag", {{"gestureId", 7}, {"seq", 1}, {"target", {26, 14}}});
+    const Envelope e = lane.call("EndGesture", {{"gestureId", 7}});
+    check(e.ok.value_or(false) && e.result.value("sketchRevision", 0) == 2, "the gesture ends");
+    const SketchVersion ended = lane.store.pin("rect");
+    check(ended && ended->revision == 2 && ended->translated.sketch,
+          "a converged gesture commits its sketch");
+    check(solved->revision == 1 && solved->translated.sketch,
+          "the pinned upsert version is still whole");
+    check_regions_match_bare_wire(lane, "after EndGesture");
+
+    const Envelope bad = lane.call("SketchUpsert", rect(-10));
+    check(bad.ok.value_or(false) && bad.result.value("state", std::string{}) == "Conflicting",
+          "the conflicting rectangle upserts");
+    const SketchVersion conflicting = lane.store.pin("rect");
+    check(conflicting && !conflicting->translated.sketch,
+          "an unconverged upsert commits no sketch");
+    check_regions_match_bare_wire(lane, "after a conflicting upsert");
+}
+}  // namespace
+
+int main() {
+    test_pinned_versions_are_immutable();
+    test_lane_commits_the_solved_sketch();
+    if (g_failures == 0) std::fprintf(stderr, "test_sketch_store_versions: OK\n");
+    return g_failures;
+}
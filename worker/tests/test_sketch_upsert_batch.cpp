@@ -0,0 +1,235 @@
+// SketchUpsertBatch — a document's sketches upserted in one request, solved on
+// a bounded pool and committed in request order (SolverLane::on_upsert_batch).
+//
+// Document open used to send one SketchUpsert per sketch, each translated,
+// solved and diagnosed in turn on the single solver-lane thread.
+//
+// Pins:
+//   1. a batch answers, stores and revisions exactly what the same sketches
+//      upserted one by one do (a repeated sketchId included);
+//   2. a bad entry fails alone and is not stored; the rest still commit;
+//   3. a missing `sketches` fails the request;
+//   4. the helper threads persist across batches and lanes: with tracing on,
+//      repeated batches on two lanes never add upsert threads (each new thread
+//      would keep a trace ring for good).
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "protocol/SolverLane.h"
+#include "session/SketchStore.h"
+#include "util/Trace.h"
+
+using nlohmann::json;
+using onecad::protocol::Envelope;
+
+namespace {
+int g_failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message.c_str());
+        ++g_failures;
+    }
+}
+
+json point_entity(const std::string& id, double x, double y) {
+    return {{"id", id}, {"type", "Point"}, {"at", {x, y}}};
+}
+
+// A skewed H/V rectangle with `dims` of its two side dimensions; every third
+// sketch also carries a conflicting third one.
+json rect_sketch(const std::string& sketch_id, int n, int dims) {
+    json entities = json::array();
+    json constraints = json::array();
+    const double w = 10.0 + n;
+    const double skew[4][2] = {{0, 0}, {w, 0.4}, {w + 0.3, 8}, {0.2, 7.7}};
+    for (int i = 0; i < 4; ++i) {
+        entities.push_back(point_entity("p" + std::to_string(i), skew[i][0], skew[i][1]));
+    }
+    for (int i = 0; i < 4; ++i) {
+        const std::string l = "l" + std::to_string(i);
+        entities.push_back({{"id", l}, {"type", "Line"}, {"p0Ref", "p" + std::to_string(i)},
+                            {"p1Ref", "p" + std::to_string((i + 1) % 4)}});
+        constraints.push_back(
+            {{"id", "hv" + std::to_string(i)}, {"type", i % 2 == 0 ? "Horizontal" : "Vertical"},
+             {"entities", {l}}});
+    }
+    if (dims > 0) {
+        constraints.push_back(
+            {{"id", "w"}, {"type", "Distance"}, {"entities", {"l0"}}, {"value", w}});
+    }
+    if (dims > 1) {
+        constraints.push_back(
+            {{"id", "h"}, {"type", "Distance"}, {"entities", {"l1"}}, {"value", 8.0}});
+    }
+    if (n % 3 == 2) {
+        constraints.push_back(
+            {{"id", "bad"}, {"type", "Distance"}, {"entities", {"l2"}}, {"value", w + 3}});
+    }
+    return {{"sketchId", sketch_id}, {"plane", {{"kind", "XY"}}}, {"entities", entities},
+            {"constraints", constraints}};
+}
+
+struct Lane {
+    onecad::session::SketchStore store;
+    onecad::protocol::Dispatcher dispatcher;
+    onecad::protocol::SolverLane lane{store};
+    std::uint64_t next_id = 1;
+
+    Lane() { lane.register_verbs(dispatcher); }
+
+    Envelope call(const char* verb, json args) {
+        return dispatcher.dispatch_once(Envelope::request(next_id++, verb, std::move(args)));
+    }
+};
+
+// ── 1. Batch == sequential ───────────────────────────────────────────────────
+void test_batch_matches_sequential_upserts() {
+    json sketches = json::array();
+    for (int n = 0; n < 24; ++n) {
+        sketches.push_back(rect_sketch("sk_" + std::to_string(n), n, n % 3));
+    }
+    // The same sketch twice: the later entry wins, at revision 2.
+    sketches.push_back(rect_sketch("sk_4", 30, 2));
+
+    Lane sequential;
+    std::vector<json> one_by_one;
+    for (const json& s : sketches) {
+        const Envelope r = sequential.call("SketchUpsert", s);
+        check(r.ok.value_or(false), "a sequential upsert succeeds");
+        one_by_one.push_back(r.result);
+    }
+
+    Lane batched;
+    const Envelope r = batched.call("SketchUpsertBatch", {{"sketches", sketches}});
+    check(r.ok.value_or(false), "the batch succeeds");
+    const json results = r.result.value("results", json::array());
+    check(results.size() == sketches.size(), "one result per sketch");
+    if (results.size() != sketches.size()) return;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        check(results[i] == one_by_one[i],
+              "result " + std::to_string(i) + " is the sequential one: " + results[i].dump() +
+                  " vs " + one_by_one[i].dump());
+    }
+    check(results.back().value("sketchRevision", 0) == 2, "a repeated sketch is at revision 2");
+
+    // Where a sketch keeps free DOF, WHICH solution PlaneGCS settles on follows
+    // its pointer-keyed parameter maps — two sequential upserts of it already
+    // store different poses — so its stored wire is compared only when solved
+    // to a unique pose.
+    for (std::size_t i = 0; i < sketches.size(); ++i) {
+        const std::string id = sketches[i]["sketchId"];
+        const auto a = sequential.store.pin(id);
+        const auto b = batched.store.pin(id);
+        check(a && b && a->revision == b->revision,
+              "the store holds the sequential revision of " + id);
+        if (a && b && results[i].value("state", std::string{}) == "FullyConstrained") {
+            check(a->wire_args == b->wire_args, "the store holds the sequential wire of " + id);
+        }
+    }
+
+    // The batch leaves the lane exactly where sequential upserts do: a later
+    // SketchUpsert of the same content answers the same.
+    const Envelope again = batched.call("SketchUpsert", sketches[7]);
+    const Envelope again_seq = sequential.call("SketchUpsert", sketches[7]);
+    check(again.result == again_seq.result, "a later upsert answers the same");
+}
+
+// ── 2 + 3. Failures ──────────────────────────────────────────────────────────
+void test_a_bad_sketch_fails_alone() {
+    Lane lane;
+    json broken = rect_sketch("sk_broken", 0, 1);
+    broken["entities"].push_back(
+        {{"id", "dangling"}, {"type", "Line"}, {"p0Ref", "p0"}, {"p1Ref", "nowhere"}});
+    json nameless = rect_sketch("", 1, 1);
+    nameless.erase("sketchId");
+    const json sketches = json::array(
+        {rect_sketch("sk_a", 0, 2), broken, nameless, rect_sketch("sk_b", 1, 1)});
+
+    const Envelope r = lane.call("SketchUpsertBatch", {{"sketches", sketches}});
+    check(r.ok.value_or(false), "a batch with bad entries still succeeds");
+    const json results = r.result.value("results", json::array());
+    check(results.size() == 4, "one result per sketch");
+    if (results.size() != 4) return;
+    check(results[0].value("upserted", false) && results[3].value("upserted", false),
+          "the good sketches are upserted");
+    for (std::size_t i : {std::size_t{1}, std::size_t{2}}) {
+        check(!results[i].value("upserted", true) && results[i].contains("error") &&
+                  results[i]["error"].value("code", std::string{}) == "OP_FAILED",
+              "entry " + std::to_string(i) + " fails with OP_FAILED");
+    }
+    check(results[1].value("sketchId", std::string{}) == "sk_broken",
+          "a failed entry names its sketch");
+    check(!lane.store.contains("sk_broken"), "a failed sketch is not stored");
+    check(lane.store.contains("sk_a") && lane.store.contains("sk_b"),
+          "the others are stored");
+
+    check(!lane.call("SketchUpsertBatch", json::object()).ok.value_or(true),
+          "a batch without sketches fails");
+}
+
+// ── 4. The pool persists ─────────────────────────────────────────────────────
+// Trace thread ids named "upsert" in a dump of every ring so far.
+std::set<int> upsert_threads() {
+    const std::string path =
+        "/tmp/onecad_test_upsert_batch_" + std::to_string(::getpid()) + ".json";
+    std::string error;
+    std::set<int> tids;
+    check(onecad::trace::write_chrome_trace(path, error) >= 0, "the trace dumps: " + error);
+    std::ifstream in(path);
+    const json dump = json::parse(in, nullptr, /*allow_exceptions=*/false);
+    ::unlink(path.c_str());
+    if (!dump.is_object() || !dump.contains("traceEvents")) return tids;
+    for (const json& ev : dump["traceEvents"]) {
+        if (ev.value("ph", "") == "M" && ev.value("name", "") == "thread_name" &&
+            ev["args"].value("name", "") == "upsert") {
+            tids.insert(ev.value("tid", 0));
+        }
+    }
+    return tids;
+}
+
+void test_pool_threads_persist() {
+    onecad::trace::enable();
+    json sketches = json::array();
+    for (int n = 0; n < 24; ++n) {
+        sketches.push_back(rect_sketch("sk_" + std::to_string(n), n, 2));
+    }
+    Lane first;
+    Lane second;
+    check(first.call("SketchUpsertBatch", {{"sketches", sketches}}).ok.value_or(false),
+          "the first traced batch succeeds");
+    const std::set<int> after_one = upsert_threads();
+    for (int round = 0; round < 4; ++round) {
+        check(first.call("SketchUpsertBatch", {{"sketches", sketches}}).ok.value_or(false) &&
+                  second.call("SketchUpsertBatch", {{"sketches", sketches}}).ok.value_or(false),
+              "repeated traced batches succeed");
+    }
+    const std::set<int> after_all = upsert_threads();
+    onecad::trace::disable();
+    // A pool thread may record its first span in a later batch (a helper that
+    // claimed no sketch records none), but there are never more of them.
+    check(after_all.size() <= 3, "at most kUpsertBatchWorkers - 1 upsert threads (saw " +
+                                     std::to_string(after_all.size()) + ")");
+    for (int tid : after_one) {
+        check(after_all.count(tid) == 1, "a later batch reuses the earlier batch's threads");
+    }
+}
+}  // namespace
+
+int main() {
+    test_batch_matches_sequential_upserts();
+    test_a_bad_sketch_fails_alone();
+    test_pool_threads_persist();
+    if (g_failures == 0) std::fprintf(stderr, "test_sketch_upsert_batch: OK\n");
+    return g_failures;
+}
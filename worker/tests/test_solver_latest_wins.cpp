@@ -10,24 +10,44 @@
 //     sizeable sketch so each solve out-runs the send loop.
 //   * the highest-seq drag ALWAYS resolves (nothing newer can supersede it).
 //
+// Then, in process (a Dispatcher + SolverLane over pipes), the drag ALREADY
+// RUNNING is superseded: a newer drag cancels it (CANCELLED/superseded, counted
+// as `drags.interrupted`) and the newer one is answered. The running drag is
+// held at a gate until the cancel has landed, so which drag is in flight when
+// the newer one arrives is fixed rather than raced against the solve's time.
+// On a sketch long enough that one substep outlasts 1 ms, a step over its
+// `budgetMs` comes back `partial`, not late, and an EndGesture commit over its
+// budget is rolled back to the pose last reported instead of committing part
+// of the way.
+//
 // No test framework: exit code == failure count. Usage: test_solver_latest_wins
 // <worker-path>.
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <future>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
 #include "protocol/Envelope.h"
 #include "protocol/Frame.h"
+#include "protocol/SolverLane.h"
+#include "session/SketchStore.h"
 
 using nlohmann::json;
+using onecad::protocol::Dispatcher;
 using onecad::protocol::Envelope;
 using onecad::protocol::Frame;
+using onecad::protocol::HandlerContext;
 using onecad::protocol::ReadStatus;
+using onecad::protocol::SolverLane;
 
 namespace {
 int g_failures = 0;
@@ -79,7 +99,7 @@ bool recv(const Worker& w, json& out) {
 // Consistent H/V staircase chain: seg i horizontal (even) / vertical (odd),
 // each length 10, joined by Coincident. Distinct endpoints so Coincident is
 // exercised. Returns the SketchUpsert args.
-json make_chain(int nseg) {
+json make_chain(int nseg, const std::string& sketch_id = "chain") {
     json ents = json::array();
     json cons = json::array();
     double x = 0, y = 0;
@@ -105,10 +125,113 @@ json make_chain(int nseg) {
         prev_end = e;
         x = ex; y = ey;
     }
-    return {{"sketchId", "chain"}, {"plane", {{"kind", "XY"}}},
+    return {{"sketchId", sketch_id}, {"plane", {{"kind", "XY"}}},
             {"entities", ents}, {"constraints", cons}};
 }
 
+// Where a drag response (or the EndGesture commit) puts `id`: its entry in the
+// reported `positions` delta if it moved, else `fallback`.
+std::pair<double, double> moved_to(const json& resp, const std::string& id,
+                                   std::pair<double, double> fallback) {
+    if (!resp.contains("result") || !resp["result"].contains("positions")) return fallback;
+    const json& positions = resp["result"]["positions"];
+    if (!positions.contains(id)) return fallback;
+    return {positions[id][0].get<double>(), positions[id][1].get<double>()};
+}
+
+// The in-flight half: a Dispatcher + SolverLane in this process, driven over
+// pipes exactly like the worker's stdin/stdout.
+void in_flight_supersession() {
+    constexpr std::uint64_t kGatedDrag = 400;
+    onecad::session::SketchStore store;
+    SolverLane lane(store);
+    Dispatcher dispatcher;
+    std::promise<void> gated_started;
+    for (const std::string& verb : SolverLane::verbs()) {
+        dispatcher.register_solver_verb(
+            verb, [&](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext& ctx) {
+                // The gate: drag 400 says it is running, then solves only once
+                // the Dispatcher has cancelled it (the timeout is a hang guard).
+                if (r.id == kGatedDrag) {
+                    gated_started.set_value();
+                    const auto give_up =
+                        std::chrono::steady_clock::now() + std::chrono::seconds(30);
+                    while (!ctx.cancel.cancelled() &&
+                           std::chrono::steady_clock::now() < give_up) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    CHECK(ctx.cancel.cancelled());
+                }
+                return lane.handle(r, &ctx.cancel);
+            });
+    }
+    dispatcher.register_solver_verb(
+        "GetWorkerStats", [&dispatcher](const Envelope& r, const std::vector<std::uint8_t>&,
+                                        HandlerContext&) {
+            return Envelope::ok_response(r.id, dispatcher.stats_json());
+        });
+
+    int p2d[2], d2p[2];
+    if (pipe(p2d) != 0 || pipe(d2p) != 0) { CHECK(false); return; }
+    std::thread lane_thread([&] {
+        dispatcher.run(p2d[0], d2p[1]);
+        close(d2p[1]);
+    });
+    Worker w;
+    w.to = p2d[1];
+    w.from = d2p[0];
+
+    json resp;
+    send(w, Envelope::request(4, "SketchUpsert", make_chain(500, "long")));
+    CHECK(recv(w, resp) && resp.value("ok", false));
+    send(w, Envelope::request(5, "BeginGesture",
+                              json{{"sketchId", "long"}, {"sketchRevision", 1}, {"gestureId", 2},
+                                   {"drag", {{"pointId", "s0"}}}}));
+    CHECK(recv(w, resp) && resp.value("ok", false));
+
+    send(w, Envelope::request(kGatedDrag, "SolveDrag",
+                              json{{"gestureId", 2}, {"seq", 1}, {"pointId", "s0"},
+                                   {"target", {-900.0, -900.0}}, {"budgetMs", 60000}}));
+    gated_started.get_future().wait();
+    send(w, Envelope::request(401, "SolveDrag",
+                              json{{"gestureId", 2}, {"seq", 2}, {"pointId", "s0"},
+                                   {"target", {-1.0, -1.0}}}));
+    json running, newer;
+    CHECK(recv(w, running) && recv(w, newer));
+    CHECK(running.value("id", std::uint64_t{0}) == kGatedDrag && !running.value("ok", true));
+    CHECK(running.contains("error") && running["error"].value("code", "") == "CANCELLED" &&
+          running["error"].value("message", "") == "superseded");
+    CHECK(newer.value("id", 0) == 401 && newer.value("ok", false));
+    std::pair<double, double> s0 = moved_to(newer, "s0", {0.0, 0.0});
+
+    // A 1 ms budget cannot fit one substep of this chain: rolled back, `partial`.
+    send(w, Envelope::request(402, "SolveDrag",
+                              json{{"gestureId", 2}, {"seq", 3}, {"pointId", "s0"},
+                                   {"target", {900.0, 900.0}}, {"budgetMs", 1}}));
+    CHECK(recv(w, resp) && resp.value("ok", false) && resp.contains("result") &&
+          resp["result"].value("status", "") == "partial");
+    s0 = moved_to(resp, "s0", s0);
+
+    send(w, Envelope::request(6, "GetWorkerStats"));
+    CHECK(recv(w, resp) && resp.value("ok", false) &&
+          resp["result"]["drags"].value("interrupted", 0) >= 1);
+
+    // Nor one substep of the commit: it is rolled back whole and the gesture
+    // commits where the last step left s0, not part of the way to the target.
+    send(w, Envelope::request(7, "EndGesture",
+                              json{{"gestureId", 2}, {"budgetMs", 1},
+                                   {"commit", {{"finalTarget", {900.0, 900.0}}}}}));
+    CHECK(recv(w, resp) && resp.value("ok", false) &&
+          resp["result"].value("status", "") == "partial");
+    const auto committed = moved_to(resp, "s0", {0.0, 0.0});
+    CHECK(std::abs(committed.first - s0.first) < 1e-9 &&
+          std::abs(committed.second - s0.second) < 1e-9);
+
+    close(w.to);
+    lane_thread.join();
+    close(w.from);
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -176,6 +299,8 @@ int main(int argc, char** argv) {
     waitpid(w.pid, &status, 0);
     close(w.from);
 
+    in_flight_supersession();
+
     if (g_failures == 0) std::fprintf(stderr, "solver latest-wins: OK\n");
     return g_failures;
 }
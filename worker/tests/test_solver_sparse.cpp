@@ -0,0 +1,385 @@
+// Sparse solve path — `SolverConfig::sparseThreshold` and PlaneGCS's
+// GCSSparse.cpp.
+//
+// Every PlaneGCS subsystem used to factor a dense Jacobian, and the rank
+// diagnosis a dense QR, so a 1000-entity sketch spent seconds per solve on
+// zeros. From `sparseThreshold` parameters on, the same loops run on sparse
+// factorizations; below it nothing changes.
+//
+// Pins, each solved once with the threshold at 0 (always dense) and once at 1
+// (always sparse) on separately translated copies of the same sketch:
+//   1. a plain solve of a perturbed chain lands on the same shape;
+//   2. a drag (soft targets: the SQP path) lands on the same pose;
+//   3. the diagnosis agrees on DOF, redundancy and the conflicting set;
+//   4. a fully constrained chain of arcs and concentric circles solves to the
+//      same pose, and a drag of its free-floating copy to the same pose too;
+//   5. under-constrained: both paths agree on the DOF and both satisfy every
+//      constraint, though each may settle the free DOF its own way;
+//   6. over-constrained arcs and circles: the same redundancy and the same
+//      conflicting set.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "sketch/Sketch.h"
+#include "sketch/SketchPoint.h"
+#include "sketch/WireSketch.h"
+#include "sketch/solver/ConstraintSolver.h"
+#include "sketch/solver/SolverAdapter.h"
+
+using nlohmann::json;
+namespace sk = onecad::core::sketch;
+
+namespace {
+int g_failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", message.c_str());
+        ++g_failures;
+    }
+}
+
+// An H/V staircase of `nseg` 10 mm segments drawn 8-12 mm long, so the first
+// solve has work to do. `extra` constraints are appended as given.
+json staircase(int nseg, const json& extra = json::array()) {
+    json entities = json::array();
+    json constraints = json::array();
+    double x = 0.0;
+    double y = 0.0;
+    for (int i = 0; i < nseg; ++i) {
+        const std::string n = std::to_string(i);
+        const bool horizontal = i % 2 == 0;
+        const double drawn = 8.0 + (i % 5);
+        const double ex = horizontal ? x + drawn : x + 0.3;
+        const double ey = horizontal ? y - 0.2 : y + drawn;
+        entities.push_back({{"id", "s" + n}, {"type", "Point"}, {"at", {x, y}}});
+        entities.push_back({{"id", "e" + n}, {"type", "Point"}, {"at", {ex, ey}}});
+        entities.push_back({{"id", "L" + n}, {"type", "Line"}, {"p0Ref", "s" + n},
+                            {"p1Ref", "e" + n}});
+        constraints.push_back({{"id", "d" + n}, {"type", "Distance"}, {"entities", {"L" + n}},
+                               {"value", 10.0}});
+        constraints.push_back({{"id", "hv" + n},
+                               {"type", horizontal ? "Horizontal" : "Vertical"},
+                               {"entities", {"L" + n}}});
+        if (i > 0) {
+            const std::string prev = "e" + std::to_string(i - 1);
+            constraints.push_back({{"id", "c" + n}, {"type", "Coincident"},
+                                   {"entities", {prev, "s" + n}}, {"positions", {"", ""}}});
+        }
+        x = ex + 0.5;
+        y = ey - 0.4;
+    }
+    for (const json& c : extra) constraints.push_back(c);
+    return {{"sketchId", "stairs"}, {"plane", {{"kind", "XY"}}}, {"entities", entities},
+            {"constraints", constraints}};
+}
+
+sk::SolverConfig with_threshold(int params) {
+    sk::SolverConfig config;
+    config.sparseThreshold = params;
+    return config;
+}
+
+// A chain of `n` semicircular arcs, each starting where the last one ends, with
+// their centres on one horizontal line and a circle concentric with each, drawn
+// off their constrained radii. Fully constrained when `anchored` (arc 0's
+// centre Fixed); free to translate otherwise. `extra` constraints are appended.
+json beads(int n, bool anchored = true, const json& extra = json::array()) {
+    json entities = json::array();
+    json constraints = json::array();
+    for (int i = 0; i < n; ++i) {
+        const std::string a = "a" + std::to_string(i);
+        const std::string k = "k" + std::to_string(i);
+        const double jitter = 0.3 * ((i % 3) - 1);
+        entities.push_back({{"id", a}, {"type", "Arc"}, {"center", {10.0 * i + jitter, -jitter}},
+                            {"radius", 5.0 + jitter}, {"startAngle", 3.1}, {"endAngle", 0.04}});
+        entities.push_back({{"id", k}, {"type", "Circle"}, {"center", {10.0 * i, jitter}},
+                            {"radius", 2.0 - jitter}});
+        constraints.push_back({{"id", "r" + a}, {"type", "Radius"}, {"entities", {a}},
+                               {"value", 5.0}});
+        constraints.push_back({{"id", "r" + k}, {"type", "Radius"}, {"entities", {k}},
+                               {"value", 2.0}});
+        constraints.push_back({{"id", "o" + k}, {"type", "Concentric"}, {"entities", {a, k}}});
+        constraints.push_back({{"id", "he" + a}, {"type", "HorizontalPoints"},
+                               {"entities", {a, a}}, {"positions", {"center", "end"}}});
+        if (i == 0) {
+            constraints.push_back({{"id", "hs" + a}, {"type", "HorizontalPoints"},
+                                   {"entities", {a, a}}, {"positions", {"center", "start"}}});
+        } else {
+            const std::string prev = "a" + std::to_string(i - 1);
+            constraints.push_back({{"id", "j" + a}, {"type", "Coincident"},
+                                   {"entities", {prev, a}}, {"positions", {"end", "start"}}});
+            constraints.push_back({{"id", "hc" + a}, {"type", "HorizontalPoints"},
+                                   {"entities", {prev, a}}, {"positions", {"center", "center"}}});
+        }
+    }
+    if (anchored) {
+        constraints.push_back({{"id", "fix"}, {"type", "Fixed"}, {"entities", {"a0"}},
+                               {"positions", {"center"}}});
+    }
+    for (const json& c : extra) constraints.push_back(c);
+    return {{"sketchId", "beads"}, {"plane", {{"kind", "XY"}}}, {"entities", entities},
+            {"constraints", constraints}};
+}
+
+// Point handle -> solved position: every Point entity and every synthesized
+// child (line endpoints, arc and circle centres, arc ends).
+std::unordered_map<std::string, sk::Vec2d> points(const onecad::wire::TranslateResult& tr) {
+    std::unordered_map<std::string, sk::Vec2d> out;
+    for (const auto& [wire, internal] : tr.index.handle_to_point) {
+        if (const auto* p = tr.sketch->getEntityAs<sk::SketchPoint>(internal)) {
+            out[wire] = sk::Vec2d{p->position().X(), p->position().Y()};
+        }
+    }
+    return out;
+}
+
+// Every point at the same place, measured from `origin` when one is given (a
+// solve with free DOF may settle the whole shape elsewhere).
+bool same_pose(const onecad::wire::TranslateResult& a, const onecad::wire::TranslateResult& b,
+               const std::string& origin = "") {
+    const auto pa = points(a);
+    const auto pb = points(b);
+    if (pa.size() != pb.size()) return false;
+    const sk::Vec2d oa = origin.empty() ? sk::Vec2d{} : pa.at(origin);
+    const sk::Vec2d ob = origin.empty() ? sk::Vec2d{} : pb.at(origin);
+    for (const auto& [id, at] : pa) {
+        const auto it = pb.find(id);
+        if (it == pb.end() || std::abs((it->second.x - ob.x) - (at.x - oa.x)) > 1e-6 ||
+            std::abs((it->second.y - ob.y) - (at.y - oa.y)) > 1e-6) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// One translated copy of `wire` with its own solver at `threshold`.
+struct Run {
+    onecad::wire::TranslateResult tr;
+    sk::ConstraintSolver solver;
+
+    Run(const json& wire, int threshold)
+        : tr(onecad::wire::translate(wire)), solver(with_threshold(threshold)) {
+        check(tr.ok, "the sketch translates: " + tr.error);
+        if (tr.ok) {
+            check(sk::SolverAdapter::populateSolver(*tr.sketch, solver),
+                  "the sketch populates the solver");
+        }
+    }
+};
+
+// ── 1. A plain solve ─────────────────────────────────────────────────────────
+void test_solve_matches_dense() {
+    Run dense(staircase(40), 0);
+    Run sparse(staircase(40), 1);
+    if (!dense.tr.ok || !sparse.tr.ok) return;
+
+    const sk::SolverResult rd = dense.solver.solve();
+    const sk::SolverResult rs = sparse.solver.solve();
+    check(rd.success && rs.success, "both solves succeed: " + rd.errorMessage + " / " +
+                                        rs.errorMessage);
+    dense.solver.applySolution();
+    sparse.solver.applySolution();
+    // The staircase is free to translate, and the two DogLeg Gauss steps pick
+    // different translations (dense: an LU solution; sparse: the least-norm one).
+    check(same_pose(dense.tr, sparse.tr, "s0"), "the sparse solve lands on the dense shape");
+}
+
+// ── 2. A drag ────────────────────────────────────────────────────────────────
+void test_drag_matches_dense() {
+    Run dense(staircase(40), 0);
+    Run sparse(staircase(40), 1);
+    if (!dense.tr.ok || !sparse.tr.ok) return;
+    check(dense.solver.solve().success && sparse.solver.solve().success, "both settle");
+    dense.solver.applySolution();
+    sparse.solver.applySolution();
+
+    const auto drag = [](Run& run) {
+        const sk::EntityID tip = run.tr.index.resolve_point("e39", "");
+        return run.solver.solveWithGroupDrag({{tip, sk::Vec2d{180.0, 230.0}}});
+    };
+    const sk::SolverResult rd = drag(dense);
+    const sk::SolverResult rs = drag(sparse);
+    check(rd.success && rs.success, "both drags succeed: " + rd.errorMessage + " / " +
+                                        rs.errorMessage);
+    dense.solver.applySolution();
+    sparse.solver.applySolution();
+    check(same_pose(dense.tr, sparse.tr), "the sparse drag lands on the dense pose");
+}
+
+// ── 3. The diagnosis ─────────────────────────────────────────────────────────
+std::vector<std::string> conflicting(const Run& run, const sk::SolverResult& r) {
+    std::vector<std::string> out;
+    for (const auto& id : r.conflictingConstraints) {
+        out.push_back(run.tr.index.internal_constraint_to_wire.at(id));
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+void test_diagnosis_matches_dense() {
+    const json redundant = staircase(
+        40, json::array({{{"id", "dup"}, {"type", "Horizontal"}, {"entities", {"L4"}}}}));
+    Run dense(redundant, 0);
+    Run sparse(redundant, 1);
+    if (!dense.tr.ok || !sparse.tr.ok) return;
+    const int dof = dense.solver.diagnose();
+    check(dof == 2, "a free staircase keeps its translation (DOF " + std::to_string(dof) + ")");
+    check(sparse.solver.diagnose() == dof, "the sparse diagnosis agrees on DOF");
+    check(dense.solver.hasRedundant() && sparse.solver.hasRedundant(),
+          "both diagnoses see the duplicate Horizontal");
+
+    const json conflict = staircase(
+        40, json::array({{{"id", "bad"}, {"type", "Distance"}, {"entities", {"L7"}},
+                          {"value", 12.0}}}));
+    Run dense_c(conflict, 0);
+    Run sparse_c(conflict, 1);
+    if (!dense_c.tr.ok || !sparse_c.tr.ok) return;
+    const sk::SolverResult rd = dense_c.solver.solve();
+    const sk::SolverResult rs = sparse_c.solver.solve();
+    const auto cd = conflicting(dense_c, rd);
+    check(!rd.success && !cd.empty(), "the dense solve reports the conflict");
+    check(!rs.success && conflicting(sparse_c, rs) == cd,
+          "the sparse diagnosis names the same conflicting constraints");
+}
+// ── 4. Arcs and circles ──────────────────────────────────────────────────────
+void test_curves_match_dense() {
+    Run dense(beads(20), 0);
+    Run sparse(beads(20), 1);
+    if (!dense.tr.ok || !sparse.tr.ok) return;
+    const int dof = dense.solver.diagnose();
+    check(dof == 0, "the anchored bead chain is fully constrained (DOF " + std::to_string(dof) +
+                        ")");
+    check(sparse.solver.diagnose() == dof, "the sparse diagnosis agrees on the beads' DOF");
+    const sk::SolverResult rd = dense.solver.solve();
+    const sk::SolverResult rs = sparse.solver.solve();
+    check(rd.success && rs.success, "both bead solves succeed: " + rd.errorMessage + " / " +
+                                        rs.errorMessage);
+    dense.solver.applySolution();
+    sparse.solver.applySolution();
+    check(same_pose(dense.tr, sparse.tr), "the sparse bead solve lands on the dense pose");
+
+    // Free-floating, the chain only translates: pulling its last arc's end pins
+    // the translation, so both paths must land on one pose.
+    Run dense_free(beads(20, /*anchored=*/false), 0);
+    Run sparse_free(beads(20, /*anchored=*/false), 1);
+    if (!dense_free.tr.ok || !sparse_free.tr.ok) return;
+    check(dense_free.solver.solve().success && sparse_free.solver.solve().success,
+          "both free bead chains settle");
+    dense_free.solver.applySolution();
+    sparse_free.solver.applySolution();
+    const auto drag = [](Run& run) {
+        const sk::EntityID tip = run.tr.index.resolve_point("a19", "end");
+        return run.solver.solveWithGroupDrag({{tip, sk::Vec2d{220.0, 40.0}}});
+    };
+    const sk::SolverResult dd = drag(dense_free);
+    const sk::SolverResult ds = drag(sparse_free);
+    check(dd.success && ds.success, "both bead drags succeed: " + dd.errorMessage + " / " +
+                                        ds.errorMessage);
+    dense_free.solver.applySolution();
+    sparse_free.solver.applySolution();
+    const sk::Vec2d tip = points(sparse_free.tr).at("a19.end");
+    check(std::abs(tip.x - 220.0) < 1e-6 && std::abs(tip.y - 40.0) < 1e-6,
+          "the bead drag reaches its target");
+    check(same_pose(dense_free.tr, sparse_free.tr), "the sparse bead drag lands on the dense pose");
+}
+
+// ── 5. Under-constrained ─────────────────────────────────────────────────────
+// Every staircase segment 10 mm long and every joint closed.
+bool lengths_hold(const Run& run, int nseg) {
+    const auto at = points(run.tr);
+    for (int i = 0; i < nseg; ++i) {
+        const sk::Vec2d s = at.at("s" + std::to_string(i));
+        const sk::Vec2d e = at.at("e" + std::to_string(i));
+        if (std::abs(std::hypot(e.x - s.x, e.y - s.y) - 10.0) > 1e-6) return false;
+        if (i == 0) continue;
+        const sk::Vec2d prev = at.at("e" + std::to_string(i - 1));
+        if (std::hypot(s.x - prev.x, s.y - prev.y) > 1e-6) return false;
+    }
+    return true;
+}
+
+void test_underconstrained_matches_dense() {
+    // The staircase without its Horizontal/Vertical constraints: every segment
+    // keeps its length but is free to turn.
+    json wire = staircase(40);
+    json kept = json::array();
+    for (const json& c : wire["constraints"]) {
+        if (c["id"].get<std::string>().rfind("hv", 0) != 0) kept.push_back(c);
+    }
+    wire["constraints"] = kept;
+    Run dense(wire, 0);
+    Run sparse(wire, 1);
+    if (!dense.tr.ok || !sparse.tr.ok) return;
+    const int dof = dense.solver.diagnose();
+    check(dof == 42, "a free-jointed staircase keeps a turn per segment and its translation (DOF " +
+                         std::to_string(dof) + ")");
+    check(sparse.solver.diagnose() == dof, "the sparse diagnosis agrees on the free DOF");
+    check(dense.solver.solve().success && sparse.solver.solve().success,
+          "both under-constrained solves succeed");
+    dense.solver.applySolution();
+    sparse.solver.applySolution();
+    check(lengths_hold(dense, 40), "the dense solve satisfies every constraint");
+    check(lengths_hold(sparse, 40), "the sparse solve satisfies every constraint");
+
+    // The bead chain without its anchor or its arcs' end constraints.
+    json beads_wire = beads(20, /*anchored=*/false);
+    json beads_kept = json::array();
+    for (const json& c : beads_wire["constraints"]) {
+        if (c["id"].get<std::string>().rfind("he", 0) != 0) beads_kept.push_back(c);
+    }
+    beads_wire["constraints"] = beads_kept;
+    Run dense_beads(beads_wire, 0);
+    Run sparse_beads(beads_wire, 1);
+    if (!dense_beads.tr.ok || !sparse_beads.tr.ok) return;
+    const int beads_dof = dense_beads.solver.diagnose();
+    check(beads_dof == 22, "loose beads keep an end angle each and their translation (DOF " +
+                               std::to_string(beads_dof) + ")");
+    check(sparse_beads.solver.diagnose() == beads_dof,
+          "the sparse diagnosis agrees on the loose beads' DOF");
+}
+
+// ── 6. Over-constrained arcs and circles ─────────────────────────────────────
+void test_overconstrained_curves_match_dense() {
+    const json redundant =
+        beads(20, true,
+              json::array({{{"id", "dup"}, {"type", "Concentric"}, {"entities", {"k5", "a5"}}}}));
+    Run dense(redundant, 0);
+    Run sparse(redundant, 1);
+    if (!dense.tr.ok || !sparse.tr.ok) return;
+    const int dof = dense.solver.diagnose();
+    check(dof == 0, "the duplicate Concentric frees nothing (DOF " + std::to_string(dof) + ")");
+    check(sparse.solver.diagnose() == dof, "the sparse diagnosis agrees on the redundant DOF");
+    check(dense.solver.hasRedundant() && sparse.solver.hasRedundant(),
+          "both diagnoses see the duplicate Concentric");
+
+    const json conflict = beads(
+        20, true, json::array({{{"id", "bad"}, {"type", "Diameter"}, {"entities", {"k9"}},
+                                {"value", 5.0}}}));
+    Run dense_c(conflict, 0);
+    Run sparse_c(conflict, 1);
+    if (!dense_c.tr.ok || !sparse_c.tr.ok) return;
+    const sk::SolverResult rd = dense_c.solver.solve();
+    const sk::SolverResult rs = sparse_c.solver.solve();
+    const auto cd = conflicting(dense_c, rd);
+    check(!rd.success && !cd.empty(), "the dense solve reports the circle's conflict");
+    check(!rs.success && conflicting(sparse_c, rs) == cd,
+          "the sparse diagnosis names the same conflicting curve constraints");
+}
+}  // namespace
+
+int main() {
+    test_solve_matches_dense();
+    test_drag_matches_dense();
+    test_diagnosis_matches_dense();
+    test_curves_match_dense();
+    test_underconstrained_matches_dense();
+    test_overconstrained_curves_match_dense();
+    if (g_failures == 0) std::fprintf(stderr, "test_solver_sparse: OK\n");
+    return g_failures;
+}
@@ -0,0 +1,153 @@
+// test_trace.cpp — opt-in span tracing (util/Trace.h). In-process, real OCCT
+// (worker_core links it).
+//
+// Pins:
+//   1. a span taken while tracing is off records nothing;
+//   2. the dump is valid Chrome trace-event JSON: one `X` event per span with its
+//      detail, `M` thread_name metadata, one tid per recording thread;
+//   3. a span left open across enable() stays inert (no half-timed event);
+//   4. the per-thread ring keeps exactly the newest kRingEvents spans;
+//   5. a dump concurrent with writers only ever emits whole events.
+//
+// No framework: exit code == failure count.
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "nlohmann/json.hpp"
+#include "util/Trace.h"
+
+using nlohmann::json;
+namespace trace = onecad::trace;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) { std::fprintf(stderr, "FAIL: %s\n", msg.c_str()); ++g_failures; }
+}
+
+std::string temp_path(const char* tag) {
+    return "/tmp/onecad-test-trace-" + std::to_string(::getpid()) + "-" + tag + ".json";
+}
+
+json dump(const char* tag, long& events) {
+    const std::string path = temp_path(tag);
+    std::string error;
+    events = trace::write_chrome_trace(path, error);
+    check(events >= 0, "dump succeeds: " + error);
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    ::unlink(path.c_str());
+    return json::parse(ss.str(), nullptr, /*allow_exceptions=*/false);
+}
+
+std::size_t count_named(const json& doc, const std::string& name) {
+    std::size_t n = 0;
+    for (const json& ev : doc["traceEvents"]) {
+        if (ev.value("ph", "") == "X" && ev.value("name", "") == name) ++n;
+    }
+    return n;
+}
+
+// ── 1–3. Off, on, dump shape ─────────────────────────────────────────────────
+void test_spans() {
+    check(!trace::enabled(), "tracing starts off");
+    { const trace::Span s("off.span"); }
+    std::unique_ptr<trace::Span> straddling = std::make_unique<trace::Span>("straddle");
+
+    trace::enable();
+    trace::set_thread_name("main");
+    { const trace::Span s("main.span", "detail-a"); }
+    std::thread worker([] {
+        trace::set_thread_name("helper");
+        const trace::Span s("helper.span", std::string(200, 'x'));  // truncated detail
+    });
+    worker.join();
+    straddling.reset();
+
+    long events = 0;
+    const json doc = dump("spans", events);
+    check(doc.is_object() && doc["traceEvents"].is_array(), "the dump is trace-event JSON");
+    check(count_named(doc, "off.span") == 0, "a span taken while off records nothing");
+    check(count_named(doc, "straddle") == 0, "a span opened while off stays inert");
+    check(count_named(doc, "main.span") == 1 && count_named(doc, "helper.span") == 1,
+          "one event per span");
+    std::set<int> tids;
+    std::set<std::string> thread_names;
+    for (const json& ev : doc["traceEvents"]) {
+        if (ev.value("ph", "") == "M") thread_names.insert(ev["args"].value("name", ""));
+        if (ev.value("ph", "") != "X") continue;
+        tids.insert(ev.value("tid", 0));
+        check(ev.contains("ts") && ev.contains("dur") && ev.value("dur", -1) >= 0, "timed");
+        if (ev.value("name", "") == "main.span") {
+            check(ev["args"].value("detail", "") == "detail-a", "detail carried");
+        }
+        if (ev.value("name", "") == "helper.span") {
+            check(ev["args"].value("detail", "").size() == trace::kDetailBytes,
+                  "a long detail is truncated");
+        }
+    }
+    check(tids.size() == 2, "each thread records under its own tid");
+    check(thread_names.count("main") == 1 && thread_names.count("helper") == 1,
+          "thread names are emitted as metadata");
+    check(events == static_cast<long>(count_named(doc, "main.span") +
+                                      count_named(doc, "helper.span")),
+          "the returned count is the span count");
+}
+
+// ── 4. Ring wrap ─────────────────────────────────────────────────────────────
+void test_ring_wrap() {
+    std::thread writer([] {
+        for (std::size_t i = 0; i < trace::kRingEvents + 100; ++i) {
+            const trace::Span s("wrap.span");
+        }
+    });
+    writer.join();
+    long events = 0;
+    const json doc = dump("wrap", events);
+    check(count_named(doc, "wrap.span") == trace::kRingEvents,
+          "the ring keeps the newest kRingEvents spans");
+}
+
+// ── 5. Dump while writing ────────────────────────────────────────────────────
+void test_concurrent_dump() {
+    std::atomic<bool> stop{false};
+    std::thread writer([&stop] {
+        while (!stop.load()) {
+            const trace::Span s("busy.span", "abcdefghijklmnopqrstuvwxyz");
+        }
+    });
+    for (int i = 0; i < 5; ++i) {
+        long events = 0;
+        const json doc = dump("busy", events);
+        check(doc.is_object(), "a concurrent dump parses");
+        for (const json& ev : doc["traceEvents"]) {
+            if (ev.value("name", "") != "busy.span") continue;
+            if (ev["args"].value("detail", "") != "abcdefghijklmnopqrstuvwxyz") {
+                check(false, "a concurrent dump emitted a torn event");
+                break;
+            }
+        }
+    }
+    stop.store(true);
+    writer.join();
+    trace::disable();
+    check(!trace::enabled(), "disable turns recording off");
+}
+}  // namespace
+
+int main() {
+    test_spans();
+    test_ring_wrap();
+    test_concurrent_dump();
+    if (g_failures == 0) std::fprintf(stderr, "test_trace: OK\n");
+    return g_failures;
+}
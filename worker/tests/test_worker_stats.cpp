@@ -0,0 +1,219 @@
+// test_worker_stats.cpp — runtime counters behind GetWorkerStats (util/Stats.h,
+// Dispatcher::stats_json). In-process, real OCCT (Dispatcher links it).
+//
+// Pins:
+//   1. the histogram's buckets: exact below 16 us, every quantile within 1/16 of
+//      the true value above, and concurrent records lose no sample;
+//   2. the named registry hands back the same instance for a name;
+//   3. per-verb latency + error counts, unknown verbs counted apart;
+//   4. through `run`: lane wait/depth is recorded and a queued SolveDrag replaced
+//      by a newer one is counted as coalesced;
+//   5. phase timers (ExecutePlan `stepTimings`): exclusive of nested phases, inert
+//      outside a PhaseScope, and scopes nest without leaking into each other.
+//
+// No framework: exit code == failure count.
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "protocol/Frame.h"
+#include "util/Stats.h"
+
+using nlohmann::json;
+using onecad::protocol::Dispatcher;
+using onecad::protocol::Envelope;
+using onecad::protocol::ErrorInfo;
+using onecad::protocol::HandlerContext;
+using onecad::stats::Histogram;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) { std::fprintf(stderr, "FAIL: %s\n", msg.c_str()); ++g_failures; }
+}
+
+// ── 1. Histogram ─────────────────────────────────────────────────────────────
+void test_histogram() {
+    for (std::uint64_t v = 0; v < 16; ++v) {
+        check(Histogram::bucket_upper(Histogram::bucket_of(v)) == v, "small values are exact");
+    }
+    for (std::uint64_t v : {16ull, 17ull, 100ull, 4095ull, 4096ull, 123456789ull, ~0ull}) {
+        const std::uint64_t upper = Histogram::bucket_upper(Histogram::bucket_of(v));
+        check(upper >= v && upper - v <= v / 16, "bucket bound within 1/16: " + std::to_string(v));
+    }
+
+    Histogram h;
+    check(h.quantile(0.5) == 0 && h.count() == 0, "an empty histogram reports zero");
+    for (std::uint64_t v = 1; v <= 1000; ++v) h.record(v);
+    check(h.count() == 1000 && h.max() == 1000, "count + max");
+    const std::uint64_t p50 = h.quantile(0.50);
+    const std::uint64_t p99 = h.quantile(0.99);
+    check(p50 >= 500 && p50 <= 500 + 500 / 16, "p50 of 1..1000");
+    check(p99 >= 990 && p99 <= 1000, "p99 of 1..1000 (capped at max)");
+    const json j = h.to_json();
+    check(j.value("meanUs", 0) == 500 && j.contains("p95Us"), "json view");
+
+    Histogram shared;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&shared, t] {
+            for (int i = 0; i < 10000; ++i) shared.record(static_cast<std::uint64_t>(i + t));
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    check(shared.count() == 40000, "concurrent records are all counted");
+}
+
+// ── 2. Registry ──────────────────────────────────────────────────────────────
+void test_registry() {
+    onecad::stats::Counter& a = onecad::stats::counter("test.counter");
+    a.add(3);
+    check(&onecad::stats::counter("test.counter") == &a, "a name maps to one counter");
+    onecad::stats::histogram("test.timing").record(7);
+    const json snap = onecad::stats::snapshot();
+    check(snap["counters"].value("test.counter", 0) == 3, "snapshot counters");
+    check(snap["timings"]["test.timing"].value("count", 0) == 1, "snapshot timings");
+    check(onecad::stats::peak_rss_bytes() > 0, "peak RSS is reported");
+}
+
+// ── 3. Per-verb counters ─────────────────────────────────────────────────────
+void test_verbs() {
+    Dispatcher d;
+    d.register_verb("Ok", [](const Envelope& r, const std::vector<std::uint8_t>&,
+                             HandlerContext&) { return Envelope::ok_response(r.id, json{}); });
+    d.register_verb("Fail", [](const Envelope& r, const std::vector<std::uint8_t>&,
+                               HandlerContext&) {
+        return Envelope::error_response(r.id, ErrorInfo{"OP_FAILED", "no", false});
+    });
+    d.register_verb("Never", [](const Envelope& r, const std::vector<std::uint8_t>&,
+                                HandlerContext&) { return Envelope::ok_response(r.id, json{}); });
+    d.dispatch_once(Envelope::request(1, "Ok"));
+    d.dispatch_once(Envelope::request(2, "Ok"));
+    d.dispatch_once(Envelope::request(3, "Fail"));
+    d.dispatch_once(Envelope::request(4, "Nope"));
+    const json s = d.stats_json();
+    check(s["verbs"]["Ok"].value("count", 0) == 2 && s["verbs"]["Ok"].value("errors", 1) == 0,
+          "per-verb count");
+    check(s["verbs"]["Fail"].value("errors", 0) == 1, "per-verb errors");
+    check(!s["verbs"].contains("Never"), "a verb that never ran is omitted");
+    check(s.value("unknownVerbs", 0) == 1, "unknown verbs counted apart");
+    check(s.value("uptimeMs", -1) == 0, "no uptime before run");
+}
+
+// ── 4. Lanes + drag coalescing through run() ────────────────────────────────
+bool send(int fd, std::uint64_t id, const std::string& verb, const json& args) {
+    onecad::protocol::Frame f;
+    f.json = onecad::protocol::serialize(Envelope::request(id, verb, args));
+    return onecad::protocol::write_frame(fd, f);
+}
+
+void test_lanes() {
+    Dispatcher d;
+    const auto slow = [](const Envelope& r, const std::vector<std::uint8_t>&, HandlerContext&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        return Envelope::ok_response(r.id, json{});
+    };
+    d.register_verb("Busy", slow);
+    d.register_solver_verb("SolveDrag", slow);
+    int in[2];
+    int out[2];
+    check(pipe(in) == 0 && pipe(out) == 0, "pipes");
+    // Drain the worker's output so writes never block.
+    std::thread drain([fd = out[0]] {
+        char buf[4096];
+        while (::read(fd, buf, sizeof(buf)) > 0) {
+        }
+    });
+    std::thread writer([fd = in[1]] {
+        send(fd, 1, "Busy", json::object());
+        send(fd, 2, "Busy", json::object());
+        // The first drag occupies the lane; 4 and 5 race for the one queued slot.
+        send(fd, 3, "SolveDrag", json{{"gestureId", 1}, {"seq", 1}});
+        send(fd, 4, "SolveDrag", json{{"gestureId", 1}, {"seq", 2}});
+        send(fd, 5, "SolveDrag", json{{"gestureId", 1}, {"seq", 3}});
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        ::close(fd);
+    });
+    d.run(in[0], out[1]);
+    writer.join();
+    ::close(out[1]);
+    drain.join();
+    ::close(in[0]);
+    ::close(out[0]);
+
+    const json s = d.stats_json();
+    const json& kernel = s["lanes"]["kernel"];
+    check(kernel["wait"].value("count", 0) == 2, "every kernel job records its wait");
+    check(kernel["wait"].value("maxUs", 0) >= 20000, "the second Busy waited behind the first");
+    check(kernel.value("peakDepth", 0) >= 1 && kernel.value("depth", 9) == 0, "kernel depth");
+    check(s["drags"].value("coalesced", 0) >= 1, "a replaced drag is counted");
+    check(s["verbs"]["SolveDrag"].value("count", 0) <= 2, "coalesced drags never ran");
+    check(s.value("uptimeMs", 0) > 0, "uptime since run");
+}
+// ── 5. Phase accounting ──────────────────────────────────────────────────────
+void sleep_ms(int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+void test_phases() {
+    using onecad::stats::Phase;
+    using onecad::stats::PhaseScope;
+    using onecad::stats::PhaseTimer;
+    using onecad::stats::PhaseTotals;
+
+    { const PhaseTimer stray(Phase::Build); }  // no scope: records nowhere
+
+    PhaseTotals outer;
+    PhaseTotals inner;
+    std::uint64_t build_wall_us = 0;  // the Build timer's whole span, audit included
+    {
+        const PhaseScope scope(outer);
+        const auto build_started = std::chrono::steady_clock::now();
+        {
+            const PhaseTimer build(Phase::Build);
+            sleep_ms(10);
+            {
+                const PhaseTimer audit(Phase::Audit);
+                sleep_ms(20);
+            }
+            {
+                // A nested scope (a plan inside a plan) sees only its own timers.
+                const PhaseScope nested(inner);
+                const PhaseTimer history(Phase::History);
+                sleep_ms(5);
+            }
+        }
+        build_wall_us = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - build_started)
+                .count());
+    }
+    check(outer.of(Phase::Audit) >= 20000, "the nested phase is recorded");
+    // Lower bounds only: a loaded host stretches every sleep. Build + Audit is
+    // the Build timer's span, so it fits the wall time measured around it;
+    // counting the audit into Build as well would overshoot by the audit.
+    check(outer.of(Phase::Build) >= 15000, "the parent keeps its own time");
+    check(outer.of(Phase::Build) + outer.of(Phase::Audit) <= build_wall_us,
+          "the parent excludes its nested audit");
+    check(outer.of(Phase::History) == 0 && inner.of(Phase::History) >= 5000,
+          "a nested scope collects apart");
+    check(inner.of(Phase::Build) == 0, "the outer timer does not leak into a nested scope");
+    check(onecad::stats::current_rss_bytes().value_or(1) > 0, "current RSS when available");
+}
+}  // namespace
+
+int main() {
+    test_histogram();
+    test_registry();
+    test_verbs();
+    test_lanes();
+    test_phases();
+    if (g_failures == 0) std::fprintf(stderr, "test_worker_stats: OK\n");
+    return g_failures;
+}
@@ -4,9 +4,14 @@
 // producing a different body), RestoreCheckpoint(1) → the head rolls back to the box,
 // and its geometry signature is IDENTICAL to the checkpoint's (BinTools round-trips
 // exactly; determinism). An absent step ⇒ restored:false (Rust would replay from 0).
+// A RESTARTED worker (fresh Session) restores the same step from the persisted bytes
+// — head signature and partition identical to the saved one — and refuses tampered
+// bytes or a foreign `compat` (restored:false ⇒ replay).
 // No framework: exit code == failure count.
+#include <cstdint>
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "io/Checkpoint.h"
 #include "nlohmann/json.hpp"
@@ -58,14 +63,86 @@ std::string build_box(Session& s, double w, double h, double dist) {
                              json{{"jobId", 1}, {"documentRevision", 0}, {"workerEpoch", 3}}));
     return onecad::session::geometry_signature(s.bodies_copy());
 }
+
+// A RestoreCheckpoint request as Rust sends it after a restart: the persisted
+// SaveCheckpoint result as args, its blobs re-shipped in the request tail.
+Envelope persisted_restore(const Envelope& save, std::uint64_t id) {
+    json args = save.result;
+    args["stepIndex"] = 1;
+    args["expectedHistoryPrefixHash"] = save.result["historyPrefixHash"];
+    args["workerEpoch"] = 3;
+    Envelope req = Envelope::request(id, "RestoreCheckpoint", args);
+    req.bin = save.bin;
+    return req;
+}
+
+void test_persisted_restore(const Envelope& save, const std::string& box_sig,
+                            const std::string& body_id) {
+    // A restarted worker: nothing retained, the head is empty.
+    Session fresh;
+    fresh.open("doc", 0, 3, "determinism");
+    Envelope restore =
+        onecad::io::handle_restore_checkpoint(fresh, persisted_restore(save, 5), save.out_bin);
+    check(restore.ok.value_or(false), "persisted: RestoreCheckpoint ok");
+    check(restore.result.value("restored", false), "persisted: restored true");
+    check(restore.result.value("source", "") == "persisted", "persisted: source == persisted");
+    check(!restore.result.value("driftDetected", true), "persisted: no drift");
+    check(onecad::session::geometry_signature(fresh.bodies_copy()) == box_sig,
+          "persisted: restored head signature IDENTICAL to the replayed one");
+    check(fresh.head().history_prefix_hash == save.result.value("historyPrefixHash", ""),
+          "persisted: head carries the checkpoint's historyPrefixHash");
+    const onecad::elementmap::ElementMapPartition part = fresh.partition_copy();
+    const onecad::elementmap::PartitionEntry* e = part.find("el_ckpt");
+    check(part.size() == 1 && e != nullptr && e->body_id == body_id && e->topo_key == "f:1",
+          "persisted: partition entry re-minted at its topoKey");
+    check(e != nullptr && e->anchor.value("worldPoint", json()) == json::array({1.0, 2.0, 3.0}),
+          "persisted: partition anchor restored verbatim");
+
+    // Now retained in-session: a bytes-less restore of the same step succeeds.
+    Envelope again = onecad::io::handle_restore_checkpoint(
+        fresh, Envelope::request(6, "RestoreCheckpoint",
+                                 json{{"stepIndex", 1}, {"workerEpoch", 3}}));
+    check(again.result.value("source", "") == "session", "persisted: then retained in-session");
+
+    // Tampered blob ⇒ refused, the head untouched, Rust replays.
+    Session torn;
+    torn.open("doc", 0, 3, "determinism");
+    std::vector<std::uint8_t> bad = save.out_bin;
+    bad[save.bin.front().off + save.bin.front().len / 2] ^= 0xFF;
+    Envelope tampered =
+        onecad::io::handle_restore_checkpoint(torn, persisted_restore(save, 7), bad);
+    check(tampered.ok.value_or(false) && !tampered.result.value("restored", true),
+          "persisted: a tampered blob is refused (replay)");
+    check(torn.bodies_copy().size() == 0, "persisted: a refused restore installs nothing");
+
+    // A checkpoint written under other versions ⇒ refused.
+    Envelope foreign_req = persisted_restore(save, 8);
+    foreign_req.args["compat"]["kernelPolicyVersion"] = ONECAD_KERNEL_POLICY_VERSION + 1;
+    Envelope foreign = onecad::io::handle_restore_checkpoint(torn, foreign_req, save.out_bin);
+    check(!foreign.result.value("restored", true), "persisted: a foreign compat is refused");
+
+    // A saved signature the bytes do not fold to ⇒ drift, nothing installed.
+    Envelope drift_req = persisted_restore(save, 9);
+    drift_req.args["signatures"]["geometry"] = "0000000000000000";
+    Envelope drift = onecad::io::handle_restore_checkpoint(torn, drift_req, save.out_bin);
+    check(!drift.result.value("restored", true) && drift.result.value("driftDetected", false),
+          "persisted: a signature mismatch is drift");
+    check(torn.bodies_copy().size() == 0, "persisted: drift installs nothing");
+}
 }  // namespace
 
 int main() {
     Session s;
     s.open("doc", 0, 3, "determinism");
 
-    // Publish a 10x10x10 box, then checkpoint it at step 1.
+    // Publish a 10x10x10 box, mint one face id on it, then checkpoint it at step 1.
     const std::string box_sig = build_box(s, 10, 10, 10);
+    const std::string box_id = s.bodies_copy().ids().front();
+    const auto minted = s.bind_element_ids(
+        s.head().snapshot_id,
+        {onecad::session::ElementBindingInput{box_id, "f:1", "el_ckpt", "face",
+                                               json{{"worldPoint", {1.0, 2.0, 3.0}}}}});
+    check(minted.ok, "checkpoint: face id minted before the save");
     Envelope save = onecad::io::handle_save_checkpoint(
         s, Envelope::request(2, "SaveCheckpoint", json{{"stepIndex", 1}}));
     check(save.ok.value_or(false), "checkpoint: SaveCheckpoint ok");
@@ -106,6 +183,8 @@ int main() {
     check(absent.ok.value_or(false), "checkpoint: absent-step RestoreCheckpoint is ok (not an error)");
     check(!absent.result.value("restored", true), "checkpoint: absent step ⇒ restored:false");
 
+    test_persisted_restore(save, box_sig, box_id);
+
     if (g_failures == 0) std::fprintf(stderr, "wp6_checkpoint: OK\n");
     return g_failures;
 }
@@ -0,0 +1,201 @@
+// test_zygote.cpp — pre-warmed worker spawning (protocol/Zygote.h), end to end
+// over a real control socket, real fork()s and real pipes.
+//
+// The zygote here runs a small Dispatcher instead of the full worker (no OCCT
+// warm-up), which is all the fork path depends on. Pins:
+//   1. a spawned child answers with its own hello, then serves requests on the
+//      descriptors the requester passed, and exits on stdin EOF;
+//   2. isolation: children are distinct processes from the zygote and from each
+//      other; state a child mutates is invisible to a sibling forked later;
+//   3. a child given its own stderr logs there, every line tagged with its pid.
+//
+// No framework: exit code == failure count.
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Dispatcher.h"
+#include "protocol/Envelope.h"
+#include "protocol/Frame.h"
+#include "protocol/Zygote.h"
+#include "util/Log.h"
+
+using nlohmann::json;
+using onecad::protocol::Dispatcher;
+using onecad::protocol::Envelope;
+using onecad::protocol::Frame;
+using onecad::protocol::HandlerContext;
+using onecad::protocol::ReadStatus;
+
+namespace {
+int g_failures = 0;
+void check(bool cond, const std::string& msg) {
+    if (!cond) { std::fprintf(stderr, "FAIL: %s\n", msg.c_str()); ++g_failures; }
+}
+
+// Process-local state a child mutates; set before the zygote forks, so every
+// child starts from the zygote's value.
+int g_counter = 0;
+
+int child_main() {
+    Dispatcher dispatcher;
+    dispatcher.register_verb(
+        "Bump", [](const Envelope& req, const std::vector<std::uint8_t>&, HandlerContext&) {
+            ++g_counter;
+            return Envelope::ok_response(
+                req.id, json{{"counter", g_counter}, {"pid", static_cast<int>(::getpid())}});
+        });
+    dispatcher.register_verb(
+        "Log", [](const Envelope& req, const std::vector<std::uint8_t>&, HandlerContext&) {
+            WLOG_INFO("zygote-test marker");
+            return Envelope::ok_response(req.id);
+        });
+    const Envelope hello = Envelope::hello(json{{"pid", static_cast<int>(::getpid())}});
+    return dispatcher.run(STDIN_FILENO, STDOUT_FILENO, &hello);
+}
+
+bool socket_accepts(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path.c_str());
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    const bool ok = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    ::close(fd);
+    return ok;
+}
+
+// One forked worker as seen by the requester.
+struct Child {
+    pid_t pid = -1;
+    int to = -1;    // its stdin
+    int from = -1;  // its stdout
+    int err = -1;   // its stderr, when one was passed
+};
+
+Child spawn(const std::string& socket_path, bool own_stderr) {
+    Child c;
+    int p2c[2];
+    int c2p[2];
+    int e2p[2] = {-1, -1};
+    if (::pipe(p2c) != 0 || ::pipe(c2p) != 0) return c;
+    if (own_stderr && ::pipe(e2p) != 0) return c;
+    std::string error;
+    c.pid = onecad::protocol::zygote_spawn(socket_path, p2c[0], c2p[1], e2p[1], error);
+    if (c.pid <= 0) std::fprintf(stderr, "zygote_spawn: %s\n", error.c_str());
+    ::close(p2c[0]);
+    ::close(c2p[1]);
+    if (e2p[1] >= 0) ::close(e2p[1]);
+    c.to = p2c[1];
+    c.from = c2p[0];
+    c.err = e2p[0];
+    return c;
+}
+
+json read_json(int fd) {
+    const auto rr = onecad::protocol::read_frame(fd);
+    if (rr.status != ReadStatus::Ok) return json();
+    return json::parse(rr.frame.json, nullptr, /*allow_exceptions=*/false);
+}
+
+json call(const Child& c, std::uint64_t id, const std::string& verb) {
+    Frame f;
+    f.json = onecad::protocol::serialize(Envelope::request(id, verb));
+    if (!onecad::protocol::write_frame(c.to, f)) return json();
+    return read_json(c.from);
+}
+
+// Close stdin (the worker exits on EOF), drain stdout to EOF; returns whatever
+// the child wrote to its own stderr.
+std::string shut_down(Child& c) {
+    ::close(c.to);
+    char buf[4096];
+    while (::read(c.from, buf, sizeof(buf)) > 0) {
+    }
+    ::close(c.from);
+    std::string err;
+    if (c.err >= 0) {
+        ssize_t n;
+        while ((n = ::read(c.err, buf, sizeof(buf))) > 0) err.append(buf, static_cast<std::size_t>(n));
+        ::close(c.err);
+    }
+    return err;
+}
+
+}  // namespace
+
+int main() {
+    const std::string socket_path =
+        "/tmp/onecad_test_zygote_" + std::to_string(::getpid()) + ".sock";
+    g_counter = 41;
+
+    // The zygote is a child of the test so that SIGCHLD handling and its
+    // single-threaded fork discipline never touch the test process.
+    const pid_t zygote = ::fork();
+    if (zygote == 0) _exit(onecad::protocol::run_zygote(socket_path, child_main));
+    check(zygote > 0, "the zygote process started");
+    bool ready = false;
+    for (int i = 0; i < 500 && !ready; ++i) {
+        ready = socket_accepts(socket_path);
+        if (!ready) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    check(ready, "the zygote listens on its socket");
+
+    // ── 1 + 3. A child with its own stderr: hello, requests, tagged log ──────
+    Child a = spawn(socket_path, /*own_stderr=*/true);
+    check(a.pid > 0 && a.pid != zygote && a.pid != ::getpid(),
+          "the child is its own process");
+    const json hello_a = read_json(a.from);
+    check(hello_a.value("t", std::string{}) == "hello", "the child's first frame is its hello");
+    check(hello_a.contains("result") && hello_a["result"].value("pid", -1) == a.pid,
+          "the hello comes from the pid the zygote reported");
+    const json first = call(a, 1, "Bump");
+    check(first.value("ok", false) && first["result"].value("counter", 0) == 42,
+          "the child starts from the zygote's state");
+    check(first["result"].value("pid", -1) == a.pid, "the request ran in the child");
+    const json second = call(a, 2, "Bump");
+    check(second.value("ok", false) && second["result"].value("counter", 0) == 43,
+          "the child keeps its own state across requests");
+    check(call(a, 3, "Log").value("ok", false), "the child logs on request");
+
+    // ── 2. Isolation: a sibling forked after `a` mutated its state ──────────
+    Child b = spawn(socket_path, /*own_stderr=*/false);
+    check(b.pid > 0 && b.pid != a.pid && b.pid != zygote, "siblings are distinct processes");
+    check(read_json(b.from).value("t", std::string{}) == "hello", "the sibling says hello");
+    const json sibling = call(b, 1, "Bump");
+    check(sibling.value("ok", false) && sibling["result"].value("counter", 0) == 42,
+          "a sibling does not see the other child's state");
+    check(sibling["result"].value("pid", -1) == b.pid, "the sibling served its own request");
+    check(g_counter == 41, "the requester's state is untouched");
+
+    const std::string log_a = shut_down(a);
+    shut_down(b);
+    const std::string tag = "[worker " + std::to_string(a.pid) + "]";
+    check(log_a.find("zygote-test marker") != std::string::npos,
+          "the child's log reached the stderr it was given");
+    std::size_t lines = 0;
+    std::size_t tagged = 0;
+    for (std::size_t pos = 0; pos < log_a.size();) {
+        const std::size_t eol = log_a.find('\n', pos);
+        const std::string line = log_a.substr(pos, eol == std::string::npos ? eol : eol - pos);
+        ++lines;
+        if (line.find(tag) != std::string::npos) ++tagged;
+        if (eol == std::string::npos) break;
+        pos = eol + 1;
+    }
+    check(lines > 0 && tagged == lines, "every child log line carries its pid tag");
+
+    ::kill(zygote, SIGTERM);
+    int status = 0;
+    ::waitpid(zygote, &status, 0);
+    ::unlink(socket_path.c_str());
+
+    if (g_failures == 0) std::fprintf(stderr, "zygote: all checks passed\n");
+    return g_failures;
+}
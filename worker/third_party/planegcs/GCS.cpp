@@ -487,6 +487,7 @@ System::System()
     , convergenceRedundant(1e-10)
     , qrAlgorithm(EigenSparseQR)
     , dogLegGaussStep(FullPivLU)
+    , sparseThreshold(0)
     , qrpivotThreshold(1E-13)
     , debugMode(Minimal)
     , LM_eps(1E-10)
@@ -537,6 +538,13 @@ void System::setMaxIterationsRedundant(int maxIterIn)
     }
 }
 
+void System::setSparseThreshold(int params)
+{
+    if (params >= 0) {
+        sparseThreshold = params;
+    }
+}
+
 System::~System()
 {
     clear();
@@ -1901,8 +1909,24 @@ int System::solve(VEC_pD& params, bool isFine, Algorithm alg, bool isRedundantso
     return solve(isFine, alg, isRedundantsolving);
 }
 
+void System::setInterruptCheck(std::function<bool()> check)
+{
+    interruptCheck = std::move(check);
+}
+
+bool System::shouldInterrupt()
+{
+    ++iterationCount;
+    if (!interrupted && interruptCheck && interruptCheck()) {
+        interrupted = true;
+    }
+    return interrupted;
+}
+
 int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
 {
+    interrupted = false;
+    iterationCount = 0;
     if (!isInit) {
         return Failed;
     }
@@ -1912,6 +1936,9 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
     // even if no other system has to be solved
     int res = Success;
     for (int cid = 0; cid < int(subSystems.size()); cid++) {
+        if (interrupted) {
+            return Failed;
+        }
         if ((subSystems[cid] || subSystemsAux[cid]) && !isReset) {
             resetToReference();
             isReset = true;
@@ -1926,6 +1953,9 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
             res = std::max(res, solve(subSystemsAux[cid], isFine, alg, isRedundantsolving));
         }
     }
+    if (interrupted) {
+        return Failed;
+    }
     if (res == Success) {
         for (std::set<Constraint*>::const_iterator constr = redundant.begin();
              constr != redundant.end();
@@ -2014,6 +2044,9 @@ int System::solve_BFGS(SubSystem* subsys, bool /*isFine*/, bool isRedundantsolvi
     double h_norm {};
 
     for (int iter = 1; iter < maxIterNumber; ++iter) {
+        if (shouldInterrupt()) {
+            break;
+        }
         h_norm = h.norm();
         if (h_norm <= convCriterion || err <= smallF) {
             if (debugMode == IterationLevel) {
@@ -2077,6 +2110,9 @@ int System::solve_BFGS(SubSystem* subsys, bool /*isFine*/, bool isRedundantsolvi
 
     subsys->revertParams();
 
+    if (interrupted) {
+        return Failed;
+    }
     if (err <= smallF) {
         return Success;
     }
@@ -2091,6 +2127,11 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
     extractSubsystem(subsys, isRedundantsolving);
 #endif
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    if (useSparse(subsys->pSize())) {
+        return solve_LM_sparse(subsys, isRedundantsolving);
+    }
+#endif
 
     int xsize = subsys->pSize();
     int csize = subsys->cSize();
@@ -2151,6 +2192,10 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
             stop = 6;
             break;
         }
+        else if (shouldInterrupt()) {
+            stop = 8;
+            break;
+        }
 
         // J^T J, J^T e
         subsys->calcJacobi(J);
@@ -2270,6 +2315,11 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
 #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
     extractSubsystem(subsys, isRedundantsolving);
 #endif
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    if (useSparse(subsys->pSize())) {
+        return solve_DL_sparse(subsys, isRedundantsolving);
+    }
+#endif
 
     int xsize = subsys->pSize();
     int csize = subsys->cSize();
@@ -2355,6 +2405,10 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
             stop = 6;
             break;
         }
+        else if (shouldInterrupt()) {
+            stop = 8;
+            break;
+        }
 
         // get the steepest descent direction
         alpha = g.squaredNorm() / (Jx * g).squaredNorm();
@@ -4547,6 +4601,11 @@ int System::solve(SubSystem* subsysA, SubSystem* subsysB, bool /*isFine*/, bool
         plistAB.resize(it - plistAB.begin());
     }
     int xsize = plistAB.size();
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    if (useSparse(xsize)) {
+        return solve_SQP_sparse(subsysA, subsysB, plistAB, isRedundantsolving);
+    }
+#endif
 
     Eigen::MatrixXd B = Eigen::MatrixXd::Identity(xsize, xsize);
     Eigen::MatrixXd JA(csizeA, xsize);
@@ -4583,6 +4642,9 @@ int System::solve(SubSystem* subsysA, SubSystem* subsysB, bool /*isFine*/, bool
     double mu = 0;
     lambda.setZero();
     for (int iter = 1; iter < maxIterNumber; iter++) {
+        if (shouldInterrupt()) {
+            break;
+        }
         int status = qp_eq(B, grad, JA, resA, xdir, Y, Z);
         if (status) {
             break;
@@ -4807,6 +4869,13 @@ int System::diagnose(Algorithm alg)
     redundantTags.clear();
     partiallyRedundantTags.clear();
 
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    // OneCAD: a large system never builds the dense Jacobian (GCSSparse.cpp).
+    if (qrAlgorithm == EigenSparseQR && useSparse(plist.size() - pdrivenlist.size())) {
+        return diagnoseSparse(alg);
+    }
+#endif
+
     // This QR diagnosis uses a reduced Jacobian matrix to calculate the rank of the system
     // and identify conflicting and redundant constraints.
     //
@@ -5468,6 +5537,25 @@ void System::identifyConflictingRedundantConstraints(
         conflictGroups[j - rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
     }
 
+    resolveConflictGroups(
+        alg,
+        conflictGroups,
+        tagmultiplicity,
+        pdiagnoselist,
+        constrNum,
+        nonredundantconstrNum
+    );
+}
+
+void System::resolveConflictGroups(
+    Algorithm alg,
+    std::vector<std::vector<Constraint*>>& conflictGroups,
+    const std::map<int, int>& tagmultiplicity,
+    GCS::VEC_pD& pdiagnoselist,
+    int constrNum,
+    int& nonredundantconstrNum
+)
+{
     // Augment the information regarding the group of constraints that are conflicting or redundant.
     if (debugMode == IterationLevel) {
         SolverReportingManager::Manager().LogGroupOfConstraints(
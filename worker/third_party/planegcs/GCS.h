@@ -27,6 +27,8 @@
 
 #include <Eigen/QR>
 
+#include <functional>
+
 #include "SketcherGlobal.h"
 #include "SubSystem.h"
 
@@ -145,10 +147,41 @@ private:
 
     bool emptyDiagnoseMatrix;  // false only if there is at least one driving constraint.
 
+    // OneCAD: cooperative interruption (see setInterruptCheck).
+    std::function<bool()> interruptCheck;
+    bool interrupted = false;
+    int iterationCount = 0;
+    bool shouldInterrupt();
+
     int solve_BFGS(SubSystem* subsys, bool isFine = true, bool isRedundantsolving = false);
     int solve_LM(SubSystem* subsys, bool isRedundantsolving = false);
     int solve_DL(SubSystem* subsys, bool isRedundantsolving = false);
 
+    // OneCAD: the sparse linear-algebra path (GCSSparse.cpp), taken by every
+    // subsystem and diagnosis of at least `sparseThreshold` parameters.
+    bool useSparse(std::size_t paramCount) const;
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    int solve_LM_sparse(SubSystem* subsys, bool isRedundantsolving);
+    int solve_DL_sparse(SubSystem* subsys, bool isRedundantsolving);
+    int solve_SQP_sparse(
+        SubSystem* subsysA,
+        SubSystem* subsysB,
+        VEC_pD& plistAB,
+        bool isRedundantsolving
+    );
+    int diagnoseSparse(Algorithm alg);
+    void makeReducedJacobian(
+        Eigen::SparseMatrix<double>& J,
+        std::map<int, int>& jacobianconstraintmap,
+        GCS::VEC_pD& pdiagnoselist,
+        std::map<int, int>& tagmultiplicity
+    );
+    void identifyDependentParametersSparse(
+        const Eigen::SparseMatrix<double>& J,
+        const GCS::VEC_pD& pdiagnoselist
+    );
+#endif
+
     void makeReducedJacobian(
         Eigen::MatrixXd& J,
         std::map<int, int>& jacobianconstraintmap,
@@ -200,6 +233,17 @@ private:
         int& nonredundantconstrNum
     );
 
+    // OneCAD: the part of identifyConflictingRedundantConstraints after the
+    // conflict groups are known, shared with the sparse diagnosis.
+    void resolveConflictGroups(
+        Algorithm alg,
+        std::vector<std::vector<Constraint*>>& conflictGroups,
+        const std::map<int, int>& tagmultiplicity,
+        GCS::VEC_pD& pdiagnoselist,
+        int constrNum,
+        int& nonredundantconstrNum
+    );
+
     void eliminateNonZerosOverPivotInUpperTriangularMatrix(Eigen::MatrixXd& R, int rank);
 
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
@@ -240,6 +284,7 @@ public:
     double convergenceRedundant;
     QRAlgorithm qrAlgorithm;
     DogLegGaussStep dogLegGaussStep;
+    int sparseThreshold;  // OneCAD: see setSparseThreshold
     double qrpivotThreshold;
     DebugMode debugMode;
     double LM_eps;
@@ -264,6 +309,10 @@ public:
     void setMaxIterations(int maxIterIn);
     void setConvergenceRedundant(double tol);
     void setMaxIterationsRedundant(int maxIterIn);
+    // OneCAD: subsystems (and diagnoses) of at least `params` parameters solve
+    // on sparse factorizations instead of dense ones; 0 (the default) keeps
+    // every system dense.
+    void setSparseThreshold(int params);
 
     void clear();
     void clearByTag(int tagId);
@@ -655,6 +704,24 @@ public:
 
     void invalidatedDiagnosis();
 
+    // OneCAD: cooperative interruption. When set, `check` is polled once per
+    // iteration of every solve loop (BFGS, LM, DogLeg, SQP); once it returns
+    // true the running solve stops, reports Failed, and wasInterrupted() holds
+    // until the next solve. Parameters are left at the last iterate, so the
+    // caller decides whether to keep or revert it. An empty function clears it.
+    void setInterruptCheck(std::function<bool()> check);
+    bool wasInterrupted() const
+    {
+        return interrupted;
+    }
+
+    // OneCAD: iterations run by the last solve(), summed over its subsystems
+    // and counted at the same per-iteration poll as the interrupt check.
+    int lastIterations() const
+    {
+        return iterationCount;
+    }
+
     // Unit testing interface - not intended for use by production code
 protected:
     size_t _getNumberOfConstraints(int tagID = -1)
@@ -0,0 +1,799 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/***************************************************************************
+ *   OneCAD addition to the vendored PlaneGCS (see VENDOR.txt).            *
+ *                                                                         *
+ *   The sparse linear-algebra path of GCS::System: LM, DogLeg, the SQP    *
+ *   drag solve and the QR diagnosis for systems of at least               *
+ *   `sparseThreshold` parameters. Each loop mirrors its dense original    *
+ *   in GCS.cpp line for line; only the matrices and factorizations        *
+ *   differ, so a fix to one belongs in both.                              *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <vector>
+
+#include "GCS.h"
+
+namespace GCS
+{
+
+bool System::useSparse(std::size_t paramCount) const
+{
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    return sparseThreshold > 0 && paramCount >= std::size_t(sparseThreshold);
+#else
+    (void)paramCount;
+    return false;
+#endif
+}
+
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+
+namespace
+{
+using SparseMatrix = Eigen::SparseMatrix<double>;
+
+// Ridge added to the normal matrices the sparse path factorizes (J*J^T for
+// DogLeg, the Gauss-Newton Hessian for SQP), relative to their largest
+// diagonal entry. It keeps a rank-deficient matrix factorizable by Cholesky and
+// only weighs directions nothing else constrains, where it picks the smallest
+// move; it vanishes from the converged solution because the step does.
+constexpr double kRidge = 1e-8;
+
+SparseMatrix identity(int n)
+{
+    SparseMatrix I(n, n);
+    I.setIdentity();
+    return I;
+}
+
+double ridgeFor(const SparseMatrix& M)
+{
+    const double maxDiagonal = M.rows() > 0 ? M.diagonal().cwiseAbs().maxCoeff() : 0.;
+    return kRidge * std::max(1., maxDiagonal);
+}
+
+// The pivot rows each non-pivot column of an upper-trapezoidal R depends on:
+// the nonzeros of R11^-1 * R12, scaled by the pivots exactly as
+// eliminateNonZerosOverPivotInUpperTriangularMatrix leaves them in a dense R,
+// and tested against the same 1e-10.
+std::vector<std::vector<int>> pivotDependencies(const SparseMatrix& R, int rank, int cols)
+{
+    std::vector<std::vector<int>> dependencies(cols - rank);
+    if (rank == 0 || cols == rank) {
+        return dependencies;
+    }
+    const SparseMatrix R11 = R.topLeftCorner(rank, rank);
+    SparseMatrix W = R.block(0, rank, rank, cols - rank);
+    R11.triangularView<Eigen::Upper>().solveInPlace(W);
+    const Eigen::VectorXd pivots = R11.diagonal();
+    for (int j = 0; j < W.outerSize(); j++) {
+        for (SparseMatrix::InnerIterator it(W, j); it; ++it) {
+            if (fabs(pivots(it.row()) * it.value()) > 1e-10) {
+                dependencies[j].push_back(int(it.row()));
+            }
+        }
+    }
+    return dependencies;
+}
+
+// [ H   JA^T ]
+// [ JA   0   ], the equality-constrained QP of one SQP step
+void assembleKKT(const SparseMatrix& H, const SparseMatrix& JA, SparseMatrix& K)
+{
+    const int n = int(H.rows());
+    std::vector<Eigen::Triplet<double>> entries;
+    entries.reserve(H.nonZeros() + 2 * JA.nonZeros());
+    for (int k = 0; k < H.outerSize(); k++) {
+        for (SparseMatrix::InnerIterator it(H, k); it; ++it) {
+            entries.emplace_back(it.row(), it.col(), it.value());
+        }
+    }
+    for (int k = 0; k < JA.outerSize(); k++) {
+        for (SparseMatrix::InnerIterator it(JA, k); it; ++it) {
+            entries.emplace_back(n + it.row(), it.col(), it.value());
+            entries.emplace_back(it.col(), n + it.row(), it.value());
+        }
+    }
+    K.resize(n + JA.rows(), n + JA.rows());
+    K.setFromTriplets(entries.begin(), entries.end());
+}
+}  // namespace
+
+// solve_LM with J^T*J kept sparse and the damped normal equations solved by a
+// sparse Cholesky (LDL^T) instead of a dense full-pivot LU.
+int System::solve_LM_sparse(SubSystem* subsys, bool isRedundantsolving)
+{
+    int xsize = subsys->pSize();
+    int csize = subsys->cSize();
+
+    if (xsize == 0) {
+        return Success;
+    }
+
+    Eigen::VectorXd e(csize), e_new(csize);
+    SparseMatrix J(csize, xsize);
+    SparseMatrix A(xsize, xsize), Aaug(xsize, xsize);
+    const SparseMatrix I = identity(xsize);
+    Eigen::SimplicialLDLT<SparseMatrix> ldlt;
+    bool analysed = false;  // J's pattern, and so A's, is fixed for the whole solve
+    Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
+
+    subsys->redirectParams();
+
+    subsys->getParams(x);
+    subsys->calcResidual(e);
+    e *= -1;
+
+    int maxIterNumber = (sketchSizeMultiplier ? maxIter * xsize : maxIter);
+
+    double divergingLim = 1e6 * e.squaredNorm() + 1e12;
+
+    double eps = LM_eps;
+    double eps1 = LM_eps1;
+    double tau = LM_tau;
+
+    if (isRedundantsolving) {
+        maxIterNumber = (sketchSizeMultiplierRedundant ? maxIterRedundant * xsize : maxIterRedundant);
+        eps = LM_epsRedundant;
+        eps1 = LM_eps1Redundant;
+        tau = LM_tauRedundant;
+    }
+
+    double nu = 2, mu = 0;
+    int iter = 0, stop = 0;
+    for (iter = 0; iter < maxIterNumber && !stop; ++iter) {
+        // check error
+        double err = e.squaredNorm();
+        if (err <= eps * eps) {
+            // error is small, Success
+            stop = 1;
+            break;
+        }
+        else if (err > divergingLim || err != err) {
+            // check for diverging and NaN
+            stop = 6;
+            break;
+        }
+        else if (shouldInterrupt()) {
+            stop = 8;
+            break;
+        }
+
+        // J^T J, J^T e
+        subsys->calcJacobi(J);
+
+        A = J.transpose() * J;
+        g = J.transpose() * e;
+
+        // Compute ||J^T e||_inf
+        double g_inf = g.lpNorm<Eigen::Infinity>();
+        diag_A = A.diagonal();
+
+        // check for convergence
+        if (g_inf <= eps1) {
+            stop = 2;
+            break;
+        }
+
+        // compute initial damping factor
+        if (iter == 0) {
+            mu = tau * diag_A.lpNorm<Eigen::Infinity>();
+        }
+
+        double h_norm {};
+        // determine increment using adaptive damping
+        int k = 0;
+        while (k < 50) {
+            // augment normal equations A = A+uI (on a copy: nothing to restore)
+            Aaug = A + mu * I;
+            if (!analysed) {
+                ldlt.analyzePattern(Aaug);
+                analysed = true;
+            }
+            ldlt.factorize(Aaug);
+
+            // solve augmented functions A*h=-g
+            double rel_error = std::numeric_limits<double>::infinity();
+            if (ldlt.info() == Eigen::Success) {
+                h = ldlt.solve(g);
+                rel_error = (Aaug * h - g).norm() / g.norm();
+            }
+
+            // check if solving works
+            if (rel_error < 1e-5) {
+                // restrict h according to maxStep
+                double scale = subsys->maxStep(h);
+                if (scale < 1.) {
+                    h *= scale;
+                }
+
+                // compute par's new estimate and ||d_par||^2
+                x_new = x + h;
+                h_norm = h.squaredNorm();
+
+                constexpr double epsilon = std::numeric_limits<double>::epsilon();
+                if (h_norm <= eps1 * eps1 * x.norm()) {
+                    // relative change in p is small, stop
+                    stop = 3;
+                    break;
+                }
+                else if (h_norm >= (x.norm() + eps1) / (epsilon * epsilon)) {
+                    // almost singular
+                    stop = 4;
+                    break;
+                }
+
+                subsys->setParams(x_new);
+                subsys->calcResidual(e_new);
+                e_new *= -1;
+
+                double dF = e.squaredNorm() - e_new.squaredNorm();
+                double dL = h.dot(mu * h + g);
+
+                if (dF > 0. && dL > 0.) {  // reduction in error, increment is accepted
+                    double tmp = 2 * dF / dL - 1.;
+                    mu *= std::max(1. / 3., 1. - tmp * tmp * tmp);
+                    nu = 2;
+
+                    // update par's estimate
+                    x = x_new;
+                    e = e_new;
+                    break;
+                }
+            }
+
+            // if this point is reached, either the linear system could not be solved or
+            // the error did not reduce; in any case, the increment must be rejected
+
+            mu *= nu;
+            nu *= 2.0;
+
+            k++;
+        }
+        if (k > 50) {
+            stop = 7;
+            break;
+        }
+    }
+
+    if (iter >= maxIterNumber) {
+        stop = 5;
+    }
+
+    subsys->revertParams();
+
+    return (stop == 1) ? Success : Failed;
+}
+
+// solve_DL with a sparse Jacobian. The Gauss-Newton step is the least-norm one
+// (the dense LeastNormLdlt option, J^T (J J^T)^-1), factorized by a sparse
+// Cholesky: the dense default, a full-pivot LU of J, has no sparse equivalent.
+// On an under-constrained system the two steps differ, so the sparse path can
+// settle on another pose among equally valid ones; it moves less to get there.
+int System::solve_DL_sparse(SubSystem* subsys, bool isRedundantsolving)
+{
+    int xsize = subsys->pSize();
+    int csize = subsys->cSize();
+
+    if (xsize == 0) {
+        return Success;
+    }
+
+    double tolg = DL_tolg;
+    double tolx = DL_tolx;
+    double tolf = DL_tolf;
+
+    int maxIterNumber = (sketchSizeMultiplier ? maxIter * xsize : maxIter);
+    if (isRedundantsolving) {
+        tolg = DL_tolgRedundant;
+        tolx = DL_tolxRedundant;
+        tolf = DL_tolfRedundant;
+
+        maxIterNumber = (sketchSizeMultiplierRedundant ? maxIterRedundant * xsize : maxIterRedundant);
+    }
+
+    Eigen::VectorXd x(xsize), x_new(xsize);
+    Eigen::VectorXd fx(csize), fx_new(csize);
+    SparseMatrix Jx(csize, xsize), Jx_new(csize, xsize), JJt(csize, csize);
+    const SparseMatrix I = identity(csize);
+    Eigen::SimplicialLDLT<SparseMatrix> ldlt;
+    bool analysed = false;  // J's pattern, and so J J^T's, is fixed for the whole solve
+    Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
+
+    subsys->redirectParams();
+
+    double err;
+    subsys->getParams(x);
+    subsys->calcResidual(fx, err);
+    subsys->calcJacobi(Jx);
+
+    g = Jx.transpose() * (-fx);
+
+    // get the infinity norm fx_inf and g_inf
+    double g_inf = g.lpNorm<Eigen::Infinity>();
+    double fx_inf = fx.lpNorm<Eigen::Infinity>();
+
+    double divergingLim = 1e6 * err + 1e12;
+
+    double delta = 0.1;
+    double alpha = 0.;
+    double nu = 2.;
+    int iter = 0, stop = 0, reduce = 0;
+    while (!stop) {
+        // check if finished
+        if (fx_inf <= tolf) {
+            // Success
+            stop = 1;
+            break;
+        }
+        else if (g_inf <= tolg) {
+            stop = 2;
+            break;
+        }
+        else if (delta <= tolx * (tolx + x.norm())) {
+            stop = 2;
+            break;
+        }
+        else if (iter >= maxIterNumber) {
+            stop = 4;
+            break;
+        }
+        else if (err > divergingLim || err != err) {
+            // check for diverging and NaN
+            stop = 6;
+            break;
+        }
+        else if (shouldInterrupt()) {
+            stop = 8;
+            break;
+        }
+
+        // get the steepest descent direction
+        alpha = g.squaredNorm() / (Jx * g).squaredNorm();
+        h_sd = alpha * g;
+
+        // get the gauss-newton step
+        JJt = Jx * Jx.transpose();
+        JJt += ridgeFor(JJt) * I;
+        if (!analysed) {
+            ldlt.analyzePattern(JJt);
+            analysed = true;
+        }
+        ldlt.factorize(JJt);
+        if (ldlt.info() != Eigen::Success) {
+            break;
+        }
+        h_gn = Jx.transpose() * ldlt.solve(-fx);
+
+        double rel_error = (Jx * h_gn + fx).norm() / fx.norm();
+        if (rel_error > 1e15) {
+            break;
+        }
+
+        // compute the dogleg step
+        if (h_gn.norm() < delta) {
+            h_dl = h_gn;
+            if (h_dl.norm() <= tolx * (tolx + x.norm())) {
+                stop = 5;
+                break;
+            }
+        }
+        else if (alpha * g.norm() >= delta) {
+            h_dl = (delta / (alpha * g.norm())) * h_sd;
+        }
+        else {
+            // compute beta
+            double beta = 0;
+            Eigen::VectorXd b = h_gn - h_sd;
+            double bb = (b.transpose() * b).norm();
+            double gb = (h_sd.transpose() * b).norm();
+            double c = (delta + h_sd.norm()) * (delta - h_sd.norm());
+
+            if (gb > 0) {
+                beta = c / (gb + sqrt(gb * gb + c * bb));
+            }
+            else {
+                beta = (sqrt(gb * gb + c * bb) - gb) / bb;
+            }
+
+            // and update h_dl and dL with beta
+            h_dl = h_sd + beta * b;
+        }
+
+        // get the new values
+        double err_new;
+        x_new = x + h_dl;
+        subsys->setParams(x_new);
+        subsys->calcResidual(fx_new, err_new);
+        subsys->calcJacobi(Jx_new);
+
+        // calculate the linear model and the update ratio
+        double dL = err - 0.5 * (fx + Jx * h_dl).squaredNorm();
+        double dF = err - err_new;
+        double rho = dL / dF;
+
+        if (dF > 0 && dL > 0) {
+            x = x_new;
+            Jx = Jx_new;
+            fx = fx_new;
+            err = err_new;
+
+            g = Jx.transpose() * (-fx);
+
+            // get infinity norms
+            g_inf = g.lpNorm<Eigen::Infinity>();
+            fx_inf = fx.lpNorm<Eigen::Infinity>();
+        }
+        else {
+            rho = -1;
+        }
+
+        // update delta
+        if (fabs(rho - 1.) < 0.2 && h_dl.norm() > delta / 3. && reduce <= 0) {
+            delta = 3 * delta;
+            nu = 2;
+            reduce = 0;
+        }
+        else if (rho < 0.25) {
+            delta = delta / nu;
+            nu = 2 * nu;
+            reduce = 2;
+        }
+        else {
+            reduce--;
+        }
+
+        // count this iteration and start again
+        iter++;
+    }
+
+    subsys->revertParams();
+
+    return (stop == 1) ? Success : Failed;
+}
+
+// The SQP drag solve (System::solve(subsysA, subsysB)) with sparse matrices.
+// The dense loop keeps a BFGS approximation of the soft objective's Hessian,
+// which fills in to xsize^2, and solves each QP through a full-pivot QR of
+// JA^T. Here the Hessian is the Gauss-Newton one, JB^T JB (plus a ridge), as
+// sparse as the soft constraints, and each QP is one sparse LU of its KKT
+// matrix. The soft objective is a sum of squares, so Gauss-Newton is at least
+// as good a model of it as BFGS, and needs no warm-up iterations.
+int System::solve_SQP_sparse(
+    SubSystem* subsysA,
+    SubSystem* subsysB,
+    VEC_pD& plistAB,
+    bool isRedundantsolving
+)
+{
+    int xsize = plistAB.size();
+    int csizeA = subsysA->cSize();
+    int csizeB = subsysB->cSize();
+
+    SparseMatrix JA(csizeA, xsize), JB(csizeB, xsize), B(xsize, xsize), K;
+    const SparseMatrix I = identity(xsize);
+    Eigen::SparseLU<SparseMatrix, Eigen::COLAMDOrdering<int>> kkt;
+    bool analysed = false;  // the KKT pattern is fixed for the whole solve
+
+    Eigen::VectorXd resA(csizeA);
+    Eigen::VectorXd x(xsize), x0(xsize), xdir(xsize), xdir1(xsize);
+    Eigen::VectorXd grad(xsize);
+    Eigen::VectorXd h(xsize);
+    Eigen::VectorXd rhs(xsize + csizeA), sol(xsize + csizeA);
+
+    h.setConstant(std::numeric_limits<double>::infinity());  // no step taken yet
+
+    // We assume that there are no common constraints in subsysA and subsysB
+    subsysA->redirectParams();
+    subsysB->redirectParams();
+
+    subsysB->getParams(plistAB, x);
+    subsysA->getParams(plistAB, x);
+    subsysB->setParams(plistAB, x);  // just to ensure that A and B are synchronized
+
+    subsysB->calcGrad(plistAB, grad);
+    subsysB->calcJacobi(plistAB, JB);
+    subsysA->calcJacobi(plistAB, JA);
+    subsysA->calcResidual(resA);
+
+    int maxIterNumber
+        = (isRedundantsolving
+               ? (sketchSizeMultiplierRedundant ? maxIterRedundant * xsize : maxIterRedundant)
+               : (sketchSizeMultiplier ? maxIter * xsize : maxIter));
+
+    double divergingLim = 1e6 * subsysA->error() + 1e12;
+
+    double mu = 0;
+    for (int iter = 1; iter < maxIterNumber; iter++) {
+        if (shouldInterrupt()) {
+            break;
+        }
+        B = JB.transpose() * JB;
+        B += ridgeFor(B) * I;
+        assembleKKT(B, JA, K);
+        if (!analysed) {
+            kkt.analyzePattern(K);
+            analysed = true;
+        }
+        kkt.factorize(K);
+        if (kkt.info() != Eigen::Success) {
+            break;  // JA rank-deficient: where the dense qp_eq gives up too
+        }
+        rhs << -grad, -resA;
+        sol = kkt.solve(rhs);
+        xdir = sol.head(xsize);
+
+        x0 = x;
+
+        // line search
+        {
+            double eta = 0.25;
+            double tau = 0.5;
+            double rho = 0.5;
+            double alpha = 1;
+            alpha = std::min(alpha, subsysA->maxStep(plistAB, xdir));
+
+            // Eq. 18.36
+            mu = std::max(
+                mu,
+                (grad.dot(xdir) + std::max(0., 0.5 * xdir.dot(B * xdir)))
+                    / ((1. - rho) * resA.lpNorm<1>())
+            );
+
+            // Eq. 18.27
+            double f0 = subsysB->error() + mu * resA.lpNorm<1>();
+
+            // Eq. 18.29
+            double deriv = grad.dot(xdir) - mu * resA.lpNorm<1>();
+
+            x = x0 + alpha * xdir;
+            subsysA->setParams(plistAB, x);
+            subsysB->setParams(plistAB, x);
+            subsysA->calcResidual(resA);
+            double f = subsysB->error() + mu * resA.lpNorm<1>();
+
+            // line search, Eq. 18.28
+            bool first = true;
+            while (f > f0 + eta * alpha * deriv) {
+                if (first) {
+                    // second-order correction: back onto JA's linearization,
+                    // through the same factorization
+                    rhs << Eigen::VectorXd::Zero(xsize), -resA;
+                    sol = kkt.solve(rhs);
+                    xdir1 = sol.head(xsize);
+                    x += xdir1;  // = x0 + alpha * xdir + xdir1
+                    subsysA->setParams(plistAB, x);
+                    subsysB->setParams(plistAB, x);
+                    subsysA->calcResidual(resA);
+                    f = subsysB->error() + mu * resA.lpNorm<1>();
+                    if (f < f0 + eta * alpha * deriv) {
+                        break;
+                    }
+                }
+                alpha = tau * alpha;
+                if (alpha < 1e-8) {  // let the linesearch fail
+                    alpha = 0.;
+                }
+                x = x0 + alpha * xdir;
+                subsysA->setParams(plistAB, x);
+                subsysB->setParams(plistAB, x);
+                subsysA->calcResidual(resA);
+                f = subsysB->error() + mu * resA.lpNorm<1>();
+                if (alpha < 1e-8) {  // let the linesearch fail
+                    break;
+                }
+            }
+        }
+        h = x - x0;
+
+        subsysB->calcGrad(plistAB, grad);
+        subsysB->calcJacobi(plistAB, JB);
+        subsysA->calcJacobi(plistAB, JA);
+        subsysA->calcResidual(resA);
+
+        double err = subsysA->error();
+        if (h.norm() <= (isRedundantsolving ? convergenceRedundant : convergence) && err <= smallF) {
+            break;
+        }
+        if (err > divergingLim || err != err) {  // check for diverging and NaN
+            break;
+        }
+    }
+
+    int ret;
+    if (subsysA->error() <= smallF) {
+        ret = Success;
+    }
+    else if (h.norm() <= (isRedundantsolving ? convergenceRedundant : convergence)) {
+        ret = Converged;
+    }
+    else {
+        ret = Failed;
+    }
+
+    subsysA->revertParams();
+    subsysB->revertParams();
+    return ret;
+}
+
+// makeReducedJacobian without the dense matrix: one grad() per parameter a
+// constraint actually has, instead of one per parameter of the system.
+void System::makeReducedJacobian(
+    SparseMatrix& J,
+    std::map<int, int>& jacobianconstraintmap,
+    GCS::VEC_pD& pdiagnoselist,
+    std::map<int, int>& tagmultiplicity
+)
+{
+    // construct specific parameter list for diagonose ignoring driven constraint parameters
+    const SET_pD driven(pdrivenlist.begin(), pdrivenlist.end());
+    MAP_pD_I column;
+    for (double* param : plist) {
+        if (driven.count(param) == 0) {
+            column[param] = int(pdiagnoselist.size());
+            pdiagnoselist.push_back(param);
+        }
+    }
+
+    std::vector<Eigen::Triplet<double>> entries;
+    int jacobianconstraintcount = 0;
+    int allcount = 0;
+    for (auto& constr : clist) {
+        constr->revertParams();
+        ++allcount;
+        if (constr->getTag() >= 0 && constr->isDriving()) {
+            jacobianconstraintcount++;
+            // grad() already sums over every use of a parameter, so each once
+            VEC_pD params = constr->params();
+            std::sort(params.begin(), params.end());
+            params.erase(std::unique(params.begin(), params.end()), params.end());
+            for (double* param : params) {
+                MAP_pD_I::const_iterator col = column.find(param);
+                if (col != column.end()) {
+                    entries.emplace_back(
+                        jacobianconstraintcount - 1,
+                        col->second,
+                        constr->grad(param)
+                    );
+                }
+            }
+
+            // parallel processing: create tag multiplicity map
+            if (tagmultiplicity.find(constr->getTag()) == tagmultiplicity.end()) {
+                tagmultiplicity[constr->getTag()] = 0;
+            }
+            else {
+                tagmultiplicity[constr->getTag()]++;
+            }
+
+            jacobianconstraintmap[jacobianconstraintcount - 1] = allcount - 1;
+        }
+    }
+
+    J.resize(jacobianconstraintcount, int(pdiagnoselist.size()));
+    J.setFromTriplets(entries.begin(), entries.end());
+}
+
+// identifyDependentParametersSparseQR on the sparse Jacobian, reading the
+// dependencies off R through pivotDependencies instead of a dense copy of R.
+void System::identifyDependentParametersSparse(
+    const SparseMatrix& J,
+    const GCS::VEC_pD& pdiagnoselist
+)
+{
+    Eigen::SparseQR<SparseMatrix, Eigen::COLAMDOrdering<int>> SqrJ;
+    SqrJ.compute(J);
+    const int rank = int(SqrJ.rank());
+    const int cols = int(SqrJ.cols());
+    const std::vector<std::vector<int>> dependencies
+        = pivotDependencies(SqrJ.matrixR(), rank, cols);
+    const auto& permutation = SqrJ.colsPermutation().indices();
+
+    pDependentParametersGroups.resize(cols - rank);
+    for (int j = rank; j < cols; j++) {
+        for (int row : dependencies[j - rank]) {
+            int origCol = permutation[row];
+
+            pDependentParametersGroups[j - rank].push_back(pdiagnoselist[origCol]);
+            pDependentParameters.push_back(pdiagnoselist[origCol]);
+        }
+        int origCol = permutation[j];
+
+        pDependentParametersGroups[j - rank].push_back(pdiagnoselist[origCol]);
+        pDependentParameters.push_back(pdiagnoselist[origCol]);
+    }
+}
+
+// The EigenSparseQR branch of diagnose() with the Jacobian and R kept sparse.
+// The dense-Jacobian branch builds J as a constraints x parameters dense matrix
+// and, for the conflict analysis, a dense R of constraints x constraints: at a
+// few thousand parameters that is hundreds of megabytes before any QR runs.
+int System::diagnoseSparse(Algorithm alg)
+{
+    SparseMatrix J;
+    std::map<int, int> jacobianconstraintmap;
+    GCS::VEC_pD pdiagnoselist;
+    std::map<int, int> tagmultiplicity;
+
+    makeReducedJacobian(J, jacobianconstraintmap, pdiagnoselist, tagmultiplicity);
+
+    // this function will exit with a diagnosis and, unless overridden by functions below, with full
+    // DoFs
+    hasDiagnosis = true;
+    dofs = pdiagnoselist.size();
+
+    if (J.rows() == 0) {
+        return dofs;
+    }
+
+    // From here on, presuming `J.rows() > 0`.
+    emptyDiagnoseMatrix = false;
+
+    // As in diagnose(): the parameter QR runs alongside the constraint QR and is
+    // waited for before the redundant solve touches pdiagnoselist.
+    auto fut = std::async(
+        &System::identifyDependentParametersSparse,
+        this,
+        std::cref(J),
+        std::cref(pdiagnoselist)
+    );
+
+    // The dense-Jacobian branch sets the pivot threshold only after compute(),
+    // where it no longer changes the rank, so this keeps Eigen's default too.
+    Eigen::SparseQR<SparseMatrix, Eigen::COLAMDOrdering<int>> SqrJT;
+    const SparseMatrix JT = J.transpose();
+    SqrJT.compute(JT);
+
+    int paramsNum = SqrJT.rows();
+    int constrNum = SqrJT.cols();
+    int rank = SqrJT.rank();
+
+    fut.wait();  // wait for the execution of identifyDependentParametersSparse to finish
+
+    dofs = paramsNum - rank;  // unless overconstraint, which will be overridden below
+
+    // Detecting conflicting or redundant constraints
+    if (constrNum > rank) {
+        const std::vector<std::vector<int>> dependencies
+            = pivotDependencies(SqrJT.matrixR(), rank, constrNum);
+        const auto& permutation = SqrJT.colsPermutation().indices();
+
+        std::vector<std::vector<Constraint*>> conflictGroups(constrNum - rank);
+        for (int j = rank; j < constrNum; j++) {
+            for (int row : dependencies[j - rank]) {
+                int origCol = permutation[row];
+
+                conflictGroups[j - rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
+            }
+            int origCol = permutation[j];
+
+            conflictGroups[j - rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
+        }
+
+        int nonredundantconstrNum;
+        resolveConflictGroups(
+            alg,
+            conflictGroups,
+            tagmultiplicity,
+            pdiagnoselist,
+            constrNum,
+            nonredundantconstrNum
+        );
+
+        if (paramsNum == rank && nonredundantconstrNum > rank) {
+            // over-constrained
+            dofs = paramsNum - nonredundantconstrNum;
+        }
+    }
+
+    return dofs;
+}
+
+#endif  // EIGEN_SPARSEQR_COMPATIBLE
+
+}  // namespace GCS
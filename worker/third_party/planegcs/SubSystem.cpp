@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <iterator>
+#include <unordered_map>
 
 #include "SubSystem.h"
 
@@ -269,6 +270,36 @@ void SubSystem::calcJacobi(Eigen::MatrixXd& jacobi)
     calcJacobi(plist, jacobi);
 }
 
+void SubSystem::calcJacobi(VEC_pD& params, Eigen::SparseMatrix<double>& jacobi)
+{
+    // redirected parameter -> column; a subsystem's parameter list holds each
+    // reduction target once, so the map is one-to-one
+    std::unordered_map<double*, int> column;
+    for (int j = 0; j < int(params.size()); j++) {
+        MAP_pD_pD::const_iterator pmapfind = pmap.find(params[j]);
+        if (pmapfind != pmap.end()) {
+            column.emplace(pmapfind->second, j);
+        }
+    }
+
+    std::vector<Eigen::Triplet<double>> entries;
+    for (int i = 0; i < csize; i++) {
+        for (double* param : c2p[clist[i]]) {
+            std::unordered_map<double*, int>::const_iterator col = column.find(param);
+            if (col != column.end()) {
+                entries.emplace_back(i, col->second, clist[i]->grad(param));
+            }
+        }
+    }
+    jacobi.resize(csize, int(params.size()));
+    jacobi.setFromTriplets(entries.begin(), entries.end());
+}
+
+void SubSystem::calcJacobi(Eigen::SparseMatrix<double>& jacobi)
+{
+    calcJacobi(plist, jacobi);
+}
+
 void SubSystem::calcGrad(VEC_pD& params, Eigen::VectorXd& grad)
 {
     assert(grad.size() == int(params.size()));
@@ -0,0 +1,203 @@
+// dragstepbench — in-process microbenchmark of the drag solve's parameter
+// snapshot and of one drag step.
+//
+// `ConstraintSolver::captureDragSolveSnapshot` / `restoreDragSolveSnapshot`
+// bracket every drag (runDragSubsteps rolls a refused or refined substep back
+// through them), and every solve backs its parameters up the same way. This
+// times both on sketches of 100 to 5000 entities (an H/V staircase plus free
+// circles and arcs, so every parameter kind is bound), next to what one
+// `Sketch::solveWithDrag` step of the same sketch costs end to end.
+//
+// Output: a markdown table written to --out (default RESULTS.md) and printed
+// to stdout. No worker process, no transport: solverbench gates the lane.
+//
+//   dragstepbench [--iters N] [--quick] [--out RESULTS.md]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "sketch/Sketch.h"
+#include "sketch/SketchPoint.h"
+#include "sketch/WireSketch.h"
+#include "sketch/solver/ConstraintSolver.h"
+#include "sketch/solver/SolverAdapter.h"
+
+using nlohmann::json;
+namespace sk = onecad::core::sketch;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// An H/V staircase of `nseg` 10 mm segments (3 entities each), and one free
+// circle and one free arc per ten segments beside it.
+json staircase(int nseg) {
+    json entities = json::array();
+    json constraints = json::array();
+    double x = 0.0;
+    double y = 0.0;
+    for (int i = 0; i < nseg; ++i) {
+        const std::string n = std::to_string(i);
+        const bool horizontal = i % 2 == 0;
+        const double ex = horizontal ? x + 10.0 : x;
+        const double ey = horizontal ? y : y + 10.0;
+        entities.push_back({{"id", "s" + n}, {"type", "Point"}, {"at", {x, y}}});
+        entities.push_back({{"id", "e" + n}, {"type", "Point"}, {"at", {ex, ey}}});
+        entities.push_back({{"id", "L" + n}, {"type", "Line"}, {"p0Ref", "s" + n},
+                            {"p1Ref", "e" + n}});
+        constraints.push_back({{"id", "d" + n}, {"type", "Distance"}, {"entities", {"L" + n}},
+                               {"value", 10.0}});
+        constraints.push_back({{"id", "hv" + n},
+                               {"type", horizontal ? "Horizontal" : "Vertical"},
+                               {"entities", {"L" + n}}});
+        if (i > 0) {
+            const std::string prev = "e" + std::to_string(i - 1);
+            constraints.push_back({{"id", "c" + n}, {"type", "Coincident"},
+                                   {"entities", {prev, "s" + n}}, {"positions", {"", ""}}});
+        }
+        if (i % 10 == 0) {
+            entities.push_back({{"id", "C" + n}, {"type", "Circle"},
+                                {"center", {x, y - 30.0}}, {"radius", 4.0}});
+            entities.push_back({{"id", "A" + n}, {"type", "Arc"}, {"center", {x, y - 50.0}},
+                                {"radius", 4.0}, {"startAngle", 0.0}, {"endAngle", 1.5}});
+        }
+        x = ex;
+        y = ey;
+    }
+    return {{"sketchId", "stairs"}, {"plane", {{"kind", "XY"}}}, {"entities", entities},
+            {"constraints", constraints}};
+}
+
+double pct(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const std::size_t idx =
+        std::min(v.size() - 1, static_cast<std::size_t>(q * (v.size() - 1) + 0.5));
+    return v[idx];
+}
+
+std::string fmt(double v) {
+    char b[32];
+    std::snprintf(b, sizeof(b), "%.3f", v);
+    return b;
+}
+
+double micros_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+struct Row {
+    int entities = 0;
+    std::size_t parameters = 0;
+    double capture_us = 0.0;  // per call, averaged over a batch
+    double restore_us = 0.0;
+    std::vector<double> step_us;
+    int refused = 0;
+};
+
+// Capture and restore, each timed as the mean of `reps` back-to-back calls
+// (one is below the clock's resolution on a small sketch).
+void time_snapshot(const json& wire, int reps, Row& row) {
+    onecad::wire::TranslateResult tr = onecad::wire::translate(wire);
+    sk::ConstraintSolver solver;
+    if (!tr.ok || !sk::SolverAdapter::populateSolver(*tr.sketch, solver)) {
+        std::fprintf(stderr, "dragstepbench: the sketch does not populate: %s\n",
+                     tr.error.c_str());
+        std::exit(1);
+    }
+    row.parameters = solver.captureDragSolveSnapshot().values.size();
+
+    std::vector<sk::ConstraintSolver::DragSolveSnapshot> taken(reps);
+    auto start = Clock::now();
+    for (int i = 0; i < reps; ++i) taken[i] = solver.captureDragSolveSnapshot();
+    row.capture_us = micros_since(start) / reps;
+
+    start = Clock::now();
+    for (int i = 0; i < reps; ++i) solver.restoreDragSolveSnapshot(taken[reps - 1 - i]);
+    row.restore_us = micros_since(start) / reps;
+}
+
+// `steps` drag steps of the staircase's far end, 0.5 mm apart on a circle.
+void time_drag(const json& wire, int nseg, int steps, Row& row) {
+    onecad::wire::TranslateResult tr = onecad::wire::translate(wire);
+    if (!tr.ok) std::exit(1);
+    tr.sketch->solve();
+    const sk::EntityID end = tr.index.resolve_point("e" + std::to_string(nseg - 1), "");
+    const auto* point = tr.sketch->getEntityAs<sk::SketchPoint>(end);
+    if (!point) std::exit(1);
+    const double cx = point->position().X();
+    const double cy = point->position().Y();
+    const double radius = 0.5 * steps / (2.0 * M_PI);
+    tr.sketch->beginPointDrag(end);
+    for (int i = 1; i <= steps; ++i) {
+        const double a = 2.0 * M_PI * i / steps;
+        const sk::Vec2d target{cx + radius * std::sin(a), cy + radius * (1.0 - std::cos(a))};
+        const auto start = Clock::now();
+        const sk::SolveResult r = tr.sketch->solveWithDrag(end, target);
+        row.step_us.push_back(micros_since(start));
+        if (!r.success) ++row.refused;
+    }
+    tr.sketch->endPointDrag();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string out_path = "RESULTS.md";
+    int iters = 200;
+    std::vector<int> sizes = {100, 500, 1000, 5000};
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--out" && i + 1 < argc) out_path = argv[++i];
+        else if (a == "--iters" && i + 1 < argc) iters = std::atoi(argv[++i]);
+        else if (a == "--quick") { iters = 10; sizes = {100, 1000}; }
+        else {
+            std::fprintf(stderr, "usage: %s [--iters N] [--quick] [--out FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<Row> rows;
+    for (int entities : sizes) {
+        // 3 entities per segment, 2 more per ten segments.
+        const int nseg = std::max(1, (entities * 10) / 32);
+        const json wire = staircase(nseg);
+        Row row;
+        row.entities = static_cast<int>(wire["entities"].size());
+        time_snapshot(wire, 1000, row);
+        // The largest sketches solve in tens of milliseconds a step.
+        time_drag(wire, nseg, entities >= 5000 ? std::max(1, iters / 10) : iters, row);
+        rows.push_back(std::move(row));
+    }
+
+    std::ostringstream md;
+    md << "# Drag snapshot + step microbenchmark\n\n";
+    md << "capture / restore = mean of 1000 back-to-back "
+          "`captureDragSolveSnapshot` / `restoreDragSolveSnapshot` calls on a "
+          "solver holding the whole sketch. step = one `Sketch::solveWithDrag` of "
+          "the staircase's far end, 0.5 mm from the last (its own component's "
+          "solver, substeps included).\n\n";
+    md << "| entities | parameters | capture (us) | restore (us) | step p50 (us) "
+          "| step p95 (us) | steps | refused |\n";
+    md << "|---:|---:|---:|---:|---:|---:|---:|---:|\n";
+    for (const Row& r : rows) {
+        md << "| " << r.entities << " | " << r.parameters << " | " << fmt(r.capture_us) << " | "
+           << fmt(r.restore_us) << " | " << fmt(pct(r.step_us, 0.50)) << " | "
+           << fmt(pct(r.step_us, 0.95)) << " | " << r.step_us.size() << " | " << r.refused
+           << " |\n";
+    }
+
+    {
+        std::ofstream f(out_path);
+        f << md.str();
+    }
+    std::fprintf(stdout, "%s\n", md.str().c_str());
+    std::fprintf(stderr, "dragstepbench: wrote %s\n", out_path.c_str());
+    return 0;
+}
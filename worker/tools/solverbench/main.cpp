@@ -2,9 +2,13 @@
 //
 // Spawns the real onecad-worker and drives the SCHEMA §7.4 gesture protocol over
 // stdio, measuring per-request round-trip latency (steady_clock at write ->
-// response read) for SolveDrag across sketches of 10/50/200/500 entities plus a
-// pathological set (near-singular / redundant / conflicting). Per scenario it
-// reports p50/p95/p99 round-trip AND the solveMicros vs transport-overhead split.
+// response read) for SolveDrag across sketches of 10/50/200/500 entities, large
+// 1000/2000/5000-entity ones (sparse solve path, fewer samples), a 500-entity
+// sketch of independent profiles (per-component solve), plus a pathological set
+// (near-singular / redundant / conflicting), and fast flicks on a constrained
+// linkage (drag warm start + adaptive substeps). Per scenario it
+// reports p50/p95/p99 round-trip AND the solveMicros vs transport-overhead split,
+// with the PlaneGCS iterations and substeps each SolveDrag reported.
 // One run also fires a Debug.Busy that spins the KERNEL lane, to prove drag
 // latency is unaffected by a busy kernel lane.
 //
@@ -144,6 +148,69 @@ json make_chain(const std::string& sketch_id, int nseg, int& entity_count) {
             {"entities", ents}, {"constraints", cons}};
 }
 
+// Independent profiles: `nrect` closed rectangles side by side, each 4 shared
+// corner points + 4 lines (8 entities) held by H/V + two Distances, and no
+// constraint between rectangles. A drag of "r0c0" touches one rectangle only, so
+// the worker solves (and diffs) that component alone — its latency should track
+// the 10-entity chain, not the sketch size.
+json make_profiles(const std::string& sketch_id, int nrect, int& entity_count) {
+    json ents = json::array(), cons = json::array();
+    for (int r = 0; r < nrect; ++r) {
+        const std::string k = "r" + std::to_string(r);
+        const double ox = 20.0 * r, w = 8.0, h = 5.0;
+        const double cx[] = {ox, ox + w, ox + w, ox};
+        const double cy[] = {0, 0, h, h};
+        for (int i = 0; i < 4; ++i) {
+            ents.push_back({{"id", k + "c" + std::to_string(i)}, {"type", "Point"},
+                            {"at", {cx[i], cy[i]}}});
+        }
+        for (int i = 0; i < 4; ++i) {
+            const std::string l = k + "L" + std::to_string(i);
+            ents.push_back({{"id", l}, {"type", "Line"},
+                            {"p0Ref", k + "c" + std::to_string(i)},
+                            {"p1Ref", k + "c" + std::to_string((i + 1) % 4)}});
+            cons.push_back({{"id", k + "hv" + std::to_string(i)},
+                            {"type", (i % 2 == 0) ? "Horizontal" : "Vertical"},
+                            {"entities", {l}}});
+        }
+        cons.push_back({{"id", k + "w"}, {"type", "Distance"}, {"entities", {k + "L0"}},
+                        {"value", w}});
+        cons.push_back({{"id", k + "h"}, {"type", "Distance"}, {"entities", {k + "L1"}},
+                        {"value", h}});
+    }
+    entity_count = static_cast<int>(ents.size());
+    return {{"sketchId", sketch_id}, {"plane", {{"kind", "XY"}}},
+            {"entities", ents}, {"constraints", cons}};
+}
+
+// Linkage: `nlink` links of length 10 hinged end to end, each square to the one
+// before, the first hinged on a Fixed root. Rigid but for the swing about the
+// root, so a body drag of the last link swings the whole arm — the shape a fast
+// flick on a constrained linkage takes.
+json make_linkage(const std::string& sketch_id, int nlink, int& entity_count) {
+    json ents = json::array(), cons = json::array();
+    ents.push_back({{"id", "j0"}, {"type", "Point"}, {"at", {0, 0}}});
+    cons.push_back({{"id", "root"}, {"type", "Fixed"}, {"entities", {"j0"}}});
+    double x = 0, y = 0;
+    for (int i = 0; i < nlink; ++i) {
+        // Alternate +x / +y so consecutive links start out square.
+        x += (i % 2 == 0) ? 10 : 0;
+        y += (i % 2 == 0) ? 0 : 10;
+        const std::string j = "j" + std::to_string(i + 1), l = "k" + std::to_string(i);
+        ents.push_back({{"id", j}, {"type", "Point"}, {"at", {x, y}}});
+        ents.push_back({{"id", l}, {"type", "Line"}, {"p0Ref", "j" + std::to_string(i)},
+                        {"p1Ref", j}});
+        cons.push_back({{"id", "len" + std::to_string(i)}, {"type", "Distance"},
+                        {"entities", {l}}, {"value", 10.0}});
+        if (i > 0)
+            cons.push_back({{"id", "sq" + std::to_string(i)}, {"type", "Perpendicular"},
+                            {"entities", {"k" + std::to_string(i - 1), l}}});
+    }
+    entity_count = static_cast<int>(ents.size());
+    return {{"sketchId", sketch_id}, {"plane", {{"kind", "XY"}}},
+            {"entities", ents}, {"constraints", cons}};
+}
+
 // Near-singular: two nearly-parallel lines joined at a shared vertex with a tiny
 // (0.05deg) angle constraint -> ill-conditioned Jacobian.
 json make_near_singular() {
@@ -208,9 +275,42 @@ struct Scenario {
     std::vector<double> rtt_us;      // round-trip
     std::vector<double> solve_us;    // solveMicros
     std::vector<double> transport_us;
+    std::vector<double> iterations;  // PlaneGCS iterations, summed over substeps
+    int max_substeps = 0;            // most solves one SolveDrag step took
     std::string status_note;         // dominant SolveDrag status observed
 };
 
+// One SolveDrag round trip, recorded into `sc`; returns the reported status.
+std::string time_drag(Client& c, const json& args, Scenario& sc) {
+    const auto t0 = Clock::now();
+    const std::uint64_t id = c.send("SolveDrag", args);
+    json r;
+    if (!c.recv_id(id, r)) return "?";
+    const auto t1 = Clock::now();
+    const double rtt =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / 1000.0;
+    double solve = 0.0;
+    std::string status = "?";
+    if (r.value("ok", false) && r.contains("result")) {
+        const json& res = r["result"];
+        solve = res.value("solveMicros", 0.0);
+        status = res.value("status", std::string{"?"});
+        sc.iterations.push_back(res.value("iterations", 0.0));
+        sc.max_substeps = std::max(sc.max_substeps, res.value("substeps", 0));
+    }
+    sc.rtt_us.push_back(rtt);
+    sc.solve_us.push_back(solve);
+    sc.transport_us.push_back(std::max(0.0, rtt - solve));
+    return status;
+}
+
+void note_dominant(const std::unordered_map<std::string, int>& statuses, Scenario& sc) {
+    int best = -1;
+    for (const auto& [k, v] : statuses) {
+        if (v > best) { best = v; sc.status_note = k; }
+    }
+}
+
 // Run one gesture: `n_small` small-move drags + `n_large` large jumps. Records
 // RTT/solve/transport samples into `sc`.
 void run_gesture(Client& c, const std::string& sketch_id, std::uint64_t gid,
@@ -225,34 +325,43 @@ void run_gesture(Client& c, const std::string& sketch_id, std::uint64_t gid,
     auto one_drag = [&](double tx, double ty) {
         ++seq;
         json d = {{"gestureId", gid}, {"seq", seq}, {"pointId", drag_pt}, {"target", {tx, ty}}};
-        const auto t0 = Clock::now();
-        const std::uint64_t id = c.send("SolveDrag", d);
-        json r;
-        if (!c.recv_id(id, r)) return;
-        const auto t1 = Clock::now();
-        const double rtt =
-            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / 1000.0;
-        double solve = 0.0;
-        std::string status = "?";
-        if (r.value("ok", false) && r.contains("result")) {
-            solve = r["result"].value("solveMicros", 0.0);
-            status = r["result"].value("status", std::string{"?"});
-        }
-        sc.rtt_us.push_back(rtt);
-        sc.solve_us.push_back(solve);
-        sc.transport_us.push_back(std::max(0.0, rtt - solve));
-        statuses[status]++;
+        statuses[time_drag(c, d, sc)]++;
     };
 
     for (int i = 0; i < n_small; ++i) one_drag(0.01 * (i % 20) - 0.1, 0.01 * (i % 15));
     for (int i = 0; i < n_large; ++i) one_drag(50.0 * ((i % 2) ? 1 : -1), 40.0 * (i % 3));
 
     c.recv_id(c.send("EndGesture", json{{"gestureId", gid}}), resp);
+    note_dominant(statuses, sc);
+}
 
-    int best = -1;
-    for (const auto& [k, v] : statuses) {
-        if (v > best) { best = v; sc.status_note = k; }
+// Run one body-drag gesture of `entity` made of `n_flicks` fast flicks: each an
+// accelerating straight swipe whose last frames jump 128-160 mm (past the
+// 100 mm at which a drag used to be split into substeps), turning ~137 degrees
+// between flicks.
+void run_flicks(Client& c, const std::string& sketch_id, std::uint64_t gid,
+                const std::string& entity, double gx, double gy, int n_flicks, Scenario& sc) {
+    json bargs = {{"sketchId", sketch_id}, {"sketchRevision", 1}, {"gestureId", gid},
+                  {"drag", {{"kind", "entityBody"}, {"entity", entity}, {"grab", {gx, gy}}}}};
+    json resp;
+    c.recv_id(c.send("BeginGesture", bargs), resp);
+
+    const double frames[] = {2, 4, 8, 16, 32, 64, 128, 160, 160};
+    std::unordered_map<std::string, int> statuses;
+    int seq = 0;
+    double heading = 0.0;
+    for (int f = 0; f < n_flicks; ++f, heading += 2.4) {
+        for (double step : frames) {
+            gx += step * std::cos(heading);
+            gy += step * std::sin(heading);
+            ++seq;
+            statuses[time_drag(c, {{"gestureId", gid}, {"seq", seq}, {"target", {gx, gy}}},
+                               sc)]++;
+        }
     }
+
+    c.recv_id(c.send("EndGesture", json{{"gestureId", gid}}), resp);
+    note_dominant(statuses, sc);
 }
 
 std::string fmt(double v) {
@@ -309,6 +418,51 @@ int main(int argc, char** argv) {
         scenarios.push_back(std::move(sc));
     }
 
+    // --- large sketches: the sparse solve path (SolverConfig::sparseThreshold) ---
+    // Fewer samples: every drag of a 5000-entity chain is one sparse solve of
+    // ~6700 parameters, and BeginGesture diagnoses all of them.
+    const int large_targets[] = {1000, 2000, 5000};
+    for (int t : large_targets) {
+        const int nseg = (t + 1) / 3;
+        int ec = 0;
+        const std::string sid = "chain" + std::to_string(t);
+        json args = make_chain(sid, nseg, ec);
+        c.recv_id(c.send("SketchUpsert", args), resp);
+        Scenario sc;
+        sc.name = "chain " + std::to_string(t) + " (sparse)";
+        sc.entities = ec;
+        run_gesture(c, sid, gid++, "s0", std::min(iters, 100), std::min(large, 4), sc);
+        scenarios.push_back(std::move(sc));
+    }
+
+    // --- independent profiles: per-component drag solve ---
+    {
+        int ec = 0;
+        json args = make_profiles("profiles500", 500 / 8, ec);
+        c.recv_id(c.send("SketchUpsert", args), resp);
+        Scenario sc;
+        sc.name = "profiles 500 (independent)";
+        sc.entities = ec;
+        run_gesture(c, "profiles500", gid++, "r0c0", iters, large, sc);
+        scenarios.push_back(std::move(sc));
+    }
+
+    // --- fast flicks on a constrained linkage: warm start + adaptive substeps ---
+    {
+        int ec = 0;
+        const int nlink = 20;
+        json args = make_linkage("linkage60", nlink, ec);
+        c.recv_id(c.send("SketchUpsert", args), resp);
+        Scenario sc;
+        sc.name = "linkage 60 (flicks)";
+        sc.entities = ec;
+        const json& tip = args["entities"].back();  // the last link; grab its far end
+        const json& end = args["entities"][args["entities"].size() - 2]["at"];
+        run_flicks(c, "linkage60", gid++, tip["id"].get<std::string>(), end[0].get<double>(),
+                   end[1].get<double>(), std::max(2, large / 2), sc);
+        scenarios.push_back(std::move(sc));
+    }
+
     // --- pathological set (fixed small; fewer iters) ---
     struct Path { std::string name; json (*gen)(); std::string sid; std::string pt; };
     std::vector<Path> paths = {
@@ -354,10 +508,12 @@ int main(int argc, char** argv) {
     md << "Round-trip = steady_clock at request write -> response read. "
           "solveMicros is the worker-reported PlaneGCS solve time; transport = "
           "round-trip - solveMicros. Each row: small-move drags"
-       << " (+ large jumps) over one gesture.\n\n";
+       << " (+ large jumps) over one gesture; the linkage row is fast flicks instead. "
+          "iters = PlaneGCS iterations per SolveDrag (summed over its substeps).\n\n";
     md << "| scenario | entities | samples | status | rtt p50 (ms) | rtt p95 (ms) | rtt p99 (ms) "
-          "| solve p50 | solve p95 | solve p99 | transport p95 (ms) |\n";
-    md << "|---|---:|---:|---|---:|---:|---:|---:|---:|---:|---:|\n";
+          "| solve p50 | solve p95 | solve p99 | transport p95 (ms) | iters p50 | iters p95 "
+          "| substeps max |\n";
+    md << "|---|---:|---:|---|---:|---:|---:|---:|---:|---:|---:|---:|---:|---:|\n";
     for (auto& sc : scenarios) {
         md << "| " << sc.name << " | " << sc.entities << " | " << sc.rtt_us.size() << " | "
            << sc.status_note << " | " << fmt(us_to_ms(pct(sc.rtt_us, 0.50))) << " | "
@@ -365,7 +521,8 @@ int main(int argc, char** argv) {
            << " | " << fmt(us_to_ms(pct(sc.solve_us, 0.50))) << " | "
            << fmt(us_to_ms(pct(sc.solve_us, 0.95))) << " | "
            << fmt(us_to_ms(pct(sc.solve_us, 0.99))) << " | "
-           << fmt(us_to_ms(pct(sc.transport_us, 0.95))) << " |\n";
+           << fmt(us_to_ms(pct(sc.transport_us, 0.95))) << " | " << pct(sc.iterations, 0.50)
+           << " | " << pct(sc.iterations, 0.95) << " | " << sc.max_substeps << " |\n";
     }
     md << "\n";
 
@@ -0,0 +1,267 @@
+// spawnbench — worker STARTUP LATENCY: cold spawn vs zygote fork.
+//
+// Rust respawns a worker after a crash, on ResetSession escalation and per open
+// document, so crash recovery and open-document latency are both bounded below
+// by worker startup. This measures the two ways to get a worker:
+//
+//   cold    fork+exec `onecad-worker` (what Rust does today);
+//   zygote  ask one long-lived `onecad-worker --zygote <socket>` for a forked,
+//           already-warmed child (protocol/Zygote.h).
+//
+// Each sample is timed from the spawn call to (a) the worker's hello frame and
+// (b) the response to a first `GetWorkerHead` — the earliest point at which a
+// spawned worker has proven it serves requests. The zygote's own one-time start
+// (exec + warm-up) is reported separately: it is paid once, off the critical path.
+//
+// Output: a markdown table (stdout + --out), p50/p95/max per path and the p50
+// speed-up. Exit 0 when every sample of both paths answered, else 2.
+//
+//   spawnbench --worker <path> [--iters N] [--quick] [--out RESULTS.md]
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "protocol/Envelope.h"
+#include "protocol/Frame.h"
+#include "protocol/Zygote.h"
+
+using nlohmann::json;
+using onecad::protocol::Envelope;
+using onecad::protocol::Frame;
+using onecad::protocol::ReadStatus;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double ms_since(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+double pct(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const std::size_t idx = static_cast<std::size_t>(q * static_cast<double>(v.size() - 1) + 0.5);
+    return v[std::min(idx, v.size() - 1)];
+}
+
+std::string fmt(double ms) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.2f", ms);
+    return buf;
+}
+
+// One spawned worker's pipes: `to` feeds its stdin, `from` reads its stdout.
+struct Pipes {
+    int to = -1;
+    int from = -1;
+};
+
+// After the spawn call: read the hello, then round-trip a GetWorkerHead.
+// Fills the two latencies (ms since `t0`); false when either frame is missing.
+bool handshake(const Pipes& p, Clock::time_point t0, double& hello_ms, double& ready_ms) {
+    auto rr = onecad::protocol::read_frame(p.from);
+    if (rr.status != ReadStatus::Ok) return false;
+    if (json::parse(rr.frame.json).value("t", std::string{}) != "hello") return false;
+    hello_ms = ms_since(t0);
+    Frame f;
+    f.json = onecad::protocol::serialize(Envelope::request(1, "GetWorkerHead"));
+    if (!onecad::protocol::write_frame(p.to, f)) return false;
+    rr = onecad::protocol::read_frame(p.from);
+    if (rr.status != ReadStatus::Ok) return false;
+    ready_ms = ms_since(t0);
+    return json::parse(rr.frame.json).value("ok", false);
+}
+
+// Close stdin (the worker exits on EOF) and drain stdout to EOF.
+void shut_down(Pipes& p) {
+    ::close(p.to);
+    char buf[4096];
+    while (::read(p.from, buf, sizeof(buf)) > 0) {
+    }
+    ::close(p.from);
+}
+
+pid_t exec_worker(const std::string& path, const std::vector<std::string>& args, Pipes* pipes) {
+    int p2c[2] = {-1, -1};
+    int c2p[2] = {-1, -1};
+    if (pipes != nullptr && (pipe(p2c) != 0 || pipe(c2p) != 0)) return -1;
+    const pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        if (pipes != nullptr) {
+            dup2(p2c[0], STDIN_FILENO);
+            dup2(c2p[1], STDOUT_FILENO);
+            close(p2c[0]); close(p2c[1]); close(c2p[0]); close(c2p[1]);
+        }
+        std::vector<char*> argv{const_cast<char*>(path.c_str())};
+        for (const std::string& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+        argv.push_back(nullptr);
+        execv(path.c_str(), argv.data());
+        _exit(127);
+    }
+    if (pipes != nullptr) {
+        close(p2c[0]); close(c2p[1]);
+        pipes->to = p2c[1];
+        pipes->from = c2p[0];
+    }
+    return pid;
+}
+
+bool socket_accepts(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    const bool ok = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    ::close(fd);
+    return ok;
+}
+
+struct Series {
+    std::string name;
+    std::vector<double> hello_ms;
+    std::vector<double> ready_ms;
+    int failures = 0;
+};
+
+void run_cold(const std::string& worker, int iters, Series& out) {
+    for (int i = 0; i < iters; ++i) {
+        Pipes p;
+        const Clock::time_point t0 = Clock::now();
+        const pid_t pid = exec_worker(worker, {}, &p);
+        double hello = 0.0;
+        double ready = 0.0;
+        if (pid < 0) { ++out.failures; continue; }
+        if (handshake(p, t0, hello, ready)) {
+            out.hello_ms.push_back(hello);
+            out.ready_ms.push_back(ready);
+        } else {
+            ++out.failures;
+        }
+        shut_down(p);
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+}
+
+void run_zygote(const std::string& socket_path, int iters, Series& out) {
+    for (int i = 0; i < iters; ++i) {
+        int p2c[2];
+        int c2p[2];
+        if (pipe(p2c) != 0 || pipe(c2p) != 0) { ++out.failures; continue; }
+        const Clock::time_point t0 = Clock::now();
+        std::string error;
+        const pid_t pid = onecad::protocol::zygote_spawn(socket_path, p2c[0], c2p[1], error);
+        close(p2c[0]); close(c2p[1]);
+        Pipes p{p2c[1], c2p[0]};
+        double hello = 0.0;
+        double ready = 0.0;
+        if (pid > 0 && handshake(p, t0, hello, ready)) {
+            out.hello_ms.push_back(hello);
+            out.ready_ms.push_back(ready);
+        } else {
+            if (pid <= 0) std::fprintf(stderr, "spawnbench: zygote spawn: %s\n", error.c_str());
+            ++out.failures;
+        }
+        shut_down(p);  // the zygote reaps its children
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string worker;
+    std::string out_path = "RESULTS.md";
+    int iters = 50;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--worker" && i + 1 < argc) worker = argv[++i];
+        else if (a == "--out" && i + 1 < argc) out_path = argv[++i];
+        else if (a == "--iters" && i + 1 < argc) iters = std::atoi(argv[++i]);
+        else if (a == "--quick") iters = 5;
+    }
+    if (worker.empty() || iters <= 0) {
+        std::fprintf(stderr, "usage: %s --worker <path> [--iters N] [--quick] [--out FILE]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    Series cold{"cold spawn (fork+exec)"};
+    run_cold(worker, iters, cold);
+
+    // One zygote for the whole run; its start is the one-time cost.
+    const std::string socket_path =
+        "/tmp/onecad-spawnbench-" + std::to_string(static_cast<int>(::getpid())) + ".sock";
+    const Clock::time_point z0 = Clock::now();
+    const pid_t zygote = exec_worker(worker, {"--zygote", socket_path}, nullptr);
+    double zygote_ready_ms = -1.0;
+    while (zygote > 0 && ms_since(z0) < 60000.0) {
+        if (socket_accepts(socket_path)) {
+            zygote_ready_ms = ms_since(z0);
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    Series forked{"zygote fork"};
+    if (zygote_ready_ms >= 0.0) {
+        run_zygote(socket_path, iters, forked);
+    } else {
+        std::fprintf(stderr, "spawnbench: zygote never became ready\n");
+        forked.failures = iters;
+    }
+    if (zygote > 0) {
+        kill(zygote, SIGTERM);
+        int status = 0;
+        waitpid(zygote, &status, 0);
+    }
+    ::unlink(socket_path.c_str());
+
+    // --- build markdown ---
+    std::ostringstream md;
+    md << "# Worker startup latency (cold spawn vs zygote fork)\n\n";
+    md << "Timed from the spawn call. hello = first frame read; ready = first "
+          "GetWorkerHead response read. " << iters << " samples per path.\n\n";
+    md << "| path | samples | failures | hello p50 (ms) | hello p95 (ms) | hello max (ms) "
+          "| ready p50 (ms) | ready p95 (ms) |\n";
+    md << "|---|---:|---:|---:|---:|---:|---:|---:|\n";
+    for (const Series* s : {&cold, &forked}) {
+        const double max = s->hello_ms.empty()
+                               ? 0.0
+                               : *std::max_element(s->hello_ms.begin(), s->hello_ms.end());
+        md << "| " << s->name << " | " << s->hello_ms.size() << " | " << s->failures << " | "
+           << fmt(pct(s->hello_ms, 0.50)) << " | " << fmt(pct(s->hello_ms, 0.95)) << " | "
+           << fmt(max) << " | " << fmt(pct(s->ready_ms, 0.50)) << " | "
+           << fmt(pct(s->ready_ms, 0.95)) << " |\n";
+    }
+    md << "\n- zygote one-time start (exec + warm-up to socket ready): **"
+       << fmt(zygote_ready_ms) << " ms**\n";
+    const double fork_p50 = pct(forked.ready_ms, 0.50);
+    if (fork_p50 > 0.0) {
+        md << "- ready p50 speed-up: **" << fmt(pct(cold.ready_ms, 0.50) / fork_p50)
+           << "x**\n";
+    }
+
+    {
+        std::ofstream f(out_path);
+        f << md.str();
+    }
+    std::fprintf(stdout, "%s\n", md.str().c_str());
+    std::fprintf(stderr, "spawnbench: wrote %s\n", out_path.c_str());
+    return (cold.failures == 0 && forked.failures == 0) ? 0 : 2;
+}